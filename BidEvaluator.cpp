@@ -0,0 +1,165 @@
+#include "BidEvaluator.h"
+#include <algorithm>
+
+namespace {
+    constexpr int DIX_DE_DER = 10;
+    constexpr int ATOUTS_PARTENAIRE_MIN = 3; // Atouts supposés chez le partenaire qui a annoncé
+    constexpr int TIRAGES_PARTENAIRE = 16;   // Tirages avant d'abandonner la contrainte
+}
+
+Carte::Couleur BidEvaluator::couleurAtout(Option option)
+{
+    static const Carte::Couleur couleurs[] = { Carte::COEUR, Carte::TREFLE, Carte::CARREAU, Carte::PIQUE };
+    return option < OPTION_TOUT_ATOUT ? couleurs[option] : Carte::COULEURINVALIDE;
+}
+
+CardTables::Mode BidEvaluator::mode(Option option)
+{
+    if (option == OPTION_TOUT_ATOUT) return CardTables::MODE_TOUT_ATOUT;
+    if (option == OPTION_SANS_ATOUT) return CardTables::MODE_SANS_ATOUT;
+    return CardTables::MODE_COULEUR;
+}
+
+int BidEvaluator::bidSuit(Option option)
+{
+    if (option == OPTION_TOUT_ATOUT) return 7;
+    if (option == OPTION_SANS_ATOUT) return 8;
+    return static_cast<int>(couleurAtout(option));
+}
+
+// Joue la donne jusqu'au bout ; retourne les points de l'équipe 0-2 (joueur 0 = le bot)
+int BidEvaluator::playout(std::array<CardSet, 4> mains, int entame, const PlayoutPolicy::Contrat &contrat, bool *capot)
+{
+    int points = 0;
+    int plisEquipe = 0;
+    int leader = entame;
+
+    for (int numeroPli = 0; numeroPli < 8; numeroPli++) {
+        PlayoutPolicy::Pli pli;
+        pli.leader = leader;
+        CardSet enJeu = mains[0] | mains[1] | mains[2] | mains[3];
+
+        for (int i = 0; i < 4; i++) {
+            int joueur = (leader + i) % 4;
+            CardId choix = PlayoutPolicy::chooseCard(mains[joueur], enJeu & ~mains[joueur], pli,
+                                                     joueur, joueur % 2 == 0, contrat);
+            mains[joueur].remove(choix);
+            enJeu.remove(choix);
+            pli.poser(choix, contrat);
+        }
+
+        leader = pli.joueurGagnant();
+        int pointsPli = pli.points + (numeroPli == 7 ? DIX_DE_DER : 0);
+        if (leader % 2 == 0) {
+            points += pointsPli;
+            plisEquipe++;
+        }
+    }
+
+    *capot = plisEquipe == 8;
+    return points;
+}
+
+std::array<BidEvaluator::Estimation, BidEvaluator::NB_OPTIONS> BidEvaluator::evaluate(CardSet main, const Options &options)
+{
+    std::array<PlayoutPolicy::Contrat, NB_OPTIONS> contrats;
+    std::array<Estimation, NB_OPTIONS> estimations;
+    for (int o = 0; o < NB_OPTIONS; o++) {
+        PlayoutPolicy::Contrat &contrat = contrats[o];
+        contrat = PlayoutPolicy::makeContrat(couleurAtout(static_cast<Option>(o)), mode(static_cast<Option>(o)));
+
+        if (contrat.mode == CardTables::MODE_COULEUR) {
+            CardSet roiDame = CardSet::single(makeCardId(contrat.couleurAtout, Carte::ROI))
+                            | CardSet::single(makeCardId(contrat.couleurAtout, Carte::DAME));
+            estimations[o].belote = (main & roiDame) == roiDame ? 20 : 0;
+        }
+    }
+
+    std::array<CardId, NB_CARTES> inconnues;
+    int nbInconnues = 0;
+    CardSet reste = ~main;
+    while (!reste.empty()) {
+        inconnues[nbInconnues++] = reste.popFirst();
+    }
+    int parJoueur = nbInconnues / 3;
+    CardSet atoutsPartenaire = CardSet::suit(options.couleurPartenaire);
+
+    std::mt19937 rng(options.seed);
+    std::array<std::array<int, NB_PALIERS>, NB_OPTIONS> reussites = {};
+    std::array<int, NB_OPTIONS> capots = {};
+
+    for (int s = 0; s < options.samples; s++) {
+        // Une donne commune aux 6 atouts
+        std::array<CardSet, 4> mains;
+        for (int tirage = 0; tirage < TIRAGES_PARTENAIRE; tirage++) {
+            std::shuffle(inconnues.begin(), inconnues.begin() + nbInconnues, rng);
+            mains = {{ main, CardSet(), CardSet(), CardSet() }};
+            for (int i = 0; i < nbInconnues; i++) {
+                mains[1 + std::min(i / parJoueur, 2)].add(inconnues[i]);
+            }
+            if (atoutsPartenaire.empty() || (mains[2] & atoutsPartenaire).size() >= ATOUTS_PARTENAIRE_MIN) break;
+        }
+
+        for (int o = 0; o < NB_OPTIONS; o++) {
+            bool capot = false;
+            int points = playout(mains, options.entame, contrats[o], &capot);
+            estimations[o].pointsMoyens += points;
+            capots[o] += capot ? 1 : 0;
+            for (int p = 0; p < NB_PALIERS; p++) {
+                if (points + estimations[o].belote >= 80 + 10 * p) reussites[o][p]++;
+            }
+        }
+    }
+
+    if (options.samples > 0) {
+        for (int o = 0; o < NB_OPTIONS; o++) {
+            estimations[o].pointsMoyens /= options.samples;
+            estimations[o].probaCapot = static_cast<double>(capots[o]) / options.samples;
+            for (int p = 0; p < NB_PALIERS; p++) {
+                estimations[o].probaContrat[p] = static_cast<double>(reussites[o][p]) / options.samples;
+            }
+        }
+    }
+    return estimations;
+}
+
+BidEvaluator::Decision BidEvaluator::choisirAnnonce(const std::array<Estimation, NB_OPTIONS> &estimations,
+                                                    Player::Annonce currentBid, double risque)
+{
+    // Probabilité de réussite exigée pour s'engager
+    double seuil = 1.0 - std::clamp(risque, 0.0, 1.0);
+    int minimum = (currentBid == Player::ANNONCEINVALIDE) ? Player::QUATREVINGT : currentBid + 1;
+
+    Decision decision;
+    for (int o = 0; o < NB_OPTIONS; o++) {
+        const Estimation &estimation = estimations[o];
+        Player::Annonce annonce = Player::PASSE;
+        double proba = 0.0;
+
+        if (estimation.probaCapot >= seuil && Player::CAPOT >= minimum) {
+            annonce = Player::CAPOT;
+            proba = estimation.probaCapot;
+        } else {
+            for (int p = NB_PALIERS - 1; p >= 0; p--) {
+                int niveau = Player::QUATREVINGT + p;
+                if (niveau < minimum) break;
+                if (estimation.probaContrat[p] >= seuil) {
+                    annonce = static_cast<Player::Annonce>(niveau);
+                    proba = estimation.probaContrat[p];
+                    break;
+                }
+            }
+        }
+        if (annonce == Player::PASSE) continue;
+
+        // Annonce la plus haute, puis la plus sûre
+        bool mieux = decision.annonce == Player::PASSE || annonce > decision.annonce
+                  || (annonce == decision.annonce && proba > decision.probaReussite);
+        if (mieux) {
+            decision.annonce = annonce;
+            decision.option = static_cast<Option>(o);
+            decision.probaReussite = proba;
+        }
+    }
+    return decision;
+}
@@ -0,0 +1,71 @@
+#ifndef BIDEVALUATOR_H
+#define BIDEVALUATOR_H
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include "Carte.h"
+#include "CardSet.h"
+#include "CardTables.h"
+#include "Player.h"
+#include "PlayoutPolicy.h"
+
+// Évaluation d'une main pour les enchères par simulation Monte-Carlo
+// Pour chaque atout possible (4 couleurs, Tout Atout, Sans Atout), complète
+// aléatoirement les 3 autres mains et joue la donne avec PlayoutPolicy
+// (masques de bits, sans allocation). La même donne tirée sert aux 6 atouts,
+// ce qui rend les options directement comparables.
+class BidEvaluator
+{
+    public:
+        enum Option {
+            OPTION_COEUR = 0,
+            OPTION_TREFLE,
+            OPTION_CARREAU,
+            OPTION_PIQUE,
+            OPTION_TOUT_ATOUT,
+            OPTION_SANS_ATOUT,
+            NB_OPTIONS
+        };
+
+        // Nombre de paliers d'annonce de 80 à 160
+        static constexpr int NB_PALIERS = 9;
+
+        struct Options {
+            int samples = 64;                   // Donnes simulées par évaluation
+            double risque = 0.25;               // 0 = prudent, 1 = annonce au moindre espoir
+            int entame = 0;                     // Position (relative au bot) du joueur qui entame
+            Carte::Couleur couleurPartenaire = Carte::COULEURINVALIDE;  // Atout annoncé par le partenaire
+            std::uint32_t seed = 0;
+        };
+
+        // Résultat pour un atout, du point de vue de l'équipe du bot
+        struct Estimation {
+            double pointsMoyens = 0.0;          // Points de plis moyens (dix de der compris), hors belote
+            int belote = 0;                     // 20 si le bot a Roi + Dame d'atout
+            double probaCapot = 0.0;
+            std::array<double, NB_PALIERS> probaContrat = {};  // P(points + belote >= 80 + 10 * palier)
+        };
+
+        struct Decision {
+            Player::Annonce annonce = Player::PASSE;
+            Option option = OPTION_COEUR;
+            double probaReussite = 0.0;
+        };
+
+        // Évalue les 6 atouts pour une main de 8 cartes
+        static std::array<Estimation, NB_OPTIONS> evaluate(CardSet main, const Options &options);
+
+        // Meilleure annonce strictement supérieure à currentBid (PASSE si aucune n'est assez sûre)
+        static Decision choisirAnnonce(const std::array<Estimation, NB_OPTIONS> &estimations,
+                                       Player::Annonce currentBid, double risque);
+
+        static Carte::Couleur couleurAtout(Option option);
+        static CardTables::Mode mode(Option option);
+        static int bidSuit(Option option);  // Code de couleur du protocole (3-6, 7 = TA, 8 = SA)
+
+    private:
+        static int playout(std::array<CardSet, 4> mains, int entame, const PlayoutPolicy::Contrat &contrat, bool *capot);
+};
+
+#endif
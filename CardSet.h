@@ -0,0 +1,104 @@
+#ifndef CARDSET_H
+#define CARDSET_H
+
+#include <cstdint>
+#include "Carte.h"
+
+// Identifiant compact d'une carte : couleur x chiffre dans [0, 31]
+// bits 3-4 = index de couleur (COEUR=0, TREFLE=1, CARREAU=2, PIQUE=3)
+// bits 0-2 = index de chiffre (SEPT=0 ... AS=7)
+using CardId = std::uint8_t;
+
+constexpr CardId CARD_ID_INVALIDE = 0xFF;
+constexpr int NB_CARTES = 32;
+
+constexpr int suitIndex(Carte::Couleur couleur)
+{
+    return static_cast<int>(couleur) - static_cast<int>(Carte::COEUR);
+}
+
+constexpr int rankIndex(Carte::Chiffre chiffre)
+{
+    return static_cast<int>(chiffre) - static_cast<int>(Carte::SEPT);
+}
+
+constexpr CardId makeCardId(Carte::Couleur couleur, Carte::Chiffre chiffre)
+{
+    return static_cast<CardId>(suitIndex(couleur) * 8 + rankIndex(chiffre));
+}
+
+inline CardId makeCardId(const Carte &carte)
+{
+    return makeCardId(carte.getCouleur(), carte.getChiffre());
+}
+
+constexpr Carte::Couleur couleurOf(CardId id)
+{
+    return static_cast<Carte::Couleur>((id >> 3) + static_cast<int>(Carte::COEUR));
+}
+
+constexpr Carte::Chiffre chiffreOf(CardId id)
+{
+    return static_cast<Carte::Chiffre>((id & 7) + static_cast<int>(Carte::SEPT));
+}
+
+// Ensemble de cartes sous forme de masque 32 bits (1 bit par carte)
+// Une main, un pli ou les cartes déjà jouées tiennent dans un seul registre
+class CardSet
+{
+    public:
+        constexpr CardSet() : m_bits(0) {}
+        constexpr explicit CardSet(std::uint32_t bits) : m_bits(bits) {}
+
+        static constexpr CardSet single(CardId id) { return CardSet(1u << id); }
+        static constexpr CardSet full() { return CardSet(0xFFFFFFFFu); }
+
+        // Les 8 cartes d'une couleur (ensemble vide pour COULEURINVALIDE)
+        static constexpr CardSet suit(Carte::Couleur couleur)
+        {
+            return (suitIndex(couleur) >= 0 && suitIndex(couleur) < 4)
+                ? CardSet(0xFFu << (suitIndex(couleur) * 8))
+                : CardSet();
+        }
+
+        constexpr std::uint32_t bits() const { return m_bits; }
+        constexpr bool empty() const { return m_bits == 0; }
+        constexpr bool contains(CardId id) const { return id < NB_CARTES && ((m_bits >> id) & 1u); }
+
+        int size() const { return __builtin_popcount(m_bits); }
+
+        void add(CardId id) { m_bits |= (1u << id); }
+        void remove(CardId id) { m_bits &= ~(1u << id); }
+        void clear() { m_bits = 0; }
+
+        // Cartes de l'ensemble appartenant à une couleur donnée
+        constexpr CardSet ofSuit(Carte::Couleur couleur) const { return *this & suit(couleur); }
+        constexpr bool hasSuit(Carte::Couleur couleur) const { return !ofSuit(couleur).empty(); }
+
+        // Plus petit identifiant présent (CARD_ID_INVALIDE si vide)
+        CardId first() const
+        {
+            return m_bits ? static_cast<CardId>(__builtin_ctz(m_bits)) : CARD_ID_INVALIDE;
+        }
+
+        // Retire et retourne le plus petit identifiant (itération bit à bit)
+        CardId popFirst()
+        {
+            CardId id = first();
+            m_bits &= m_bits - 1;
+            return id;
+        }
+
+        constexpr CardSet operator|(CardSet other) const { return CardSet(m_bits | other.m_bits); }
+        constexpr CardSet operator&(CardSet other) const { return CardSet(m_bits & other.m_bits); }
+        constexpr CardSet operator~() const { return CardSet(~m_bits); }
+        constexpr bool operator==(CardSet other) const { return m_bits == other.m_bits; }
+        constexpr bool operator!=(CardSet other) const { return m_bits != other.m_bits; }
+        CardSet &operator|=(CardSet other) { m_bits |= other.m_bits; return *this; }
+        CardSet &operator&=(CardSet other) { m_bits &= other.m_bits; return *this; }
+
+    private:
+        std::uint32_t m_bits;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef CARDTABLES_H
+#define CARDTABLES_H
+
+#include <array>
+#include <cstdint>
+#include "Carte.h"
+
+// Tables de force et de points des cartes, générées à la compilation
+// Indexées par [mode de jeu][atout ou non][chiffre - SEPT]
+namespace CardTables {
+
+    enum Mode {
+        MODE_COULEUR = 0,   // Atout classique (une couleur)
+        MODE_TOUT_ATOUT,    // Toutes les cartes sont atout
+        MODE_SANS_ATOUT,    // Aucune carte n'est atout
+        NB_MODES
+    };
+
+    using Rangee = std::array<std::uint8_t, 8>;
+    using Table = std::array<std::array<Rangee, 2>, NB_MODES>;
+
+    // Ordre croissant des chiffres, hors atout et à l'atout
+    constexpr std::array<Carte::Chiffre, 8> ORDRE_NORMAL = {
+        Carte::SEPT, Carte::HUIT, Carte::NEUF, Carte::VALET,
+        Carte::DAME, Carte::ROI, Carte::DIX, Carte::AS
+    };
+    constexpr std::array<Carte::Chiffre, 8> ORDRE_ATOUT = {
+        Carte::SEPT, Carte::HUIT, Carte::DAME, Carte::ROI,
+        Carte::DIX, Carte::AS, Carte::NEUF, Carte::VALET
+    };
+
+    // Inverse une liste ordonnée : rang du chiffre -> force (0 = plus faible)
+    constexpr Rangee forceDepuisOrdre(const std::array<Carte::Chiffre, 8> &ordre)
+    {
+        Rangee force{};
+        for (int i = 0; i < 8; i++) {
+            force[ordre[i] - Carte::SEPT] = static_cast<std::uint8_t>(i);
+        }
+        return force;
+    }
+
+    // Points par chiffre (7, 8, 9, 10, V, D, R, A)
+    constexpr Rangee POINTS_NORMAL      = { 0, 0,  0, 10,  2, 3, 4, 11 };
+    constexpr Rangee POINTS_ATOUT       = { 0, 0, 14, 10, 20, 3, 4, 11 };
+    constexpr Rangee POINTS_TOUT_ATOUT  = { 0, 0,  9,  4, 14, 2, 3,  6 };
+    constexpr Rangee POINTS_SANS_ATOUT  = { 0, 0,  0, 10,  2, 3, 4, 19 };
+
+    // En TA toutes les cartes suivent l'ordre atout, en SA l'ordre normal
+    constexpr Table FORCE = {{
+        {{ forceDepuisOrdre(ORDRE_NORMAL), forceDepuisOrdre(ORDRE_ATOUT) }},
+        {{ forceDepuisOrdre(ORDRE_ATOUT),  forceDepuisOrdre(ORDRE_ATOUT) }},
+        {{ forceDepuisOrdre(ORDRE_NORMAL), forceDepuisOrdre(ORDRE_NORMAL) }}
+    }};
+
+    constexpr Table POINTS = {{
+        {{ POINTS_NORMAL,     POINTS_ATOUT }},
+        {{ POINTS_TOUT_ATOUT, POINTS_TOUT_ATOUT }},
+        {{ POINTS_SANS_ATOUT, POINTS_SANS_ATOUT }}
+    }};
+
+    // Pour chaque chiffre, masque 8 bits des chiffres plus forts de la même couleur
+    constexpr Rangee plusFortesDepuisForce(const Rangee &force)
+    {
+        Rangee masques{};
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < 8; j++) {
+                if (force[j] > force[i]) {
+                    masques[i] = static_cast<std::uint8_t>(masques[i] | (1u << j));
+                }
+            }
+        }
+        return masques;
+    }
+
+    constexpr Table PLUS_FORTES = {{
+        {{ plusFortesDepuisForce(FORCE[MODE_COULEUR][0]),    plusFortesDepuisForce(FORCE[MODE_COULEUR][1]) }},
+        {{ plusFortesDepuisForce(FORCE[MODE_TOUT_ATOUT][0]), plusFortesDepuisForce(FORCE[MODE_TOUT_ATOUT][1]) }},
+        {{ plusFortesDepuisForce(FORCE[MODE_SANS_ATOUT][0]), plusFortesDepuisForce(FORCE[MODE_SANS_ATOUT][1]) }}
+    }};
+
+    constexpr int force(Mode mode, bool isAtout, Carte::Chiffre chiffre)
+    {
+        return FORCE[mode][isAtout][chiffre - Carte::SEPT];
+    }
+
+    constexpr int points(Mode mode, bool isAtout, Carte::Chiffre chiffre)
+    {
+        return POINTS[mode][isAtout][chiffre - Carte::SEPT];
+    }
+
+    constexpr std::uint8_t plusFortes(Mode mode, bool isAtout, Carte::Chiffre chiffre)
+    {
+        return PLUS_FORTES[mode][isAtout][chiffre - Carte::SEPT];
+    }
+
+    static_assert(force(MODE_COULEUR, true, Carte::VALET) == 7, "Valet d'atout = plus forte carte");
+    static_assert(force(MODE_COULEUR, false, Carte::AS) == 7, "As = plus forte carte hors atout");
+    static_assert(force(MODE_COULEUR, false, Carte::NEUF) == 2, "Ordre hors atout");
+    static_assert(points(MODE_TOUT_ATOUT, true, Carte::VALET) == 14, "Valet = 14 en TA");
+    static_assert(plusFortes(MODE_COULEUR, true, Carte::VALET) == 0, "Rien au-dessus du Valet d'atout");
+    static_assert(points(MODE_SANS_ATOUT, false, Carte::AS) == 19, "As = 19 en SA");
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include <iostream>
 #include "Carte.h"
+#include "CardTables.h"
 
 Carte::Carte()
 {
@@ -33,72 +34,12 @@ Carte::Chiffre Carte::getChiffre() const
 
 int Carte::getValeurDeLaCarte() const
 {
-    int value = 0;
-    if(!m_isAtout) {
-        if(m_chiffre == VALET)
-            value = 2;
-        else if (m_chiffre == DAME)
-            value = 3;
-        else if (m_chiffre == ROI)
-            value = 4;
-        else if (m_chiffre == DIX)
-            value = 10;
-        else if (m_chiffre == AS)
-            value = 11;
-    } else {
-        if(m_chiffre == VALET)
-            value = 20;
-        else if (m_chiffre == NEUF)
-            value = 14;
-        else if (m_chiffre == DAME)
-            value = 3;
-        else if (m_chiffre == ROI)
-            value = 4;
-        else if (m_chiffre == DIX)
-            value = 10;
-        else if (m_chiffre == AS)
-            value = 11;
-    }
-
-    return value;
+    return CardTables::points(CardTables::MODE_COULEUR, m_isAtout, m_chiffre);
 }
 
 int Carte::getOrdreCarteForte() const
 {
-    int value = 0;
-    if(m_chiffre == SEPT)
-            value = 0;
-    else if(m_chiffre == HUIT)
-            value = 1;
-    else if(!m_isAtout) {
-        if(m_chiffre == NEUF)
-            value = 2;
-        if(m_chiffre == VALET)
-            value = 3;
-        else if (m_chiffre == DAME)
-            value = 4;
-        else if (m_chiffre == ROI)
-            value = 5;
-        else if (m_chiffre == DIX)
-            value = 6;
-        else if (m_chiffre == AS)
-            value = 7;
-    } else {
-        if(m_chiffre == DAME)
-            value = 2;
-        else if (m_chiffre == ROI)
-            value = 3;
-        else if (m_chiffre == DIX)
-            value = 4;
-        else if (m_chiffre == AS)
-            value = 5;
-        else if (m_chiffre == NEUF)
-            value = 6;
-        else if (m_chiffre == VALET)
-            value = 7;
-    }
-    //std::cout << "getOrdreCarteForte called: " << value << std::endl;
-    return value;
+    return CardTables::force(CardTables::MODE_COULEUR, m_isAtout, m_chiffre);
 }
 
 void Carte::setAtout(bool isAtout)
@@ -106,6 +47,11 @@ void Carte::setAtout(bool isAtout)
     m_isAtout = isAtout;
 }
 
+bool Carte::isAtout() const
+{
+    return m_isAtout;
+}
+
 void Carte::printCarte() const
 {
     if(m_chiffre <= Carte::DIX)
@@ -136,21 +82,13 @@ void Carte::printCarte() const
 }
 
 bool Carte::operator<(const Carte &other) const {
-    bool retValue = false;
-    if(m_isAtout == false && other.m_isAtout == true) {
-        retValue = true;
-    } else if(m_isAtout == true && other.m_isAtout == false) {
-        retValue = false;
-    } else if(this->m_couleur != other.m_couleur) {
-        retValue = false;
-    } else {
-        // std::cout << "Comparaison des cartes: " ;
-        // this->printCarte();
-        // std::cout << "getOrdreCarteForte = " << this->getOrdreCarteForte() << std::endl;
-        // other.printCarte();
-        // std::cout << "getOrdreCarteForte() = " << other.getOrdreCarteForte() << std::endl;        
-        retValue = this->getOrdreCarteForte() < other.getOrdreCarteForte();
+    // Un atout bat toujours une carte non atout
+    if(m_isAtout != other.m_isAtout) {
+        return other.m_isAtout;
     }
-
-    return retValue;
+    // Couleurs différentes : la carte déjà posée reste maîtresse
+    if(m_couleur != other.m_couleur) {
+        return false;
+    }
+    return getOrdreCarteForte() < other.getOrdreCarteForte();
 }
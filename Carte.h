@@ -25,8 +25,9 @@ class Carte
 
         Carte();
         Carte(const Carte &carte);
+        Carte& operator=(const Carte &carte) = default;
         Carte(Couleur couleur, Chiffre chiffre);
-        virtual ~Carte();
+        ~Carte();
 
         Couleur getCouleur() const;
         Chiffre getChiffre() const;
@@ -37,6 +38,7 @@ class Carte
         int getOrdreCarteForte() const;
 
         void setAtout(bool isAtout);
+        bool isAtout() const;
 
         bool operator<(const Carte &other) const;
 
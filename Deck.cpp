@@ -5,26 +5,32 @@
 
 Deck::Deck()
 {
-    for(Carte::Chiffre ch =  Carte::SEPT ; ch <= Carte::AS ; ch = static_cast<Carte::Chiffre>(static_cast<int>(ch) + 1))
-    {        
-        for(Carte::Couleur co = Carte::COEUR ; co <= Carte::PIQUE ; co = static_cast<Carte::Couleur>(static_cast<int>(co) + 1))
-        {
-            Carte* carte = nullptr;
-        
-            carte = new Carte(co, ch);
-            m_deck.push_back(carte);
-        }
+    for(CardId id = 0; id < NB_CARTES; id++) {
+        m_cartes[id] = Carte(couleurOf(id), chiffreOf(id));
     }
+    m_deck.reserve(NB_CARTES);
+    fillDeck();
 }
 
 Deck::~Deck()
 {
-    for(Carte* carte : m_deck) {
-        delete carte;
-    }
     m_deck.clear();
 }
 
+void Deck::fillDeck()
+{
+    m_deck.clear();
+    for(Carte::Chiffre ch =  Carte::SEPT ; ch <= Carte::AS ; ch = static_cast<Carte::Chiffre>(static_cast<int>(ch) + 1))
+    {
+        for(Carte::Couleur co = Carte::COEUR ; co <= Carte::PIQUE ; co = static_cast<Carte::Couleur>(static_cast<int>(co) + 1))
+        {
+            Carte* carte = &m_cartes[makeCardId(co, ch)];
+            carte->setAtout(false);
+            m_deck.push_back(carte);
+        }
+    }
+}
+
 void Deck::printDeck()
 {
     for(Carte* c : m_deck) {
@@ -62,23 +68,8 @@ void Deck::setAtout(Carte::Couleur atoutCouleur)
 
 void Deck::resetDeck()
 {
-    // Supprimer les cartes existantes
-    for(Carte* carte : m_deck) {
-        delete carte;
-    }
-    m_deck.clear();
-
-    // Recréer le deck complet
-    for(Carte::Chiffre ch =  Carte::SEPT ; ch <= Carte::AS ; ch = static_cast<Carte::Chiffre>(static_cast<int>(ch) + 1))
-    {        
-        for(Carte::Couleur co = Carte::COEUR ; co <= Carte::PIQUE ; co = static_cast<Carte::Couleur>(static_cast<int>(co) + 1))
-        {
-            Carte* carte = nullptr;
-        
-            carte = new Carte(co, ch);
-            m_deck.push_back(carte);
-        }
-    }
+    // Remettre les 32 cartes dans le deck (les cartes ne sont jamais réallouées)
+    fillDeck();
 }
 
 void Deck::distribute(std::vector<Carte *> &main1, std::vector<Carte *> &main2, std::vector<Carte *> &main3, std::vector<Carte *> &main4)
@@ -182,3 +173,12 @@ void Deck::distribute323(std::vector<Carte*> &main1, std::vector<Carte*> &main2,
         main4.push_back(m_deck[cardIndex++]);
     }
 }
+
+CardSet Deck::getCardSet() const
+{
+    CardSet set;
+    for (const Carte* carte : m_deck) {
+        set.add(makeCardId(*carte));
+    }
+    return set;
+}
@@ -1,14 +1,20 @@
 #ifndef DECK_H
 #define DECK_H
 
+#include <array>
 #include <vector>
 #include "Carte.h"
+#include "CardSet.h"
 
  class Deck {
     public:
         Deck(/*Carte::Couleur atoutCouleur*/);
         ~Deck();
 
+        // Les cartes distribuées pointent dans m_cartes : un deck ne se copie pas
+        Deck(const Deck&) = delete;
+        Deck& operator=(const Deck&) = delete;
+
         void printDeck();
         void shuffleDeck();
         void resetDeck();
@@ -23,8 +29,16 @@
         // Les 11 cartes restantes servent pour la distribution complémentaire après "Prendre"
         void distributeBelote(std::vector<Carte*> &main1, std::vector<Carte*> &main2, std::vector<Carte*> &main3, std::vector<Carte*> &main4, Carte*& retournee);
 
+        // Cartes restant dans le deck sous forme de masque
+        CardSet getCardSet() const;
+
     private:
+        // Les 32 cartes sont stockées par valeur dans le deck (indexées par CardId)
+        // et réutilisées de manche en manche : aucune allocation par carte
+        std::array<Carte, NB_CARTES> m_cartes;
         std::vector<Carte *> m_deck;
+
+        void fillDeck();
         //Carte::Couleur m_atoutCouleur;
  };
 
@@ -0,0 +1,425 @@
+#include "DoubleDummySolver.h"
+#include "LegalMoves.h"
+#include <algorithm>
+
+namespace {
+    // Points du dix de der
+    constexpr int DIX_DE_DER = 10;
+    constexpr int VALEUR_INF = 1000;
+    // Nœuds entre deux lectures de l'horloge (échéance)
+    constexpr std::uint64_t NOEUDS_PAR_CONTROLE = 1024;
+}
+
+DoubleDummySolver::DoubleDummySolver(int ttBits)
+    : m_table(std::size_t(1) << ttBits)
+    , m_mask((std::uint64_t(1) << ttBits) - 1)
+{
+    setContract(m_couleurAtout, m_mode);
+    clear();
+}
+
+void DoubleDummySolver::setContract(Carte::Couleur couleurAtout, CardTables::Mode mode)
+{
+    m_couleurAtout = couleurAtout;
+    m_mode = mode;
+    for (int id = 0; id < NB_CARTES; id++) {
+        m_points[id] = static_cast<std::uint8_t>(cardPoints(static_cast<CardId>(id), couleurAtout, mode));
+    }
+}
+
+void DoubleDummySolver::clear()
+{
+    for (Entry &entry : m_table) {
+        entry.used = false;
+    }
+}
+
+void DoubleDummySolver::setDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    m_deadline = deadline;
+    m_hasDeadline = true;
+    m_aborted = false;
+}
+
+void DoubleDummySolver::clearDeadline()
+{
+    m_hasDeadline = false;
+    m_aborted = false;
+}
+
+bool DoubleDummySolver::deadlinePassed()
+{
+    if (!m_aborted && m_hasDeadline && std::chrono::steady_clock::now() >= m_deadline) {
+        m_aborted = true;
+    }
+    return m_aborted;
+}
+
+bool DoubleDummySolver::isAtout(CardId id, Carte::Couleur couleurAtout, CardTables::Mode mode)
+{
+    if (mode == CardTables::MODE_TOUT_ATOUT) return true;
+    if (mode == CardTables::MODE_SANS_ATOUT) return false;
+    return couleurOf(id) == couleurAtout;
+}
+
+int DoubleDummySolver::cardPoints(CardId id, Carte::Couleur couleurAtout, CardTables::Mode mode)
+{
+    return CardTables::points(mode, isAtout(id, couleurAtout, mode), chiffreOf(id));
+}
+
+int DoubleDummySolver::pliWinner(const CardId *pli, int pliSize, Carte::Couleur couleurAtout, CardTables::Mode mode)
+{
+    int gagnant = 0;
+    bool gagnantAtout = isAtout(pli[0], couleurAtout, mode);
+    for (int i = 1; i < pliSize; i++) {
+        bool atout = isAtout(pli[i], couleurAtout, mode);
+        bool bat;
+        if (atout != gagnantAtout) {
+            // Une carte d'atout bat une carte non atout
+            bat = atout;
+        } else if (couleurOf(pli[i]) != couleurOf(pli[gagnant])) {
+            // Défausse : ne prend pas la main
+            bat = false;
+        } else {
+            bat = CardTables::force(mode, atout, chiffreOf(pli[i]))
+                > CardTables::force(mode, atout, chiffreOf(pli[gagnant]));
+        }
+        if (bat) {
+            gagnant = i;
+            gagnantAtout = atout;
+        }
+    }
+    return gagnant;
+}
+
+DoubleDummySolver::State DoubleDummySolver::toState(const Position &position) const
+{
+    State state;
+    state.mains = position.mains;
+    state.pli = position.pli;
+    state.pliSize = position.pliSize;
+    state.leader = position.leader;
+    state.pointsPli = 0;
+    for (int i = 0; i < position.pliSize; i++) {
+        state.pointsPli += cardPoints(position.pli[i], position.couleurAtout, position.mode);
+    }
+    state.pointsMains = 0;
+    for (const CardSet &main : position.mains) {
+        CardSet reste = main;
+        while (!reste.empty()) {
+            state.pointsMains += cardPoints(reste.popFirst(), position.couleurAtout, position.mode);
+        }
+    }
+    return state;
+}
+
+int DoubleDummySolver::remainingPoints(const State &state) const
+{
+    return state.pointsPli + state.pointsMains + DIX_DE_DER;
+}
+
+std::uint64_t DoubleDummySolver::hashState(const State &state) const
+{
+    std::uint64_t h = static_cast<std::uint64_t>(state.leader);
+    for (const CardSet &main : state.mains) {
+        h = (h ^ main.bits()) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+// Coups à explorer, triés du plus prometteur au moins prometteur
+// Les cartes consécutives d'une même main et de même valeur sont équivalentes : une seule est gardée
+int DoubleDummySolver::generateMoves(const State &state, CardId *moves) const
+{
+    int joueur = (state.leader + state.pliSize) % 4;
+    CardSet main = state.mains[joueur];
+
+    Carte::Couleur couleurDemandee = Carte::COULEURINVALIDE;
+    CardId carteGagnante = CARD_ID_INVALIDE;
+    bool partenaireGagne = false;
+    if (state.pliSize > 0) {
+        int gagnant = pliWinner(state.pli.data(), state.pliSize, m_couleurAtout, m_mode);
+        couleurDemandee = couleurOf(state.pli[0]);
+        carteGagnante = state.pli[gagnant];
+        partenaireGagne = (state.leader + gagnant + 2) % 4 == joueur;
+    }
+    CardSet legaux = LegalMoves::legalMoves(main, couleurDemandee, carteGagnante, partenaireGagne,
+                                            m_couleurAtout, m_mode);
+
+    // Cartes encore en jeu (mains + pli en cours) : les autres sont tombées
+    CardSet enJeu;
+    for (const CardSet &m : state.mains) {
+        enJeu |= m;
+    }
+    for (int i = 0; i < state.pliSize; i++) {
+        enJeu.add(state.pli[i]);
+    }
+
+    int scores[8];
+    int count = 0;
+    for (int s = Carte::COEUR; s <= Carte::PIQUE; s++) {
+        Carte::Couleur couleur = static_cast<Carte::Couleur>(s);
+        if (!legaux.hasSuit(couleur)) continue;
+
+        bool atout = isAtout(makeCardId(couleur, Carte::SEPT), m_couleurAtout, m_mode);
+        const auto &ordre = (m_mode == CardTables::MODE_TOUT_ATOUT || (m_mode == CardTables::MODE_COULEUR && atout))
+            ? CardTables::ORDRE_ATOUT : CardTables::ORDRE_NORMAL;
+
+        // Parcours de la plus forte à la plus faible
+        CardId precedente = CARD_ID_INVALIDE;
+        for (int r = 7; r >= 0; r--) {
+            CardId id = makeCardId(couleur, ordre[r]);
+            if (!legaux.contains(id)) {
+                // Une carte encore en jeu ailleurs casse la séquence
+                if (enJeu.contains(id)) precedente = CARD_ID_INVALIDE;
+                continue;
+            }
+            int points = m_points[id];
+            if (precedente != CARD_ID_INVALIDE && m_points[precedente] == points) {
+                continue;
+            }
+            precedente = id;
+
+            int score;
+            if (state.pliSize == 0) {
+                // Entame : d'abord les cartes maîtresses (rien de plus fort chez les autres)
+                CardSet plusFortes = LegalMoves::plusFortesQue(id, m_mode, atout) & enJeu & ~main;
+                score = (plusFortes.empty() ? 100 + points : 0) + CardTables::force(m_mode, atout, chiffreOf(id));
+            } else {
+                std::array<CardId, 4> essai = state.pli;
+                essai[state.pliSize] = id;
+                bool gagne = pliWinner(essai.data(), state.pliSize + 1, m_couleurAtout, m_mode) == state.pliSize;
+                if (gagne) {
+                    score = 200 + points;
+                } else if (partenaireGagne) {
+                    score = 100 + points;
+                } else {
+                    score = 50 - points;
+                }
+            }
+
+            // Insertion triée (au plus 8 coups)
+            int pos = count;
+            while (pos > 0 && scores[pos - 1] < score) {
+                scores[pos] = scores[pos - 1];
+                moves[pos] = moves[pos - 1];
+                pos--;
+            }
+            scores[pos] = score;
+            moves[pos] = id;
+            count++;
+        }
+    }
+    return count;
+}
+
+// Points gagnés par l'équipe 0-2 à partir de l'état (pli en cours compris)
+int DoubleDummySolver::search(State &state, int alpha, int beta)
+{
+    m_nodes++;
+    // Recherche interrompue : la valeur rendue n'a pas de sens, rien n'est mis en table
+    if (m_aborted || (m_nodes % NOEUDS_PAR_CONTROLE == 0 && deadlinePassed())) return 0;
+
+    Entry *entry = nullptr;
+
+    if (state.pliSize == 0) {
+        if ((state.mains[0] | state.mains[1] | state.mains[2] | state.mains[3]).empty()) {
+            return 0;
+        }
+
+        // La valeur est toujours comprise entre 0 et les points restants
+        int total = remainingPoints(state);
+        if (total <= alpha) return total;
+        if (beta <= 0) return 0;
+
+        entry = &m_table[hashState(state) & m_mask];
+        bool match = entry->used && entry->leader == state.leader
+                  && entry->mains[0] == state.mains[0].bits() && entry->mains[1] == state.mains[1].bits()
+                  && entry->mains[2] == state.mains[2].bits() && entry->mains[3] == state.mains[3].bits();
+        if (match) {
+            if (entry->lower >= beta) return entry->lower;
+            if (entry->upper <= alpha) return entry->upper;
+            alpha = std::max(alpha, static_cast<int>(entry->lower));
+            beta = std::min(beta, static_cast<int>(entry->upper));
+            if (alpha >= beta) return alpha;
+        } else {
+            entry->used = true;
+            entry->leader = static_cast<std::uint8_t>(state.leader);
+            for (int i = 0; i < 4; i++) entry->mains[i] = state.mains[i].bits();
+            entry->lower = 0;
+            entry->upper = static_cast<std::int16_t>(total);
+        }
+    }
+
+    // Fenêtre effective (après resserrement par la table) pour classer le résultat
+    int alphaInitial = alpha;
+    int betaInitial = beta;
+
+    int joueur = (state.leader + state.pliSize) % 4;
+    bool maximise = (joueur % 2) == 0;
+
+    CardId moves[8];
+    int nbMoves = generateMoves(state, moves);
+
+    int best = maximise ? -VALEUR_INF : VALEUR_INF;
+    for (int i = 0; i < nbMoves; i++) {
+        CardId id = moves[i];
+        State child = state;
+        child.mains[joueur].remove(id);
+        child.pli[child.pliSize++] = id;
+        child.pointsPli += m_points[id];
+        child.pointsMains -= m_points[id];
+
+        int value;
+        if (child.pliSize == 4) {
+            // Pli complet : le gagnant ramasse et rejoue
+            int gagnant = (child.leader + pliWinner(child.pli.data(), 4, m_couleurAtout, m_mode)) % 4;
+            bool dernier = (child.mains[0] | child.mains[1] | child.mains[2] | child.mains[3]).empty();
+            int gain = child.pointsPli + (dernier ? DIX_DE_DER : 0);
+            int gainEquipe = (gagnant % 2 == 0) ? gain : 0;
+
+            child.leader = gagnant;
+            child.pliSize = 0;
+            child.pointsPli = 0;
+            value = gainEquipe + search(child, alpha - gainEquipe, beta - gainEquipe);
+        } else {
+            value = search(child, alpha, beta);
+        }
+        if (m_aborted) return 0;
+
+        if (maximise) {
+            best = std::max(best, value);
+            alpha = std::max(alpha, best);
+        } else {
+            best = std::min(best, value);
+            beta = std::min(beta, best);
+        }
+        if (alpha >= beta) break;
+    }
+
+    // Stockage des bornes (échec haut = borne basse, échec bas = borne haute)
+    if (entry) {
+        // L'entrée a pu être remplacée par une autre position pendant la recherche
+        bool match = entry->leader == state.leader
+                  && entry->mains[0] == state.mains[0].bits() && entry->mains[1] == state.mains[1].bits()
+                  && entry->mains[2] == state.mains[2].bits() && entry->mains[3] == state.mains[3].bits();
+        if (!match) {
+            entry->leader = static_cast<std::uint8_t>(state.leader);
+            for (int i = 0; i < 4; i++) entry->mains[i] = state.mains[i].bits();
+            entry->lower = 0;
+            entry->upper = static_cast<std::int16_t>(remainingPoints(state));
+        }
+        if (best <= alphaInitial) {
+            entry->upper = static_cast<std::int16_t>(std::min<int>(entry->upper, best));
+        } else if (best >= betaInitial) {
+            entry->lower = static_cast<std::int16_t>(std::max<int>(entry->lower, best));
+        } else {
+            entry->lower = entry->upper = static_cast<std::int16_t>(best);
+        }
+    }
+
+    return best;
+}
+
+int DoubleDummySolver::solve(const Position &position)
+{
+    if (position.mode != m_mode || position.couleurAtout != m_couleurAtout) {
+        // Les valeurs en table dépendent du contrat
+        setContract(position.couleurAtout, position.mode);
+        clear();
+    }
+    State state = toState(position);
+
+    // Recherche par fenêtres nulles (dichotomie sur la valeur) : chaque passe
+    // coupe beaucoup plus que la fenêtre complète, et la table garde les bornes
+    int lower = 0;
+    int upper = remainingPoints(state);
+    while (lower < upper && !m_aborted) {
+        int test = (lower + upper + 1) / 2;
+        State copie = state;
+        int value = search(copie, test - 1, test);
+        if (value >= test) {
+            lower = value;
+        } else {
+            upper = value;
+        }
+    }
+    return lower;
+}
+
+std::vector<std::pair<CardId, int>> DoubleDummySolver::evaluateMoves(const Position &position)
+{
+    std::vector<std::pair<CardId, int>> resultats;
+    int joueur = position.currentPlayer();
+
+    // Points en jeu depuis la racine, pour exprimer la valeur côté équipe 1-3
+    int enJeu = DIX_DE_DER;
+    for (int i = 0; i < position.pliSize; i++) {
+        enJeu += cardPoints(position.pli[i], position.couleurAtout, position.mode);
+    }
+    for (const CardSet &main : position.mains) {
+        CardSet reste = main;
+        while (!reste.empty()) {
+            enJeu += cardPoints(reste.popFirst(), position.couleurAtout, position.mode);
+        }
+    }
+
+    // Toutes les cartes légales (y compris les équivalentes, pour l'appelant)
+    Carte::Couleur couleurDemandee = Carte::COULEURINVALIDE;
+    CardId carteGagnante = CARD_ID_INVALIDE;
+    bool partenaireGagne = false;
+    if (position.pliSize > 0) {
+        int gagnant = pliWinner(position.pli.data(), position.pliSize, position.couleurAtout, position.mode);
+        couleurDemandee = couleurOf(position.pli[0]);
+        carteGagnante = position.pli[gagnant];
+        partenaireGagne = (position.leader + gagnant + 2) % 4 == joueur;
+    }
+    CardSet legaux = LegalMoves::legalMoves(position.mains[joueur], couleurDemandee, carteGagnante,
+                                            partenaireGagne, position.couleurAtout, position.mode);
+
+    while (!legaux.empty()) {
+        // Échéance passée : les coups restants ne sont pas évalués
+        if (deadlinePassed()) break;
+        CardId id = legaux.popFirst();
+        Position enfant = position;
+        enfant.mains[joueur].remove(id);
+        enfant.pli[enfant.pliSize++] = id;
+
+        int pointsEquipe0;
+        if (enfant.pliSize == 4) {
+            int gagnant = (enfant.leader + pliWinner(enfant.pli.data(), 4, enfant.couleurAtout, enfant.mode)) % 4;
+            bool dernier = (enfant.mains[0] | enfant.mains[1] | enfant.mains[2] | enfant.mains[3]).empty();
+            int gain = dernier ? DIX_DE_DER : 0;
+            for (int i = 0; i < 4; i++) {
+                gain += cardPoints(enfant.pli[i], enfant.couleurAtout, enfant.mode);
+            }
+            enfant.leader = gagnant;
+            enfant.pliSize = 0;
+            enfant.pli.fill(CARD_ID_INVALIDE);
+            pointsEquipe0 = (gagnant % 2 == 0 ? gain : 0) + solve(enfant);
+        } else {
+            pointsEquipe0 = solve(enfant);
+        }
+        if (m_aborted) break;
+
+        // Valeur du point de vue de l'équipe du joueur
+        int valeur = (joueur % 2 == 0) ? pointsEquipe0 : enJeu - pointsEquipe0;
+        resultats.push_back(std::make_pair(id, valeur));
+    }
+    return resultats;
+}
+
+CardId DoubleDummySolver::bestMove(const Position &position, int *value)
+{
+    CardId best = CARD_ID_INVALIDE;
+    int bestValue = -VALEUR_INF;
+    for (const auto &coup : evaluateMoves(position)) {
+        if (coup.second > bestValue) {
+            bestValue = coup.second;
+            best = coup.first;
+        }
+    }
+    if (value) *value = bestValue;
+    return best;
+}
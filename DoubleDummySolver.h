@@ -0,0 +1,103 @@
+#ifndef DOUBLEDUMMYSOLVER_H
+#define DOUBLEDUMMYSOLVER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Carte.h"
+#include "CardSet.h"
+#include "CardTables.h"
+
+// Solveur "double mort" (information parfaite) pour la phase de jeu
+// Alpha-beta sur les points de carte, avec table de transposition aux débuts
+// de pli, ordonnancement des coups et regroupement des cartes équivalentes.
+// Sert de base aux bots par échantillonnage, à l'analyse d'après-partie et
+// au benchmark des bots. La belote (20 points annoncés) n'est pas comptée ici.
+class DoubleDummySolver
+{
+    public:
+        // Position à résoudre : les 4 mains connues et le pli en cours
+        struct Position {
+            std::array<CardSet, 4> mains;
+            std::array<CardId, 4> pli = {{ CARD_ID_INVALIDE, CARD_ID_INVALIDE, CARD_ID_INVALIDE, CARD_ID_INVALIDE }};
+            int pliSize = 0;       // Nombre de cartes déjà posées dans le pli en cours
+            int leader = 0;        // Joueur ayant entamé le pli en cours
+            Carte::Couleur couleurAtout = Carte::COULEURINVALIDE;  // COULEURINVALIDE en TA/SA
+            CardTables::Mode mode = CardTables::MODE_COULEUR;
+
+            int currentPlayer() const { return (leader + pliSize) % 4; }
+        };
+
+        // ttBits : taille de la table de transposition (2^ttBits entrées)
+        explicit DoubleDummySolver(int ttBits = 16);
+
+        // Points restant à gagner (cartes du pli en cours comprises, dix de der compris)
+        // par l'équipe 0-2, en jeu parfait des deux côtés
+        int solve(const Position &position);
+
+        // Valeur exacte de chaque coup légal, du point de vue de l'équipe du joueur qui doit jouer
+        std::vector<std::pair<CardId, int>> evaluateMoves(const Position &position);
+
+        // Meilleure carte pour le joueur qui doit jouer (value reçoit sa valeur si non nul)
+        CardId bestMove(const Position &position, int *value = nullptr);
+
+        // Vide la table de transposition (à faire si le contrat change)
+        void clear();
+
+        // Échéance des recherches : une fois passée, solve() et evaluateMoves() s'arrêtent
+        // au plus tôt et aborted() devient vrai (leurs résultats sont alors à ignorer)
+        void setDeadline(std::chrono::steady_clock::time_point deadline);
+        void clearDeadline();
+        bool aborted() const { return m_aborted; }
+
+        std::uint64_t nodeCount() const { return m_nodes; }
+
+        // Utilitaires partagés avec les bots
+        static bool isAtout(CardId id, Carte::Couleur couleurAtout, CardTables::Mode mode);
+        static int cardPoints(CardId id, Carte::Couleur couleurAtout, CardTables::Mode mode);
+        // Index (0..pliSize-1) de la carte maîtresse d'un pli
+        static int pliWinner(const CardId *pli, int pliSize, Carte::Couleur couleurAtout, CardTables::Mode mode);
+
+    private:
+        struct Entry {
+            std::array<std::uint32_t, 4> mains;
+            std::int16_t lower;
+            std::int16_t upper;
+            std::uint8_t leader;
+            bool used;
+        };
+
+        struct State {
+            std::array<CardSet, 4> mains;
+            std::array<CardId, 4> pli;
+            int pliSize;
+            int leader;
+            int pointsPli;    // Points des cartes déjà posées dans le pli
+            int pointsMains;  // Points des cartes encore en main
+        };
+
+        void setContract(Carte::Couleur couleurAtout, CardTables::Mode mode);
+        bool deadlinePassed();
+        int search(State &state, int alpha, int beta);
+        int generateMoves(const State &state, CardId *moves) const;
+        int remainingPoints(const State &state) const;
+        std::uint64_t hashState(const State &state) const;
+        State toState(const Position &position) const;
+
+        std::vector<Entry> m_table;
+        std::uint64_t m_mask;
+        std::uint64_t m_nodes = 0;
+
+        bool m_hasDeadline = false;
+        bool m_aborted = false;
+        std::chrono::steady_clock::time_point m_deadline;
+
+        // Contrat courant et points de chaque carte pour ce contrat
+        Carte::Couleur m_couleurAtout = Carte::COULEURINVALIDE;
+        CardTables::Mode m_mode = CardTables::MODE_COULEUR;
+        std::array<std::uint8_t, NB_CARTES> m_points;
+};
+
+#endif
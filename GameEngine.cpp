@@ -0,0 +1,306 @@
+#include "GameEngine.h"
+#include "LegalMoves.h"
+#include "PimcBot.h"
+#include "server/ScoreCalculator.h"
+#include <algorithm>
+
+namespace {
+    constexpr int DIX_DE_DER = 10;
+    constexpr int BELOTE = 20;
+    constexpr int POINTS_BELOTE_MOITIE = 81;   // Mode Belote : le preneur doit faire plus
+    constexpr int ATOUTS_PRENEUR_MIN = 3;   // Comme GameServer : atouts supposés chez le preneur
+}
+
+GameEngine::GameEngine(const Config &config, std::uint32_t seed)
+    : m_config(config)
+    , m_rng(seed)
+{
+}
+
+void GameEngine::distribuer(std::array<CardSet, 4> &mains)
+{
+    std::array<CardId, NB_CARTES> cartes;
+    for (int id = 0; id < NB_CARTES; id++) {
+        cartes[id] = static_cast<CardId>(id);
+    }
+    std::shuffle(cartes.begin(), cartes.end(), m_rng);
+    for (int p = 0; p < 4; p++) {
+        mains[p] = CardSet();
+        for (int i = 0; i < 8; i++) {
+            mains[p].add(cartes[p * 8 + i]);
+        }
+    }
+}
+
+void GameEngine::encheres(int premierJoueur, const std::array<CardSet, 4> &mains, ResultatManche &resultat)
+{
+    Player::Annonce enchere = Player::ANNONCEINVALIDE;
+    std::array<Carte::Couleur, 4> couleurAnnoncee = {{ Carte::COULEURINVALIDE, Carte::COULEURINVALIDE,
+                                                       Carte::COULEURINVALIDE, Carte::COULEURINVALIDE }};
+    int passes = 0;
+    int joueur = premierJoueur;
+
+    // 4 passes sans annonce, ou 3 passes après une annonce
+    while (passes < (enchere == Player::ANNONCEINVALIDE ? 4 : 3) && enchere != Player::CAPOT) {
+        BidEvaluator::Options options;
+        options.samples = m_config.bidSamples;
+        options.risque = m_config.risque[joueur % 2];
+        options.entame = (premierJoueur - joueur + 4) % 4;
+        options.couleurPartenaire = couleurAnnoncee[(joueur + 2) % 4];
+        options.seed = m_rng();
+
+        // Les mains sont évaluées du point de vue du joueur (placé en 0)
+        auto estimations = BidEvaluator::evaluate(mains[joueur], options);
+        BidEvaluator::Decision decision = BidEvaluator::choisirAnnonce(estimations, enchere, options.risque);
+
+        if (decision.annonce == Player::PASSE) {
+            passes++;
+        } else {
+            passes = 0;
+            enchere = decision.annonce;
+            resultat.preneur = joueur;
+            resultat.annonce = decision.annonce;
+            resultat.option = decision.option;
+            couleurAnnoncee[joueur] = BidEvaluator::couleurAtout(decision.option);
+        }
+        joueur = (joueur + 1) % 4;
+    }
+}
+
+CardId GameEngine::jouerCarte(const Donne &donne, const PlayoutPolicy::Pli &pli, int joueur)
+{
+    const PlayoutPolicy::Contrat &contrat = donne.contrat;
+    CardSet main = donne.mains[joueur];
+    CardSet legaux = main;
+    if (pli.taille > 0) {
+        bool partenaireGagne = pli.joueurGagnant() % 2 == joueur % 2;
+        legaux = LegalMoves::legalMoves(main, pli.demandee, pli.cartes[pli.gagnant], partenaireGagne,
+                                        contrat.couleurAtout, contrat.mode);
+    }
+    if (legaux.size() == 1) {
+        return legaux.first();
+    }
+
+    BotType bot = m_config.bots[joueur];
+    if (bot == BOT_ALEATOIRE) {
+        int index = std::uniform_int_distribution<int>(0, legaux.size() - 1)(m_rng);
+        while (index-- > 0) legaux.popFirst();
+        return legaux.first();
+    }
+
+    if (bot == BOT_PIMC && main.size() <= m_config.pimcMaxHandSize) {
+        PimcBot::Contexte contexte;
+        contexte.joueur = joueur;
+        contexte.main = main;
+        for (int p = 0; p < 4; p++) {
+            contexte.nbCartes[p] = donne.mains[p].size();
+            contexte.exclues[p] = donne.exclues[p];
+        }
+        contexte.jouees = donne.tombees;
+        contexte.pli = pli.cartes;
+        contexte.pliSize = pli.taille;
+        contexte.leader = pli.taille > 0 ? pli.leader : joueur;
+        contexte.couleurAtout = contrat.couleurAtout;
+        contexte.mode = contrat.mode;
+        if (contrat.mode == CardTables::MODE_COULEUR && donne.preneur != joueur) {
+            int atoutsJoues = (donne.jouees[donne.preneur] & contrat.atouts).size();
+            contexte.atoutsMin[donne.preneur] = std::max(0, ATOUTS_PRENEUR_MIN - atoutsJoues);
+        }
+
+        PimcBot::Options options;
+        options.maxSamples = m_config.pimcSamples;
+        options.budgetMs = 1000;
+        options.seed = m_rng();
+        PimcBot::Resultat resultat = PimcBot::chooseCard(contexte, options);
+        if (resultat.carte != CARD_ID_INVALIDE && legaux.contains(resultat.carte)) {
+            return resultat.carte;
+        }
+    }
+
+    CardSet autres = (donne.mains[0] | donne.mains[1] | donne.mains[2] | donne.mains[3]) & ~main;
+    return PlayoutPolicy::chooseCard(main, autres, pli, joueur, joueur % 2 == donne.preneur % 2, contrat);
+}
+
+GameEngine::ResultatManche GameEngine::playManche(int premierJoueur)
+{
+    ResultatManche resultat;
+    Donne donne;
+    distribuer(donne.mains);
+
+    encheres(premierJoueur, donne.mains, resultat);
+    if (resultat.preneur < 0) {
+        return resultat;
+    }
+
+    donne.preneur = resultat.preneur;
+    donne.contrat = PlayoutPolicy::makeContrat(BidEvaluator::couleurAtout(resultat.option),
+                                               BidEvaluator::mode(resultat.option));
+    const PlayoutPolicy::Contrat &contrat = donne.contrat;
+
+    resultat.belote = belote(donne.mains, contrat);
+
+    int leader = premierJoueur;
+    for (int numeroPli = 0; numeroPli < 8; numeroPli++) {
+        PlayoutPolicy::Pli pli;
+        pli.leader = leader;
+
+        for (int i = 0; i < 4; i++) {
+            int joueur = (leader + i) % 4;
+            CardId carte = jouerCarte(donne, pli, joueur);
+
+            if (pli.taille > 0) {
+                bool partenaireGagne = pli.joueurGagnant() % 2 == joueur % 2;
+                donne.exclues[joueur] |= LegalMoves::cartesExclues(carte, pli.demandee, pli.cartes[pli.gagnant],
+                                                                   partenaireGagne, contrat.couleurAtout, contrat.mode);
+            }
+            donne.mains[joueur].remove(carte);
+            donne.jouees[joueur].add(carte);
+            pli.poser(carte, contrat);
+        }
+
+        for (int i = 0; i < 4; i++) {
+            donne.tombees.add(pli.cartes[i]);
+        }
+        ResultatPli fin = resoudrePli(pli.cartes, pli.leader, contrat, numeroPli == 7);
+        leader = fin.gagnant;
+        resultat.points[leader % 2] += fin.points;
+        resultat.plis[leader % 2]++;
+        resultat.plisJoueur[leader]++;
+    }
+
+    Prise prise;
+    prise.preneur = resultat.preneur;
+    prise.annonce = resultat.annonce;
+    Resolution resolution = resoudreManche(prise, resultat.points, resultat.plisJoueur, resultat.belote);
+    resultat.score = resolution.score;
+    resultat.contratReussi = resolution.contratReussi;
+    return resultat;
+}
+
+GameEngine::ResultatPli GameEngine::resoudrePli(const std::array<CardId, 4> &cartes, int leader,
+                                                const PlayoutPolicy::Contrat &contrat, bool dernierPli)
+{
+    PlayoutPolicy::Pli pli;
+    pli.leader = leader;
+    for (CardId carte : cartes) {
+        pli.poser(carte, contrat);
+    }
+
+    ResultatPli resultat;
+    resultat.gagnant = pli.joueurGagnant();
+    resultat.points = pli.points + (dernierPli ? DIX_DE_DER : 0);
+    return resultat;
+}
+
+std::array<int, 2> GameEngine::belote(const std::array<CardSet, 4> &mains, const PlayoutPolicy::Contrat &contrat)
+{
+    std::array<int, 2> points = {{ 0, 0 }};
+    if (contrat.mode != CardTables::MODE_COULEUR) {
+        return points;
+    }
+    CardSet roiDame = CardSet::single(makeCardId(contrat.couleurAtout, Carte::ROI))
+                    | CardSet::single(makeCardId(contrat.couleurAtout, Carte::DAME));
+    for (int p = 0; p < 4; p++) {
+        if ((mains[p] & roiDame) == roiDame) points[p % 2] = BELOTE;
+    }
+    return points;
+}
+
+GameEngine::Resolution GameEngine::resoudreManche(const Prise &prise, const std::array<int, 2> &points,
+                                                  const std::array<int, 4> &plisJoueur, const std::array<int, 2> &belote)
+{
+    Resolution resolution;
+    int equipe = prise.preneur % 2;
+    int defense = 1 - equipe;
+    std::array<int, 2> plis = {{ plisJoueur[0] + plisJoueur[2], plisJoueur[1] + plisJoueur[3] }};
+    resolution.capot = {{ plis[0] == 8, plis[1] == 8 }};
+    resolution.valeurContrat = Player::getContractValue(prise.annonce);
+
+    if (prise.modeBelote) {
+        // Capot du preneur, contre-capot de la défense, sinon plus de la moitié des points
+        resolution.capotNonAnnonce = resolution.capot;
+        resolution.capotReussi = resolution.capot[0] || resolution.capot[1];
+        resolution.equipeCapot = resolution.capot[0] ? 0 : resolution.capot[1] ? 1 : -1;
+        resolution.contratReussi = resolution.capot[equipe]
+            || (!resolution.capot[defense] && points[equipe] + belote[equipe] > POINTS_BELOTE_MOITIE);
+        ScoreCalculator::ScoreResult score = ScoreCalculator::calculateBeloteMancheScore(
+            points[0], points[1], equipe == 0, resolution.capot[0], resolution.capot[1], belote[0], belote[1]);
+        resolution.score = {{ score.scoreTeam1, score.scoreTeam2 }};
+        return resolution;
+    }
+
+    resolution.capotAnnonce = prise.annonce == Player::CAPOT;
+    resolution.generaleAnnonce = prise.annonce == Player::GENERALE;
+    bool annonceSpeciale = resolution.capotAnnonce || resolution.generaleAnnonce;
+    resolution.capotNonAnnonce = {{ !annonceSpeciale && resolution.capot[0], !annonceSpeciale && resolution.capot[1] }};
+
+    if (resolution.capotAnnonce) {
+        // L'équipe du preneur doit faire les 8 plis
+        resolution.capotReussi = resolution.capot[equipe];
+        resolution.contratReussi = resolution.capotReussi;
+    } else if (resolution.generaleAnnonce) {
+        // Le preneur doit faire les 8 plis seul
+        resolution.generaleReussie = plisJoueur[prise.preneur] == 8;
+        resolution.contratReussi = resolution.generaleReussie;
+    } else {
+        resolution.capotReussi = resolution.capotNonAnnonce[0] || resolution.capotNonAnnonce[1];
+        resolution.contratReussi = points[equipe] + belote[equipe] >= resolution.valeurContrat;
+    }
+
+    if (resolution.capotNonAnnonce[0] || resolution.capotNonAnnonce[1]) {
+        resolution.equipeCapot = resolution.capotNonAnnonce[0] ? 0 : 1;
+    } else if (resolution.capotAnnonce && resolution.capotReussi) {
+        resolution.equipeCapot = equipe;
+    }
+
+    ScoreCalculator::ScoreResult score = ScoreCalculator::calculateMancheScore(
+        points[0], points[1], resolution.valeurContrat, equipe == 0,
+        prise.coinche, prise.surcoinche, resolution.capotAnnonce, resolution.capotReussi,
+        resolution.generaleAnnonce, resolution.generaleReussie,
+        resolution.capotNonAnnonce[0], resolution.capotNonAnnonce[1], belote[0], belote[1]);
+    resolution.score = {{ score.scoreTeam1, score.scoreTeam2 }};
+    return resolution;
+}
+
+int GameEngine::vainqueur(const std::array<int, 2> &score, int scoreVictoire)
+{
+    bool victoire0 = score[0] >= scoreVictoire;
+    bool victoire1 = score[1] >= scoreVictoire;
+    if (victoire0 && victoire1) {
+        return score[0] > score[1] ? 0 : 1;
+    }
+    if (victoire0 || victoire1) {
+        return victoire0 ? 0 : 1;
+    }
+    return -1;
+}
+
+GameEngine::ResultatPartie GameEngine::playGame()
+{
+    ResultatPartie partie;
+    int premierJoueur = 0;
+
+    while (partie.manches < m_config.maxManches) {
+        ResultatManche manche = playManche(premierJoueur);
+        partie.score[0] += manche.score[0];
+        partie.score[1] += manche.score[1];
+        partie.manches++;
+        premierJoueur = (premierJoueur + 1) % 4;
+
+        if (manche.preneur < 0) {
+            partie.manchesPassees++;
+        } else {
+            int equipe = manche.preneur % 2;
+            partie.contrats[equipe]++;
+            partie.contratsReussis[equipe] += manche.contratReussi ? 1 : 0;
+            partie.capots[equipe] += manche.plis[equipe] == 8 ? 1 : 0;
+            partie.annonces[manche.annonce]++;
+        }
+
+        partie.vainqueur = vainqueur(partie.score, m_config.scoreVictoire);
+        if (partie.vainqueur >= 0) {
+            break;
+        }
+    }
+    return partie;
+}
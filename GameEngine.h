@@ -0,0 +1,136 @@
+#ifndef GAMEENGINE_H
+#define GAMEENGINE_H
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include "Carte.h"
+#include "CardSet.h"
+#include "CardTables.h"
+#include "Player.h"
+#include "BidEvaluator.h"
+#include "PlayoutPolicy.h"
+
+// Moteur de partie sans réseau ni timers (Coinche, 4 bots)
+// Enchaîne distribution, enchères, jeu de la carte et calcul du score.
+// Utilisé par coinche_selfplay pour comparer des bots et mesurer le débit
+// du cœur de règles.
+//
+// Les règles d'un pli et de fin de manche (resoudrePli, belote, resoudreManche,
+// vainqueur) sont aussi celles du serveur : GameServer les appelle et n'ajoute
+// que timers, sockets et statistiques. Elles couvrent coinche, surcoinche et le
+// mode Belote ; playManche n'en simule pas les enchères (les bots ne coinchent pas).
+class GameEngine
+{
+    public:
+        enum BotType {
+            BOT_ALEATOIRE = 0,   // Carte légale au hasard
+            BOT_HEURISTIQUE,     // PlayoutPolicy
+            BOT_PIMC             // PimcBot en fin de manche, PlayoutPolicy avant
+        };
+
+        struct Config {
+            std::array<BotType, 4> bots = {{ BOT_HEURISTIQUE, BOT_HEURISTIQUE, BOT_HEURISTIQUE, BOT_HEURISTIQUE }};
+            std::array<double, 2> risque = {{ 0.25, 0.25 }};  // Prise de risque aux enchères par équipe
+            int bidSamples = 64;         // Donnes simulées par BidEvaluator
+            int pimcSamples = 16;        // Donnes échantillonnées par coup PIMC
+            int pimcMaxHandSize = 7;     // Comme le serveur : PIMC à partir du 2e pli
+            int scoreVictoire = 1000;
+            int maxManches = 200;        // Garde-fou pour playGame
+        };
+
+        // Contrat à résoudre en fin de manche
+        struct Prise {
+            int preneur = -1;
+            Player::Annonce annonce = Player::PASSE;
+            bool coinche = false;
+            bool surcoinche = false;
+            bool modeBelote = false;   // Règles de la Belote : le preneur doit dépasser 81 points
+        };
+
+        struct ResultatPli {
+            int gagnant = -1;          // Joueur maître du pli
+            int points = 0;            // Dix de der compris pour le dernier pli
+        };
+
+        struct Resolution {
+            std::array<int, 2> score = {{ 0, 0 }};   // Points marqués par équipe (ScoreCalculator)
+            int valeurContrat = 0;
+            bool contratReussi = false;
+            bool capotAnnonce = false;
+            bool capotReussi = false;                // Capot annoncé réussi, ou capot non annoncé
+            bool generaleAnnonce = false;
+            bool generaleReussie = false;
+            std::array<bool, 2> capot = {{ false, false }};            // Les 8 plis pour l'équipe
+            std::array<bool, 2> capotNonAnnonce = {{ false, false }};
+            int equipeCapot = -1;                    // Capot à annoncer aux joueurs (-1 : aucun)
+        };
+
+        struct ResultatManche {
+            int preneur = -1;                         // -1 : tout le monde a passé
+            Player::Annonce annonce = Player::PASSE;
+            BidEvaluator::Option option = BidEvaluator::OPTION_COEUR;
+            std::array<int, 2> points = {{ 0, 0 }};   // Points de plis, dix de der compris
+            std::array<int, 2> plis = {{ 0, 0 }};
+            std::array<int, 4> plisJoueur = {{ 0, 0, 0, 0 }};
+            std::array<int, 2> belote = {{ 0, 0 }};
+            std::array<int, 2> score = {{ 0, 0 }};    // Points marqués (ScoreCalculator)
+            bool contratReussi = false;
+        };
+
+        struct ResultatPartie {
+            std::array<int, 2> score = {{ 0, 0 }};
+            int manches = 0;
+            int vainqueur = -1;                       // Équipe 0 (joueurs 0-2) ou 1 (joueurs 1-3)
+
+            // Cumul des manches
+            int manchesPassees = 0;
+            std::array<int, 2> contrats = {{ 0, 0 }};
+            std::array<int, 2> contratsReussis = {{ 0, 0 }};
+            std::array<int, 2> capots = {{ 0, 0 }};
+            std::array<int, Player::PASSE + 1> annonces = {};  // Nombre de contrats par annonce
+        };
+
+        GameEngine(const Config &config, std::uint32_t seed);
+
+        // Joue une manche complète, premierJoueur ouvre les enchères et entame
+        ResultatManche playManche(int premierJoueur);
+
+        // Joue une partie jusqu'au score de victoire
+        ResultatPartie playGame();
+
+        // Pli complet : cartes dans l'ordre où elles ont été jouées, à partir de leader
+        static ResultatPli resoudrePli(const std::array<CardId, 4> &cartes, int leader,
+                                       const PlayoutPolicy::Contrat &contrat, bool dernierPli);
+
+        // Points de belote (20) par équipe : Roi et Dame d'atout dans une même main
+        static std::array<int, 2> belote(const std::array<CardSet, 4> &mains, const PlayoutPolicy::Contrat &contrat);
+
+        // Score de la manche et réussite du contrat (capot, générale, coinche, mode Belote)
+        //   points : points de plis par équipe, dix de der compris, belote non comprise
+        static Resolution resoudreManche(const Prise &prise, const std::array<int, 2> &points,
+                                         const std::array<int, 4> &plisJoueur, const std::array<int, 2> &belote);
+
+        // Équipe gagnante (0 ou 1), -1 tant qu'aucune n'a atteint scoreVictoire.
+        // Si les deux l'atteignent, la plus haute gagne
+        static int vainqueur(const std::array<int, 2> &score, int scoreVictoire);
+
+    private:
+        struct Donne {
+            std::array<CardSet, 4> mains;
+            std::array<CardSet, 4> exclues;   // Déductions des coupes/défausses (pour PIMC)
+            std::array<CardSet, 4> jouees;    // Cartes jouées par chaque joueur
+            CardSet tombees;                  // Cartes des plis terminés
+            int preneur = -1;
+            PlayoutPolicy::Contrat contrat;
+        };
+
+        void distribuer(std::array<CardSet, 4> &mains);
+        void encheres(int premierJoueur, const std::array<CardSet, 4> &mains, ResultatManche &resultat);
+        CardId jouerCarte(const Donne &donne, const PlayoutPolicy::Pli &pli, int joueur);
+
+        Config m_config;
+        std::mt19937 m_rng;
+};
+
+#endif
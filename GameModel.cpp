@@ -1375,6 +1375,7 @@ void GameModel::receivePlayerAction(int playerIndex, const QString& action, cons
             // Réinitialiser le gagnant après l'animation
             m_pliWinnerId = -1;
             emit pliWinnerIdChanged();
+            emit pliCleared();
         });
     } else if (action == "mancheFinished") {
         QJsonObject scoreData = data.toJsonObject();
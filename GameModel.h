@@ -211,6 +211,7 @@ signals:
     void cardPlayedLocally(int cardIndex, int cardValue, int cardSuit);
     void bidMadeLocally(int bidValue, int suitValue);
     void forfeitLocally();
+    void pliCleared();  // Fin de l'animation de ramassage du pli
 
 private:
     HandModel* getHandModelByPosition(int position);
@@ -57,7 +57,7 @@ void HandModel::refresh() {
 void HandModel::sortAndAnimate(std::function<void()> sortFunction) {
     if (!m_player) return;
 
-    // 1. Snapshot de l'ancien ordre (getMain() retourne par valeur = copie)
+    // 1. Snapshot de l'ancien ordre (copie explicite : getMain() retourne une référence)
     std::vector<Carte*> oldOrder = m_player->getMain();
 
     // 2. Tri en place dans Player
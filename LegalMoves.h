@@ -0,0 +1,118 @@
+#ifndef LEGALMOVES_H
+#define LEGALMOVES_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Carte.h"
+#include "CardSet.h"
+#include "CardTables.h"
+
+// Génération des coups légaux par masques de bits
+// Remplace la boucle carte par carte de Player::isCartePlayable : quelques
+// ET/OU sur des masques de couleur et des masques "plus forte que"
+namespace LegalMoves {
+
+    // Cartes de la même couleur strictement plus fortes que la carte donnée
+    inline CardSet plusFortesQue(CardId id, CardTables::Mode mode, bool isAtout)
+    {
+        std::uint32_t masque = CardTables::plusFortes(mode, isAtout, chiffreOf(id));
+        return CardSet(masque << (suitIndex(couleurOf(id)) * 8));
+    }
+
+    // Cartes jouables d'une main
+    //   couleurDemandee : couleur de la première carte (COULEURINVALIDE si on entame)
+    //   carteGagnante   : carte maîtresse du pli (CARD_ID_INVALIDE si pli vide)
+    //   partenaireGagne : le partenaire tient le pli (défausse libre)
+    //   couleurAtout    : COULEURINVALIDE en TA/SA
+    inline CardSet legalMoves(CardSet main, Carte::Couleur couleurDemandee,
+                              CardId carteGagnante, bool partenaireGagne,
+                              Carte::Couleur couleurAtout, CardTables::Mode mode)
+    {
+        // Entame : tout est jouable
+        if (couleurDemandee == Carte::COULEURINVALIDE) {
+            return main;
+        }
+
+        bool gagnanteAtout = carteGagnante != CARD_ID_INVALIDE
+                          && (mode == CardTables::MODE_TOUT_ATOUT || couleurOf(carteGagnante) == couleurAtout);
+
+        // Fournir à la couleur demandée, en montant si c'est de l'atout
+        CardSet couleur = main.ofSuit(couleurDemandee);
+        if (!couleur.empty()) {
+            bool atoutDemande = mode == CardTables::MODE_TOUT_ATOUT || couleurDemandee == couleurAtout;
+            if (atoutDemande && gagnanteAtout) {
+                CardSet plusFortes = couleur & plusFortesQue(carteGagnante, mode, true);
+                if (!plusFortes.empty()) {
+                    return plusFortes;
+                }
+            }
+            return couleur;
+        }
+
+        // Plus de couleur demandée : défausse libre si le partenaire est maître
+        // (et toujours en TA, où couper n'existe pas)
+        if (partenaireGagne || mode == CardTables::MODE_TOUT_ATOUT) {
+            return main;
+        }
+
+        // Sinon couper, en surcoupant si possible
+        CardSet atouts = main.ofSuit(couleurAtout);
+        if (atouts.empty()) {
+            return main;
+        }
+        if (gagnanteAtout) {
+            CardSet plusFortes = atouts & plusFortesQue(carteGagnante, mode, true);
+            if (!plusFortes.empty()) {
+                return plusFortes;
+            }
+        }
+        return atouts;
+    }
+
+    // Cartes qu'un joueur ne peut pas avoir en main, déduites de la carte qu'il vient de jouer :
+    // toute carte qui, détenue, aurait rendu ce coup illégal (couleur non fournie, pas coupé,
+    // pas monté...). Les paramètres décrivent le pli avant que la carte soit posée.
+    inline CardSet cartesExclues(CardId carteJouee, Carte::Couleur couleurDemandee,
+                                 CardId carteGagnante, bool partenaireGagne,
+                                 Carte::Couleur couleurAtout, CardTables::Mode mode)
+    {
+        CardSet exclues;
+        if (couleurDemandee == Carte::COULEURINVALIDE) {
+            return exclues;
+        }
+        for (int id = 0; id < NB_CARTES; id++) {
+            if (id == carteJouee) continue;
+            CardSet main = CardSet::single(carteJouee) | CardSet::single(static_cast<CardId>(id));
+            CardSet legaux = legalMoves(main, couleurDemandee, carteGagnante, partenaireGagne, couleurAtout, mode);
+            if (!legaux.contains(carteJouee)) {
+                exclues.add(static_cast<CardId>(id));
+            }
+        }
+        return exclues;
+    }
+
+    // Variante à partir du pli en cours (pair<playerIndex, carte>), telle que stockée par le serveur
+    inline CardSet legalMoves(CardSet main, const std::vector<std::pair<int, Carte*>> &pli,
+                              int playerIndex, Carte::Couleur couleurAtout, CardTables::Mode mode)
+    {
+        if (pli.empty()) {
+            return main;
+        }
+
+        // Carte maîtresse du pli
+        Carte* carteGagnante = pli[0].second;
+        int idxPlayerWinning = pli[0].first;
+        for (std::size_t i = 1; i < pli.size(); i++) {
+            if (*carteGagnante < *pli[i].second) {
+                carteGagnante = pli[i].second;
+                idxPlayerWinning = pli[i].first;
+            }
+        }
+
+        return legalMoves(main, pli[0].second->getCouleur(), makeCardId(*carteGagnante),
+                          (idxPlayerWinning + 2) % 4 == playerIndex, couleurAtout, mode);
+    }
+}
+
+#endif
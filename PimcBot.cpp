@@ -0,0 +1,133 @@
+#include "PimcBot.h"
+#include "DoubleDummySolver.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // Tentatives de distribution avant abandon (la moitié en respectant l'enchère)
+    constexpr int MAX_TENTATIVES = 64;
+}
+
+bool PimcBot::sampleDeal(const Contexte &contexte, std::mt19937 &rng, std::array<CardSet, 4> &mains)
+{
+    // Cartes cachées : ni dans ma main, ni tombées, ni dans le pli en cours
+    CardSet inconnues = ~(contexte.main | contexte.jouees);
+    for (int i = 0; i < contexte.pliSize; i++) {
+        inconnues.remove(contexte.pli[i]);
+    }
+
+    std::array<CardId, NB_CARTES> cartes;
+    int nbInconnues = 0;
+    while (!inconnues.empty()) {
+        cartes[nbInconnues++] = inconnues.popFirst();
+    }
+
+    // Nombre de joueurs pouvant recevoir chaque carte
+    auto nbAutorises = [&contexte](CardId id) {
+        int n = 0;
+        for (int p = 0; p < 4; p++) {
+            if (p != contexte.joueur && contexte.nbCartes[p] > 0 && !contexte.exclues[p].contains(id)) n++;
+        }
+        return n;
+    };
+
+    for (int tentative = 0; tentative < MAX_TENTATIVES; tentative++) {
+        bool avecEnchere = tentative < MAX_TENTATIVES / 2;
+
+        std::array<int, 4> places;
+        for (int p = 0; p < 4; p++) {
+            places[p] = (p == contexte.joueur) ? 0 : contexte.nbCartes[p];
+            mains[p] = CardSet();
+        }
+        mains[contexte.joueur] = contexte.main;
+
+        // Les cartes les plus contraintes d'abord, ordre aléatoire à contrainte égale
+        std::shuffle(cartes.begin(), cartes.begin() + nbInconnues, rng);
+        std::stable_sort(cartes.begin(), cartes.begin() + nbInconnues, [&nbAutorises](CardId a, CardId b) {
+            return nbAutorises(a) < nbAutorises(b);
+        });
+
+        bool ok = true;
+        for (int i = 0; i < nbInconnues && ok; i++) {
+            CardId id = cartes[i];
+
+            // Tirage pondéré par les places restantes (donne uniforme sans contrainte)
+            int total = 0;
+            for (int p = 0; p < 4; p++) {
+                if (places[p] > 0 && !contexte.exclues[p].contains(id)) total += places[p];
+            }
+            if (total == 0) {
+                ok = false;
+                break;
+            }
+            int tirage = std::uniform_int_distribution<int>(0, total - 1)(rng);
+            for (int p = 0; p < 4; p++) {
+                if (places[p] <= 0 || contexte.exclues[p].contains(id)) continue;
+                if (tirage < places[p]) {
+                    mains[p].add(id);
+                    places[p]--;
+                    break;
+                }
+                tirage -= places[p];
+            }
+        }
+        if (!ok) continue;
+
+        if (avecEnchere) {
+            CardSet atouts = CardSet::suit(contexte.couleurAtout);
+            bool coherent = true;
+            for (int p = 0; p < 4; p++) {
+                if (p != contexte.joueur && (mains[p] & atouts).size() < contexte.atoutsMin[p]) {
+                    coherent = false;
+                }
+            }
+            if (!coherent) continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+PimcBot::Resultat PimcBot::chooseCard(const Contexte &contexte, const Options &options)
+{
+    // Un solveur par thread : sa table de transposition est réutilisée d'un coup à l'autre
+    thread_local DoubleDummySolver solver;
+
+    Resultat resultat;
+    std::mt19937 rng(options.seed);
+    // Le budget vaut aussi à l'intérieur d'un échantillon : le solveur s'arrête à l'échéance
+    solver.setDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(options.budgetMs));
+
+    std::array<long, NB_CARTES> sommes{};
+    std::array<int, NB_CARTES> vus{};
+
+    for (int s = 0; s < options.maxSamples && !solver.aborted(); s++) {
+        DoubleDummySolver::Position position;
+        if (!sampleDeal(contexte, rng, position.mains)) continue;
+        position.pli = contexte.pli;
+        position.pliSize = contexte.pliSize;
+        position.leader = contexte.leader;
+        position.couleurAtout = contexte.couleurAtout;
+        position.mode = contexte.mode;
+
+        std::vector<std::pair<CardId, int>> coups = solver.evaluateMoves(position);
+        // Échantillon inachevé (échéance) : ses coups ne sont pas tous évalués, on l'écarte
+        if (solver.aborted()) break;
+        for (const auto &coup : coups) {
+            sommes[coup.first] += coup.second;
+            vus[coup.first]++;
+        }
+        resultat.samples++;
+    }
+    solver.clearDeadline();
+
+    for (int id = 0; id < NB_CARTES; id++) {
+        if (vus[id] == 0) continue;
+        double moyenne = static_cast<double>(sommes[id]) / vus[id];
+        if (resultat.carte == CARD_ID_INVALIDE || moyenne > resultat.esperance) {
+            resultat.carte = static_cast<CardId>(id);
+            resultat.esperance = moyenne;
+        }
+    }
+    return resultat;
+}
@@ -0,0 +1,54 @@
+#ifndef PIMCBOT_H
+#define PIMCBOT_H
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include "Carte.h"
+#include "CardSet.h"
+#include "CardTables.h"
+
+// Bot par échantillonnage (Perfect Information Monte Carlo)
+// Tire des distributions plausibles des cartes cachées (cohérentes avec les
+// cartes tombées, les coupes/défausses observées et l'enchère du preneur),
+// résout chacune avec le DoubleDummySolver et joue la carte de meilleure
+// espérance. Sans dépendance Qt : le serveur l'exécute sur un pool de threads.
+class PimcBot
+{
+    public:
+        // Ce que le bot sait de la donne au moment de jouer
+        struct Contexte {
+            int joueur = 0;                       // Position du bot
+            CardSet main;                         // Main du bot
+            std::array<int, 4> nbCartes = {{ 0, 0, 0, 0 }};  // Cartes restant en main par joueur
+            std::array<CardSet, 4> exclues;       // Cartes qu'un joueur ne peut pas avoir
+            std::array<int, 4> atoutsMin = {{ 0, 0, 0, 0 }}; // Atouts cachés attendus (enchère)
+            CardSet jouees;                       // Cartes des plis terminés
+            std::array<CardId, 4> pli = {{ CARD_ID_INVALIDE, CARD_ID_INVALIDE, CARD_ID_INVALIDE, CARD_ID_INVALIDE }};
+            int pliSize = 0;
+            int leader = 0;
+            Carte::Couleur couleurAtout = Carte::COULEURINVALIDE;
+            CardTables::Mode mode = CardTables::MODE_COULEUR;
+        };
+
+        struct Options {
+            int maxSamples = 48;        // Nombre maximum de donnes échantillonnées
+            int budgetMs = 250;         // Temps maximum par coup (aucune carte si aucun échantillon n'est fini)
+            std::uint32_t seed = 0;
+        };
+
+        struct Resultat {
+            CardId carte = CARD_ID_INVALIDE;  // CARD_ID_INVALIDE si aucun échantillon valide ou fini à temps
+            int samples = 0;
+            double esperance = 0.0;           // Points moyens pour l'équipe du bot
+        };
+
+        // Choisit la carte à jouer (appelable depuis n'importe quel thread)
+        static Resultat chooseCard(const Contexte &contexte, const Options &options);
+
+        // Complète les mains des 3 autres joueurs de façon aléatoire et cohérente
+        // Retourne false si aucune distribution compatible n'a été trouvée
+        static bool sampleDeal(const Contexte &contexte, std::mt19937 &rng, std::array<CardSet, 4> &mains);
+};
+
+#endif
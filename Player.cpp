@@ -1,14 +1,21 @@
 #include "Player.h"
+#include "LegalMoves.h"
 #include "Carte.h"
 #include <iostream>
 #include <algorithm>
+#include <utility>
 
 Player::Player(std::string name, std::vector<Carte *> main, int index)
     : m_name(name)
-    , m_main(main)
+    , m_main(std::move(main))
     , m_index(index)
     , m_annonce(ANNONCEINVALIDE) 
 {
+    for (const Carte* carte : m_main) {
+        if (carte) {
+            m_mainSet.add(makeCardId(*carte));
+        }
+    }
 }
 
 Player::~Player()
@@ -94,6 +101,9 @@ void Player::printAnnonce() const
 void Player::addCardToHand(Carte* carte)
 {
     m_main.push_back(carte);
+    if (carte) {
+        m_mainSet.add(makeCardId(*carte));
+    }
 }
 
 void Player::printMain() const
@@ -109,7 +119,7 @@ std::string Player::getName() const
     return m_name;
 }
 
-std::vector<Carte*> Player::getMain() const
+const std::vector<Carte*>& Player::getMain() const
 {
     return m_main;
 }
@@ -166,83 +176,19 @@ bool Player::isCartePlayable(int carteIdx, const Carte::Couleur &couleurDemandee
                      const Carte::Couleur &couleurAtout, Carte* carteAtout,
                      int idxPlayerWinning, bool isToutAtout) const {
 
-    // std::cout << "Verification si la carte est jouable pour le jouer: " << m_name << " et carteIdx = " << carteIdx << std::endl;
-    // std::cout << "******************************************************* " << std::endl;
-    // std::cout << "*****************************idxPlayerWinning: " << idxPlayerWinning << " m_index: " << m_index << std::endl;
-    // std::cout << "Mode Tout Atout: " << (isToutAtout ? "OUI" : "NON") << std::endl;
-
     if (carteIdx < 0 || carteIdx >= m_main.size()) {
         return false;
-        std::cout << "Index de carte invalide." << std::endl;
     }
 
-    const Carte* carte = m_main[carteIdx];
-    //carte->printCarte();
+    // Les règles (fournir, monter, couper, surcouper, défausse si partenaire maître)
+    // sont évaluées sur le masque de la main, voir LegalMoves.h
+    CardTables::Mode mode = isToutAtout ? CardTables::MODE_TOUT_ATOUT : CardTables::MODE_COULEUR;
+    CardId carteGagnante = carteAtout ? makeCardId(*carteAtout) : CARD_ID_INVALIDE;
+    bool partenaireGagne = (idxPlayerWinning + 2) % 4 == m_index;
 
-    //std::cout << "Couleur demandee: " << couleurDemandee << ", Couleur atout: " << couleurAtout << std::endl;
-    
-    // Premier joueur peut jouer n'importe quoi
-    if (couleurDemandee == Carte::COULEURINVALIDE) {
-        //std::cout << "Premier joueur, carte jouable." << std::endl;
-        return true;
-    }
-    
-    // Si la carte est de la couleur demandée
-    if (carte->getCouleur() == couleurDemandee) {
-        //std::cout << "Carte de la couleur demandee, carte jouable. Carte couleur : " << carte->getCouleur() << " carte chiffre : " << carte->getChiffre() << std::endl;
-
-        // En mode TA ou si la couleur demandée est l'atout, vérifier si on peut monter
-        if(isToutAtout || carte->getCouleur() == couleurAtout) {
-            //std::cout << "C'est aussi un atout." << std::endl;
-            if(carteAtout != nullptr) {
-                if(*carteAtout < *carte) {
-                    //std::cout << "Atout joue precedemment, mais on peut monter, carte jouable." << std::endl;
-                } else {
-                    if(hasHigher(carteAtout)) {
-                        //std::cout << "Vous avez un atout plus fort que l'atout joue precedemment, " << std::endl;
-                        //std::cout << "veuillez selectionner un atout plus fort..." << std::endl;
-                        return false;
-                    } else {
-                        //std::cout << "Atout joue precedemment, on ne peut pas monter, carte jouable." << std::endl;
-                    }
-                }
-            }
-        }
-        return true;
-    }
-
-    if(m_main[carteIdx]->getCouleur() != couleurDemandee && hasCouleur(couleurDemandee)) {
-        //std::cout << "Vous avez la couleur demandee, veuillez selectionner une carte de cette couleur..." << std::endl;
-        return false;
-    }
-    else if(m_main[carteIdx]->getCouleur() != couleurDemandee && !hasCouleur(couleurDemandee) &&
-            (idxPlayerWinning + 2)%4 == m_index) {
-        // Si pas la couleur demandée mais que son partenaire tient le pli, alors le joueur peut se defausser
-        return true;
-    }
-    // En mode Tout Atout, pas de contrainte d'atout spécifique (toutes les cartes sont atouts)
-    else if(!isToutAtout &&
-            m_main[carteIdx]->getCouleur() != couleurDemandee && !hasCouleur(couleurDemandee) &&
-            m_main[carteIdx]->getCouleur() != couleurAtout && hasCouleur(couleurAtout) ) {
-        //std::cout << "Vous avez de l'atout, veuillez selectionner une carte de cette couleur..." << std::endl;
-        return false;
-    } else if ((m_main[carteIdx]->getCouleur() != couleurDemandee && !hasCouleur(couleurDemandee) &&
-                m_main[carteIdx]->getCouleur() == couleurAtout && carteAtout != nullptr)
-                || couleurDemandee == couleurAtout) {
-        if(*carteAtout < *m_main[carteIdx]) {
-            return true;
-        } else {
-            if(hasHigher(carteAtout)) {
-                //std::cout << "Vous avez un atout plus fort que l'atout joue precedemment, " << std::endl;
-                //std::cout << "veuillez selectionner un atout plus fort..." << std::endl;
-                return false;
-            } else {
-                return true;
-            }
-        }
-    } else {
-        return true;
-    }
+    CardSet jouables = LegalMoves::legalMoves(m_mainSet, couleurDemandee, carteGagnante,
+                                              partenaireGagne, couleurAtout, mode);
+    return jouables.contains(makeCardId(*m_main[carteIdx]));
 }
 
 void Player::setAtout(const Carte::Couleur &couleurAtout)
@@ -301,13 +247,28 @@ bool Player::getHasBelotte() const
 void Player::removeCard(int cardIndex)
 {
     if (cardIndex >= 0 && cardIndex < m_main.size()) {
+        CardId id = makeCardId(*m_main[cardIndex]);
         m_main.erase(m_main.begin() + cardIndex);
+
+        // Côté client, les mains adverses contiennent des cartes fantômes identiques :
+        // ne retirer le bit que si plus aucune carte de la main ne porte cet identifiant
+        bool stillInHand = false;
+        for (const Carte* carte : m_main) {
+            if (makeCardId(*carte) == id) {
+                stillInHand = true;
+                break;
+            }
+        }
+        if (!stillInHand) {
+            m_mainSet.remove(id);
+        }
     }
 }
 
 void Player::clearHand()
 {
     m_main.clear();
+    m_mainSet.clear();
     m_hasBelotte = false;
 }
 
@@ -366,29 +327,3 @@ void Player::sortHandSansAtout(bool reversed)
                         : a->getOrdreCarteForte() < b->getOrdreCarteForte();
     });
 }
-
-bool Player::hasCouleur(const Carte::Couleur &couleur) const
-{
-    bool haveCouleur = false;
-    for(auto &carte : m_main) {
-        if(carte->getCouleur() == couleur) {
-            haveCouleur = true;
-            break;
-        }
-    }
-    return haveCouleur;
-}
-
-bool Player::hasHigher(Carte *carte) const
-{
-    bool haveHigher = false;
-    for(auto &elt : m_main) {
-        //elt->printCarte();
-        //carte->printCarte();
-        if(*carte < *elt) {
-            haveHigher = true;
-            break;
-        }
-    }
-    return haveHigher;
-}
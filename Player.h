@@ -2,6 +2,7 @@
 #define PLAYER_H
 
 #include "Carte.h"
+#include "CardSet.h"
 #include <string>
 #include <vector>
 #include <array>
@@ -31,7 +32,7 @@ class Player
 
         ~Player();
 
-        // Return a vector of player's cards
+        // Return a copy of player's cards (snapshot, à éviter dans les boucles : préférer getMain())
         std::vector<Carte> getCartes() const;
 
         void removeCard(int cardIndex);
@@ -78,7 +79,12 @@ class Player
         void printMain() const;
 
         std::string getName() const;
-        std::vector<Carte*> getMain() const;
+        // Vue en lecture seule sur la main, sans copie
+        // Attention : invalidée par removeCard/addCardToHand/clearHand et réordonnée par les tris
+        const std::vector<Carte*>& getMain() const;
+
+        // Main sous forme de masque (1 bit par carte), tenu à jour avec m_main
+        CardSet getMainSet() const { return m_mainSet; }
 
         static int convertAnnonceEnPoint(const Annonce &annonce);
 
@@ -88,12 +94,11 @@ class Player
     private:
         std::string m_name;
         std::vector<Carte*> m_main;
+        CardSet m_mainSet;
         int m_index;
         Annonce m_annonce;
         Carte::Couleur m_couleur;
 
-        bool hasCouleur(const Carte::Couleur &couleur) const;
-        bool hasHigher(Carte *carte) const;
         std::vector<std::array<Carte*, 4> > m_plis;
         bool m_hasBelotte = false;
 };
@@ -0,0 +1,130 @@
+#include "PlayoutPolicy.h"
+#include "LegalMoves.h"
+
+namespace {
+    constexpr int FORCE_ATOUT = 32;  // Décalage : tout atout bat toute carte non atout
+
+    // Force d'une carte dans le pli (-1 si défausse). En Tout Atout chaque couleur
+    // est atout mais on ne coupe pas : seule la couleur demandée peut prendre le pli
+    int forceDansPli(CardId id, Carte::Couleur demandee, const PlayoutPolicy::Contrat &contrat)
+    {
+        if (couleurOf(id) == demandee) return contrat.force[id];
+        bool coupe = contrat.mode == CardTables::MODE_COULEUR && contrat.atouts.contains(id);
+        return coupe ? contrat.force[id] : -1;
+    }
+}
+
+PlayoutPolicy::Contrat PlayoutPolicy::makeContrat(Carte::Couleur couleurAtout, CardTables::Mode mode)
+{
+    Contrat contrat;
+    contrat.couleurAtout = couleurAtout;
+    contrat.mode = mode;
+    contrat.atouts = mode == CardTables::MODE_TOUT_ATOUT ? CardSet::full()
+                   : mode == CardTables::MODE_SANS_ATOUT ? CardSet() : CardSet::suit(couleurAtout);
+    for (int id = 0; id < NB_CARTES; id++) {
+        CardId carte = static_cast<CardId>(id);
+        bool atout = contrat.atouts.contains(carte);
+        contrat.points[id] = static_cast<std::uint8_t>(CardTables::points(mode, atout, chiffreOf(carte)));
+        contrat.force[id] = static_cast<std::uint8_t>(CardTables::force(mode, atout, chiffreOf(carte))
+                                                      + (atout ? FORCE_ATOUT : 0));
+        contrat.plusFortes[id] = LegalMoves::plusFortesQue(carte, mode, atout);
+    }
+    return contrat;
+}
+
+void PlayoutPolicy::Pli::poser(CardId id, const Contrat &contrat)
+{
+    if (taille == 0) {
+        demandee = couleurOf(id);
+    }
+    int force = forceDansPli(id, demandee, contrat);
+    if (force > forceGagnante) {
+        forceGagnante = force;
+        gagnant = taille;
+    }
+    cartes[taille++] = id;
+    points += contrat.points[id];
+}
+
+CardId PlayoutPolicy::chooseCard(CardSet main, CardSet autres, const Pli &pli, int joueur, bool attaque, const Contrat &contrat)
+{
+    CardId choix;
+
+    if (pli.taille == 0) {
+        // Entame : cartes maîtresses d'abord, atout maître en tête pour l'attaque
+        CardSet maitres;
+        CardSet reste = main;
+        while (!reste.empty()) {
+            CardId id = reste.popFirst();
+            if ((contrat.plusFortes[id] & autres).empty()) maitres.add(id);
+        }
+        CardSet atoutsMaitres = maitres & contrat.atouts;
+        if (attaque && contrat.mode == CardTables::MODE_COULEUR && !atoutsMaitres.empty()
+            && !(autres & contrat.atouts).empty()) {
+            return atoutsMaitres.first();
+        }
+
+        CardSet maitresHorsAtout = maitres & ~contrat.atouts;
+        if (contrat.mode == CardTables::MODE_TOUT_ATOUT) maitresHorsAtout = maitres;
+        bool maitre = !maitresHorsAtout.empty();
+        CardSet candidats = maitre ? maitresHorsAtout : main;
+        choix = candidats.first();
+        reste = candidats;
+        while (!reste.empty()) {
+            CardId id = reste.popFirst();
+            // Maître : la plus grosse ; sinon la plus petite
+            bool mieux = maitre ? contrat.points[id] > contrat.points[choix]
+                                : contrat.force[id] < contrat.force[choix];
+            if (mieux) choix = id;
+        }
+        return choix;
+    }
+
+    bool partenaireGagne = pli.joueurGagnant() % 2 == joueur % 2;
+    CardId carteGagnante = pli.cartes[pli.gagnant];
+    CardSet legaux = LegalMoves::legalMoves(main, pli.demandee, carteGagnante, partenaireGagne,
+                                            contrat.couleurAtout, contrat.mode);
+    bool dernier = pli.taille == 3;
+
+    // Cartes qui prennent la main
+    CardSet gagnantes;
+    CardSet reste = legaux;
+    while (!reste.empty()) {
+        CardId id = reste.popFirst();
+        if (forceDansPli(id, pli.demandee, contrat) > pli.forceGagnante) gagnantes.add(id);
+    }
+
+    bool chargeur = partenaireGagne && (dernier || (contrat.plusFortes[carteGagnante] & autres).empty());
+    if (chargeur) {
+        // Partenaire maître : donner des points, sans gaspiller d'atout si possible
+        CardSet candidats = (legaux & ~contrat.atouts).empty() ? legaux : (legaux & ~contrat.atouts);
+        choix = candidats.first();
+        reste = candidats;
+        while (!reste.empty()) {
+            CardId id = reste.popFirst();
+            if (contrat.points[id] > contrat.points[choix]) choix = id;
+        }
+    } else if (!partenaireGagne && !gagnantes.empty()) {
+        // Prendre : le plus de points en dernier, sinon la carte la plus faible qui passe
+        choix = gagnantes.first();
+        reste = gagnantes;
+        while (!reste.empty()) {
+            CardId id = reste.popFirst();
+            bool mieux = dernier ? contrat.points[id] > contrat.points[choix]
+                                 : contrat.force[id] < contrat.force[choix];
+            if (mieux) choix = id;
+        }
+    } else {
+        // Se défausser : la carte qui rapporte le moins
+        choix = legaux.first();
+        reste = legaux;
+        while (!reste.empty()) {
+            CardId id = reste.popFirst();
+            if (contrat.points[id] < contrat.points[choix]
+                || (contrat.points[id] == contrat.points[choix] && contrat.force[id] < contrat.force[choix])) {
+                choix = id;
+            }
+        }
+    }
+    return choix;
+}
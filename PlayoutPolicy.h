@@ -0,0 +1,49 @@
+#ifndef PLAYOUTPOLICY_H
+#define PLAYOUTPOLICY_H
+
+#include <array>
+#include <cstdint>
+#include "Carte.h"
+#include "CardSet.h"
+#include "CardTables.h"
+
+// Politique de jeu rapide (masques de bits, sans allocation)
+// Sert aux simulations d'enchères (BidEvaluator) et aux bots du moteur
+// d'auto-jeu (GameEngine) : tirer les atouts pour l'équipe qui a pris,
+// jouer ses cartes maîtresses, charger le partenaire maître, prendre au
+// moindre coût, sinon se défausser petit.
+namespace PlayoutPolicy {
+
+    // Tables précalculées pour un contrat : le choix d'une carte se fait par indexation
+    struct Contrat {
+        Carte::Couleur couleurAtout = Carte::COULEURINVALIDE;  // COULEURINVALIDE en TA/SA
+        CardTables::Mode mode = CardTables::MODE_COULEUR;
+        CardSet atouts;
+        std::array<std::uint8_t, NB_CARTES> points;
+        std::array<std::uint8_t, NB_CARTES> force;     // Force, majorée pour les atouts
+        std::array<CardSet, NB_CARTES> plusFortes;     // Cartes de même couleur plus fortes
+    };
+
+    Contrat makeContrat(Carte::Couleur couleurAtout, CardTables::Mode mode);
+
+    // Pli en cours
+    struct Pli {
+        std::array<CardId, 4> cartes = {{ CARD_ID_INVALIDE, CARD_ID_INVALIDE, CARD_ID_INVALIDE, CARD_ID_INVALIDE }};
+        int taille = 0;
+        int leader = 0;       // Joueur qui a entamé
+        int gagnant = 0;      // Index (0..taille-1) de la carte maîtresse
+        int forceGagnante = -1;
+        Carte::Couleur demandee = Carte::COULEURINVALIDE;
+        int points = 0;
+
+        void poser(CardId id, const Contrat &contrat);
+        int joueurGagnant() const { return (leader + gagnant) % 4; }
+    };
+
+    // Carte jouée par le joueur qui doit jouer dans le pli
+    //   autres  : cartes encore en jeu hors de sa main
+    //   attaque : le joueur est dans l'équipe du preneur
+    CardId chooseCard(CardSet main, CardSet autres, const Pli &pli, int joueur, bool attaque, const Contrat &contrat);
+}
+
+#endif
@@ -0,0 +1,200 @@
+// Micro-benchmark de la couche SQLite : latence par appel des requêtes du
+// chemin de jeu, préparées à chaque appel (ancien code) ou en cache
+// (DatabaseManager::cachedQuery), et débit des lectures avec et sans
+// threads de lecture (DatabaseWorker::readRequest), puis durée d'un hash de
+// mot de passe selon le coût PBKDF2 (PasswordHasher) pour choisir
+// --pbkdf2-iterations du serveur.
+//
+// Usage : coinche_dbbench [--iterations N] [--accounts N] [--readers N] [--kdf-samples N]
+
+#include "DatabaseManager.h"
+#include "DatabaseWorker.h"
+#include "PasswordHasher.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QSqlDatabase>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+namespace {
+
+const char *SQL_USER_ID = "SELECT id FROM users WHERE pseudo = :pseudo";
+const char *SQL_STATS = "SELECT games_played, games_won, coinche_attempts, coinche_success, capot_realises, capot_annonces_realises, capot_annonces_tentes, generale_attempts, generale_success, annonces_coinchees, annonces_coinchees_gagnees, surcoinche_attempts, surcoinche_success, annonces_surcoinchees, annonces_surcoinchees_gagnees, max_win_streak, belote_games_played, belote_games_won, belote_max_win_streak, belote_capots FROM stats WHERE user_id = :user_id";
+const char *SQL_COINCHE = "UPDATE stats SET coinche_success = coinche_success + 1 WHERE user_id = :user_id";
+
+struct Mesure {
+    std::vector<qint64> ns;
+
+    void afficher(const char *nom) {
+        std::sort(ns.begin(), ns.end());
+        double total = 0;
+        for (qint64 v : ns) total += v;
+        std::printf("  %-34s moyenne %7.1f µs   p50 %7.1f µs   p99 %7.1f µs\n", nom,
+                    total / ns.size() / 1000.0,
+                    ns[ns.size() / 2] / 1000.0,
+                    ns[std::min(ns.size() - 1, ns.size() * 99 / 100)] / 1000.0);
+    }
+};
+
+Mesure mesurer(int iterations, const std::function<void(int)> &appel) {
+    Mesure mesure;
+    mesure.ns.reserve(iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; i++) {
+        timer.start();
+        appel(i);
+        mesure.ns.push_back(timer.nsecsElapsed());
+    }
+    return mesure;
+}
+
+// Ancien code : QSqlQuery construite et préparée à chaque appel
+int userIdSansCache(QSqlDatabase &db, const QString &pseudo) {
+    QSqlQuery query(db);
+    query.prepare(SQL_USER_ID);
+    query.bindValue(":pseudo", pseudo);
+    if (!query.exec() || !query.next()) return -1;
+    return query.value(0).toInt();
+}
+
+int statsSansCache(QSqlDatabase &db, const QString &pseudo) {
+    int userId = userIdSansCache(db, pseudo);
+    QSqlQuery query(db);
+    query.prepare(SQL_STATS);
+    query.bindValue(":user_id", userId);
+    if (!query.exec() || !query.next()) return 0;
+    return query.value(0).toInt();
+}
+
+bool coincheSansCache(QSqlDatabase &db, const QString &pseudo) {
+    int userId = userIdSansCache(db, pseudo);
+    QSqlQuery query(db);
+    query.prepare(SQL_COINCHE);
+    query.bindValue(":user_id", userId);
+    return query.exec();
+}
+
+// Temps pour servir nbLectures getPlayerStats pendant que nbLectures écritures sont en file
+double debitLectures(const QString &dbPath, int readers, int nbLectures, int nbComptes) {
+    DatabaseWorker worker(QString("bench_worker_%1").arg(readers));
+    if (!worker.start(dbPath, readers)) return 0;
+
+    QObject context;
+    int recues = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < nbLectures; i++) {
+        QString pseudo = QString("joueur%1").arg(i % nbComptes);
+        worker.post([pseudo](DatabaseManager &db) { db.updateCoincheStats(pseudo, true, false); });
+        worker.readRequest<DatabaseManager::PlayerStats>(&context,
+            [pseudo](DatabaseManager &db) { return db.getPlayerStats(pseudo); },
+            [&recues](const DatabaseManager::PlayerStats &) { recues++; });
+    }
+    while (recues < nbLectures) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+    double ms = timer.nsecsElapsed() / 1e6;
+    worker.stop();
+    return ms;
+}
+
+// Durée d'un hash (= d'une vérification) pour chaque coût
+void mesurerKdf(int echantillons) {
+    std::printf("\nHachage des mots de passe (%d hash par coût)\n", echantillons);
+    const int couts[] = { PasswordHasher::MIN_ITERATIONS, 10000, 50000,
+                          PasswordHasher::DEFAULT_ITERATIONS, 2 * PasswordHasher::DEFAULT_ITERATIONS };
+    for (int nbIterations : couts) {
+        Mesure mesure = mesurer(echantillons, [nbIterations](int i) {
+            PasswordHasher::hash("motdepasse", QString("salt%1").arg(i), nbIterations);
+        });
+        std::sort(mesure.ns.begin(), mesure.ns.end());
+        double ms = mesure.ns[mesure.ns.size() / 2] / 1e6;
+        std::printf("  PBKDF2-SHA256 %7d itérations : %8.2f ms   (~%.0f vérifications/s par cœur)\n",
+                    nbIterations, ms, ms > 0 ? 1000.0 / ms : 0.0);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int iterations = 5000;
+    int nbComptes = 200;
+    int nbLecteurs = 2;
+    int echantillonsKdf = 5;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char *option = argv[i];
+        const char *valeur = argv[i + 1];
+        if (std::strcmp(option, "--iterations") == 0) {
+            iterations = std::max(1, std::atoi(valeur));
+        } else if (std::strcmp(option, "--accounts") == 0) {
+            nbComptes = std::max(1, std::atoi(valeur));
+        } else if (std::strcmp(option, "--readers") == 0) {
+            nbLecteurs = std::max(0, std::atoi(valeur));
+        } else if (std::strcmp(option, "--kdf-samples") == 0) {
+            echantillonsKdf = std::max(0, std::atoi(valeur));
+        } else {
+            std::fprintf(stderr, "Option inconnue : %s\n", option);
+            return 1;
+        }
+    }
+
+    QString dbPath = QDir::temp().filePath("coinche_dbbench.db");
+    QFile::remove(dbPath);
+    QFile::remove(dbPath + "-wal");
+    QFile::remove(dbPath + "-shm");
+
+    {
+        DatabaseManager manager(nullptr, "bench_cache");
+        if (!manager.initialize(dbPath)) {
+            std::fprintf(stderr, "Impossible d'initialiser %s\n", qPrintable(dbPath));
+            return 1;
+        }
+        // Comptes de test : coût minimal, le hachage est mesuré à part
+        PasswordHasher::setIterations(PasswordHasher::MIN_ITERATIONS);
+        for (int i = 0; i < nbComptes; i++) {
+            QString errorMsg;
+            manager.createAccount(QString("joueur%1").arg(i), QString("joueur%1@bench.local").arg(i),
+                                  "motdepasse", "avatar1.svg", errorMsg);
+        }
+
+        // Connexion séparée pour l'ancien code (même fichier, mêmes PRAGMA par défaut)
+        QSqlDatabase brute = QSqlDatabase::addDatabase("QSQLITE", "bench_sans_cache");
+        brute.setDatabaseName(dbPath);
+        brute.open();
+
+        auto pseudo = [nbComptes](int i) { return QString("joueur%1").arg(i % nbComptes); };
+
+        std::printf("Latence par appel (%d appels, %d comptes)\n", iterations, nbComptes);
+        mesurer(iterations, [&](int i) { statsSansCache(brute, pseudo(i)); }).afficher("getPlayerStats, prepare à chaque appel");
+        mesurer(iterations, [&](int i) { manager.getPlayerStats(pseudo(i)); }).afficher("getPlayerStats, requête en cache");
+        mesurer(iterations, [&](int i) { coincheSansCache(brute, pseudo(i)); }).afficher("updateCoincheStats, prepare");
+        mesurer(iterations, [&](int i) { manager.updateCoincheStats(pseudo(i), false, true); }).afficher("updateCoincheStats, en cache");
+
+        brute.close();
+        brute = QSqlDatabase();
+        QSqlDatabase::removeDatabase("bench_sans_cache");
+    }
+    QSqlDatabase::removeDatabase("bench_cache");
+
+    std::printf("\nLectures pendant des écritures (%d getPlayerStats + %d updateCoincheStats)\n", iterations, iterations);
+    std::printf("  thread principal seul : %8.1f ms\n", debitLectures(dbPath, 0, iterations, nbComptes));
+    std::printf("  %d thread(s) de lecture : %8.1f ms\n", nbLecteurs, debitLectures(dbPath, nbLecteurs, iterations, nbComptes));
+
+    if (echantillonsKdf > 0) {
+        mesurerKdf(echantillonsKdf);
+    }
+
+    QFile::remove(dbPath);
+    return 0;
+}
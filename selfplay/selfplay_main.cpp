@@ -0,0 +1,214 @@
+// Auto-jeu bot contre bot : compare deux configurations de bots et mesure le
+// débit du moteur de règles (GameEngine), sans réseau ni délais d'animation.
+//
+// Usage : coinche_selfplay [--games N] [--threads T] [--seed S]
+//                          [--team0 aleatoire|heuristique|pimc] [--team1 ...]
+//                          [--risk0 R] [--risk1 R] [--bid-samples N] [--pimc-samples N]
+//                          [--bid-bench N]
+//
+// --bid-bench N : chronomètre seulement BidEvaluator::evaluate sur N mains tirées au
+// hasard (temps moyen et maximum par main), sans jouer de partie
+
+#include "GameEngine.h"
+#include "BidEvaluator.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Statistiques {
+    long parties = 0;
+    long manches = 0;
+    long manchesPassees = 0;
+    std::array<long, 2> victoires = {{ 0, 0 }};
+    std::array<long, 2> points = {{ 0, 0 }};            // Somme des scores finaux
+    std::array<long, 2> contrats = {{ 0, 0 }};          // Contrats pris par équipe
+    std::array<long, 2> contratsReussis = {{ 0, 0 }};
+    std::array<long, 2> capots = {{ 0, 0 }};
+    std::array<long, Player::PASSE + 1> annonces = {};
+    std::map<int, long> ecarts;                         // Écart final (équipe 0 - équipe 1) par tranche de 100
+
+    void ajouter(const GameEngine::ResultatPartie &partie) {
+        parties++;
+        manches += partie.manches;
+        manchesPassees += partie.manchesPassees;
+        if (partie.vainqueur >= 0) victoires[partie.vainqueur]++;
+        for (int e = 0; e < 2; e++) {
+            points[e] += partie.score[e];
+            contrats[e] += partie.contrats[e];
+            contratsReussis[e] += partie.contratsReussis[e];
+            capots[e] += partie.capots[e];
+        }
+        for (std::size_t a = 0; a < annonces.size(); a++) annonces[a] += partie.annonces[a];
+        int ecart = partie.score[0] - partie.score[1];
+        ecarts[(ecart >= 0 ? ecart / 100 : (ecart - 99) / 100) * 100]++;
+    }
+
+    void ajouter(const Statistiques &autre) {
+        parties += autre.parties;
+        manches += autre.manches;
+        manchesPassees += autre.manchesPassees;
+        for (int e = 0; e < 2; e++) {
+            victoires[e] += autre.victoires[e];
+            points[e] += autre.points[e];
+            contrats[e] += autre.contrats[e];
+            contratsReussis[e] += autre.contratsReussis[e];
+            capots[e] += autre.capots[e];
+        }
+        for (std::size_t a = 0; a < annonces.size(); a++) annonces[a] += autre.annonces[a];
+        for (const auto &e : autre.ecarts) ecarts[e.first] += e.second;
+    }
+};
+
+GameEngine::BotType parseBot(const char *nom) {
+    if (std::strcmp(nom, "aleatoire") == 0) return GameEngine::BOT_ALEATOIRE;
+    if (std::strcmp(nom, "pimc") == 0) return GameEngine::BOT_PIMC;
+    if (std::strcmp(nom, "heuristique") != 0) {
+        std::fprintf(stderr, "Bot inconnu '%s', heuristique utilisé\n", nom);
+    }
+    return GameEngine::BOT_HEURISTIQUE;
+}
+
+const char *nomBot(GameEngine::BotType bot) {
+    switch (bot) {
+        case GameEngine::BOT_ALEATOIRE: return "aleatoire";
+        case GameEngine::BOT_PIMC:      return "pimc";
+        default:                        return "heuristique";
+    }
+}
+
+double pourcentage(long n, long total) {
+    return total > 0 ? 100.0 * n / total : 0.0;
+}
+
+// Temps d'évaluation des enchères, main par main (un seul thread)
+int benchEncheres(long nbMains, int samples, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::array<CardId, NB_CARTES> cartes;
+    for (int id = 0; id < NB_CARTES; id++) cartes[id] = static_cast<CardId>(id);
+
+    double total = 0.0;
+    double maximum = 0.0;
+    for (long n = 0; n < nbMains; n++) {
+        std::shuffle(cartes.begin(), cartes.end(), rng);
+        CardSet main;
+        for (int i = 0; i < 8; i++) main.add(cartes[i]);
+        BidEvaluator::Options options;
+        options.samples = samples;
+        options.seed = seed + static_cast<std::uint32_t>(n);
+
+        auto debut = std::chrono::steady_clock::now();
+        BidEvaluator::evaluate(main, options);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - debut).count();
+        total += ms;
+        maximum = std::max(maximum, ms);
+    }
+    std::printf("Enchères : %ld mains, %d donnes simulées par main : %.2f ms/main en moyenne, %.2f ms au plus\n",
+                nbMains, samples, nbMains > 0 ? total / nbMains : 0.0, maximum);
+    return 0;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    long nbParties = 1000;
+    int nbThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::uint32_t seed = 1;
+    GameEngine::Config config;
+    long nbMainsBench = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char *option = argv[i];
+        const char *valeur = argv[i + 1];
+        if (std::strcmp(option, "--games") == 0) {
+            nbParties = std::atol(valeur);
+        } else if (std::strcmp(option, "--threads") == 0) {
+            nbThreads = std::max(1, std::atoi(valeur));
+        } else if (std::strcmp(option, "--seed") == 0) {
+            seed = static_cast<std::uint32_t>(std::strtoul(valeur, nullptr, 10));
+        } else if (std::strcmp(option, "--team0") == 0) {
+            config.bots[0] = config.bots[2] = parseBot(valeur);
+        } else if (std::strcmp(option, "--team1") == 0) {
+            config.bots[1] = config.bots[3] = parseBot(valeur);
+        } else if (std::strcmp(option, "--risk0") == 0) {
+            config.risque[0] = std::atof(valeur);
+        } else if (std::strcmp(option, "--risk1") == 0) {
+            config.risque[1] = std::atof(valeur);
+        } else if (std::strcmp(option, "--bid-samples") == 0) {
+            config.bidSamples = std::max(1, std::atoi(valeur));
+        } else if (std::strcmp(option, "--pimc-samples") == 0) {
+            config.pimcSamples = std::max(1, std::atoi(valeur));
+        } else if (std::strcmp(option, "--bid-bench") == 0) {
+            nbMainsBench = std::max(1L, std::atol(valeur));
+        } else {
+            std::fprintf(stderr, "Option inconnue : %s\n", option);
+            return 1;
+        }
+    }
+
+    if (nbMainsBench > 0) {
+        return benchEncheres(nbMainsBench, config.bidSamples, seed);
+    }
+
+    std::printf("Auto-jeu : %ld parties, %d threads, équipe 0 = %s (risque %.2f), équipe 1 = %s (risque %.2f)\n",
+                nbParties, nbThreads, nomBot(config.bots[0]), config.risque[0],
+                nomBot(config.bots[1]), config.risque[1]);
+
+    // Chaque thread prend la partie suivante ; la graine dépend du numéro de partie (résultats reproductibles)
+    std::atomic<long> prochaine(0);
+    Statistiques total;
+    std::mutex mutexTotal;
+    auto debut = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nbThreads; t++) {
+        threads.emplace_back([&]() {
+            Statistiques stats;
+            for (long n = prochaine++; n < nbParties; n = prochaine++) {
+                GameEngine engine(config, seed * 1000003u + static_cast<std::uint32_t>(n));
+                stats.ajouter(engine.playGame());
+            }
+
+            std::lock_guard<std::mutex> verrou(mutexTotal);
+            total.ajouter(stats);
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    double secondes = std::chrono::duration<double>(std::chrono::steady_clock::now() - debut).count();
+
+    std::printf("\n%ld parties, %ld manches en %.2f s : %.1f parties/s, %.0f manches/s\n",
+                total.parties, total.manches, secondes,
+                total.parties / secondes, total.manches / secondes);
+    std::printf("Manches sans preneur : %.1f %%\n", pourcentage(total.manchesPassees, total.manches));
+    for (int e = 0; e < 2; e++) {
+        std::printf("Équipe %d : %.1f %% de victoires, %.0f points/partie, %ld contrats (%.1f %% réussis), %ld capots\n",
+                    e, pourcentage(total.victoires[e], total.parties),
+                    total.parties > 0 ? static_cast<double>(total.points[e]) / total.parties : 0.0,
+                    total.contrats[e], pourcentage(total.contratsReussis[e], total.contrats[e]), total.capots[e]);
+    }
+
+    std::printf("\nAnnonces :\n");
+    for (int a = Player::QUATREVINGT; a <= Player::GENERALE; a++) {
+        if (total.annonces[a] == 0) continue;
+        std::printf("  %4d : %ld\n", Player::getContractValue(static_cast<Player::Annonce>(a)), total.annonces[a]);
+    }
+    std::printf("\nÉcart final (équipe 0 - équipe 1) :\n");
+    for (const auto &e : total.ecarts) {
+        std::printf("  [%5d, %5d[ : %ld\n", e.first, e.first + 100, e.second);
+    }
+    return 0;
+}
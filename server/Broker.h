@@ -0,0 +1,310 @@
+#ifndef BROKER_H
+#define BROKER_H
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <QDebug>
+#include <functional>
+
+// Plusieurs processus coinche_server sur une même machine, coordonnés par un broker
+//
+// Le broker (coinche_server --broker-only) écoute sur un socket Unix. Chaque serveur
+// de jeu s'y connecte (--broker) et lui envoie régulièrement son état : joueurs en
+// partie, codes de lobbies, taille des files de matchmaking, nombre de rooms. Le
+// broker renvoie à tous l'annuaire fusionné : qui possède quel joueur et quel lobby,
+// et quel serveur reçoit les prochaines entrées en matchmaking de chaque mode.
+//
+// Les serveurs ne se parlent pas : un client connecté au mauvais serveur reçoit
+// {"type": "redirect", "url": ...} et rejoue son action sur le bon (reconnexion à
+// une partie, matchmaking, lobby privé). Un serveur remplit une table à la fois par
+// mode ; quand sa file est vide, le broker désigne le serveur le moins chargé.
+//
+// Protocole : une ligne JSON compacte par message, dans les deux sens.
+// Sans broker (ou broker injoignable), chaque serveur fonctionne seul comme avant.
+namespace Broker {
+
+// Clients qui savent suivre un message "redirect"
+constexpr int REDIRECT_MIN_VERSION = 11;
+
+constexpr int SYNC_INTERVAL_MS = 2000;      // État complet envoyé au broker au moins à ce rythme
+constexpr int RECONNECT_INTERVAL_MS = 3000;
+
+inline const QStringList &modes() {
+    static const QStringList liste = {"coinche", "belote"};
+    return liste;
+}
+
+inline void writeLine(QLocalSocket *socket, const QJsonObject &message) {
+    socket->write(QJsonDocument(message).toJson(QJsonDocument::Compact));
+    socket->write("\n");
+}
+
+// Lit les lignes complètes disponibles
+inline void readLines(QLocalSocket *socket, const std::function<void(const QJsonObject &)> &handler) {
+    while (socket->canReadLine()) {
+        QJsonParseError erreur;
+        QJsonDocument doc = QJsonDocument::fromJson(socket->readLine().trimmed(), &erreur);
+        if (erreur.error != QJsonParseError::NoError || !doc.isObject()) {
+            qWarning() << "Broker - Ligne invalide ignorée:" << erreur.errorString();
+            continue;
+        }
+        handler(doc.object());
+    }
+}
+
+} // namespace Broker
+
+// Processus coordinateur : agrège l'état des serveurs et diffuse l'annuaire
+class MatchmakingBroker
+{
+public:
+    MatchmakingBroker() : m_server(new QLocalServer) {}
+    ~MatchmakingBroker() {
+        // Les sockets partent avec le serveur : plus de notifications vers ce broker
+        for (QLocalSocket *socket : m_serveurs.keys()) QObject::disconnect(socket, nullptr, nullptr, nullptr);
+        delete m_server;
+    }
+
+    MatchmakingBroker(const MatchmakingBroker &) = delete;
+    MatchmakingBroker &operator=(const MatchmakingBroker &) = delete;
+
+    bool listen(const QString &socketPath) {
+        QLocalServer::removeServer(socketPath);  // Socket laissé par un broker arrêté brutalement
+        if (!m_server->listen(socketPath)) {
+            qCritical() << "Broker - Impossible d'écouter sur" << socketPath << ":" << m_server->errorString();
+            return false;
+        }
+        QObject::connect(m_server, &QLocalServer::newConnection, m_server, [this]() {
+            while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+                m_serveurs.insert(socket, Serveur());
+                QObject::connect(socket, &QLocalSocket::readyRead, socket, [this, socket]() {
+                    Broker::readLines(socket, [this, socket](const QJsonObject &message) { onMessage(socket, message); });
+                });
+                QObject::connect(socket, &QLocalSocket::disconnected, socket, [this, socket]() {
+                    qInfo() << "Broker - Serveur déconnecté:" << m_serveurs.value(socket).id;
+                    m_serveurs.remove(socket);
+                    socket->deleteLater();
+                    publish();
+                });
+            }
+        });
+        qInfo() << "Broker - En écoute sur" << socketPath;
+        return true;
+    }
+
+    int serverCount() const { return m_serveurs.size(); }
+
+private:
+    struct Serveur {
+        QString id;
+        QString url;
+        QJsonArray players;
+        QJsonArray lobbies;
+        QJsonObject queues;  // mode → joueurs en file
+        int rooms = 0;
+    };
+
+    void onMessage(QLocalSocket *socket, const QJsonObject &message) {
+        if (message["type"].toString() != "state") return;
+
+        Serveur &serveur = m_serveurs[socket];
+        if (serveur.id.isEmpty()) {
+            qInfo() << "Broker - Serveur enregistré:" << message["server"].toString() << message["url"].toString();
+        }
+        serveur.id = message["server"].toString();
+        serveur.url = message["url"].toString();
+        serveur.players = message["players"].toArray();
+        serveur.lobbies = message["lobbies"].toArray();
+        serveur.queues = message["queues"].toObject();
+        serveur.rooms = message["rooms"].toInt();
+        publish();
+    }
+
+    // Serveur qui remplit la prochaine table d'un mode : on le garde tant que sa file
+    // n'est pas vide, sinon le moins chargé prend le relais
+    QString choisirHote(const QString &mode) const {
+        const Serveur *actuel = nullptr;
+        const Serveur *moinsCharge = nullptr;
+        for (const Serveur &serveur : m_serveurs) {
+            if (serveur.id.isEmpty()) continue;
+            if (serveur.id == m_hotes.value(mode)) actuel = &serveur;
+            if (!moinsCharge || serveur.rooms < moinsCharge->rooms
+                || (serveur.rooms == moinsCharge->rooms && serveur.id < moinsCharge->id)) {
+                moinsCharge = &serveur;
+            }
+        }
+        if (actuel && actuel->queues[mode].toInt() > 0) return actuel->id;
+        return moinsCharge ? moinsCharge->id : QString();
+    }
+
+    void publish() {
+        QJsonObject serveurs, joueurs, lobbies, hotes;
+        for (const Serveur &serveur : m_serveurs) {
+            if (serveur.id.isEmpty()) continue;
+            serveurs[serveur.id] = serveur.url;
+            for (const QJsonValue &nom : serveur.players) joueurs[nom.toString()] = serveur.id;
+            for (const QJsonValue &code : serveur.lobbies) lobbies[code.toString()] = serveur.id;
+        }
+        for (const QString &mode : Broker::modes()) {
+            m_hotes[mode] = choisirHote(mode);
+            hotes[mode] = m_hotes[mode];
+        }
+
+        QJsonObject annuaire;
+        annuaire["type"] = "directory";
+        annuaire["servers"] = serveurs;
+        annuaire["players"] = joueurs;
+        annuaire["lobbies"] = lobbies;
+        annuaire["hosts"] = hotes;
+
+        // Rien de nouveau : pas de diffusion (les serveurs envoient leur état toutes les 2 s)
+        if (annuaire == m_dernierAnnuaire) return;
+        m_dernierAnnuaire = annuaire;
+        for (auto it = m_serveurs.constBegin(); it != m_serveurs.constEnd(); ++it) {
+            Broker::writeLine(it.key(), annuaire);
+        }
+    }
+
+    QLocalServer *m_server;
+    QHash<QLocalSocket*, Serveur> m_serveurs;
+    QHash<QString, QString> m_hotes;  // mode → id du serveur qui remplit la prochaine table
+    QJsonObject m_dernierAnnuaire;
+};
+
+// Côté serveur de jeu : publie l'état local et garde une copie de l'annuaire
+class BrokerClient
+{
+public:
+    using StateProvider = std::function<QJsonObject()>;
+
+    BrokerClient(const QString &socketPath, const QString &serverId, const QString &publicUrl)
+        : m_socketPath(socketPath)
+        , m_serverId(serverId)
+        , m_publicUrl(publicUrl)
+        , m_socket(new QLocalSocket)
+        , m_syncTimer(new QTimer)
+        , m_reconnectTimer(new QTimer)
+    {
+        m_syncTimer->setInterval(Broker::SYNC_INTERVAL_MS);
+        m_reconnectTimer->setInterval(Broker::RECONNECT_INTERVAL_MS);
+        m_reconnectTimer->setSingleShot(true);
+
+        QObject::connect(m_socket, &QLocalSocket::connected, m_socket, [this]() {
+            qInfo() << "Broker - Connecté à" << m_socketPath << "en tant que" << m_serverId;
+            publishNow();
+            m_syncTimer->start();
+        });
+        QObject::connect(m_socket, &QLocalSocket::readyRead, m_socket, [this]() {
+            Broker::readLines(m_socket, [this](const QJsonObject &message) { onMessage(message); });
+        });
+        QObject::connect(m_socket, &QLocalSocket::disconnected, m_socket, [this]() {
+            qWarning() << "Broker - Connexion perdue, fonctionnement autonome en attendant";
+            onLost();
+        });
+        QObject::connect(m_socket, &QLocalSocket::errorOccurred, m_socket, [this](QLocalSocket::LocalSocketError) {
+            if (m_socket->state() == QLocalSocket::UnconnectedState) onLost();
+        });
+        QObject::connect(m_syncTimer, &QTimer::timeout, m_syncTimer, [this]() { publishNow(); });
+        QObject::connect(m_reconnectTimer, &QTimer::timeout, m_reconnectTimer, [this]() { connectToBroker(); });
+    }
+
+    ~BrokerClient() {
+        QObject::disconnect(m_socket, nullptr, nullptr, nullptr);
+        delete m_reconnectTimer;
+        delete m_syncTimer;
+        delete m_socket;
+    }
+
+    BrokerClient(const BrokerClient &) = delete;
+    BrokerClient &operator=(const BrokerClient &) = delete;
+
+    void setStateProvider(StateProvider provider) { m_stateProvider = std::move(provider); }
+
+    void connectToBroker() {
+        if (m_socket->state() != QLocalSocket::UnconnectedState) return;
+        m_socket->connectToServer(m_socketPath);
+    }
+
+    // L'état local a changé : envoi groupé à la prochaine itération de la boucle
+    void publishSoon() {
+        if (m_publishPending || !isConnected()) return;
+        m_publishPending = true;
+        QTimer::singleShot(0, m_socket, [this]() { publishNow(); });
+    }
+
+    bool isConnected() const { return m_socket->state() == QLocalSocket::ConnectedState; }
+    QString serverId() const { return m_serverId; }
+
+    // URL du serveur qui doit traiter le joueur / le lobby / le matchmaking du mode,
+    // vide si c'est ce serveur ou s'il n'est pas connu
+    QString urlForPlayer(const QString &playerName) const { return urlOf(m_joueurs.value(playerName)); }
+    QString urlForLobby(const QString &code) const { return urlOf(m_lobbies.value(code)); }
+    QString urlForMatchmaking(const QString &mode) const { return urlOf(m_hotes.value(mode)); }
+
+    // Code de lobby déjà utilisé par un autre serveur
+    bool isLobbyCodeTaken(const QString &code) const { return m_lobbies.contains(code); }
+
+private:
+    QString urlOf(const QString &serverId) const {
+        if (serverId.isEmpty() || serverId == m_serverId || !isConnected()) return QString();
+        return m_urls.value(serverId);
+    }
+
+    void publishNow() {
+        m_publishPending = false;
+        if (!isConnected() || !m_stateProvider) return;
+        QJsonObject etat = m_stateProvider();
+        etat["type"] = "state";
+        etat["server"] = m_serverId;
+        etat["url"] = m_publicUrl;
+        Broker::writeLine(m_socket, etat);
+    }
+
+    void onMessage(const QJsonObject &message) {
+        if (message["type"].toString() != "directory") return;
+
+        auto lire = [](const QJsonObject &objet) {
+            QHash<QString, QString> table;
+            for (auto it = objet.constBegin(); it != objet.constEnd(); ++it) table.insert(it.key(), it.value().toString());
+            return table;
+        };
+        m_urls = lire(message["servers"].toObject());
+        m_joueurs = lire(message["players"].toObject());
+        m_lobbies = lire(message["lobbies"].toObject());
+        m_hotes = lire(message["hosts"].toObject());
+    }
+
+    void onLost() {
+        m_syncTimer->stop();
+        m_urls.clear();
+        m_joueurs.clear();
+        m_lobbies.clear();
+        m_hotes.clear();
+        if (!m_reconnectTimer->isActive()) m_reconnectTimer->start();
+    }
+
+    QString m_socketPath;
+    QString m_serverId;
+    QString m_publicUrl;
+    QLocalSocket *m_socket;
+    QTimer *m_syncTimer;
+    QTimer *m_reconnectTimer;
+    StateProvider m_stateProvider;
+    bool m_publishPending = false;
+
+    // Dernier annuaire reçu
+    QHash<QString, QString> m_urls;     // serverId → URL publique
+    QHash<QString, QString> m_joueurs;  // playerName → serverId
+    QHash<QString, QString> m_lobbies;  // code → serverId
+    QHash<QString, QString> m_hotes;    // mode → serverId
+};
+
+#endif // BROKER_H
@@ -1,23 +1,69 @@
 #include "DatabaseManager.h"
+#include "PasswordHasher.h"
 #include <QDateTime>
 #include <QRandomGenerator>
 
-DatabaseManager::DatabaseManager(QObject *parent)
+DatabaseManager::DatabaseManager(QObject *parent, const QString &connectionName)
     : QObject(parent)
+    , m_connectionName(connectionName)
 {
 }
 
 DatabaseManager::~DatabaseManager()
 {
     if (m_db.isOpen()) {
+        flushDailyCounters();
+        // Les requêtes préparées doivent être libérées avant la connexion
+        m_statements.clear();
+        m_failedStatement.reset();
         m_db.close();
     }
 }
 
+QSqlQuery &DatabaseManager::cachedQuery(const QString &sql)
+{
+    auto it = m_statements.find(sql);
+    if (it == m_statements.end()) {
+        auto query = std::make_unique<QSqlQuery>(m_db);
+        if (!query->prepare(sql)) {
+            // Pas de mise en cache : l'erreur sera remontée par exec()
+            qWarning() << "Erreur preparation requete:" << query->lastError().text();
+            m_failedStatement = std::move(query);
+            return *m_failedStatement;
+        }
+        it = m_statements.emplace(sql, std::move(query)).first;
+    }
+    it->second->finish();
+    return *it->second;
+}
+
+bool DatabaseManager::openReadOnly(const QString &dbPath)
+{
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(dbPath);
+
+    if (!m_db.open()) {
+        qCritical() << "Erreur ouverture base de donnees (lecture):" << m_db.lastError().text();
+        return false;
+    }
+
+    // Le schéma et le mode WAL sont créés par la connexion principale (initialize)
+    QSqlQuery pragmaQuery(m_db);
+    if (!pragmaQuery.exec("PRAGMA query_only = ON")) {
+        qWarning() << "Impossible d'activer query_only:" << pragmaQuery.lastError().text();
+    }
+    pragmaQuery.exec("PRAGMA cache_size = -10000");
+    pragmaQuery.exec("PRAGMA temp_store = MEMORY");
+    pragmaQuery.exec("PRAGMA mmap_size = 30000000000");
+
+    qDebug() << "Connexion lecture ouverte:" << m_connectionName;
+    return true;
+}
+
 bool DatabaseManager::initialize(const QString &dbPath)
 {
     // Créer ou ouvrir la base de données SQLite
-    m_db = QSqlDatabase::addDatabase("QSQLITE", "coinche_connection");
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
     m_db.setDatabaseName(dbPath);
 
     if (!m_db.open()) {
@@ -418,6 +464,43 @@ bool DatabaseManager::createTables()
 
     qDebug() << "Table 'user_sessions' creee/verifiee";
 
+    // Recherche de la session ouverte d'un joueur (recordSessionEnd)
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_user_sessions_open ON user_sessions(pseudo, login_time) WHERE logout_time IS NULL")) {
+        qWarning() << "Erreur creation index user_sessions:" << query.lastError().text();
+    }
+
+    // Joueurs actifs par jour : alimentée à chaque début de session,
+    // remplace les auto-jointures de user_sessions pour la rétention
+    QString createDailyActiveUsers = R"(
+        CREATE TABLE IF NOT EXISTS daily_active_users (
+            date TEXT NOT NULL,
+            pseudo TEXT NOT NULL,
+            PRIMARY KEY (date, pseudo)
+        ) WITHOUT ROWID
+    )";
+
+    if (!query.exec(createDailyActiveUsers)) {
+        qCritical() << "Erreur creation table daily_active_users:" << query.lastError().text();
+        return false;
+    }
+
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_daily_active_users_pseudo ON daily_active_users(pseudo, date)")) {
+        qWarning() << "Erreur creation index daily_active_users:" << query.lastError().text();
+    }
+
+    // Migration : construire la table à partir de l'historique des sessions (une seule fois)
+    if (query.exec("SELECT EXISTS (SELECT 1 FROM daily_active_users)") && query.next() && !query.value(0).toBool()) {
+        query.finish();
+        if (!query.exec("INSERT OR IGNORE INTO daily_active_users (date, pseudo) "
+                        "SELECT DISTINCT date(login_time), pseudo FROM user_sessions")) {
+            qWarning() << "Erreur migration daily_active_users:" << query.lastError().text();
+        } else {
+            qInfo() << "Migration: daily_active_users remplie depuis user_sessions -" << query.numRowsAffected() << "entrees";
+        }
+    }
+
+    qDebug() << "Table 'daily_active_users' creee/verifiee";
+
     // Table d'audit RGPD (traçabilité des actions sur les données personnelles)
     QString createGdprAuditLog = R"(
         CREATE TABLE IF NOT EXISTS gdpr_audit_log (
@@ -490,34 +573,34 @@ bool DatabaseManager::createTables()
 
     qDebug() << "Table 'friends' creee/verifiee";
 
-    return true;
-}
-
-QString DatabaseManager::generateSalt()
-{
-    // Générer un salt aléatoire de 32 caractères
-    QString salt;
-    const QString chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    // Cotes Glicko-2 par mode de jeu
+    QString createRatingsTable = R"(
+        CREATE TABLE IF NOT EXISTS ratings (
+            user_id INTEGER NOT NULL,
+            mode TEXT NOT NULL,
+            rating REAL NOT NULL DEFAULT 1500,
+            rd REAL NOT NULL DEFAULT 350,
+            volatility REAL NOT NULL DEFAULT 0.06,
+            games INTEGER NOT NULL DEFAULT 0,
+            updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+            PRIMARY KEY (user_id, mode),
+            FOREIGN KEY (user_id) REFERENCES users(id) ON DELETE CASCADE
+        )
+    )";
 
-    for (int i = 0; i < 32; i++) {
-        salt += chars[QRandomGenerator::global()->bounded(chars.length())];
+    if (!query.exec(createRatingsTable)) {
+        qCritical() << "Erreur creation table ratings:" << query.lastError().text();
+        return false;
     }
 
-    return salt;
-}
+    qDebug() << "Table 'ratings' creee/verifiee";
 
-QString DatabaseManager::hashPassword(const QString &password, const QString &salt)
-{
-    // Combiner le mot de passe et le salt, puis hasher avec SHA-256
-    QString combined = password + salt;
-    QByteArray hash = QCryptographicHash::hash(combined.toUtf8(), QCryptographicHash::Sha256);
-    return QString(hash.toHex());
+    return true;
 }
 
 bool DatabaseManager::emailExists(const QString &email)
 {
-    QSqlQuery query(m_db);
-    query.prepare("SELECT COUNT(*) FROM users WHERE email = :email");
+    QSqlQuery &query = cachedQuery("SELECT COUNT(*) FROM users WHERE email = :email");
     query.bindValue(":email", email);
 
     if (!query.exec()) {
@@ -525,17 +608,15 @@ bool DatabaseManager::emailExists(const QString &email)
         return false;
     }
 
-    if (query.next()) {
-        return query.value(0).toInt() > 0;
-    }
-
-    return false;
+    // Libérer le verrou de lecture : la requête reste en cache
+    bool exists = query.next() && query.value(0).toInt() > 0;
+    query.finish();
+    return exists;
 }
 
 bool DatabaseManager::pseudoExists(const QString &pseudo)
 {
-    QSqlQuery query(m_db);
-    query.prepare("SELECT COUNT(*) FROM users WHERE pseudo = :pseudo");
+    QSqlQuery &query = cachedQuery("SELECT COUNT(*) FROM users WHERE pseudo = :pseudo");
     query.bindValue(":pseudo", pseudo);
 
     if (!query.exec()) {
@@ -543,28 +624,47 @@ bool DatabaseManager::pseudoExists(const QString &pseudo)
         return false;
     }
 
-    if (query.next()) {
-        return query.value(0).toInt() > 0;
-    }
+    // Libérer le verrou de lecture : la requête reste en cache
+    bool exists = query.next() && query.value(0).toInt() > 0;
+    query.finish();
+    return exists;
+}
 
-    return false;
+bool DatabaseManager::validatePassword(const QString &password, QString &errorMsg)
+{
+    if (password.length() < 8) {
+        errorMsg = "Le mot de passe doit contenir au moins 8 caractères";
+        return false;
+    }
+    return true;
 }
 
 bool DatabaseManager::createAccount(const QString &pseudo, const QString &email, const QString &password, const QString &avatar, QString &errorMsg)
 {
-    // Validations
     if (pseudo.isEmpty() || email.isEmpty() || password.isEmpty()) {
         errorMsg = "Tous les champs sont obligatoires";
         return false;
     }
 
-    if (pseudo.length() < 3) {
-        errorMsg = "Le pseudonyme doit contenir au moins 3 caractères";
+    if (!validatePassword(password, errorMsg)) {
         return false;
     }
 
-    if (password.length() < 8) {
-        errorMsg = "Le mot de passe doit contenir au moins 8 caractères";
+    // Générer le salt et hasher le mot de passe
+    QString salt = PasswordHasher::generateSalt();
+    return createAccountWithHash(pseudo, email, PasswordHasher::hash(password, salt), salt, avatar, errorMsg);
+}
+
+bool DatabaseManager::createAccountWithHash(const QString &pseudo, const QString &email, const QString &passwordHash, const QString &salt, const QString &avatar, QString &errorMsg)
+{
+    // Validations
+    if (pseudo.isEmpty() || email.isEmpty() || passwordHash.isEmpty()) {
+        errorMsg = "Tous les champs sont obligatoires";
+        return false;
+    }
+
+    if (pseudo.length() < 3) {
+        errorMsg = "Le pseudonyme doit contenir au moins 3 caractères";
         return false;
     }
 
@@ -585,10 +685,6 @@ bool DatabaseManager::createAccount(const QString &pseudo, const QString &email,
         return false;
     }
 
-    // Générer le salt et hasher le mot de passe
-    QString salt = generateSalt();
-    QString passwordHash = hashPassword(password, salt);
-
     // Utiliser un avatar par défaut si non fourni
     QString avatarToUse = avatar.isEmpty() ? "avataaars1.svg" : avatar;
 
@@ -643,80 +739,130 @@ bool DatabaseManager::authenticateUser(const QString &email, const QString &pass
         return false;
     }
 
+    Credentials credentials = getCredentials(email);
+    PasswordCheck check = checkPassword(credentials, email, password);
+    if (!check.ok) {
+        errorMsg = check.errorMsg;
+        return false;
+    }
+
+    completeLogin(email, credentials.passwordHash, check.newHash);
+
+    pseudo = credentials.pseudo;
+    avatar = credentials.avatar;
+    usingTempPassword = check.usingTempPassword;
+    isAnonymous = credentials.isAnonymous;
+    return true;
+}
+
+DatabaseManager::Credentials DatabaseManager::getCredentials(const QString &email)
+{
+    Credentials credentials;
+
     // Récupérer le salt, les hash (permanent et temporaire) et l'avatar pour cet email
-    QSqlQuery query(m_db);
-    query.prepare("SELECT pseudo, password_hash, salt, avatar, temp_password_hash, processing_restricted, restriction_reason, is_anonymous FROM users WHERE email = :email");
+    QSqlQuery &query = cachedQuery("SELECT pseudo, password_hash, salt, avatar, temp_password_hash, processing_restricted, restriction_reason, is_anonymous FROM users WHERE email = :email");
     query.bindValue(":email", email);
 
     if (!query.exec()) {
-        errorMsg = "Erreur lors de la verification: " + query.lastError().text();
-        qCritical() << "[AUTH] Erreur requête SQL email:" << email << "-" << query.lastError().text();
-        return false;
+        credentials.error = query.lastError().text();
+        qCritical() << "[AUTH] Erreur requête SQL email:" << email << "-" << credentials.error;
+        return credentials;
     }
 
-    if (!query.next()) {
-        errorMsg = "Email ou mot de passe incorrect";
-        qWarning() << "[AUTH] Échec - Email non trouvé:" << email;
-        return false;
-    }
+    if (query.next()) {
+        credentials.found = true;
+        credentials.pseudo = query.value(0).toString();
+        credentials.passwordHash = query.value(1).toString();
+        credentials.salt = query.value(2).toString();
+        credentials.avatar = query.value(3).toString();
+        credentials.tempPasswordHash = query.value(4).toString();
+        credentials.restricted = query.value(5).toBool();
+        credentials.restrictionReason = query.value(6).toString();
+        credentials.isAnonymous = query.value(7).toBool();
+    }
+    query.finish();
+    return credentials;
+}
+
+DatabaseManager::PasswordCheck DatabaseManager::checkPassword(const Credentials &credentials, const QString &email, const QString &password)
+{
+    PasswordCheck check;
 
-    QString storedPseudo = query.value(0).toString();
-    QString storedHash = query.value(1).toString();
-    QString salt = query.value(2).toString();
-    QString storedAvatar = query.value(3).toString();
-    QString tempPasswordHash = query.value(4).toString();
+    if (!credentials.error.isEmpty()) {
+        check.errorMsg = "Erreur lors de la verification: " + credentials.error;
+        return check;
+    }
 
-    // Hasher le mot de passe fourni avec le salt
-    QString providedHash = hashPassword(password, salt);
+    if (!credentials.found) {
+        check.errorMsg = "Email ou mot de passe incorrect";
+        qWarning() << "[AUTH] Échec - Email non trouvé:" << email;
+        return check;
+    }
 
     // Vérifier d'abord le mot de passe permanent
-    if (providedHash == storedHash) {
-        // Mot de passe permanent correct
-        usingTempPassword = false;
+    PasswordHasher::Verification permanent = PasswordHasher::verify(password, credentials.salt, credentials.passwordHash);
+    if (permanent.ok) {
+        // Mot de passe permanent correct : recalculer le hash s'il est à l'ancien format
+        check.usingTempPassword = false;
+        if (permanent.needsRehash) {
+            check.newHash = PasswordHasher::hash(password, credentials.salt);
+        }
     }
     // Si le mot de passe permanent ne correspond pas, vérifier le mot de passe temporaire
-    else if (!tempPasswordHash.isEmpty() && providedHash == tempPasswordHash) {
+    else if (PasswordHasher::verify(password, credentials.salt, credentials.tempPasswordHash).ok) {
         // Mot de passe temporaire correct
-        usingTempPassword = true;
+        check.usingTempPassword = true;
         qDebug() << "Authentification avec mot de passe temporaire pour:" << email;
     }
     else {
         // Aucun des deux mots de passe ne correspond
-        errorMsg = "Email ou mot de passe incorrect";
+        check.errorMsg = "Email ou mot de passe incorrect";
         // IMPORTANT: L'email est loggé pour détecter les tentatives de brute force
         // Rotation des logs recommandée : 30 jours max (voir script backup_db.sh)
         qWarning() << "[AUTH] Échec - Mot de passe incorrect pour email:" << email;
-        return false;
+        return check;
     }
 
     // Vérifier si le compte est restreint (RGPD - droit à la limitation du traitement)
-    bool isRestricted = query.value(5).toBool();
-    if (isRestricted) {
-        QString reason = query.value(6).toString();
-        errorMsg = "Votre compte est temporairement restreint. Raison : " + reason + ". Contactez-nous pour plus d'informations.";
-        qWarning() << "[AUTH] Connexion bloquée - Compte restreint - email:" << email << "raison:" << reason;
-        return false;
+    if (credentials.restricted) {
+        check.errorMsg = "Votre compte est temporairement restreint. Raison : " + credentials.restrictionReason + ". Contactez-nous pour plus d'informations.";
+        qWarning() << "[AUTH] Connexion bloquée - Compte restreint - email:" << email << "raison:" << credentials.restrictionReason;
+        return check;
     }
 
+    check.ok = true;
+    qInfo() << "[AUTH] SUCCÈS - Authentification réussie - pseudo:" << credentials.pseudo << "anonymous:" << credentials.isAnonymous;
+    return check;
+}
+
+void DatabaseManager::completeLogin(const QString &email, const QString &previousHash, const QString &newHash)
+{
     // Mettre à jour la date de dernière connexion
-    QSqlQuery updateQuery(m_db);
-    updateQuery.prepare("UPDATE users SET last_login = CURRENT_TIMESTAMP WHERE email = :email");
+    QSqlQuery &updateQuery = cachedQuery("UPDATE users SET last_login = CURRENT_TIMESTAMP WHERE email = :email");
     updateQuery.bindValue(":email", email);
     if (!updateQuery.exec()) {
         qWarning() << "[AUTH] Erreur update last_login:" << updateQuery.lastError().text();
     }
 
-    pseudo = storedPseudo;
-    avatar = storedAvatar;
-    isAnonymous = query.value(7).toBool();
-    qInfo() << "[AUTH] SUCCÈS - Authentification réussie - pseudo:" << pseudo << "anonymous:" << isAnonymous;
-    return true;
+    if (newHash.isEmpty()) {
+        return;
+    }
+
+    // Le mot de passe a pu changer depuis la lecture des identifiants : ne pas l'écraser
+    QSqlQuery &rehashQuery = cachedQuery("UPDATE users SET password_hash = :new_hash WHERE email = :email AND password_hash = :previous_hash");
+    rehashQuery.bindValue(":new_hash", newHash);
+    rehashQuery.bindValue(":email", email);
+    rehashQuery.bindValue(":previous_hash", previousHash);
+    if (!rehashQuery.exec()) {
+        qWarning() << "[AUTH] Erreur mise à jour du hash:" << rehashQuery.lastError().text();
+    } else if (rehashQuery.numRowsAffected() > 0) {
+        qInfo() << "[AUTH] Hash du mot de passe mis à jour (PBKDF2) pour:" << email;
+    }
 }
 
 int DatabaseManager::getUserIdByPseudo(const QString &pseudo)
 {
-    QSqlQuery query(m_db);
-    query.prepare("SELECT id FROM users WHERE pseudo = :pseudo");
+    QSqlQuery &query = cachedQuery("SELECT id FROM users WHERE pseudo = :pseudo");
     query.bindValue(":pseudo", pseudo);
 
     if (!query.exec()) {
@@ -724,11 +870,9 @@ int DatabaseManager::getUserIdByPseudo(const QString &pseudo)
         return -1;
     }
 
-    if (query.next()) {
-        return query.value(0).toInt();
-    }
-
-    return -1;
+    int userId = query.next() ? query.value(0).toInt() : -1;
+    query.finish();
+    return userId;
 }
 
 bool DatabaseManager::updateGameStats(const QString &pseudo, bool won)
@@ -739,24 +883,25 @@ bool DatabaseManager::updateGameStats(const QString &pseudo, bool won)
         return false;
     }
 
-    QSqlQuery query(m_db);
+    const char *sql = nullptr;
 
     if (won) {
         // Victoire : incrémenter games_played, games_won, current_win_streak
         // et mettre à jour max_win_streak si nécessaire
-        query.prepare("UPDATE stats SET "
-                     "games_played = games_played + 1, "
-                     "games_won = games_won + 1, "
-                     "current_win_streak = current_win_streak + 1, "
-                     "max_win_streak = CASE WHEN (current_win_streak + 1) > max_win_streak THEN (current_win_streak + 1) ELSE max_win_streak END "
-                     "WHERE user_id = :user_id");
+        sql = "UPDATE stats SET "
+              "games_played = games_played + 1, "
+              "games_won = games_won + 1, "
+              "current_win_streak = current_win_streak + 1, "
+              "max_win_streak = CASE WHEN (current_win_streak + 1) > max_win_streak THEN (current_win_streak + 1) ELSE max_win_streak END "
+              "WHERE user_id = :user_id";
     } else {
         // Défaite : incrémenter games_played et réinitialiser current_win_streak
-        query.prepare("UPDATE stats SET "
-                     "games_played = games_played + 1, "
-                     "current_win_streak = 0 "
-                     "WHERE user_id = :user_id");
+        sql = "UPDATE stats SET "
+              "games_played = games_played + 1, "
+              "current_win_streak = 0 "
+              "WHERE user_id = :user_id";
     }
+    QSqlQuery &query = cachedQuery(sql);
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -776,8 +921,7 @@ bool DatabaseManager::cancelDefeat(const QString &pseudo)
         return false;
     }
 
-    QSqlQuery query(m_db);
-    query.prepare("UPDATE stats SET games_played = games_played - 1 WHERE user_id = :user_id AND games_played > 0");
+    QSqlQuery &query = cachedQuery("UPDATE stats SET games_played = games_played - 1 WHERE user_id = :user_id AND games_played > 0");
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -797,20 +941,21 @@ bool DatabaseManager::updateCoincheStats(const QString &pseudo, bool attempt, bo
         return false;
     }
 
-    QSqlQuery query(m_db);
+    const char *sql = nullptr;
     if (attempt && success) {
         // Nouvelle tentative réussie
-        query.prepare("UPDATE stats SET coinche_attempts = coinche_attempts + 1, coinche_success = coinche_success + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET coinche_attempts = coinche_attempts + 1, coinche_success = coinche_success + 1 WHERE user_id = :user_id";
     } else if (attempt && !success) {
         // Nouvelle tentative échouée
-        query.prepare("UPDATE stats SET coinche_attempts = coinche_attempts + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET coinche_attempts = coinche_attempts + 1 WHERE user_id = :user_id";
     } else if (!attempt && success) {
         // Marquer une coinche existante comme réussie (sans incrémenter les tentatives)
-        query.prepare("UPDATE stats SET coinche_success = coinche_success + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET coinche_success = coinche_success + 1 WHERE user_id = :user_id";
     } else {
         // attempt = false, success = false : rien à faire
         return true;
     }
+    QSqlQuery &query = cachedQuery(sql);
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -832,8 +977,7 @@ DatabaseManager::PlayerStats DatabaseManager::getPlayerStats(const QString &pseu
         return stats;
     }
 
-    QSqlQuery query(m_db);
-    query.prepare("SELECT games_played, games_won, coinche_attempts, coinche_success, capot_realises, capot_annonces_realises, capot_annonces_tentes, generale_attempts, generale_success, annonces_coinchees, annonces_coinchees_gagnees, surcoinche_attempts, surcoinche_success, annonces_surcoinchees, annonces_surcoinchees_gagnees, max_win_streak, belote_games_played, belote_games_won, belote_max_win_streak, belote_capots FROM stats WHERE user_id = :user_id");
+    QSqlQuery &query = cachedQuery("SELECT games_played, games_won, coinche_attempts, coinche_success, capot_realises, capot_annonces_realises, capot_annonces_tentes, generale_attempts, generale_success, annonces_coinchees, annonces_coinchees_gagnees, surcoinche_attempts, surcoinche_success, annonces_surcoinchees, annonces_surcoinchees_gagnees, max_win_streak, belote_games_played, belote_games_won, belote_max_win_streak, belote_capots FROM stats WHERE user_id = :user_id");
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -867,6 +1011,7 @@ DatabaseManager::PlayerStats DatabaseManager::getPlayerStats(const QString &pseu
             stats.winRatio = (double)stats.gamesWon / (double)stats.gamesPlayed;
         }
     }
+    query.finish();
 
     return stats;
 }
@@ -879,24 +1024,25 @@ bool DatabaseManager::updateBeloteGameStats(const QString &pseudo, bool won, boo
         return false;
     }
 
-    QSqlQuery query(m_db);
+    const char *sql = nullptr;
     if (won) {
-        query.prepare(
+        sql =
             "UPDATE stats SET "
             "belote_games_played = belote_games_played + 1, "
             "belote_games_won = belote_games_won + 1, "
             "belote_current_win_streak = belote_current_win_streak + 1, "
             "belote_max_win_streak = MAX(belote_max_win_streak, belote_current_win_streak + 1), "
             "belote_capots = belote_capots + :capot "
-            "WHERE user_id = :user_id");
+            "WHERE user_id = :user_id";
     } else {
-        query.prepare(
+        sql =
             "UPDATE stats SET "
             "belote_games_played = belote_games_played + 1, "
             "belote_current_win_streak = 0, "
             "belote_capots = belote_capots + :capot "
-            "WHERE user_id = :user_id");
+            "WHERE user_id = :user_id";
     }
+    QSqlQuery &query = cachedQuery(sql);
     query.bindValue(":capot", capot ? 1 : 0);
     query.bindValue(":user_id", userId);
 
@@ -915,14 +1061,15 @@ bool DatabaseManager::updateCapotStats(const QString &pseudo, bool annonceCapot)
         return false;
     }
 
-    QSqlQuery query(m_db);
+    const char *sql = nullptr;
     if (annonceCapot) {
         // Capot annoncé et réalisé
-        query.prepare("UPDATE stats SET capot_realises = capot_realises + 1, capot_annonces_realises = capot_annonces_realises + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET capot_realises = capot_realises + 1, capot_annonces_realises = capot_annonces_realises + 1 WHERE user_id = :user_id";
     } else {
         // Capot réalisé sans annonce
-        query.prepare("UPDATE stats SET capot_realises = capot_realises + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET capot_realises = capot_realises + 1 WHERE user_id = :user_id";
     }
+    QSqlQuery &query = cachedQuery(sql);
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -942,8 +1089,7 @@ bool DatabaseManager::updateCapotAnnonceTente(const QString &pseudo)
         return false;
     }
 
-    QSqlQuery query(m_db);
-    query.prepare("UPDATE stats SET capot_annonces_tentes = capot_annonces_tentes + 1 WHERE user_id = :user_id");
+    QSqlQuery &query = cachedQuery("UPDATE stats SET capot_annonces_tentes = capot_annonces_tentes + 1 WHERE user_id = :user_id");
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -963,12 +1109,13 @@ bool DatabaseManager::updateGeneraleStats(const QString &pseudo, bool success)
         return false;
     }
 
-    QSqlQuery query(m_db);
+    const char *sql = nullptr;
     if (success) {
-        query.prepare("UPDATE stats SET generale_attempts = generale_attempts + 1, generale_success = generale_success + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET generale_attempts = generale_attempts + 1, generale_success = generale_success + 1 WHERE user_id = :user_id";
     } else {
-        query.prepare("UPDATE stats SET generale_attempts = generale_attempts + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET generale_attempts = generale_attempts + 1 WHERE user_id = :user_id";
     }
+    QSqlQuery &query = cachedQuery(sql);
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -988,14 +1135,15 @@ bool DatabaseManager::updateAnnonceCoinchee(const QString &pseudo, bool won)
         return false;
     }
 
-    QSqlQuery query(m_db);
+    const char *sql = nullptr;
     if (won) {
         // L'annonce a été coinchée mais le joueur a quand même gagné la manche
-        query.prepare("UPDATE stats SET annonces_coinchees = annonces_coinchees + 1, annonces_coinchees_gagnees = annonces_coinchees_gagnees + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET annonces_coinchees = annonces_coinchees + 1, annonces_coinchees_gagnees = annonces_coinchees_gagnees + 1 WHERE user_id = :user_id";
     } else {
         // L'annonce a été coinchée et le joueur a perdu la manche
-        query.prepare("UPDATE stats SET annonces_coinchees = annonces_coinchees + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET annonces_coinchees = annonces_coinchees + 1 WHERE user_id = :user_id";
     }
+    QSqlQuery &query = cachedQuery(sql);
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -1015,20 +1163,21 @@ bool DatabaseManager::updateSurcoincheStats(const QString &pseudo, bool attempt,
         return false;
     }
 
-    QSqlQuery query(m_db);
+    const char *sql = nullptr;
     if (attempt && success) {
         // Nouvelle tentative réussie
-        query.prepare("UPDATE stats SET surcoinche_attempts = surcoinche_attempts + 1, surcoinche_success = surcoinche_success + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET surcoinche_attempts = surcoinche_attempts + 1, surcoinche_success = surcoinche_success + 1 WHERE user_id = :user_id";
     } else if (attempt && !success) {
         // Nouvelle tentative échouée
-        query.prepare("UPDATE stats SET surcoinche_attempts = surcoinche_attempts + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET surcoinche_attempts = surcoinche_attempts + 1 WHERE user_id = :user_id";
     } else if (!attempt && success) {
         // Marquer une surcoinche existante comme réussie (sans incrémenter les tentatives)
-        query.prepare("UPDATE stats SET surcoinche_success = surcoinche_success + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET surcoinche_success = surcoinche_success + 1 WHERE user_id = :user_id";
     } else {
         // attempt = false, success = false : rien à faire
         return true;
     }
+    QSqlQuery &query = cachedQuery(sql);
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -1048,14 +1197,15 @@ bool DatabaseManager::updateAnnonceSurcoinchee(const QString &pseudo, bool won)
         return false;
     }
 
-    QSqlQuery query(m_db);
+    const char *sql = nullptr;
     if (won) {
         // L'annonce a été surcoinchée mais le joueur a quand même gagné la manche
-        query.prepare("UPDATE stats SET annonces_surcoinchees = annonces_surcoinchees + 1, annonces_surcoinchees_gagnees = annonces_surcoinchees_gagnees + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET annonces_surcoinchees = annonces_surcoinchees + 1, annonces_surcoinchees_gagnees = annonces_surcoinchees_gagnees + 1 WHERE user_id = :user_id";
     } else {
         // L'annonce a été surcoinchée et le joueur a perdu la manche
-        query.prepare("UPDATE stats SET annonces_surcoinchees = annonces_surcoinchees + 1 WHERE user_id = :user_id");
+        sql = "UPDATE stats SET annonces_surcoinchees = annonces_surcoinchees + 1 WHERE user_id = :user_id";
     }
+    QSqlQuery &query = cachedQuery(sql);
     query.bindValue(":user_id", userId);
 
     if (!query.exec()) {
@@ -1067,6 +1217,205 @@ bool DatabaseManager::updateAnnonceSurcoinchee(const QString &pseudo, bool won)
     return true;
 }
 
+bool DatabaseManager::StatsDelta::isEmpty() const
+{
+    return partie == AUCUNE && partieBelote == AUCUNE && beloteCapots == 0
+        && coincheAttempts == 0 && coincheSuccess == 0
+        && surcoincheAttempts == 0 && surcoincheSuccess == 0
+        && annoncesCoinchees == 0 && annoncesCoincheesGagnees == 0
+        && annoncesSurcoinchees == 0 && annoncesSurcoincheesGagnees == 0
+        && capotRealises == 0 && capotAnnoncesRealises == 0 && capotAnnoncesTentes == 0
+        && generaleAttempts == 0 && generaleSuccess == 0;
+}
+
+bool DatabaseManager::applyStatsDeltas(const QHash<QString, StatsDelta> &deltas)
+{
+    if (deltas.isEmpty()) {
+        return true;
+    }
+
+    // Les CASE lisent les valeurs d'avant l'UPDATE (sémantique SQLite),
+    // comme updateGameStats / updateBeloteGameStats
+    QSqlQuery &query = cachedQuery(
+        "UPDATE stats SET "
+        "games_played = games_played + :games_played, "
+        "games_won = games_won + :games_won, "
+        "current_win_streak = CASE :partie_serie WHEN 1 THEN current_win_streak + 1 WHEN 2 THEN 0 ELSE current_win_streak END, "
+        "max_win_streak = CASE WHEN :partie_max = 1 THEN MAX(max_win_streak, current_win_streak + 1) ELSE max_win_streak END, "
+        "belote_games_played = belote_games_played + :belote_games_played, "
+        "belote_games_won = belote_games_won + :belote_games_won, "
+        "belote_current_win_streak = CASE :belote_serie WHEN 1 THEN belote_current_win_streak + 1 WHEN 2 THEN 0 ELSE belote_current_win_streak END, "
+        "belote_max_win_streak = CASE WHEN :belote_max = 1 THEN MAX(belote_max_win_streak, belote_current_win_streak + 1) ELSE belote_max_win_streak END, "
+        "belote_capots = belote_capots + :belote_capots, "
+        "coinche_attempts = coinche_attempts + :coinche_attempts, "
+        "coinche_success = coinche_success + :coinche_success, "
+        "surcoinche_attempts = surcoinche_attempts + :surcoinche_attempts, "
+        "surcoinche_success = surcoinche_success + :surcoinche_success, "
+        "annonces_coinchees = annonces_coinchees + :annonces_coinchees, "
+        "annonces_coinchees_gagnees = annonces_coinchees_gagnees + :annonces_coinchees_gagnees, "
+        "annonces_surcoinchees = annonces_surcoinchees + :annonces_surcoinchees, "
+        "annonces_surcoinchees_gagnees = annonces_surcoinchees_gagnees + :annonces_surcoinchees_gagnees, "
+        "capot_realises = capot_realises + :capot_realises, "
+        "capot_annonces_realises = capot_annonces_realises + :capot_annonces_realises, "
+        "capot_annonces_tentes = capot_annonces_tentes + :capot_annonces_tentes, "
+        "generale_attempts = generale_attempts + :generale_attempts, "
+        "generale_success = generale_success + :generale_success "
+        "WHERE user_id = (SELECT id FROM users WHERE pseudo = :pseudo)");
+
+    if (!m_db.transaction()) {
+        qCritical() << "Erreur ouverture transaction stats:" << m_db.lastError().text();
+        return false;
+    }
+
+    for (auto it = deltas.constBegin(); it != deltas.constEnd(); ++it) {
+        const StatsDelta &delta = it.value();
+        if (delta.isEmpty()) continue;
+
+        query.bindValue(":games_played", delta.partie != StatsDelta::AUCUNE ? 1 : 0);
+        query.bindValue(":games_won", delta.partie == StatsDelta::VICTOIRE ? 1 : 0);
+        query.bindValue(":partie_serie", static_cast<int>(delta.partie));
+        query.bindValue(":partie_max", static_cast<int>(delta.partie));
+        query.bindValue(":belote_games_played", delta.partieBelote != StatsDelta::AUCUNE ? 1 : 0);
+        query.bindValue(":belote_games_won", delta.partieBelote == StatsDelta::VICTOIRE ? 1 : 0);
+        query.bindValue(":belote_serie", static_cast<int>(delta.partieBelote));
+        query.bindValue(":belote_max", static_cast<int>(delta.partieBelote));
+        query.bindValue(":belote_capots", delta.beloteCapots);
+        query.bindValue(":coinche_attempts", delta.coincheAttempts);
+        query.bindValue(":coinche_success", delta.coincheSuccess);
+        query.bindValue(":surcoinche_attempts", delta.surcoincheAttempts);
+        query.bindValue(":surcoinche_success", delta.surcoincheSuccess);
+        query.bindValue(":annonces_coinchees", delta.annoncesCoinchees);
+        query.bindValue(":annonces_coinchees_gagnees", delta.annoncesCoincheesGagnees);
+        query.bindValue(":annonces_surcoinchees", delta.annoncesSurcoinchees);
+        query.bindValue(":annonces_surcoinchees_gagnees", delta.annoncesSurcoincheesGagnees);
+        query.bindValue(":capot_realises", delta.capotRealises);
+        query.bindValue(":capot_annonces_realises", delta.capotAnnoncesRealises);
+        query.bindValue(":capot_annonces_tentes", delta.capotAnnoncesTentes);
+        query.bindValue(":generale_attempts", delta.generaleAttempts);
+        query.bindValue(":generale_success", delta.generaleSuccess);
+        query.bindValue(":pseudo", it.key());
+
+        if (!query.exec()) {
+            qCritical() << "Erreur application stats de manche pour" << it.key() << ":" << query.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+        if (query.numRowsAffected() == 0) {
+            // Compte supprimé entre-temps : on n'annule pas les stats des autres joueurs
+            qWarning() << "Utilisateur non trouve pour stats de manche:" << it.key();
+        }
+    }
+
+    if (!m_db.commit()) {
+        qCritical() << "Erreur commit stats de manche:" << m_db.lastError().text();
+        m_db.rollback();
+        return false;
+    }
+
+    qDebug() << "Stats de manche appliquees pour" << deltas.size() << "joueur(s)";
+    return true;
+}
+
+QList<DatabaseManager::PlayerRating> DatabaseManager::getAllRatings(const QString &mode)
+{
+    QList<PlayerRating> ratings;
+    QSqlQuery query(m_db);
+    query.prepare("SELECT u.pseudo, r.rating, r.rd, r.volatility, r.games, COALESCE(u.is_anonymous, 0) "
+                  "FROM ratings r JOIN users u ON u.id = r.user_id WHERE r.mode = :mode");
+    query.bindValue(":mode", mode);
+
+    if (!query.exec()) {
+        qWarning() << "Erreur chargement cotes" << mode << ":" << query.lastError().text();
+        return ratings;
+    }
+
+    while (query.next()) {
+        ratings.append(PlayerRating{
+            query.value(0).toString(),
+            query.value(1).toDouble(),
+            query.value(2).toDouble(),
+            query.value(3).toDouble(),
+            query.value(4).toInt(),
+            query.value(5).toBool()
+        });
+    }
+    qDebug() << "Cotes" << mode << "chargees:" << ratings.size();
+    return ratings;
+}
+
+DatabaseManager::RatingsSave DatabaseManager::rateGame(const QString &mode, const std::array<RatedSeat, 4> &seats)
+{
+    RatingsSave result;
+    if (!m_db.transaction()) {
+        qCritical() << "Erreur ouverture transaction cotes:" << m_db.lastError().text();
+        return result;
+    }
+
+    // Cotes en base : un autre serveur a pu les changer depuis leur chargement
+    std::array<Glicko2::Rating, 4> places;
+    QSqlQuery &lecture = cachedQuery(
+        "SELECT r.rating, r.rd, r.volatility, r.games FROM ratings r JOIN users u ON u.id = r.user_id "
+        "WHERE u.pseudo = :pseudo AND r.mode = :mode");
+    for (int i = 0; i < 4; i++) {
+        places[i] = seats[i].rating;
+        if (seats[i].pseudo.isEmpty()) continue;
+        lecture.bindValue(":pseudo", seats[i].pseudo);
+        lecture.bindValue(":mode", mode);
+        if (!lecture.exec()) {
+            qCritical() << "Erreur lecture cote pour" << seats[i].pseudo << ":" << lecture.lastError().text();
+            m_db.rollback();
+            return result;
+        }
+        if (lecture.next()) {
+            places[i] = {lecture.value(0).toDouble(), lecture.value(1).toDouble(),
+                         lecture.value(2).toDouble(), lecture.value(3).toInt()};
+        }
+        lecture.finish();
+    }
+
+    std::array<double, 4> scores;
+    for (int i = 0; i < 4; i++) scores[i] = seats[i].score;
+    const std::array<Glicko2::Rating, 4> apres = Glicko2::rateTeamGame(places, scores);
+    QSqlQuery &query = cachedQuery(
+        "INSERT INTO ratings (user_id, mode, rating, rd, volatility, games, updated_at) "
+        "SELECT id, :mode, :rating, :rd, :volatility, :games, CURRENT_TIMESTAMP FROM users WHERE pseudo = :pseudo "
+        "ON CONFLICT(user_id, mode) DO UPDATE SET rating = excluded.rating, rd = excluded.rd, "
+        "volatility = excluded.volatility, games = excluded.games, updated_at = excluded.updated_at");
+
+    for (int i = 0; i < 4; i++) {
+        const RatedSeat &seat = seats[i];
+        if (seat.pseudo.isEmpty()) continue;
+        query.bindValue(":mode", mode);
+        query.bindValue(":rating", apres[i].rating);
+        query.bindValue(":rd", apres[i].rd);
+        query.bindValue(":volatility", apres[i].volatility);
+        query.bindValue(":games", apres[i].games);
+        query.bindValue(":pseudo", seat.pseudo);
+
+        if (!query.exec()) {
+            // Aussi quand un autre serveur a écrit depuis notre lecture (WAL) : rien n'est écrit
+            qCritical() << "Erreur enregistrement cote pour" << seat.pseudo << ":" << query.lastError().text();
+            m_db.rollback();
+            result.saved.clear();
+            return result;
+        }
+        // Invité ou compte supprimé : pas de ligne
+        if (query.numRowsAffected() > 0) {
+            result.saved.append(PlayerRating{seat.pseudo, apres[i].rating, apres[i].rd, apres[i].volatility,
+                                             apres[i].games, seat.isAnonymous});
+        }
+    }
+
+    if (!m_db.commit()) {
+        qCritical() << "Erreur commit cotes:" << m_db.lastError().text();
+        m_db.rollback();
+        result.saved.clear();
+        return result;
+    }
+    result.ok = true;
+    return result;
+}
+
 bool DatabaseManager::deleteAccount(const QString &pseudo, QString &errorMsg)
 {
     if (pseudo.isEmpty()) {
@@ -1108,6 +1457,14 @@ bool DatabaseManager::deleteAccount(const QString &pseudo, QString &errorMsg)
         qInfo() << "[DELETE_ACCOUNT] Friends supprimés - rows:" << deleteFriendsQuery.numRowsAffected();
     }
 
+    // Supprimer les cotes (table ratings)
+    QSqlQuery deleteRatingsQuery(m_db);
+    deleteRatingsQuery.prepare("DELETE FROM ratings WHERE user_id = :user_id");
+    deleteRatingsQuery.bindValue(":user_id", userId);
+    if (!deleteRatingsQuery.exec()) {
+        qWarning() << "[DELETE_ACCOUNT] Erreur suppression ratings pour userId:" << userId << "-" << deleteRatingsQuery.lastError().text();
+    }
+
     // Supprimer d'abord les statistiques (table stats)
     QSqlQuery deleteStatsQuery(m_db);
     deleteStatsQuery.prepare("DELETE FROM stats WHERE user_id = :user_id");
@@ -1177,23 +1534,31 @@ bool DatabaseManager::setTempPassword(const QString &email, QString &tempPasswor
 
     QString salt = getSaltQuery.value(0).toString();
 
-    // Générer le mot de passe temporaire
+    // Générer le mot de passe temporaire et le hasher avec le salt existant
     tempPassword = generateTempPassword();
+    return setTempPasswordHash(email, PasswordHasher::hash(tempPassword, salt), salt, errorMsg);
+}
 
-    // Hasher le mot de passe temporaire avec le salt existant
-    QString tempPasswordHash = hashPassword(tempPassword, salt);
-
-    // Mettre à jour la base de données
+bool DatabaseManager::setTempPasswordHash(const QString &email, const QString &tempPasswordHash,
+                                          const QString &salt, QString &errorMsg)
+{
+    // Le salt doit être celui du compte : s'il a changé depuis le hachage, le hash est inutilisable
     QSqlQuery query(m_db);
-    query.prepare("UPDATE users SET temp_password_hash = :temp_hash, temp_password_created = CURRENT_TIMESTAMP WHERE email = :email");
+    query.prepare("UPDATE users SET temp_password_hash = :temp_hash, temp_password_created = CURRENT_TIMESTAMP "
+                  "WHERE email = :email AND salt = :salt");
     query.bindValue(":temp_hash", tempPasswordHash);
     query.bindValue(":email", email);
+    query.bindValue(":salt", salt);
 
     if (!query.exec()) {
         errorMsg = "Erreur lors de la génération du mot de passe temporaire: " + query.lastError().text();
         qCritical() << "Erreur setTempPassword:" << query.lastError().text();
         return false;
     }
+    if (query.numRowsAffected() == 0) {
+        errorMsg = "Compte non trouvé ou mot de passe modifié entre-temps";
+        return false;
+    }
 
     qDebug() << "Mot de passe temporaire généré pour:" << email;
     return true;
@@ -1225,8 +1590,20 @@ bool DatabaseManager::updatePassword(const QString &email, const QString &newPas
     }
 
     // Valider le nouveau mot de passe
-    if (newPassword.length() < 8) {
-        errorMsg = "Le mot de passe doit contenir au moins 8 caractères";
+    if (!validatePassword(newPassword, errorMsg)) {
+        return false;
+    }
+
+    // Générer un nouveau salt et hasher le nouveau mot de passe
+    QString salt = PasswordHasher::generateSalt();
+    return updatePasswordHash(email, PasswordHasher::hash(newPassword, salt), salt, errorMsg);
+}
+
+bool DatabaseManager::updatePasswordHash(const QString &email, const QString &passwordHash,
+                                         const QString &salt, QString &errorMsg)
+{
+    if (email.isEmpty() || passwordHash.isEmpty()) {
+        errorMsg = "Email et nouveau mot de passe requis";
         return false;
     }
 
@@ -1236,10 +1613,6 @@ bool DatabaseManager::updatePassword(const QString &email, const QString &newPas
         return false;
     }
 
-    // Générer un nouveau salt et hasher le nouveau mot de passe
-    QString salt = generateSalt();
-    QString passwordHash = hashPassword(newPassword, salt);
-
     // Mettre à jour le mot de passe permanent et effacer le mot de passe temporaire
     QSqlQuery query(m_db);
     query.prepare("UPDATE users SET password_hash = :password_hash, salt = :salt, temp_password_hash = NULL, temp_password_created = NULL WHERE email = :email");
@@ -1412,102 +1785,149 @@ bool DatabaseManager::setAnonymous(const QString &pseudo, bool anonymous, QStrin
 
 bool DatabaseManager::recordLogin(const QString &pseudo)
 {
-    QString today = QDate::currentDate().toString("yyyy-MM-dd");
-
-    // S'assurer que l'entrée du jour existe
-    QSqlQuery checkQuery(m_db);
-    checkQuery.prepare("SELECT id FROM daily_stats WHERE date = :date");
-    checkQuery.bindValue(":date", today);
-
-    if (!checkQuery.exec()) {
-        qWarning() << "Erreur verif daily_stats:" << checkQuery.lastError().text();
-        return false;
-    }
-
-    if (!checkQuery.next()) {
-        // Créer l'entrée du jour
-        QSqlQuery insertQuery(m_db);
-        insertQuery.prepare("INSERT INTO daily_stats (date, logins) VALUES (:date, 1)");
-        insertQuery.bindValue(":date", today);
+    countDaily(LOGINS);
+    qDebug() << "Login enregistré pour:" << pseudo;
+    return true;
+}
 
-        if (!insertQuery.exec()) {
-            qWarning() << "Erreur creation daily_stats:" << insertQuery.lastError().text();
-            return false;
-        }
-    } else {
-        // Incrémenter le compteur de logins
-        QSqlQuery updateQuery(m_db);
-        updateQuery.prepare("UPDATE daily_stats SET logins = logins + 1 WHERE date = :date");
-        updateQuery.bindValue(":date", today);
+bool DatabaseManager::recordGameRoomCreated()
+{
+    countDaily(GAME_ROOMS_CREATED);
+    return true;
+}
 
-        if (!updateQuery.exec()) {
-            qWarning() << "Erreur update logins:" << updateQuery.lastError().text();
-            return false;
-        }
-    }
+bool DatabaseManager::recordNewAccount()
+{
+    countDaily(NEW_ACCOUNTS);
+    return true;
+}
 
-    qDebug() << "Login enregistré pour:" << pseudo << "à la date:" << today;
+bool DatabaseManager::recordPlayerQuit()
+{
+    countDaily(PLAYER_QUITS);
     return true;
 }
 
-bool DatabaseManager::recordGameRoomCreated()
+void DatabaseManager::countDaily(CompteurJour compteur, int n)
 {
     QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    if (today != m_dailyCountersDate) {
+        // Changement de jour : la veille est écrite tout de suite si possible, sinon
+        // au prochain flush, sans jamais y mêler les événements du jour
+        rollDailyCounters(today);
+        flushDailyCounters();
+    }
+    m_dailyCounters[compteur].fetch_add(n, std::memory_order_relaxed);
+}
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO daily_stats (date, game_rooms_created) VALUES (:date, 1)
-        ON CONFLICT(date) DO UPDATE SET game_rooms_created = game_rooms_created + 1
-    )");
-    query.bindValue(":date", today);
-
-    if (!query.exec()) {
-        qWarning() << "Erreur recordGameRoomCreated:" << query.lastError().text();
-        return false;
+void DatabaseManager::rollDailyCounters(const QString &jour)
+{
+    if (jour == m_dailyCountersDate) {
+        return;
     }
 
-    qDebug() << "GameRoom créée enregistrée pour:" << today;
-    return true;
+    if (!m_dailyCountersDate.isEmpty()) {
+        std::array<int, NB_COMPTEURS_JOUR> valeurs;
+        bool vide = true;
+        for (int i = 0; i < NB_COMPTEURS_JOUR; i++) {
+            valeurs[i] = m_dailyCounters[i].exchange(0, std::memory_order_relaxed);
+            if (valeurs[i] != 0) vide = false;
+        }
+        if (!vide) {
+            auto it = m_pendingDailyCounters.find(m_dailyCountersDate);
+            if (it == m_pendingDailyCounters.end()) {
+                m_pendingDailyCounters.insert(m_dailyCountersDate, valeurs);
+            } else {
+                for (int i = 0; i < NB_COMPTEURS_JOUR; i++) (*it)[i] += valeurs[i];
+            }
+        }
+    }
+    m_dailyCountersDate = jour;
 }
 
-bool DatabaseManager::recordNewAccount()
+bool DatabaseManager::writeDailyCounters(const QString &date, const std::array<int, NB_COMPTEURS_JOUR> &valeurs)
 {
-    QString today = QDate::currentDate().toString("yyyy-MM-dd");
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO daily_stats (date, new_accounts) VALUES (:date, 1)
-        ON CONFLICT(date) DO UPDATE SET new_accounts = new_accounts + 1
+    QSqlQuery &query = cachedQuery(R"(
+        INSERT INTO daily_stats (date, logins, game_rooms_created, new_accounts, player_quits, crashes, total_session_time, session_count)
+        VALUES (:date, :logins, :game_rooms_created, :new_accounts, :player_quits, :crashes, :total_session_time, :session_count)
+        ON CONFLICT(date) DO UPDATE SET
+            logins = logins + excluded.logins,
+            game_rooms_created = game_rooms_created + excluded.game_rooms_created,
+            new_accounts = new_accounts + excluded.new_accounts,
+            player_quits = player_quits + excluded.player_quits,
+            crashes = crashes + excluded.crashes,
+            total_session_time = total_session_time + excluded.total_session_time,
+            session_count = session_count + excluded.session_count
     )");
-    query.bindValue(":date", today);
+    query.bindValue(":date", date);
+    query.bindValue(":logins", valeurs[LOGINS]);
+    query.bindValue(":game_rooms_created", valeurs[GAME_ROOMS_CREATED]);
+    query.bindValue(":new_accounts", valeurs[NEW_ACCOUNTS]);
+    query.bindValue(":player_quits", valeurs[PLAYER_QUITS]);
+    query.bindValue(":crashes", valeurs[CRASHES]);
+    query.bindValue(":total_session_time", valeurs[TOTAL_SESSION_TIME]);
+    query.bindValue(":session_count", valeurs[SESSION_COUNT]);
 
     if (!query.exec()) {
-        qWarning() << "Erreur recordNewAccount:" << query.lastError().text();
+        qWarning() << "Erreur flushDailyCounters:" << date << query.lastError().text();
         return false;
     }
-
-    qDebug() << "Nouveau compte enregistré pour:" << today;
+    qDebug() << "Compteurs quotidiens écrits pour:" << date;
     return true;
 }
 
-bool DatabaseManager::recordPlayerQuit()
+bool DatabaseManager::flushDailyCounters()
 {
-    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    if (!m_db.isOpen()) {
+        return true;
+    }
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO daily_stats (date, player_quits) VALUES (:date, 1)
-        ON CONFLICT(date) DO UPDATE SET player_quits = player_quits + 1
-    )");
-    query.bindValue(":date", today);
+    // Jours clos en attente : chacun reste en attente tant que son écriture échoue
+    bool ok = true;
+    for (auto it = m_pendingDailyCounters.begin(); it != m_pendingDailyCounters.end();) {
+        if (writeDailyCounters(it.key(), it.value())) {
+            it = m_pendingDailyCounters.erase(it);
+        } else {
+            ok = false;
+            ++it;
+        }
+    }
 
-    if (!query.exec()) {
-        qWarning() << "Erreur recordPlayerQuit:" << query.lastError().text();
+    if (m_dailyCountersDate.isEmpty()) {
+        return ok;
+    }
+
+    std::array<int, NB_COMPTEURS_JOUR> valeurs;
+    bool vide = true;
+    for (int i = 0; i < NB_COMPTEURS_JOUR; i++) {
+        valeurs[i] = m_dailyCounters[i].exchange(0, std::memory_order_relaxed);
+        if (valeurs[i] != 0) vide = false;
+    }
+    if (vide) {
+        return ok;
+    }
+
+    if (!writeDailyCounters(m_dailyCountersDate, valeurs)) {
+        // Les compteurs seront réécrits au prochain flush
+        for (int i = 0; i < NB_COMPTEURS_JOUR; i++) {
+            m_dailyCounters[i].fetch_add(valeurs[i], std::memory_order_relaxed);
+        }
         return false;
     }
+    return ok;
+}
 
-    qDebug() << "Abandon de partie enregistré pour:" << today;
-    return true;
+void DatabaseManager::startDailyCountersFlush(int intervalMs)
+{
+    if (!m_dailyFlushTimer) {
+        m_dailyFlushTimer = new QTimer(this);
+        connect(m_dailyFlushTimer, &QTimer::timeout, this, [this]() {
+            // Un changement de jour sans événement doit aussi clore la veille
+            rollDailyCounters(QDate::currentDate().toString("yyyy-MM-dd"));
+            flushDailyCounters();
+        });
+    }
+    m_dailyFlushTimer->start(intervalMs);
 }
 
 DatabaseManager::DailyStats DatabaseManager::getDailyStats(const QString &date)
@@ -1524,8 +1944,7 @@ DatabaseManager::DailyStats DatabaseManager::getDailyStats(const QString &date)
     stats.totalSessionTime = 0;
     stats.sessionCount = 0;
 
-    QSqlQuery query(m_db);
-    query.prepare("SELECT logins, game_rooms_created, new_accounts, player_quits, crashes, total_session_time, session_count FROM daily_stats WHERE date = :date");
+    QSqlQuery &query = cachedQuery("SELECT logins, game_rooms_created, new_accounts, player_quits, crashes, total_session_time, session_count FROM daily_stats WHERE date = :date");
     query.bindValue(":date", targetDate);
 
     if (!query.exec()) {
@@ -1542,6 +1961,29 @@ DatabaseManager::DailyStats DatabaseManager::getDailyStats(const QString &date)
         stats.totalSessionTime = query.value(5).toInt();
         stats.sessionCount = query.value(6).toInt();
     }
+    query.finish();
+
+    // Ajouter ce qui n'est pas encore écrit
+    if (targetDate == m_dailyCountersDate) {
+        stats.logins += m_dailyCounters[LOGINS].load(std::memory_order_relaxed);
+        stats.gameRoomsCreated += m_dailyCounters[GAME_ROOMS_CREATED].load(std::memory_order_relaxed);
+        stats.newAccounts += m_dailyCounters[NEW_ACCOUNTS].load(std::memory_order_relaxed);
+        stats.playerQuits += m_dailyCounters[PLAYER_QUITS].load(std::memory_order_relaxed);
+        stats.crashes += m_dailyCounters[CRASHES].load(std::memory_order_relaxed);
+        stats.totalSessionTime += m_dailyCounters[TOTAL_SESSION_TIME].load(std::memory_order_relaxed);
+        stats.sessionCount += m_dailyCounters[SESSION_COUNT].load(std::memory_order_relaxed);
+    }
+    auto enAttente = m_pendingDailyCounters.constFind(targetDate);
+    if (enAttente != m_pendingDailyCounters.constEnd()) {
+        const std::array<int, NB_COMPTEURS_JOUR> &valeurs = enAttente.value();
+        stats.logins += valeurs[LOGINS];
+        stats.gameRoomsCreated += valeurs[GAME_ROOMS_CREATED];
+        stats.newAccounts += valeurs[NEW_ACCOUNTS];
+        stats.playerQuits += valeurs[PLAYER_QUITS];
+        stats.crashes += valeurs[CRASHES];
+        stats.totalSessionTime += valeurs[TOTAL_SESSION_TIME];
+        stats.sessionCount += valeurs[SESSION_COUNT];
+    }
 
     return stats;
 }
@@ -1555,8 +1997,7 @@ DatabaseManager::DailyStats DatabaseManager::getYesterdayStats()
 // Tracking du temps de session - Lightweight (pas de timers)
 bool DatabaseManager::recordSessionStart(const QString &pseudo)
 {
-    QSqlQuery query(m_db);
-    query.prepare("INSERT INTO user_sessions (pseudo, login_time) VALUES (:pseudo, datetime('now'))");
+    QSqlQuery &query = cachedQuery("INSERT INTO user_sessions (pseudo, login_time) VALUES (:pseudo, datetime('now'))");
     query.bindValue(":pseudo", pseudo);
 
     if (!query.exec()) {
@@ -1564,16 +2005,22 @@ bool DatabaseManager::recordSessionStart(const QString &pseudo)
         return false;
     }
 
+    // Rollup pour la rétention (une entrée par joueur et par jour)
+    QSqlQuery &activeQuery = cachedQuery("INSERT OR IGNORE INTO daily_active_users (date, pseudo) VALUES (date('now'), :pseudo)");
+    activeQuery.bindValue(":pseudo", pseudo);
+
+    if (!activeQuery.exec()) {
+        qWarning() << "Erreur mise à jour daily_active_users:" << activeQuery.lastError().text();
+    }
+
     qDebug() << "Session démarrée pour:" << pseudo;
     return true;
 }
 
 bool DatabaseManager::recordSessionEnd(const QString &pseudo)
 {
-    QSqlQuery query(m_db);
-
     // Trouver la session active la plus récente sans logout_time
-    query.prepare("SELECT id, login_time FROM user_sessions WHERE pseudo = :pseudo AND logout_time IS NULL ORDER BY login_time DESC LIMIT 1");
+    QSqlQuery &query = cachedQuery("SELECT id, login_time FROM user_sessions WHERE pseudo = :pseudo AND logout_time IS NULL ORDER BY login_time DESC LIMIT 1");
     query.bindValue(":pseudo", pseudo);
 
     if (!query.exec() || !query.next()) {
@@ -1585,33 +2032,21 @@ bool DatabaseManager::recordSessionEnd(const QString &pseudo)
     QDateTime loginTime = query.value(1).toDateTime();
     QDateTime logoutTime = QDateTime::currentDateTime();
     int duration = loginTime.secsTo(logoutTime);
+    query.finish();
 
     // Mettre à jour la session avec le logout_time et la durée
-    query.prepare("UPDATE user_sessions SET logout_time = datetime('now'), session_duration = :duration WHERE id = :id");
-    query.bindValue(":duration", duration);
-    query.bindValue(":id", sessionId);
+    QSqlQuery &updateQuery = cachedQuery("UPDATE user_sessions SET logout_time = datetime('now'), session_duration = :duration WHERE id = :id");
+    updateQuery.bindValue(":duration", duration);
+    updateQuery.bindValue(":id", sessionId);
 
-    if (!query.exec()) {
-        qWarning() << "Erreur recordSessionEnd:" << query.lastError().text();
+    if (!updateQuery.exec()) {
+        qWarning() << "Erreur recordSessionEnd:" << updateQuery.lastError().text();
         return false;
     }
 
     // Mettre à jour les stats quotidiennes
-    QString today = QDate::currentDate().toString("yyyy-MM-dd");
-    query.prepare(R"(
-        INSERT INTO daily_stats (date, total_session_time, session_count)
-        VALUES (:date, :duration, 1)
-        ON CONFLICT(date) DO UPDATE SET
-            total_session_time = total_session_time + :duration,
-            session_count = session_count + 1
-    )");
-    query.bindValue(":date", today);
-    query.bindValue(":duration", duration);
-
-    if (!query.exec()) {
-        qWarning() << "Erreur mise à jour stats session:" << query.lastError().text();
-        return false;
-    }
+    countDaily(TOTAL_SESSION_TIME, duration);
+    countDaily(SESSION_COUNT);
 
     qDebug() << "Session terminée pour" << pseudo << "- Durée:" << duration << "secondes";
     return true;
@@ -1620,22 +2055,8 @@ bool DatabaseManager::recordSessionEnd(const QString &pseudo)
 // Tracking des crashes
 bool DatabaseManager::recordCrash()
 {
-    QString today = QDate::currentDate().toString("yyyy-MM-dd");
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO daily_stats (date, crashes)
-        VALUES (:date, 1)
-        ON CONFLICT(date) DO UPDATE SET crashes = crashes + 1
-    )");
-    query.bindValue(":date", today);
-
-    if (!query.exec()) {
-        qWarning() << "Erreur recordCrash:" << query.lastError().text();
-        return false;
-    }
-
-    qDebug() << "Crash enregistré pour:" << today;
+    countDaily(CRASHES);
+    qDebug() << "Crash enregistré";
     return true;
 }
 
@@ -1643,70 +2064,55 @@ bool DatabaseManager::recordCrash()
 DatabaseManager::RetentionStats DatabaseManager::getRetentionStats()
 {
     RetentionStats retention;
-    retention.d1Retention = 0.0;
-    retention.d7Retention = 0.0;
-    retention.d30Retention = 0.0;
 
-    QSqlQuery query(m_db);
+    // Dates UTC, comme datetime('now') dans user_sessions
+    QDate today = QDateTime::currentDateTimeUtc().date();
 
-    // Calcul D1 : % de joueurs actifs il y a 2 jours qui se sont reconnectés le lendemain
-    query.prepare(R"(
-        SELECT
-            COUNT(DISTINCT s1.pseudo) as total_users,
-            COUNT(DISTINCT CASE WHEN s2.pseudo IS NOT NULL THEN s1.pseudo END) as returned_users
-        FROM user_sessions s1
-        LEFT JOIN user_sessions s2 ON s1.pseudo = s2.pseudo
-            AND date(s2.login_time) = date(s1.login_time, '+1 day')
-        WHERE date(s1.login_time) = date('now', '-2 days')
-    )");
+    // D1 : % de joueurs actifs il y a 2 jours qui se sont reconnectés le lendemain
+    QDate cohorte = today.addDays(-2);
+    retention.d1Retention = retentionRate(cohorte, cohorte.addDays(1), cohorte.addDays(1));
 
-    if (query.exec() && query.next()) {
-        int total = query.value(0).toInt();
-        int returned = query.value(1).toInt();
-        if (total > 0) {
-            retention.d1Retention = (returned * 100.0) / total;
-        }
-    }
+    // D7 : reconnectés entre J+6 et J+8
+    cohorte = today.addDays(-9);
+    retention.d7Retention = retentionRate(cohorte, cohorte.addDays(6), cohorte.addDays(8));
 
-    // Calcul D7
-    query.prepare(R"(
-        SELECT
-            COUNT(DISTINCT s1.pseudo) as total_users,
-            COUNT(DISTINCT CASE WHEN s2.pseudo IS NOT NULL THEN s1.pseudo END) as returned_users
-        FROM user_sessions s1
-        LEFT JOIN user_sessions s2 ON s1.pseudo = s2.pseudo
-            AND date(s2.login_time) BETWEEN date(s1.login_time, '+6 days') AND date(s1.login_time, '+8 days')
-        WHERE date(s1.login_time) = date('now', '-9 days')
-    )");
+    // D30 : reconnectés entre J+29 et J+31
+    cohorte = today.addDays(-32);
+    retention.d30Retention = retentionRate(cohorte, cohorte.addDays(29), cohorte.addDays(31));
 
-    if (query.exec() && query.next()) {
-        int total = query.value(0).toInt();
-        int returned = query.value(1).toInt();
-        if (total > 0) {
-            retention.d7Retention = (returned * 100.0) / total;
-        }
-    }
+    return retention;
+}
 
-    // Calcul D30
-    query.prepare(R"(
+double DatabaseManager::retentionRate(const QDate &cohorte, const QDate &debut, const QDate &fin)
+{
+    // Coût proportionnel à la taille de la cohorte (clé primaire + index pseudo/date),
+    // indépendant de l'historique de user_sessions
+    QSqlQuery &query = cachedQuery(R"(
         SELECT
-            COUNT(DISTINCT s1.pseudo) as total_users,
-            COUNT(DISTINCT CASE WHEN s2.pseudo IS NOT NULL THEN s1.pseudo END) as returned_users
-        FROM user_sessions s1
-        LEFT JOIN user_sessions s2 ON s1.pseudo = s2.pseudo
-            AND date(s2.login_time) BETWEEN date(s1.login_time, '+29 days') AND date(s1.login_time, '+31 days')
-        WHERE date(s1.login_time) = date('now', '-32 days')
+            COUNT(*) AS total_users,
+            COALESCE(SUM(EXISTS (
+                SELECT 1 FROM daily_active_users b
+                WHERE b.pseudo = a.pseudo AND b.date BETWEEN :debut AND :fin
+            )), 0) AS returned_users
+        FROM daily_active_users a
+        WHERE a.date = :cohorte
     )");
+    query.bindValue(":debut", debut.toString("yyyy-MM-dd"));
+    query.bindValue(":fin", fin.toString("yyyy-MM-dd"));
+    query.bindValue(":cohorte", cohorte.toString("yyyy-MM-dd"));
 
-    if (query.exec() && query.next()) {
+    double taux = 0.0;
+    if (!query.exec()) {
+        qWarning() << "Erreur calcul retention:" << query.lastError().text();
+    } else if (query.next()) {
         int total = query.value(0).toInt();
         int returned = query.value(1).toInt();
         if (total > 0) {
-            retention.d30Retention = (returned * 100.0) / total;
+            taux = (returned * 100.0) / total;
         }
     }
-
-    return retention;
+    query.finish();
+    return taux;
 }
 
 // Obtenir les tendances sur N jours
@@ -1714,6 +2120,9 @@ QList<DatabaseManager::DailyStats> DatabaseManager::getTrendStats(int days)
 {
     QList<DailyStats> trends;
 
+    // La journée en cours doit inclure les compteurs pas encore écrits
+    flushDailyCounters();
+
     QSqlQuery query(m_db);
     query.prepare(R"(
         SELECT date, logins, game_rooms_created, new_accounts, player_quits, crashes, total_session_time, session_count
@@ -1867,8 +2276,7 @@ bool DatabaseManager::rejectFriendRequest(const QString &requester, const QStrin
 QJsonArray DatabaseManager::getFriendsList(const QString &pseudo)
 {
     QJsonArray friends;
-    QSqlQuery query(m_db);
-    query.prepare(R"(
+    QSqlQuery &query = cachedQuery(R"(
         SELECT
             CASE WHEN f.requester_pseudo = :pseudo1 THEN f.target_pseudo ELSE f.requester_pseudo END AS friend_pseudo,
             u.avatar
@@ -1892,6 +2300,7 @@ QJsonArray DatabaseManager::getFriendsList(const QString &pseudo)
         friendObj["avatar"] = query.value(1).toString();
         friends.append(friendObj);
     }
+    query.finish();
 
     return friends;
 }
@@ -1899,8 +2308,7 @@ QJsonArray DatabaseManager::getFriendsList(const QString &pseudo)
 QJsonArray DatabaseManager::getPendingFriendRequests(const QString &pseudo)
 {
     QJsonArray pending;
-    QSqlQuery query(m_db);
-    query.prepare(R"(
+    QSqlQuery &query = cachedQuery(R"(
         SELECT f.requester_pseudo, u.avatar
         FROM friends f
         JOIN users u ON u.pseudo = f.requester_pseudo
@@ -1919,6 +2327,7 @@ QJsonArray DatabaseManager::getPendingFriendRequests(const QString &pseudo)
         req["avatar"] = query.value(1).toString();
         pending.append(req);
     }
+    query.finish();
 
     return pending;
 }
@@ -6,28 +6,76 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QString>
-#include <QCryptographicHash>
+#include <QDate>
 #include <QDebug>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QMap>
+#include <QTimer>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include "Glicko2.h"
 
 class DatabaseManager : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit DatabaseManager(QObject *parent = nullptr);
+    // connectionName : nom de la connexion QSqlDatabase (une par thread qui accède à la base)
+    explicit DatabaseManager(QObject *parent = nullptr, const QString &connectionName = "coinche_connection");
     ~DatabaseManager();
 
     // Initialiser la base de données
     bool initialize(const QString &dbPath = "coinche.db");
 
+    // Ouvrir une connexion de lecture seule sur une base déjà initialisée
+    // (connexions des threads de lecture de DatabaseWorker)
+    bool openReadOnly(const QString &dbPath);
+
     // Créer un compte utilisateur
     bool createAccount(const QString &pseudo, const QString &email, const QString &password, const QString &avatar, QString &errorMsg);
 
+    // Créer un compte dont le mot de passe est déjà haché (PasswordHasher, hors thread SQLite)
+    bool createAccountWithHash(const QString &pseudo, const QString &email, const QString &passwordHash, const QString &salt, const QString &avatar, QString &errorMsg);
+
+    // Règles de mot de passe (longueur minimale)
+    static bool validatePassword(const QString &password, QString &errorMsg);
+
     // Vérifier les identifiants de connexion
     bool authenticateUser(const QString &email, const QString &password, QString &pseudo, QString &avatar, QString &errorMsg, bool &usingTempPassword, bool &isAnonymous);
 
+    // Connexion en trois temps (le serveur vérifie le mot de passe hors du thread SQLite) :
+    // getCredentials() sur un thread de lecture, checkPassword() sur un thread de calcul,
+    // puis completeLogin() sur le thread SQLite
+    struct Credentials {
+        bool found = false;
+        QString error;  // Erreur SQL
+        QString pseudo;
+        QString avatar;
+        QString passwordHash;
+        QString salt;
+        QString tempPasswordHash;
+        bool restricted = false;
+        QString restrictionReason;
+        bool isAnonymous = false;
+    };
+    Credentials getCredentials(const QString &email);
+
+    struct PasswordCheck {
+        bool ok = false;
+        bool usingTempPassword = false;
+        QString errorMsg;
+        QString newHash;  // Non vide : hash permanent à remplacer (ancien format ou coût)
+    };
+    // Sans accès à la base : utilisable depuis n'importe quel thread
+    static PasswordCheck checkPassword(const Credentials &credentials, const QString &email, const QString &password);
+
+    // Mettre à jour last_login et remplacer le hash si besoin (sauf s'il a changé entre-temps)
+    void completeLogin(const QString &email, const QString &previousHash, const QString &newHash);
+
     // Vérifier si un email existe déjà
     bool emailExists(const QString &email);
 
@@ -94,10 +142,68 @@ public:
     // Mettre à jour les statistiques de surcoinche subies
     bool updateAnnonceSurcoinchee(const QString &pseudo, bool won);
 
+    // Variation des statistiques d'un joueur sur une manche (et la fin de partie)
+    // Regroupe ce que font les update*Stats ci-dessus pour un seul UPDATE par joueur
+    struct StatsDelta {
+        enum Partie { AUCUNE = 0, VICTOIRE = 1, DEFAITE = 2 };
+
+        Partie partie = AUCUNE;         // Fin de partie Coinche
+        Partie partieBelote = AUCUNE;   // Fin de partie Belote
+        int beloteCapots = 0;
+        int coincheAttempts = 0;
+        int coincheSuccess = 0;
+        int surcoincheAttempts = 0;
+        int surcoincheSuccess = 0;
+        int annoncesCoinchees = 0;
+        int annoncesCoincheesGagnees = 0;
+        int annoncesSurcoinchees = 0;
+        int annoncesSurcoincheesGagnees = 0;
+        int capotRealises = 0;
+        int capotAnnoncesRealises = 0;
+        int capotAnnoncesTentes = 0;
+        int generaleAttempts = 0;
+        int generaleSuccess = 0;
+
+        bool isEmpty() const;
+    };
+
+    // Applique les variations de plusieurs joueurs en une seule transaction
+    // (une requête préparée, exécutée une fois par joueur)
+    bool applyStatsDeltas(const QHash<QString, StatsDelta> &deltas);
+
+    // Cotes Glicko-2 par mode ("coinche" / "belote"), cf. Glicko2.h
+    struct PlayerRating {
+        QString pseudo;
+        double rating;
+        double rd;
+        double volatility;
+        int games;
+        bool isAnonymous;  // RGPD : hors classement
+    };
+    // Toutes les cotes du mode (chargées une fois au démarrage pour le classement)
+    QList<PlayerRating> getAllRatings(const QString &mode);
+
+    // Une place d'une partie cotée
+    struct RatedSeat {
+        QString pseudo;          // Vide : place non cotée (bot)
+        Glicko2::Rating rating;  // Cote connue du serveur, utilisée sans ligne en base
+        bool isAnonymous = false;
+        double score = 0.0;      // 1 victoire, 0 défaite (joueur parti avant la fin)
+    };
+    struct RatingsSave {
+        bool ok = false;            // false : rien n'est enregistré (erreur SQL, conflit)
+        QList<PlayerRating> saved;  // Nouvelles cotes des joueurs qui ont un compte
+    };
+    // Relit les cotes des joueurs, applique la partie (Glicko2::rateTeamGame) et les
+    // enregistre dans une même transaction : une autre instance du serveur ne peut pas
+    // modifier une cote entre la lecture et l'écriture (l'enregistrement échoue, à refaire)
+    RatingsSave rateGame(const QString &mode, const std::array<RatedSeat, 4> &seats);
+
     // Supprimer un compte utilisateur et toutes ses données
     bool deleteAccount(const QString &pseudo, QString &errorMsg);
 
     // Tracking des statistiques quotidiennes
+    // Les compteurs sont tenus en mémoire et écrits par flushDailyCounters()
     bool recordLogin(const QString &pseudo);
     bool recordGameRoomCreated();
     bool recordNewAccount();
@@ -126,6 +232,18 @@ public:
     // Tracking des crashes
     bool recordCrash();
 
+    // Écrit les compteurs en attente dans daily_stats (un UPSERT par jour : les jours
+    // clos dont l'écriture a échoué, puis le jour en cours)
+    // Appelé par le timer, au changement de jour, avant getTrendStats et à la fermeture
+    bool flushDailyCounters();
+
+    // Changement de jour : les compteurs en cours passent en attente sous leur date
+    // et les suivants comptent pour jour (appelé par countDaily et le timer)
+    void rollDailyCounters(const QString &jour);
+
+    // Écriture périodique des compteurs du jour (timer dans le thread de la base)
+    void startDailyCountersFlush(int intervalMs);
+
     // Calcul des taux de rétention
     struct RetentionStats {
         double d1Retention;  // % de joueurs revenus J+1
@@ -138,10 +256,16 @@ public:
     QList<DailyStats> getTrendStats(int days);
 
     // Password recovery methods
-    QString generateTempPassword();
+    static QString generateTempPassword();
     bool setTempPassword(const QString &email, QString &tempPassword, QString &errorMsg);
+    // Variantes sans calcul PBKDF2 : le hash est fait par l'appelant (GameServer, m_hashPool).
+    // salt : celui du compte, lu avant le hachage (échec s'il a changé depuis)
+    bool setTempPasswordHash(const QString &email, const QString &tempPasswordHash,
+                             const QString &salt, QString &errorMsg);
     bool isUsingTempPassword(const QString &email);
     bool updatePassword(const QString &email, const QString &newPassword, QString &errorMsg);
+    bool updatePasswordHash(const QString &email, const QString &passwordHash,
+                            const QString &salt, QString &errorMsg);
     bool updatePseudo(const QString &currentPseudo, const QString &newPseudo, QString &errorMsg);
     bool updateEmail(const QString &pseudo, const QString &newEmail, QString &errorMsg);
     bool setAnonymous(const QString &pseudo, bool anonymous, QString &errorMsg);
@@ -156,15 +280,39 @@ public:
 
 private:
     QSqlDatabase m_db;
+    QString m_connectionName;
+
+    // Requêtes préparées réutilisées, indexées par leur texte SQL
+    // (SQLite ne réanalyse plus la requête à chaque appel)
+    std::unordered_map<QString, std::unique_ptr<QSqlQuery>> m_statements;
+    std::unique_ptr<QSqlQuery> m_failedStatement;  // Préparation échouée (non mise en cache)
+
+    // Retourne la requête préparée pour sql (préparée au premier appel)
+    // Appeler finish() après lecture des résultats pour libérer le verrou de lecture
+    QSqlQuery &cachedQuery(const QString &sql);
+
+    // Compteurs quotidiens pas encore écrits dans daily_stats
+    enum CompteurJour {
+        LOGINS, GAME_ROOMS_CREATED, NEW_ACCOUNTS, PLAYER_QUITS, CRASHES,
+        TOTAL_SESSION_TIME, SESSION_COUNT, NB_COMPTEURS_JOUR
+    };
+    std::array<std::atomic<int>, NB_COMPTEURS_JOUR> m_dailyCounters = {};
+    QString m_dailyCountersDate;  // Jour auquel appartiennent les compteurs
+    // Jours clos pas encore écrits (écriture échouée au changement de jour), par date
+    QMap<QString, std::array<int, NB_COMPTEURS_JOUR>> m_pendingDailyCounters;
+    QTimer *m_dailyFlushTimer = nullptr;
+
+    // % des joueurs actifs le jour cohorte revenus entre debut et fin (daily_active_users)
+    double retentionRate(const QDate &cohorte, const QDate &debut, const QDate &fin);
+
+    // Incrémente un compteur du jour (clôt d'abord la veille si la date a changé)
+    void countDaily(CompteurJour compteur, int n = 1);
 
     // Créer les tables si elles n'existent pas
     bool createTables();
 
-    // Hasher un mot de passe avec SHA-256
-    QString hashPassword(const QString &password, const QString &salt);
-
-    // Générer un salt aléatoire
-    QString generateSalt();
+    // Ajoute les valeurs aux totaux du jour date dans daily_stats (UPSERT)
+    bool writeDailyCounters(const QString &date, const std::array<int, NB_COMPTEURS_JOUR> &valeurs);
 };
 
 #endif // DATABASEMANAGER_H
@@ -0,0 +1,108 @@
+#include "DatabaseWorker.h"
+#include <QDebug>
+
+DatabaseWorker::DatabaseWorker(const QString &connectionName)
+    : m_connectionName(connectionName)
+{
+}
+
+DatabaseWorker::~DatabaseWorker()
+{
+    stop();
+}
+
+bool DatabaseWorker::start(const QString &dbPath, int readers)
+{
+    // La connexion principale crée le schéma avant l'ouverture des lecteurs
+    if (!startThread(dbPath, false)) {
+        return false;
+    }
+
+    for (int i = 0; i < readers; i++) {
+        auto lecteur = std::make_unique<DatabaseWorker>(QString("%1_lecture_%2").arg(m_connectionName).arg(i));
+        if (!lecteur->startThread(dbPath, true)) {
+            qWarning() << "DatabaseWorker - Thread de lecture" << i << "non démarré";
+            continue;
+        }
+        m_readers.push_back(std::move(lecteur));
+    }
+    return true;
+}
+
+bool DatabaseWorker::startThread(const QString &dbPath, bool readOnly)
+{
+    if (m_thread.isRunning()) {
+        qWarning() << "DatabaseWorker - Déjà démarré";
+        return m_db != nullptr;
+    }
+
+    m_thread.setObjectName(readOnly ? "DatabaseReader" : "DatabaseWorker");
+    m_context = new QObject;
+    m_context->moveToThread(&m_thread);
+    m_thread.start();
+
+    // La connexion SQLite doit être créée dans le thread qui l'utilise
+    bool ok = false;
+    QMetaObject::invokeMethod(m_context, [this, &dbPath, &ok, readOnly]() {
+        DatabaseManager *db = new DatabaseManager(nullptr, m_connectionName);
+        if (readOnly) {
+            ok = db->openReadOnly(dbPath);
+        } else {
+            ok = db->initialize(dbPath);
+            db->startDailyCountersFlush(DAILY_COUNTERS_FLUSH_MS);
+        }
+        m_db = db;
+    }, Qt::BlockingQueuedConnection);
+
+    qInfo() << "DatabaseWorker - Thread SQLite démarré:" << m_connectionName << dbPath << (ok ? "" : "(échec initialisation)");
+    return ok;
+}
+
+void DatabaseWorker::post(Job job)
+{
+    if (!m_context) {
+        qWarning() << "DatabaseWorker - Requête ignorée (worker non démarré)";
+        return;
+    }
+
+    m_pending++;
+    QMetaObject::invokeMethod(m_context, [this, job = std::move(job)]() {
+        if (m_db) {
+            job(*m_db);
+        }
+        m_pending--;
+    }, Qt::QueuedConnection);
+}
+
+void DatabaseWorker::stop()
+{
+    // Vider d'abord la file principale : elle peut encore transmettre des
+    // lectures (readAfterWrites) aux threads de lecture
+    if (m_thread.isRunning() && !m_readers.empty()) {
+        QMetaObject::invokeMethod(m_context, []() {}, Qt::BlockingQueuedConnection);
+    }
+    for (auto &lecteur : m_readers) {
+        lecteur->stop();
+    }
+    m_readers.clear();
+
+    if (!m_thread.isRunning()) {
+        delete m_context;
+        m_context = nullptr;
+        return;
+    }
+
+    // Passe après les requêtes déjà postées (même file), puis ferme la connexion
+    QMetaObject::invokeMethod(m_context, [this]() {
+        delete m_db;
+        m_db = nullptr;
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+
+    delete m_context;
+    m_context = nullptr;
+    qInfo() << "DatabaseWorker - Thread SQLite arrêté";
+}
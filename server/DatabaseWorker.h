@@ -0,0 +1,110 @@
+#ifndef DATABASEWORKER_H
+#define DATABASEWORKER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMetaObject>
+#include <QString>
+#include <QDebug>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "DatabaseManager.h"
+
+// Thread dédié à SQLite : le DatabaseManager vit (connexion comprise) dans ce thread
+//
+// Les requêtes sont exécutées une par une, dans l'ordre où elles ont été postées
+// (file d'événements du thread), ce qui garantit l'ordre des écritures d'un même
+// joueur. Le thread réseau ne touche jamais la base directement :
+// - post()    : écriture sans réponse (statistiques, tracking)
+// - request() : requête avec réponse, callback exécuté dans le thread de context
+// - readRequest() : lecture seule, exécutée par un des threads de lecture (connexions
+//   séparées, en parallèle des écritures grâce au mode WAL). Elle peut ne pas voir
+//   les écritures encore en file sur le thread principal.
+// - readAfterWrites() : comme readRequest(), mais après toutes les écritures déjà
+//   postées (un joueur relit ce qu'il vient de modifier : stats, amis, mot de passe)
+class DatabaseWorker
+{
+public:
+    // Intervalle d'écriture des compteurs quotidiens (cf. DatabaseManager::flushDailyCounters)
+    static constexpr int DAILY_COUNTERS_FLUSH_MS = 30000;
+
+    explicit DatabaseWorker(const QString &connectionName = "coinche_worker");
+    ~DatabaseWorker();
+
+    DatabaseWorker(const DatabaseWorker &) = delete;
+    DatabaseWorker &operator=(const DatabaseWorker &) = delete;
+
+    // Démarre le thread et ouvre la base (bloquant, au lancement du serveur)
+    // readers : nombre de threads de lecture (0 = tout passe par le thread principal)
+    bool start(const QString &dbPath, int readers = 0);
+
+    // Exécute les requêtes en attente puis arrête le thread
+    void stop();
+
+    using Job = std::function<void(DatabaseManager &db)>;
+
+    void post(Job job);
+
+    // callback(result) est appelé dans le thread de context, s'il existe encore.
+    // context doit vivre au moins jusqu'à stop() (GameServer arrête le worker
+    // en premier dans son destructeur).
+    template<typename Result>
+    void request(QObject *context,
+                 std::function<Result(DatabaseManager &db)> job,
+                 std::function<void(const Result &result)> callback) {
+        post([context, job = std::move(job), callback = std::move(callback)](DatabaseManager &db) {
+            auto result = std::make_shared<Result>(job(db));
+            QMetaObject::invokeMethod(context, [callback, result]() {
+                callback(*result);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    // Comme request(), sur un thread de lecture (le job ne doit rien écrire)
+    template<typename Result>
+    void readRequest(QObject *context,
+                     std::function<Result(DatabaseManager &db)> job,
+                     std::function<void(const Result &result)> callback) {
+        DatabaseWorker *lecteur = this;
+        if (!m_readers.empty()) {
+            lecteur = m_readers[m_nextReader.fetch_add(1, std::memory_order_relaxed) % m_readers.size()].get();
+        }
+        lecteur->request<Result>(context, std::move(job), std::move(callback));
+    }
+
+    // Comme readRequest(), une fois exécutées les écritures postées avant l'appel : le job
+    // passe par la file du thread principal (sans y être exécuté) puis part en lecture
+    template<typename Result>
+    void readAfterWrites(QObject *context,
+                         std::function<Result(DatabaseManager &db)> job,
+                         std::function<void(const Result &result)> callback) {
+        if (m_readers.empty()) {
+            request<Result>(context, std::move(job), std::move(callback));
+            return;
+        }
+        post([this, context, job = std::move(job), callback = std::move(callback)](DatabaseManager &) mutable {
+            readRequest<Result>(context, std::move(job), std::move(callback));
+        });
+    }
+
+    // Requêtes postées mais pas encore exécutées (monitoring)
+    int pending() const { return m_pending.load(); }
+
+    bool isRunning() const { return m_thread.isRunning() && m_db; }
+
+private:
+    bool startThread(const QString &dbPath, bool readOnly);
+
+    QString m_connectionName;
+    QThread m_thread;
+    QObject *m_context = nullptr;     // Vit dans m_thread, reçoit les requêtes
+    DatabaseManager *m_db = nullptr;  // Créé, utilisé et détruit dans m_thread
+    std::atomic<int> m_pending{0};
+
+    std::vector<std::unique_ptr<DatabaseWorker>> m_readers;  // Threads de lecture
+    std::atomic<unsigned> m_nextReader{0};
+};
+
+#endif // DATABASEWORKER_H
@@ -2,6 +2,7 @@
 // Implémentation de GameServer
 
 #include "GameServer.h"
+#include "PasswordHasher.h"
 
 // Les implémentations des méthodes de GameServer seront déplacées ici
 // pour alléger le fichier header
@@ -13,6 +14,8 @@ void GameServer::onNewConnection() {
     
     connect(socket, &QWebSocket::textMessageReceived,
             this, &GameServer::onTextMessageReceived);
+    connect(socket, &QWebSocket::binaryMessageReceived,
+            this, &GameServer::onBinaryMessageReceived);
     connect(socket, &QWebSocket::disconnected,
             this, &GameServer::onDisconnected);
     
@@ -50,19 +53,46 @@ void GameServer::onTextMessageReceived(const QString &message) {
         return;
     }
 
-    QJsonObject obj = doc.object();
+    dispatchMessage(sender, doc.object());
+}
+
+void GameServer::onBinaryMessageReceived(const QByteArray &message) {
+    QWebSocket *sender = qobject_cast<QWebSocket*>(this->sender());
+    if (!sender) return;
+
+    if (sender->state() != QAbstractSocket::ConnectedState) {
+        qDebug() << "GameServer - Message binaire ignore (socket deconnecte)";
+        return;
+    }
+
+    QJsonObject obj;
+    if (!WireProtocol::decode(message, obj)) {
+        qCritical() << "[CBOR_PARSE] Trame binaire invalide - taille:" << message.size();
+        return;
+    }
+
+    dispatchMessage(sender, obj);
+}
+
+void GameServer::dispatchMessage(QWebSocket *sender, const QJsonObject &obj) {
     QString type = obj["type"].toString().trimmed();
 
     if (type.isEmpty()) {
-        qWarning() << "[JSON_PARSE] Champ 'type' manquant ou vide - message:" << message.left(100);
+        qWarning() << "[JSON_PARSE] Champ 'type' manquant ou vide - message:"
+                   << QJsonDocument(obj).toJson(QJsonDocument::Compact).left(100);
         return;
     }
 
     qDebug() << "GameServer - Message recu:" << type;
 
+    MessageDispatcher::Route* route = m_dispatcher.find(type);
+    if (!route) {
+        qWarning() << "[MSG_DISPATCH] Type de message non reconnu:" << type;
+        return;
+    }
+
     // Vérifier la version du client pour les messages d'authentification
-    if (type == "register" || type == "registerAccount" || type == "loginAccount"
-        || type == "requestVerificationCode" || type == "verifyCodeAndRegister") {
+    if (route->checkVersion) {
         int clientVersion = obj["version"].toInt(0);
         if (clientVersion < MIN_CLIENT_VERSION) {
             QJsonObject error;
@@ -74,87 +104,79 @@ void GameServer::onTextMessageReceived(const QString &message) {
                        << "pour message" << type;
             return;
         }
-    }
 
-    if (type == "register") {
-        handleRegister(sender, obj);
-    } else if (type == "registerAccount") {
-        handleRegisterAccount(sender, obj);
-    } else if (type == "requestVerificationCode") {
-        handleRequestVerificationCode(sender, obj);
-    } else if (type == "verifyCodeAndRegister") {
-        handleVerifyCodeAndRegister(sender, obj);
-    } else if (type == "loginAccount") {
-        handleLoginAccount(sender, obj);
-    } else if (type == "deleteAccount") {
-        handleDeleteAccount(sender, obj);
-    } else if (type == "getStats") {
-        handleGetStats(sender, obj);
-    } else if (type == "joinMatchmaking") {
-        handleJoinMatchmaking(sender, obj);
-    } else if (type == "joinTraining") {
-        handleJoinTraining(sender, obj);
-    } else if (type == "leaveMatchmaking") {
-        handleLeaveMatchmaking(sender);
-    } else if (type == "playCard") {
-        handlePlayCard(sender, obj);
-    } else if (type == "makeBid") {
-        handleMakeBid(sender, obj);
-    } else if (type == "forfeit") {
-        handleForfeit(sender);
-    } else if (type == "createPrivateLobby") {
-        handleCreatePrivateLobby(sender);
-    } else if (type == "joinPrivateLobby") {
-        handleJoinPrivateLobby(sender, obj);
-    } else if (type == "lobbyReady") {
-        handleLobbyReady(sender, obj);
-    } else if (type == "setLobbyGameMode") {
-        handleSetLobbyGameMode(sender, obj);
-    } else if (type == "startLobbyGame") {
-        handleStartLobbyGame(sender);
-    } else if (type == "reorderLobbyPlayers") {
-        handleReorderLobbyPlayers(sender, obj);
-    } else if (type == "leaveLobby") {
-        handleLeaveLobby(sender);
-    } else if (type == "updateAvatar") {
-        handleUpdateAvatar(sender, obj);
-    } else if (type == "rehumanize") {
-        handleRehumanize(sender);
-    } else if (type == "sendContactMessage") {
-        handleSendContactMessage(sender, obj);
-    } else if (type == "reportCrash") {
-        handleReportCrash(sender, obj);
-    } else if (type == "sendEmoji") {
-        handleSendEmoji(sender, obj);
-    } else if (type == "forgotPassword") {
-        handleForgotPassword(sender, obj);
-    } else if (type == "changePassword") {
-        handleChangePassword(sender, obj);
-    } else if (type == "changePseudo") {
-        handleChangePseudo(sender, obj);
-    } else if (type == "changeEmail") {
-        handleChangeEmail(sender, obj);
-    } else if (type == "requestEmailChangeCode") {
-        handleRequestEmailChangeCode(sender, obj);
-    } else if (type == "verifyCodeAndChangeEmail") {
-        handleVerifyCodeAndChangeEmail(sender, obj);
-    } else if (type == "setAnonymous") {
-        handleSetAnonymous(sender, obj);
-    } else if (type == "sendFriendRequest") {
-        handleSendFriendRequest(sender, obj);
-    } else if (type == "acceptFriendRequest") {
-        handleAcceptFriendRequest(sender, obj);
-    } else if (type == "rejectFriendRequest") {
-        handleRejectFriendRequest(sender, obj);
-    } else if (type == "getFriendsList") {
-        handleGetFriendsList(sender);
-    } else if (type == "removeFriend") {
-        handleRemoveFriend(sender, obj);
-    } else if (type == "inviteToLobby") {
-        handleInviteToLobby(sender, obj);
-    } else {
-        qWarning() << "[MSG_DISPATCH] Type de message non reconnu:" << type;
+        // Protocole binaire demandé par le client : confirmé en texte, puis trames CBOR
+        if (obj["binary"].toBool() && clientVersion >= WireProtocol::BINARY_MIN_VERSION
+            && !m_binarySockets.contains(sender)) {
+            QJsonObject protocol;
+            protocol["type"] = "protocol";
+            protocol["format"] = "cbor";
+            sendMessage(sender, protocol);
+            m_binarySockets.insert(sender);
+            if (clientVersion >= WireProtocol::BATCH_MIN_VERSION) {
+                m_batchSockets.insert(sender);
+            }
+            qDebug() << "Protocole binaire active pour le socket" << sender;
+        }
+        if (clientVersion >= Broker::REDIRECT_MIN_VERSION) {
+            m_redirectSockets.insert(sender);
+        }
     }
+
+    m_dispatcher.invoke(*route, sender, obj);
+}
+
+void GameServer::registerMessageHandlers() {
+    // Authentification (version client vérifiée avant le handler)
+    m_dispatcher.registerHandler("register", [this](QWebSocket *socket, const QJsonObject &data) { handleRegister(socket, data); }, true);
+    m_dispatcher.registerHandler("registerAccount", [this](QWebSocket *socket, const QJsonObject &data) { handleRegisterAccount(socket, data); }, true);
+    m_dispatcher.registerHandler("requestVerificationCode", [this](QWebSocket *socket, const QJsonObject &data) { handleRequestVerificationCode(socket, data); }, true);
+    m_dispatcher.registerHandler("verifyCodeAndRegister", [this](QWebSocket *socket, const QJsonObject &data) { handleVerifyCodeAndRegister(socket, data); }, true);
+    m_dispatcher.registerHandler("loginAccount", [this](QWebSocket *socket, const QJsonObject &data) { handleLoginAccount(socket, data); }, true);
+
+    // Partie
+    m_dispatcher.registerHandler("playCard", [this](QWebSocket *socket, const QJsonObject &data) { handlePlayCard(socket, data); });
+    m_dispatcher.registerHandler("makeBid", [this](QWebSocket *socket, const QJsonObject &data) { handleMakeBid(socket, data); });
+    m_dispatcher.registerHandler("forfeit", [this](QWebSocket *socket, const QJsonObject &) { handleForfeit(socket); });
+    m_dispatcher.registerHandler("rehumanize", [this](QWebSocket *socket, const QJsonObject &) { handleRehumanize(socket); });
+    m_dispatcher.registerHandler("resync", [this](QWebSocket *socket, const QJsonObject &data) { handleResync(socket, data); });
+    m_dispatcher.registerHandler("animationDone", [this](QWebSocket *socket, const QJsonObject &data) { handleAnimationDone(socket, data); });
+    m_dispatcher.registerHandler("sendEmoji", [this](QWebSocket *socket, const QJsonObject &data) { handleSendEmoji(socket, data); });
+    m_dispatcher.registerHandler("joinMatchmaking", [this](QWebSocket *socket, const QJsonObject &data) { handleJoinMatchmaking(socket, data); });
+    m_dispatcher.registerHandler("joinTraining", [this](QWebSocket *socket, const QJsonObject &data) { handleJoinTraining(socket, data); });
+    m_dispatcher.registerHandler("leaveMatchmaking", [this](QWebSocket *socket, const QJsonObject &) { handleLeaveMatchmaking(socket); });
+
+    // Compte et statistiques
+    m_dispatcher.registerHandler("deleteAccount", [this](QWebSocket *socket, const QJsonObject &data) { handleDeleteAccount(socket, data); });
+    m_dispatcher.registerHandler("getStats", [this](QWebSocket *socket, const QJsonObject &data) { handleGetStats(socket, data); });
+    m_dispatcher.registerHandler("getLeaderboard", [this](QWebSocket *socket, const QJsonObject &data) { handleGetLeaderboard(socket, data); });
+    m_dispatcher.registerHandler("updateAvatar", [this](QWebSocket *socket, const QJsonObject &data) { handleUpdateAvatar(socket, data); });
+    m_dispatcher.registerHandler("forgotPassword", [this](QWebSocket *socket, const QJsonObject &data) { handleForgotPassword(socket, data); });
+    m_dispatcher.registerHandler("changePassword", [this](QWebSocket *socket, const QJsonObject &data) { handleChangePassword(socket, data); });
+    m_dispatcher.registerHandler("changePseudo", [this](QWebSocket *socket, const QJsonObject &data) { handleChangePseudo(socket, data); });
+    m_dispatcher.registerHandler("changeEmail", [this](QWebSocket *socket, const QJsonObject &data) { handleChangeEmail(socket, data); });
+    m_dispatcher.registerHandler("requestEmailChangeCode", [this](QWebSocket *socket, const QJsonObject &data) { handleRequestEmailChangeCode(socket, data); });
+    m_dispatcher.registerHandler("verifyCodeAndChangeEmail", [this](QWebSocket *socket, const QJsonObject &data) { handleVerifyCodeAndChangeEmail(socket, data); });
+    m_dispatcher.registerHandler("setAnonymous", [this](QWebSocket *socket, const QJsonObject &data) { handleSetAnonymous(socket, data); });
+    m_dispatcher.registerHandler("sendContactMessage", [this](QWebSocket *socket, const QJsonObject &data) { handleSendContactMessage(socket, data); });
+    m_dispatcher.registerHandler("reportCrash", [this](QWebSocket *socket, const QJsonObject &data) { handleReportCrash(socket, data); });
+
+    // Lobbies privés
+    m_dispatcher.registerHandler("createPrivateLobby", [this](QWebSocket *socket, const QJsonObject &) { handleCreatePrivateLobby(socket); });
+    m_dispatcher.registerHandler("joinPrivateLobby", [this](QWebSocket *socket, const QJsonObject &data) { handleJoinPrivateLobby(socket, data); });
+    m_dispatcher.registerHandler("lobbyReady", [this](QWebSocket *socket, const QJsonObject &data) { handleLobbyReady(socket, data); });
+    m_dispatcher.registerHandler("setLobbyGameMode", [this](QWebSocket *socket, const QJsonObject &data) { handleSetLobbyGameMode(socket, data); });
+    m_dispatcher.registerHandler("startLobbyGame", [this](QWebSocket *socket, const QJsonObject &) { handleStartLobbyGame(socket); });
+    m_dispatcher.registerHandler("reorderLobbyPlayers", [this](QWebSocket *socket, const QJsonObject &data) { handleReorderLobbyPlayers(socket, data); });
+    m_dispatcher.registerHandler("leaveLobby", [this](QWebSocket *socket, const QJsonObject &) { handleLeaveLobby(socket); });
+    m_dispatcher.registerHandler("inviteToLobby", [this](QWebSocket *socket, const QJsonObject &data) { handleInviteToLobby(socket, data); });
+
+    // Amis
+    m_dispatcher.registerHandler("sendFriendRequest", [this](QWebSocket *socket, const QJsonObject &data) { handleSendFriendRequest(socket, data); });
+    m_dispatcher.registerHandler("acceptFriendRequest", [this](QWebSocket *socket, const QJsonObject &data) { handleAcceptFriendRequest(socket, data); });
+    m_dispatcher.registerHandler("rejectFriendRequest", [this](QWebSocket *socket, const QJsonObject &data) { handleRejectFriendRequest(socket, data); });
+    m_dispatcher.registerHandler("getFriendsList", [this](QWebSocket *socket, const QJsonObject &) { handleGetFriendsList(socket); });
+    m_dispatcher.registerHandler("removeFriend", [this](QWebSocket *socket, const QJsonObject &data) { handleRemoveFriend(socket, data); });
 }
 
 void GameServer::onDisconnected() {
@@ -162,94 +184,89 @@ void GameServer::onDisconnected() {
     if (!socket) return;
 
     qInfo() << "Client déconnecté - socket:" << socket;
+    m_binarySockets.remove(socket);
+    m_batchSockets.remove(socket);
+    m_redirectSockets.remove(socket);
+    m_pendingFrames.remove(socket);
+    m_slowSockets.remove(socket);
 
     // Trouve la connexion correspondant à CE socket
-    QString connectionId;
+    QString connectionId = getConnectionIdBySocket(socket);
     QString playerName;
     int roomId = -1;
     int playerIndex = -1;
     bool wasInQueue = false;
 
-    for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-        // Vérifier que la connexion existe avant d'accéder à ses membres
-        if (!it.value()) {
-            qCritical() << "SEGFAULT évité - Connexion null dans m_connections";
-            continue;
-        }
-
-        if (it.value()->socket == socket) {
-            connectionId = it.key();
-            playerName = it.value()->playerName;
-            roomId = it.value()->gameRoomId;
-            playerIndex = it.value()->playerIndex;
-
-            // Retire de la file d'attente et note si le joueur était en attente
-            wasInQueue = m_matchmakingQueueCoinche.contains(connectionId) ||
-                         m_matchmakingQueueBelote.contains(connectionId);
-            m_matchmakingQueueCoinche.removeAll(connectionId);
-            m_matchmakingQueueBelote.removeAll(connectionId);
-
-            // IMPORTANT: Vérifier que c'est bien la connexion ACTIVE dans la room
-            // Si le joueur s'est reconnecté, il a une nouvelle connexion et on ne doit
-            // PAS traiter le disconnect de l'ancienne connexion
-            if (roomId != -1) {
-                GameRoom* room = m_gameRooms.value(roomId);
-                if (room && playerIndex >= 0 && playerIndex < room->connectionIds.size()) {
-                    QString currentConnId = room->connectionIds[playerIndex];
-
-                    if (currentConnId == connectionId) {
-                        // C'est bien la connexion active, traiter la déconnexion
-                        qInfo() << "Déconnexion ACTIVE - Joueur" << playerName << "(index" << playerIndex << ")";
-                        handlePlayerDisconnect(connectionId);
-                    } else if (!currentConnId.isEmpty()) {
-                        // Le joueur s'est reconnecté avec une nouvelle connexion
-                        qInfo() << "Déconnexion PÉRIMÉE ignorée - Joueur" << playerName << "déjà reconnecté (old:" << connectionId << "current:" << currentConnId << ")";
-                    } else {
-                        // Le connectionId est vide (déjà traité)
-                        qInfo() << "Déconnexion déjà traitée - connectionId vide pour joueur" << playerIndex;
-                    }
+    PlayerConnection *conn = m_connections.value(connectionId);
+    if (conn) {
+        playerName = conn->playerName;
+        roomId = conn->gameRoomId;
+        playerIndex = conn->playerIndex;
+
+        // Retire de la file d'attente et note si le joueur était en attente
+        bool retireCoinche = m_matchmakingQueueCoinche.remove(connectionId);
+        bool retireBelote = m_matchmakingQueueBelote.remove(connectionId);
+        wasInQueue = retireCoinche || retireBelote;
+
+        // IMPORTANT: Vérifier que c'est bien la connexion ACTIVE dans la room
+        // Si le joueur s'est reconnecté, il a une nouvelle connexion et on ne doit
+        // PAS traiter le disconnect de l'ancienne connexion
+        if (roomId != -1) {
+            GameRoom* room = m_gameRooms.value(roomId);
+            if (room && playerIndex >= 0 && playerIndex < room->connectionIds.size()) {
+                QString currentConnId = room->connectionIds[playerIndex];
+
+                if (currentConnId == connectionId) {
+                    // C'est bien la connexion active, traiter la déconnexion
+                    qInfo() << "Déconnexion ACTIVE - Joueur" << playerName << "(index" << playerIndex << ")";
+                    handlePlayerDisconnect(connectionId);
+                } else if (!currentConnId.isEmpty()) {
+                    // Le joueur s'est reconnecté avec une nouvelle connexion
+                    qInfo() << "Déconnexion PÉRIMÉE ignorée - Joueur" << playerName << "déjà reconnecté (old:" << connectionId << "current:" << currentConnId << ")";
                 } else {
-                    qInfo() << "Room introuvable ou index invalide pour connexion" << connectionId;
+                    // Le connectionId est vide (déjà traité)
+                    qInfo() << "Déconnexion déjà traitée - connectionId vide pour joueur" << playerIndex;
                 }
+            } else {
+                qInfo() << "Room introuvable ou index invalide pour connexion" << connectionId;
             }
+        }
 
-            // Retirer le joueur d'un éventuel lobby
-            if (!playerName.isEmpty()) {
-                for (auto lobbyIt = m_privateLobbies.begin(); lobbyIt != m_privateLobbies.end(); ++lobbyIt) {
-                    PrivateLobby* lobby = lobbyIt.value();
-                    if (lobby && lobby->playerNames.contains(playerName)) {
-                        int idx = lobby->playerNames.indexOf(playerName);
-                        lobby->playerNames.removeAt(idx);
-                        lobby->playerAvatars.removeAt(idx);
-                        lobby->readyStatus.removeAt(idx);
-                        qDebug() << "Joueur déconnecté" << playerName << "retiré du lobby" << lobbyIt.key();
-
-                        if (lobby->playerNames.isEmpty()) {
-                            qDebug() << "Lobby" << lobbyIt.key() << "supprimé (vide après déconnexion)";
-                            delete lobby;
-                            m_privateLobbies.erase(lobbyIt);
-                        } else {
-                            if (lobby->hostPlayerName == playerName) {
-                                lobby->hostPlayerName = lobby->playerNames.first();
-                                qDebug() << "Nouvel hôte du lobby:" << lobby->hostPlayerName;
-                            }
-                            sendLobbyUpdate(lobby->code);
+        // Retirer le joueur d'un éventuel lobby
+        if (!playerName.isEmpty()) {
+            for (auto lobbyIt = m_privateLobbies.begin(); lobbyIt != m_privateLobbies.end(); ++lobbyIt) {
+                PrivateLobby* lobby = lobbyIt.value();
+                if (lobby && lobby->playerNames.contains(playerName)) {
+                    int idx = lobby->playerNames.indexOf(playerName);
+                    lobby->playerNames.removeAt(idx);
+                    lobby->playerAvatars.removeAt(idx);
+                    lobby->readyStatus.removeAt(idx);
+                    qDebug() << "Joueur déconnecté" << playerName << "retiré du lobby" << lobbyIt.key();
+
+                    if (lobby->playerNames.isEmpty()) {
+                        qDebug() << "Lobby" << lobbyIt.key() << "supprimé (vide après déconnexion)";
+                        delete lobby;
+                        m_privateLobbies.erase(lobbyIt);
+                    } else {
+                        if (lobby->hostPlayerName == playerName) {
+                            lobby->hostPlayerName = lobby->playerNames.first();
+                            qDebug() << "Nouvel hôte du lobby:" << lobby->hostPlayerName;
                         }
-                        break;
+                        sendLobbyUpdate(lobby->code);
                     }
+                    break;
                 }
             }
+        }
 
-            // Terminer le tracking de session (lightweight)
-            if (!playerName.isEmpty()) {
-                m_dbManager->recordSessionEnd(playerName);
-            }
-
-            delete it.value();
-            m_connections.erase(it);
-            break;
+        // Terminer le tracking de session (lightweight)
+        if (!playerName.isEmpty()) {
+            m_dbWorker.post([playerName](DatabaseManager &db) { db.recordSessionEnd(playerName); });
         }
+
+        removeConnection(conn);
     }
+    m_connectionIdBySocket.remove(socket);
 
     // Si le joueur était dans la queue, notifier les autres joueurs
     if (wasInQueue) {
@@ -258,6 +275,7 @@ void GameServer::onDisconnected() {
         // Notifier les joueurs des deux queues
         notifyQueueStatus("coinche");
         notifyQueueStatus("belote");
+        brokerStateChanged();
     }
 
     socket->deleteLater();
@@ -269,10 +287,14 @@ void GameServer::handleRegister(QWebSocket *socket, const QJsonObject &data) {
     QString avatar = data["avatar"].toString();
     if (avatar.isEmpty()) avatar = "avataaars1.svg";
 
-    // Si le joueur n'a pas de nom (invité), générer un nom unique
-    if (playerName.isEmpty()) {
-        static int guestCounter = 0;
-        playerName = QString("Invité %1").arg(++guestCounter);
+    // Si le joueur n'a pas de nom (invité), générer un nom unique. En multi-processus,
+    // l'annuaire du broker est indexé par nom : le préfixe du serveur évite qu'un
+    // invité porte le nom d'un invité d'un autre serveur (et soit redirigé vers sa partie)
+    bool nomGenere = playerName.isEmpty();
+    if (nomGenere) {
+        ++m_guestCounter;
+        playerName = m_broker ? QString("Invité %1-%2").arg(m_broker->serverId()).arg(m_guestCounter)
+                              : QString("Invité %1").arg(m_guestCounter);
     }
 
     // IMPORTANT: Vérifier si une connexion existe déjà pour ce socket
@@ -307,11 +329,7 @@ void GameServer::handleRegister(QWebSocket *socket, const QJsonObject &data) {
             -1,    // Pas encore en partie
             -1     // Pas encore de position
         };
-        m_connections[connectionId] = conn;
-        if (m_connections.size() > m_maxSimultaneousConnections) {
-            m_maxSimultaneousConnections = m_connections.size();
-            m_statsReporter->setMaxSimultaneous(m_maxSimultaneousConnections, m_maxSimultaneousGames);
-        }
+        addConnection(conn);
         qDebug() << "Nouvelle connexion créée:" << connectionId << "pour" << playerName;
     }
 
@@ -324,6 +342,17 @@ void GameServer::handleRegister(QWebSocket *socket, const QJsonObject &data) {
 
     qInfo() << "Joueur enregistré:" << playerName << "ID:" << connectionId;
 
+    // Partie tenue par un autre serveur (multi-processus) : le client s'y reconnecte.
+    // Un nom généré ici n'a jamais été en partie ailleurs
+    if (m_broker && !nomGenere && !m_playerNameToRoomId.contains(playerName)
+        && redirectClient(socket, m_broker->urlForPlayer(playerName))) {
+        return;
+    }
+
+    if (!nomGenere) {
+        loadMatchmakingRatings(connectionId, playerName);
+    }
+
     // Vérifier si le joueur était en partie avant de se déconnecter
     bool wasInGame = data["wasInGame"].toBool(false);
     qDebug() << "Verification reconnexion pour" << playerName << "- wasInGame:" << wasInGame
@@ -413,19 +442,64 @@ void GameServer::handleReconnection(const QString& connectionId, int roomId, int
 
     // Remplacer l'ID de connexion dans la room
     room->connectionIds[playerIndex] = connectionId;
+    room->leavers.remove(playerIndex);  // Revenu à la table : coté avec son équipe
 
     // Vérifier si le joueur était un bot (remplacé pendant sa déconnexion)
     bool wasBot = room->isBot[playerIndex];
     // Note: On enverra la notification botReplacement APRÈS gameFound et gameState
     // pour que le client ait le temps de se configurer
 
-    // Préparer les données de l'état actuel de la partie pour le joueur qui se reconnecte
+    // gameFound (cartes, adversaires) puis l'état de la phase en cours
+    sendGameSnapshot(conn, room, playerIndex);
+
+    // Notifier tous les autres joueurs de la reconnexion
+    QJsonObject playerReconnectedMsg;
+    playerReconnectedMsg["type"] = "playerReconnected";
+    playerReconnectedMsg["playerIndex"] = playerIndex;
+    playerReconnectedMsg["playerName"] = conn->playerName;
+    broadcastToRoom(roomId, playerReconnectedMsg, connectionId);
+
+    qDebug() << "GameServer - Joueur" << playerIndex << "reconnecte avec succes";
+
+    // Annuler la défaite enregistrée lors de la déconnexion
+    if (!conn->playerName.isEmpty()) {
+        // Décrémenter le compteur de parties jouées (annule la défaite)
+        m_dbWorker.post([pseudo = conn->playerName](DatabaseManager &db) { db.cancelDefeat(pseudo); });
+        qDebug() << "Stats corrigees pour" << conn->playerName << "- Defaite annulee";
+    }
+
+    // IMPORTANT: Envoyer botReplacement APRÈS gameFound et gameState
+    // pour que le client ait le temps de créer le GameModel et charger CoincheView
+    if (wasBot) {
+        qDebug() << "GameServer - Le joueur" << playerIndex << "était un bot, envoi de la notification (après gameState)";
+        // Utiliser un petit délai pour laisser le temps au client de se configurer
+        scheduleRoomEvent(roomId, 500, [this, connectionId, playerIndex]() {
+            if (!m_connections.contains(connectionId)) return;
+            PlayerConnection* conn = m_connections[connectionId];
+            if (!conn || !conn->socket) return;
+
+            QJsonObject notification;
+            notification["type"] = "botReplacement";
+            notification["message"] = "Vous avez été remplacé par un bot pendant votre absence.";
+            sendMessage(conn->socket, notification);
+            qDebug() << "GameServer - Notification botReplacement envoyée au joueur" << playerIndex;
+        });
+    }
+}
+
+void GameServer::sendGameSnapshot(PlayerConnection *conn, GameRoom *room, int playerIndex) {
+    if (!conn || !conn->socket || !room) return;
+    int roomId = conn->gameRoomId;
+
+    // Préparer les données de l'état actuel de la partie pour le joueur
     QJsonObject reconnectMsg;
     reconnectMsg["type"] = "gameFound";  // Même message que pour démarrer une partie
     reconnectMsg["roomId"] = roomId;
     reconnectMsg["playerPosition"] = playerIndex;
     reconnectMsg["reconnection"] = true;  // Marquer comme reconnexion
     reconnectMsg["gameMode"] = room->isBeloteMode ? QString("belote") : QString("coinche");
+    reconnectMsg["seq"] = static_cast<qint64>(room->stateSeq);  // Point de départ des messages numérotés
+    if (room->animationAcks) reconnectMsg["animationAcks"] = true;
 
     // Retournée (Belote uniquement) — indispensable pour afficher le BeloteAnnoncesPanel
     if (room->isBeloteMode && room->retournee) {
@@ -473,22 +547,6 @@ void GameServer::handleReconnection(const QString& connectionId, int roomId, int
 
     sendMessage(conn->socket, reconnectMsg);
 
-    // Notifier tous les autres joueurs de la reconnexion
-    QJsonObject playerReconnectedMsg;
-    playerReconnectedMsg["type"] = "playerReconnected";
-    playerReconnectedMsg["playerIndex"] = playerIndex;
-    playerReconnectedMsg["playerName"] = conn->playerName;
-    broadcastToRoom(roomId, playerReconnectedMsg, connectionId);
-
-    qDebug() << "GameServer - Joueur" << playerIndex << "reconnecte avec succes";
-
-    // Annuler la défaite enregistrée lors de la déconnexion
-    if (!conn->playerName.isEmpty()) {
-        // Décrémenter le compteur de parties jouées (annule la défaite)
-        m_dbManager->cancelDefeat(conn->playerName);
-        qDebug() << "Stats corrigees pour" << conn->playerName << "- Defaite annulee";
-    }
-
     // Envoyer l'état actuel du jeu
     if (room->gameState == "bidding") {
         QJsonObject stateMsg;
@@ -611,23 +669,72 @@ void GameServer::handleReconnection(const QString& connectionId, int roomId, int
         qInfo() << "GameServer - Reconnexion (distributing → playing): atout:" << static_cast<int>(room->couleurAtout);
         sendMessage(conn->socket, stateMsg);
     }
+}
 
-    // IMPORTANT: Envoyer botReplacement APRÈS gameFound et gameState
-    // pour que le client ait le temps de créer le GameModel et charger CoincheView
-    if (wasBot) {
-        qDebug() << "GameServer - Le joueur" << playerIndex << "était un bot, envoi de la notification (après gameState)";
-        // Utiliser un petit délai pour laisser le temps au client de se configurer
-        QTimer::singleShot(500, this, [this, connectionId, playerIndex]() {
-            if (!m_connections.contains(connectionId)) return;
-            PlayerConnection* conn = m_connections[connectionId];
-            if (!conn || !conn->socket) return;
+void GameServer::handleResync(QWebSocket *socket, const QJsonObject &data) {
+    QString connectionId = getConnectionIdBySocket(socket);
+    PlayerConnection* conn = m_connections.value(connectionId);
+    if (!conn || conn->gameRoomId == -1) {
+        qDebug() << "handleResync - Joueur hors partie, ignoré";
+        return;
+    }
+    GameRoom* room = m_gameRooms.value(conn->gameRoomId);
+    int playerIndex = conn->playerIndex;
+    if (!room || playerIndex < 0 || playerIndex >= room->connectionIds.size()) return;
+
+    qint64 lastSeq = data["lastSeq"].toInteger(-1);
+    qint64 premierGarde = room->stateHistory.isEmpty() ? room->stateSeq + 1
+                                                       : room->stateHistory.first().value("seq").toInteger();
+
+    // Trou couvert par l'historique : on renvoie seulement les messages manqués, dans l'ordre
+    if (lastSeq >= 0 && lastSeq <= room->stateSeq && lastSeq + 1 >= premierGarde) {
+        int rejoues = 0;
+        for (const QJsonObject &message : room->stateHistory) {
+            if (message["seq"].toInteger() > lastSeq) {
+                sendMessage(socket, message);
+                rejoues++;
+            }
+        }
 
-            QJsonObject notification;
-            notification["type"] = "botReplacement";
-            notification["message"] = "Vous avez été remplacé par un bot pendant votre absence.";
-            sendMessage(conn->socket, notification);
-            qDebug() << "GameServer - Notification botReplacement envoyée au joueur" << playerIndex;
-        });
+        // L'historique ne garde pas les cartes jouables (privées) : les renvoyer si c'est son tour
+        if (room->gameState == "playing" && room->currentPlayerIndex == playerIndex) {
+            QJsonObject stateMsg;
+            stateMsg["type"] = "gameState";
+            stateMsg["currentPlayer"] = playerIndex;
+            stateMsg["playableCards"] = calculatePlayableCards(room, playerIndex);
+            sendMessage(socket, stateMsg);
+        }
+        qDebug() << "handleResync - Joueur" << playerIndex << ":" << rejoues << "messages renvoyés depuis seq" << lastSeq;
+        return;
+    }
+
+    // Trop ancien (ou numéro invalide) : état complet
+    qDebug() << "handleResync - Joueur" << playerIndex << ": seq" << lastSeq << "hors historique, envoi de l'état complet";
+    sendGameSnapshot(conn, room, playerIndex);
+}
+
+void GameServer::handleAnimationDone(QWebSocket *socket, const QJsonObject &data) {
+    PlayerConnection* conn = m_connections.value(getConnectionIdBySocket(socket));
+    if (!conn || conn->gameRoomId == -1) return;
+    GameRoom* room = m_gameRooms.value(conn->gameRoomId);
+    if (!room || !room->animationAcks) return;
+
+    // Les délais planifiés avant le dernier message affiché n'ont plus rien à attendre
+    qint64 seq = data["seq"].toInteger(-1);
+    QList<TimingWheel::Callback> prets;
+    for (auto it = room->ackableEvents.begin(); it != room->ackableEvents.end();) {
+        if (it->second > seq) {
+            ++it;
+            continue;
+        }
+        TimingWheel::Callback callback = m_timingWheel.take(it->first);
+        if (callback) prets.append(std::move(callback));
+        it = room->ackableEvents.erase(it);
+    }
+
+    // Exécutés hors de la boucle : ils peuvent planifier d'autres événements
+    for (const TimingWheel::Callback &callback : prets) {
+        callback();
     }
 }
 
@@ -770,51 +877,92 @@ void GameServer::handleRegisterAccount(QWebSocket *socket, const QJsonObject &da
     qDebug() << "GameServer - Tentative creation compte:" << pseudo << email << "avatar:" << avatar;
 
     QString errorMsg;
-    if (m_dbManager->createAccount(pseudo, email, password, avatar, errorMsg)) {
-        // Succès - Créer une connexion et enregistrer le joueur (comme pour loginAccount)
-        QString connectionId = QUuid::createUuid().toString();
-
-        PlayerConnection *conn = new PlayerConnection{
-            socket,
-            connectionId,
-            pseudo,
-            avatar,
-            -1,    // Pas encore en partie
-            -1,    // Pas encore de position
-            QString(), // lobbyPartnerId
-            QString(), // lobbyCode
-            false  // isAnonymous = false par défaut pour un nouveau compte
-        };
-        m_connections[connectionId] = conn;
-        if (m_connections.size() > m_maxSimultaneousConnections) {
-            m_maxSimultaneousConnections = m_connections.size();
-            m_statsReporter->setMaxSimultaneous(m_maxSimultaneousConnections, m_maxSimultaneousGames);
-        }
-
-        QJsonObject response;
-        response["type"] = "registerAccountSuccess";
-        response["playerName"] = pseudo;
-        response["avatar"] = avatar;
-        response["connectionId"] = connectionId;
-        sendMessage(socket, response);
-        qDebug() << "Compte cree avec succes:" << pseudo << "ID:" << connectionId;
-
-        // Enregistrer la création de compte dans les statistiques quotidiennes
-        m_dbManager->recordNewAccount();
-
-        // Enregistrer la connexion et démarrer le tracking de session
-        m_dbManager->recordLogin(pseudo);
-        m_dbManager->recordSessionStart(pseudo);
+    if (pseudo.isEmpty() || email.isEmpty() || password.isEmpty()) {
+        errorMsg = "Tous les champs sont obligatoires";
     } else {
-        // Echec
+        DatabaseManager::validatePassword(password, errorMsg);
+    }
+    if (!errorMsg.isEmpty()) {
         QJsonObject response;
         response["type"] = "registerAccountFailed";
         response["error"] = errorMsg;
         sendMessage(socket, response);
         qDebug() << "Echec creation compte:" << errorMsg;
+        return;
+    }
+
+    // Hachage sur m_hashPool, puis création du compte sur le thread SQLite
+    bool lance = runPasswordJob<QPair<QString, QString>>([password]() {
+        QString salt = PasswordHasher::generateSalt();
+        return qMakePair(salt, PasswordHasher::hash(password, salt));
+    }, [this, socket = QPointer<QWebSocket>(socket), pseudo, email, avatar](const QPair<QString, QString> &hash) {
+        if (!socket) return;
+        createHashedAccount(socket, pseudo, email, hash.first, hash.second, avatar, "registerAccountFailed");
+    });
+    if (!lance) {
+        QJsonObject response;
+        response["type"] = "registerAccountFailed";
+        response["error"] = SERVER_BUSY_MESSAGE;
+        sendMessage(socket, response);
     }
 }
 
+void GameServer::createHashedAccount(const QPointer<QWebSocket> &socket, const QString &pseudo, const QString &email,
+                                     const QString &salt, const QString &passwordHash, const QString &avatar,
+                                     const QString &failureType) {
+    // Création du compte sur le thread SQLite, réponse au retour
+    m_dbWorker.request<DbResult>(this, [pseudo, email, salt, passwordHash, avatar](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.createAccountWithHash(pseudo, email, passwordHash, salt, avatar, result.errorMsg);
+        if (result.ok) {
+            // Enregistrer la création de compte, la connexion et démarrer le tracking de session
+            db.recordNewAccount();
+            db.recordLogin(pseudo);
+            db.recordSessionStart(pseudo);
+        }
+        return result;
+    }, [this, socket, pseudo, avatar, failureType](const DbResult &result) {
+        if (!socket) {
+            // Client parti pendant la création : clore la session ouverte
+            if (result.ok) m_dbWorker.post([pseudo](DatabaseManager &db) { db.recordSessionEnd(pseudo); });
+            return;
+        }
+
+        if (result.ok) {
+            // Succès - Créer une connexion et enregistrer le joueur (comme pour loginAccount)
+            QString connectionId = QUuid::createUuid().toString();
+
+            PlayerConnection *conn = new PlayerConnection{
+                socket,
+                connectionId,
+                pseudo,
+                avatar,
+                -1,    // Pas encore en partie
+                -1,    // Pas encore de position
+                QString(), // lobbyPartnerId
+                QString(), // lobbyCode
+                false  // isAnonymous = false par défaut pour un nouveau compte
+            };
+            addConnection(conn);
+
+            QJsonObject response;
+            response["type"] = "registerAccountSuccess";
+            response["playerName"] = pseudo;
+            response["avatar"] = avatar;
+            response["connectionId"] = connectionId;
+            sendMessage(socket, response);
+            qDebug() << "Compte cree avec succes:" << pseudo << "ID:" << connectionId;
+        } else {
+            // Echec
+            QJsonObject response;
+            response["type"] = failureType;
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+            qDebug() << "Echec creation compte:" << result.errorMsg;
+        }
+    });
+}
+
 void GameServer::handleRequestVerificationCode(QWebSocket *socket, const QJsonObject &data) {
     QString pseudo = data["pseudo"].toString();
     QString email = data["email"].toString();
@@ -852,23 +1000,39 @@ void GameServer::handleRequestVerificationCode(QWebSocket *socket, const QJsonOb
         sendMessage(socket, response);
         return;
     }
-    if (m_dbManager->emailExists(email)) {
-        // Prévention d'énumération : répondre succès silencieux sans envoyer de code
-        qInfo() << "[VERIF_CODE] Email déjà utilisé, succès silencieux pour:" << email;
-        QJsonObject response;
-        response["type"] = "requestVerificationCodeSuccess";
-        response["email"] = email;
-        sendMessage(socket, response);
-        return;
-    }
-    if (m_dbManager->pseudoExists(pseudo)) {
-        QJsonObject response;
-        response["type"] = "requestVerificationCodeFailed";
-        response["error"] = "Ce pseudonyme est déjà utilisé";
-        sendMessage(socket, response);
-        return;
-    }
+    // Disponibilité de l'email et du pseudo sur le thread SQLite, suite au retour
+    m_dbWorker.request<DbResult>(this, [email, pseudo](DatabaseManager &db) {
+        DbResult result;
+        if (db.emailExists(email)) {
+            result.errorMsg = "email";
+        } else if (db.pseudoExists(pseudo)) {
+            result.errorMsg = "Ce pseudonyme est déjà utilisé";
+        } else {
+            result.ok = true;
+        }
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), pseudo, email, password, avatar](const DbResult &result) {
+        if (!socket) return;
+        if (result.ok) {
+            sendVerificationCode(socket, pseudo, email, password, avatar);
+        } else if (result.errorMsg == "email") {
+            // Prévention d'énumération : répondre succès silencieux sans envoyer de code
+            qInfo() << "[VERIF_CODE] Email déjà utilisé, succès silencieux pour:" << email;
+            QJsonObject response;
+            response["type"] = "requestVerificationCodeSuccess";
+            response["email"] = email;
+            sendMessage(socket, response);
+        } else {
+            QJsonObject response;
+            response["type"] = "requestVerificationCodeFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+        }
+    });
+}
 
+void GameServer::sendVerificationCode(QWebSocket *socket, const QString &pseudo, const QString &email,
+                                      const QString &password, const QString &avatar) {
     // Vérifier cooldown de renvoi si une vérification existe déjà pour cet email
     qint64 now = QDateTime::currentMSecsSinceEpoch();
     if (m_pendingVerifications.contains(email)) {
@@ -1009,52 +1173,24 @@ void GameServer::handleVerifyCodeAndRegister(QWebSocket *socket, const QJsonObje
         return;
     }
 
-    // Code correct — créer le compte
-    QString errorMsg;
-    if (m_dbManager->createAccount(pending->pseudo, pending->email, pending->password, pending->avatar, errorMsg)) {
-        QString connectionId = QUuid::createUuid().toString();
-
-        PlayerConnection *conn = new PlayerConnection{
-            socket,
-            connectionId,
-            pending->pseudo,
-            pending->avatar,
-            -1,    // Pas encore en partie
-            -1,    // Pas encore de position
-            QString(), // lobbyPartnerId
-            QString(), // lobbyCode
-            false  // isAnonymous
-        };
-        m_connections[connectionId] = conn;
-        if (m_connections.size() > m_maxSimultaneousConnections) {
-            m_maxSimultaneousConnections = m_connections.size();
-            m_statsReporter->setMaxSimultaneous(m_maxSimultaneousConnections, m_maxSimultaneousGames);
-        }
-
-        QJsonObject response;
-        response["type"] = "registerAccountSuccess";
-        response["playerName"] = pending->pseudo;
-        response["avatar"] = pending->avatar;
-        response["connectionId"] = connectionId;
-        sendMessage(socket, response);
-        qDebug() << "Compte créé avec succès après vérification:" << pending->pseudo;
-
-        m_dbManager->recordNewAccount();
-        m_dbManager->recordLogin(pending->pseudo);
-        m_dbManager->recordSessionStart(pending->pseudo);
-
-        // Nettoyer le pending
-        delete pending;
-        m_pendingVerifications.remove(email);
-    } else {
+    // Code correct — créer le compte (la vérification est consommée dans tous les cas)
+    PendingVerification verification = *pending;
+    delete pending;
+    m_pendingVerifications.remove(email);
+
+    bool lance = runPasswordJob<QPair<QString, QString>>([password = verification.password]() {
+        QString salt = PasswordHasher::generateSalt();
+        return qMakePair(salt, PasswordHasher::hash(password, salt));
+    }, [this, socket = QPointer<QWebSocket>(socket), verification](const QPair<QString, QString> &hash) {
+        if (!socket) return;
+        createHashedAccount(socket, verification.pseudo, verification.email, hash.first, hash.second,
+                            verification.avatar, "verifyCodeFailed");
+    });
+    if (!lance) {
         QJsonObject response;
         response["type"] = "verifyCodeFailed";
-        response["error"] = errorMsg;
+        response["error"] = SERVER_BUSY_MESSAGE;
         sendMessage(socket, response);
-        qDebug() << "Echec création compte après vérification:" << errorMsg;
-
-        delete pending;
-        m_pendingVerifications.remove(email);
     }
 }
 
@@ -1064,12 +1200,72 @@ void GameServer::handleLoginAccount(QWebSocket *socket, const QJsonObject &data)
 
     qDebug() << "GameServer - Tentative connexion:" << email;
 
-    QString pseudo;
-    QString avatar;
-    QString errorMsg;
-    bool usingTempPassword = false;
-    bool isAnonymous = false;
-    if (m_dbManager->authenticateUser(email, password, pseudo, avatar, errorMsg, usingTempPassword, isAnonymous)) {
+    if (email.isEmpty() || password.isEmpty()) {
+        sendLoginFailed(socket, "Email et mot de passe requis");
+        return;
+    }
+    if (m_pendingPasswordJobs >= MAX_PENDING_PASSWORD_JOBS) {
+        sendLoginFailed(socket, SERVER_BUSY_MESSAGE);
+        return;
+    }
+
+    // Identifiants lus sur un thread de lecture (après un éventuel changement de mot de passe
+    // encore en file), mot de passe vérifié sur m_hashPool :
+    // ni le thread réseau ni le thread SQLite n'attendent le calcul PBKDF2
+    m_dbWorker.readAfterWrites<DatabaseManager::Credentials>(this, [email](DatabaseManager &db) {
+        return db.getCredentials(email);
+    }, [this, socket = QPointer<QWebSocket>(socket), email, password](const DatabaseManager::Credentials &credentials) {
+        if (!socket) return;
+        bool lance = runPasswordJob<DatabaseManager::PasswordCheck>([credentials, email, password]() {
+            return DatabaseManager::checkPassword(credentials, email, password);
+        }, [this, socket, email, credentials](const DatabaseManager::PasswordCheck &check) {
+            if (!socket) return;
+            if (!check.ok) {
+                sendLoginFailed(socket, check.errorMsg);
+                return;
+            }
+            completeLoginAccount(socket, email, credentials, check);
+        });
+        if (!lance) sendLoginFailed(socket, SERVER_BUSY_MESSAGE);
+    });
+}
+
+void GameServer::sendLoginFailed(QWebSocket *socket, const QString &error) {
+    QJsonObject response;
+    response["type"] = "loginAccountFailed";
+    response["error"] = error;
+    sendMessage(socket, response);
+    qDebug() << "Echec connexion:" << error;
+}
+
+void GameServer::completeLoginAccount(const QPointer<QWebSocket> &socket, const QString &email,
+                                      const DatabaseManager::Credentials &credentials,
+                                      const DatabaseManager::PasswordCheck &check) {
+    // last_login (et nouveau hash éventuel), tracking et liste d'amis en une requête sur le thread SQLite
+    m_dbWorker.request<LoginResult>(this, [email, credentials, check](DatabaseManager &db) {
+        LoginResult result;
+        result.ok = true;
+        result.pseudo = credentials.pseudo;
+        result.avatar = credentials.avatar;
+        result.usingTempPassword = check.usingTempPassword;
+        result.isAnonymous = credentials.isAnonymous;
+        db.completeLogin(email, credentials.passwordHash, check.newHash);
+
+        // Enregistrer la connexion et démarrer le tracking de session (lightweight - pas de timer)
+        db.recordLogin(result.pseudo);
+        db.recordSessionStart(result.pseudo);
+        result.friends = db.getFriendsList(result.pseudo);
+        result.pendingRequests = db.getPendingFriendRequests(result.pseudo);
+        return result;
+    }, [this, socket](const LoginResult &result) {
+        if (!socket) {
+            // Client parti pendant l'authentification : clore la session ouverte
+            m_dbWorker.post([pseudo = result.pseudo](DatabaseManager &db) { db.recordSessionEnd(pseudo); });
+            return;
+        }
+
+        const QString &pseudo = result.pseudo;
+        const QString &avatar = result.avatar;
         // Succès - Créer une connexion et enregistrer le joueur
         QString connectionId = QUuid::createUuid().toString();
 
@@ -1082,53 +1278,27 @@ void GameServer::handleLoginAccount(QWebSocket *socket, const QJsonObject &data)
             -1,    // Pas encore de position
             QString(), // lobbyPartnerId
             QString(), // lobbyCode
-            isAnonymous
+            result.isAnonymous
         };
-        m_connections[connectionId] = conn;
-        if (m_connections.size() > m_maxSimultaneousConnections) {
-            m_maxSimultaneousConnections = m_connections.size();
-            m_statsReporter->setMaxSimultaneous(m_maxSimultaneousConnections, m_maxSimultaneousGames);
-        }
+        addConnection(conn);
 
         QJsonObject response;
         response["type"] = "loginAccountSuccess";
         response["playerName"] = pseudo;
         response["avatar"] = avatar;
         response["connectionId"] = connectionId;
-        response["usingTempPassword"] = usingTempPassword;
-        response["isAnonymous"] = isAnonymous;
+        response["usingTempPassword"] = result.usingTempPassword;
+        response["isAnonymous"] = result.isAnonymous;
         sendMessage(socket, response);
         qDebug() << "Connexion reussie:" << pseudo << "avatar:" << avatar << "ID:" << connectionId;
 
-        // Enregistrer la connexion dans les statistiques quotidiennes
-        m_dbManager->recordLogin(pseudo);
-
-        // Démarrer le tracking de session (lightweight - pas de timer)
-        m_dbManager->recordSessionStart(pseudo);
-
         // Envoyer la liste d'amis au login
-        {
-            QJsonArray friends = m_dbManager->getFriendsList(pseudo);
-            // Marquer le statut en ligne pour chaque ami
-            for (int i = 0; i < friends.size(); i++) {
-                QJsonObject f = friends[i].toObject();
-                QString friendPseudo = f["pseudo"].toString();
-                bool online = false;
-                for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-                    if (it.value() && it.value()->playerName == friendPseudo) {
-                        online = true;
-                        break;
-                    }
-                }
-                f["online"] = online;
-                friends[i] = f;
-            }
-            QJsonArray pending = m_dbManager->getPendingFriendRequests(pseudo);
-            QJsonObject friendsMsg;
-            friendsMsg["type"] = "friendsList";
-            friendsMsg["friends"] = friends;
-            friendsMsg["pendingRequests"] = pending;
-            sendMessage(socket, friendsMsg);
+        sendFriendsList(socket, result.friends, result.pendingRequests);
+
+        // Partie tenue par un autre serveur (multi-processus) : le client s'y reconnecte
+        if (m_broker && !m_playerNameToRoomId.contains(pseudo)
+            && redirectClient(socket, m_broker->urlForPlayer(pseudo))) {
+            return;
         }
 
         // Vérifier si le joueur peut se reconnecter à une partie en cours
@@ -1160,14 +1330,7 @@ void GameServer::handleLoginAccount(QWebSocket *socket, const QJsonObject &data)
                 }
             }
         }
-    } else {
-        // Echec
-        QJsonObject response;
-        response["type"] = "loginAccountFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-        qDebug() << "Echec connexion:" << errorMsg;
-    }
+    });
 }
 
 void GameServer::handleDeleteAccount(QWebSocket *socket, const QJsonObject &data) {
@@ -1197,31 +1360,47 @@ void GameServer::handleDeleteAccount(QWebSocket *socket, const QJsonObject &data
     }
 
     // Supprimer le compte
-    QString errorMsg;
-    if (m_dbManager->deleteAccount(pseudo, errorMsg)) {
-        // Succès
-        QJsonObject response;
-        response["type"] = "deleteAccountSuccess";
-        sendMessage(socket, response);
-        qInfo() << "[DELETE_ACCOUNT] SUCCÈS - Compte supprimé et déconnecté - pseudo:" << pseudo;
-
-        // Déconnecter le joueur de toute partie en cours
-        if (conn->gameRoomId != -1) {
-            // Le joueur est en partie, le traiter comme un forfait
-            handleForfeit(socket);
+    // Supprimer le compte (thread SQLite), suite au retour
+    m_dbWorker.request<DbResult>(this, [pseudo](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.deleteAccount(pseudo, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), pseudo](const DbResult &result) {
+        if (result.ok) {
+            for (const QString &mode : {QString("coinche"), QString("belote")}) {
+                ratingsFor(mode).remove(pseudo);
+                leaderboardFor(mode).remove(pseudo);
+            }
         }
+        if (!socket) return;
+        QString connectionId = getConnectionIdBySocket(socket, pseudo);
+        if (connectionId.isEmpty()) return;
+        PlayerConnection *conn = m_connections[connectionId];
 
-        // Supprimer la connexion
-        m_connections.remove(connectionId);
-        delete conn;
-    } else {
-        // Echec
-        qWarning() << "[DELETE_ACCOUNT] Échec - Erreur DB - pseudo:" << pseudo << "erreur:" << errorMsg;
-        QJsonObject response;
-        response["type"] = "deleteAccountFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-    }
+        if (result.ok) {
+            // Succès
+            QJsonObject response;
+            response["type"] = "deleteAccountSuccess";
+            sendMessage(socket, response);
+            qInfo() << "[DELETE_ACCOUNT] SUCCÈS - Compte supprimé et déconnecté - pseudo:" << pseudo;
+
+            // Déconnecter le joueur de toute partie en cours
+            if (conn->gameRoomId != -1) {
+                // Le joueur est en partie, le traiter comme un forfait
+                handleForfeit(socket);
+            }
+
+            // Supprimer la connexion
+            removeConnection(conn);
+        } else {
+            // Echec
+            qWarning() << "[DELETE_ACCOUNT] Échec - Erreur DB - pseudo:" << pseudo << "erreur:" << result.errorMsg;
+            QJsonObject response;
+            response["type"] = "deleteAccountFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+        }
+    });
 }
 
 void GameServer::handleForgotPassword(QWebSocket *socket, const QJsonObject &data) {
@@ -1229,56 +1408,91 @@ void GameServer::handleForgotPassword(QWebSocket *socket, const QJsonObject &dat
 
     qDebug() << "GameServer - Demande mot de passe oublie pour:" << email;
 
-    QString tempPassword;
-    QString errorMsg;
+    // Salt du compte lu en base, mot de passe temporaire haché sur m_hashPool,
+    // puis enregistré sur le thread SQLite : aucun ne bloque le thread réseau
+    m_dbWorker.readAfterWrites<DatabaseManager::Credentials>(this, [email](DatabaseManager &db) {
+        return db.getCredentials(email);
+    }, [this, socket = QPointer<QWebSocket>(socket), email](const DatabaseManager::Credentials &credentials) {
+        if (!credentials.found) {
+            // Email non trouvé ou erreur - renvoyer un succès pour ne pas révéler
+            // si l'adresse email existe dans la base (protection contre l'énumération de comptes)
+            QJsonObject response;
+            response["type"] = "forgotPasswordSuccess";
+            sendMessage(socket, response);
+            qDebug() << "Echec mot de passe oublie (masqué au client):" << credentials.error;
+            return;
+        }
 
-    if (m_dbManager->setTempPassword(email, tempPassword, errorMsg)) {
-        // Success - Send email with temp password
-        qDebug() << "Mot de passe temporaire genere:" << tempPassword;
-        qDebug() << "SMTP password configure:" << (m_smtpPassword.isEmpty() ? "NON" : "OUI");
+        QString salt = credentials.salt;
+        bool lance = runPasswordJob<QPair<QString, QString>>([salt]() {
+            QString tempPassword = DatabaseManager::generateTempPassword();
+            return qMakePair(tempPassword, PasswordHasher::hash(tempPassword, salt));
+        }, [this, socket, email, salt](const QPair<QString, QString> &temp) {
+            m_dbWorker.request<DbResult>(this, [email, salt, hash = temp.second](DatabaseManager &db) {
+                DbResult result;
+                result.ok = db.setTempPasswordHash(email, hash, salt, result.errorMsg);
+                return result;
+            }, [this, socket, email, tempPassword = temp.first](const DbResult &result) {
+                // Le mail part même si le client s'est déconnecté (sendMessage ignore un socket nul)
+                if (result.ok) {
+                    sendTempPasswordEmail(socket, email, tempPassword);
+                } else {
+                    QJsonObject response;
+                    response["type"] = "forgotPasswordSuccess";
+                    sendMessage(socket, response);
+                    qDebug() << "Echec mot de passe oublie (masqué au client):" << result.errorMsg;
+                }
+            });
+        });
+        if (!lance) {
+            QJsonObject response;
+            response["type"] = "forgotPasswordFailed";
+            response["error"] = SERVER_BUSY_MESSAGE;
+            sendMessage(socket, response);
+        }
+    });
+}
 
-        SmtpClient *smtp = new SmtpClient(this);
-        smtp->setHost("ssl0.ovh.net", 587);
-        smtp->setCredentials("contact@nebuludik.fr", m_smtpPassword);
-        smtp->setFrom("contact@nebuludik.fr", "Coinche de l'Espace");
+void GameServer::sendTempPasswordEmail(const QPointer<QWebSocket> &socket, const QString &email,
+                                       const QString &tempPassword) {
+    // Success - Send email with temp password
+    qDebug() << "Mot de passe temporaire genere:" << tempPassword;
+    qDebug() << "SMTP password configure:" << (m_smtpPassword.isEmpty() ? "NON" : "OUI");
 
-        QString subject = "Réinitialisation de votre mot de passe";
-        QString emailBody = QString(
-            "Bonjour,\n\n"
-            "Vous avez demandé la réinitialisation de votre mot de passe.\n\n"
-            "Voici votre mot de passe temporaire : %1\n\n"
-            "Ce mot de passe est valide pour une seule connexion. "
-            "Vous devrez choisir un nouveau mot de passe permanent lors de votre prochaine connexion.\n\n"
-            "Si vous n'avez pas demandé cette réinitialisation, ignorez ce message.\n\n"
-            "Cordialement,\n"
-            "L'équipe Coinche de l'Espace"
-        ).arg(tempPassword);
-
-        QObject::connect(smtp, &SmtpClient::emailSent, [socket, smtp, this](bool success, const QString &error) {
-            if (success) {
-                QJsonObject response;
-                response["type"] = "forgotPasswordSuccess";
-                sendMessage(socket, response);
-                qDebug() << "Email de reinitialisation envoye avec succes";
-            } else {
-                QJsonObject response;
-                response["type"] = "forgotPasswordFailed";
-                response["error"] = "Erreur lors de l'envoi de l'email";
-                sendMessage(socket, response);
-                qWarning() << "Echec envoi email:" << error;
-            }
-            smtp->deleteLater();
-        });
+    SmtpClient *smtp = new SmtpClient(this);
+    smtp->setHost("ssl0.ovh.net", 587);
+    smtp->setCredentials("contact@nebuludik.fr", m_smtpPassword);
+    smtp->setFrom("contact@nebuludik.fr", "Coinche de l'Espace");
 
-        smtp->sendEmail(email, subject, emailBody);
-    } else {
-        // Email non trouvé ou erreur - renvoyer un succès pour ne pas révéler
-        // si l'adresse email existe dans la base (protection contre l'énumération de comptes)
-        QJsonObject response;
-        response["type"] = "forgotPasswordSuccess";
-        sendMessage(socket, response);
-        qDebug() << "Echec mot de passe oublie (masqué au client):" << errorMsg;
-    }
+    QString subject = "Réinitialisation de votre mot de passe";
+    QString emailBody = QString(
+        "Bonjour,\n\n"
+        "Vous avez demandé la réinitialisation de votre mot de passe.\n\n"
+        "Voici votre mot de passe temporaire : %1\n\n"
+        "Ce mot de passe est valide pour une seule connexion. "
+        "Vous devrez choisir un nouveau mot de passe permanent lors de votre prochaine connexion.\n\n"
+        "Si vous n'avez pas demandé cette réinitialisation, ignorez ce message.\n\n"
+        "Cordialement,\n"
+        "L'équipe Coinche de l'Espace"
+    ).arg(tempPassword);
+
+    QObject::connect(smtp, &SmtpClient::emailSent, [socket, smtp, this](bool success, const QString &error) {
+        if (success) {
+            QJsonObject response;
+            response["type"] = "forgotPasswordSuccess";
+            sendMessage(socket, response);
+            qDebug() << "Email de reinitialisation envoye avec succes";
+        } else {
+            QJsonObject response;
+            response["type"] = "forgotPasswordFailed";
+            response["error"] = "Erreur lors de l'envoi de l'email";
+            sendMessage(socket, response);
+            qWarning() << "Echec envoi email:" << error;
+        }
+        smtp->deleteLater();
+    });
+
+    smtp->sendEmail(email, subject, emailBody);
 }
 
 void GameServer::handleChangePassword(QWebSocket *socket, const QJsonObject &data) {
@@ -1288,19 +1502,50 @@ void GameServer::handleChangePassword(QWebSocket *socket, const QJsonObject &dat
     qInfo() << "[CHANGE_PASSWORD] Demande changement mot de passe - email:" << email;
 
     QString errorMsg;
-    if (m_dbManager->updatePassword(email, newPassword, errorMsg)) {
-        // Success
-        QJsonObject response;
-        response["type"] = "changePasswordSuccess";
-        sendMessage(socket, response);
-        qInfo() << "[CHANGE_PASSWORD] SUCCÈS - Mot de passe changé - email:" << email;
-    } else {
-        // Failure
+    if (email.isEmpty() || newPassword.isEmpty()) {
+        errorMsg = "Email et nouveau mot de passe requis";
+    }
+    if (!errorMsg.isEmpty() || !DatabaseManager::validatePassword(newPassword, errorMsg)) {
         qWarning() << "[CHANGE_PASSWORD] Échec - email:" << email << "erreur:" << errorMsg;
         QJsonObject response;
         response["type"] = "changePasswordFailed";
         response["error"] = errorMsg;
         sendMessage(socket, response);
+        return;
+    }
+
+    // Hachage sur m_hashPool, puis mise à jour sur le thread SQLite
+    bool lance = runPasswordJob<QPair<QString, QString>>([newPassword]() {
+        QString salt = PasswordHasher::generateSalt();
+        return qMakePair(salt, PasswordHasher::hash(newPassword, salt));
+    }, [this, socket = QPointer<QWebSocket>(socket), email](const QPair<QString, QString> &hash) {
+        m_dbWorker.request<DbResult>(this, [email, salt = hash.first, passwordHash = hash.second](DatabaseManager &db) {
+            DbResult result;
+            result.ok = db.updatePasswordHash(email, passwordHash, salt, result.errorMsg);
+            return result;
+        }, [this, socket, email](const DbResult &result) {
+            if (!socket) return;
+            if (result.ok) {
+                // Success
+                QJsonObject response;
+                response["type"] = "changePasswordSuccess";
+                sendMessage(socket, response);
+                qInfo() << "[CHANGE_PASSWORD] SUCCÈS - Mot de passe changé - email:" << email;
+            } else {
+                // Failure
+                qWarning() << "[CHANGE_PASSWORD] Échec - email:" << email << "erreur:" << result.errorMsg;
+                QJsonObject response;
+                response["type"] = "changePasswordFailed";
+                response["error"] = result.errorMsg;
+                sendMessage(socket, response);
+            }
+        });
+    });
+    if (!lance) {
+        QJsonObject response;
+        response["type"] = "changePasswordFailed";
+        response["error"] = SERVER_BUSY_MESSAGE;
+        sendMessage(socket, response);
     }
 }
 
@@ -1311,13 +1556,7 @@ void GameServer::handleChangePseudo(QWebSocket *socket, const QJsonObject &data)
     qInfo() << "[CHANGE_PSEUDO] Demande changement pseudo -" << currentPseudo << "->" << newPseudo;
 
     // Vérifier que le socket correspond bien au joueur
-    QString connId;
-    for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-        if (it.value()->socket == socket && it.value()->playerName == currentPseudo) {
-            connId = it.key();
-            break;
-        }
-    }
+    QString connId = getConnectionIdBySocket(socket, currentPseudo);
 
     if (connId.isEmpty()) {
         qWarning() << "[CHANGE_PSEUDO] Échec - Session invalide - pseudo demandé:" << currentPseudo;
@@ -1328,29 +1567,47 @@ void GameServer::handleChangePseudo(QWebSocket *socket, const QJsonObject &data)
         return;
     }
 
-    QString errorMsg;
-    if (m_dbManager->updatePseudo(currentPseudo, newPseudo, errorMsg)) {
-        // Mettre à jour le nom dans la connexion
-        m_connections[connId]->playerName = newPseudo;
+    m_dbWorker.request<DbResult>(this, [currentPseudo, newPseudo](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.updatePseudo(currentPseudo, newPseudo, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), connId, currentPseudo, newPseudo](const DbResult &result) {
+        // La connexion a pu se fermer pendant la requête : l'état du serveur suit quand même la base
+        PlayerConnection *conn = m_connections.value(connId, nullptr);
+        if (result.ok) {
+            // Mettre à jour le nom dans la connexion
+            if (conn) conn->playerName = newPseudo;
+
+            // Mettre à jour m_playerNameToRoomId si le joueur est en partie
+            if (m_playerNameToRoomId.contains(currentPseudo)) {
+                int roomId = m_playerNameToRoomId.take(currentPseudo);
+                m_playerNameToRoomId[newPseudo] = roomId;
+            }
 
-        // Mettre à jour m_playerNameToRoomId si le joueur est en partie
-        if (m_playerNameToRoomId.contains(currentPseudo)) {
-            int roomId = m_playerNameToRoomId.take(currentPseudo);
-            m_playerNameToRoomId[newPseudo] = roomId;
-        }
+            // Cotes et classements suivent le pseudo (en base, elles sont liées au compte)
+            for (const QString &mode : {QString("coinche"), QString("belote")}) {
+                if (ratingsFor(mode).contains(currentPseudo)) {
+                    ratingsFor(mode)[newPseudo] = ratingsFor(mode).take(currentPseudo);
+                    leaderboardFor(mode).remove(currentPseudo);
+                    refreshLeaderboard(mode, newPseudo, !conn || conn->isAnonymous);
+                }
+            }
 
-        QJsonObject response;
-        response["type"] = "changePseudoSuccess";
-        response["newPseudo"] = newPseudo;
-        sendMessage(socket, response);
-        qInfo() << "[CHANGE_PSEUDO] SUCCÈS - Pseudo changé -" << currentPseudo << "->" << newPseudo;
-    } else {
-        qWarning() << "[CHANGE_PSEUDO] Échec -" << currentPseudo << "->" << newPseudo << "erreur:" << errorMsg;
-        QJsonObject response;
-        response["type"] = "changePseudoFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-    }
+            if (!socket) return;
+            QJsonObject response;
+            response["type"] = "changePseudoSuccess";
+            response["newPseudo"] = newPseudo;
+            sendMessage(socket, response);
+            qInfo() << "[CHANGE_PSEUDO] SUCCÈS - Pseudo changé -" << currentPseudo << "->" << newPseudo;
+        } else {
+            qWarning() << "[CHANGE_PSEUDO] Échec -" << currentPseudo << "->" << newPseudo << "erreur:" << result.errorMsg;
+            if (!socket) return;
+            QJsonObject response;
+            response["type"] = "changePseudoFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+        }
+    });
 }
 
 void GameServer::handleChangeEmail(QWebSocket *socket, const QJsonObject &data) {
@@ -1360,13 +1617,7 @@ void GameServer::handleChangeEmail(QWebSocket *socket, const QJsonObject &data)
     qInfo() << "[CHANGE_EMAIL] Demande changement email - pseudo:" << pseudo << "nouvel email:" << newEmail;
 
     // Vérifier que le socket correspond bien au joueur
-    bool authorized = false;
-    for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-        if (it.value()->socket == socket && it.value()->playerName == pseudo) {
-            authorized = true;
-            break;
-        }
-    }
+    bool authorized = !getConnectionIdBySocket(socket, pseudo).isEmpty();
 
     if (!authorized) {
         qWarning() << "[CHANGE_EMAIL] Échec - Session invalide - pseudo:" << pseudo;
@@ -1377,20 +1628,26 @@ void GameServer::handleChangeEmail(QWebSocket *socket, const QJsonObject &data)
         return;
     }
 
-    QString errorMsg;
-    if (m_dbManager->updateEmail(pseudo, newEmail, errorMsg)) {
-        QJsonObject response;
-        response["type"] = "changeEmailSuccess";
-        response["newEmail"] = newEmail;
-        sendMessage(socket, response);
-        qInfo() << "[CHANGE_EMAIL] SUCCÈS - Email changé - pseudo:" << pseudo << "nouvel email:" << newEmail;
-    } else {
-        qWarning() << "[CHANGE_EMAIL] Échec - pseudo:" << pseudo << "erreur:" << errorMsg;
-        QJsonObject response;
-        response["type"] = "changeEmailFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-    }
+    m_dbWorker.request<DbResult>(this, [pseudo, newEmail](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.updateEmail(pseudo, newEmail, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), pseudo, newEmail](const DbResult &result) {
+        if (!socket) return;
+        if (result.ok) {
+            QJsonObject response;
+            response["type"] = "changeEmailSuccess";
+            response["newEmail"] = newEmail;
+            sendMessage(socket, response);
+            qInfo() << "[CHANGE_EMAIL] SUCCÈS - Email changé - pseudo:" << pseudo << "nouvel email:" << newEmail;
+        } else {
+            qWarning() << "[CHANGE_EMAIL] Échec - pseudo:" << pseudo << "erreur:" << result.errorMsg;
+            QJsonObject response;
+            response["type"] = "changeEmailFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+        }
+    });
 }
 
 void GameServer::handleRequestEmailChangeCode(QWebSocket *socket, const QJsonObject &data) {
@@ -1409,15 +1666,23 @@ void GameServer::handleRequestEmailChangeCode(QWebSocket *socket, const QJsonObj
 
     // Si l'email est déjà utilisé, on répond "succès" sans envoyer de code
     // (prévention d'énumération : on ne révèle pas si l'adresse est enregistrée)
-    if (m_dbManager->emailExists(newEmail)) {
-        qInfo() << "[EMAIL_CHANGE_CODE] Email déjà utilisé, succès silencieux pour:" << newEmail;
-        QJsonObject response;
-        response["type"] = "requestEmailChangeCodeSuccess";
-        response["newEmail"] = newEmail;
-        sendMessage(socket, response);
-        return;
-    }
+    m_dbWorker.request<bool>(this, [newEmail](DatabaseManager &db) {
+        return db.emailExists(newEmail);
+    }, [this, socket = QPointer<QWebSocket>(socket), pseudo, newEmail](const bool &emailUtilise) {
+        if (!socket) return;
+        if (emailUtilise) {
+            qInfo() << "[EMAIL_CHANGE_CODE] Email déjà utilisé, succès silencieux pour:" << newEmail;
+            QJsonObject response;
+            response["type"] = "requestEmailChangeCodeSuccess";
+            response["newEmail"] = newEmail;
+            sendMessage(socket, response);
+            return;
+        }
+        sendEmailChangeCode(socket, pseudo, newEmail);
+    });
+}
 
+void GameServer::sendEmailChangeCode(QWebSocket *socket, const QString &pseudo, const QString &newEmail) {
     // Vérifier cooldown de renvoi
     qint64 now = QDateTime::currentMSecsSinceEpoch();
     if (m_pendingVerifications.contains(newEmail)) {
@@ -1543,19 +1808,25 @@ void GameServer::handleVerifyCodeAndChangeEmail(QWebSocket *socket, const QJsonO
     delete pending;
     m_pendingVerifications.remove(newEmail);
 
-    QString errorMsg;
-    if (m_dbManager->updateEmail(pseudo, newEmail, errorMsg)) {
-        QJsonObject response;
-        response["type"] = "changeEmailSuccess";
-        response["newEmail"] = newEmail;
-        sendMessage(socket, response);
-        qInfo() << "[VERIFY_EMAIL_CHANGE] SUCCÈS - Email changé - pseudo:" << pseudo << "->" << newEmail;
-    } else {
-        QJsonObject response;
-        response["type"] = "verifyEmailChangeFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-    }
+    m_dbWorker.request<DbResult>(this, [pseudo, newEmail](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.updateEmail(pseudo, newEmail, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), pseudo, newEmail](const DbResult &result) {
+        if (!socket) return;
+        if (result.ok) {
+            QJsonObject response;
+            response["type"] = "changeEmailSuccess";
+            response["newEmail"] = newEmail;
+            sendMessage(socket, response);
+            qInfo() << "[VERIFY_EMAIL_CHANGE] SUCCÈS - Email changé - pseudo:" << pseudo << "->" << newEmail;
+        } else {
+            QJsonObject response;
+            response["type"] = "verifyEmailChangeFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+        }
+    });
 }
 
 void GameServer::handleSetAnonymous(QWebSocket *socket, const QJsonObject &data) {
@@ -1565,13 +1836,7 @@ void GameServer::handleSetAnonymous(QWebSocket *socket, const QJsonObject &data)
     qDebug() << "GameServer - Demande anonymisation pour:" << pseudo << "->" << anonymous;
 
     // Vérifier que le socket correspond bien au joueur
-    QString connId;
-    for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-        if (it.value()->socket == socket && it.value()->playerName == pseudo) {
-            connId = it.key();
-            break;
-        }
-    }
+    QString connId = getConnectionIdBySocket(socket, pseudo);
 
     if (connId.isEmpty()) {
         QJsonObject response;
@@ -1581,22 +1846,32 @@ void GameServer::handleSetAnonymous(QWebSocket *socket, const QJsonObject &data)
         return;
     }
 
-    QString errorMsg;
-    if (m_dbManager->setAnonymous(pseudo, anonymous, errorMsg)) {
-        m_connections[connId]->isAnonymous = anonymous;
-
-        QJsonObject response;
-        response["type"] = "setAnonymousSuccess";
-        response["anonymous"] = anonymous;
-        sendMessage(socket, response);
-        qDebug() << "Anonymisation mise à jour pour:" << pseudo << "->" << anonymous;
-    } else {
-        QJsonObject response;
-        response["type"] = "setAnonymousFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-        qDebug() << "Echec anonymisation:" << errorMsg;
-    }
+    m_dbWorker.request<DbResult>(this, [pseudo, anonymous](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.setAnonymous(pseudo, anonymous, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), connId, pseudo, anonymous](const DbResult &result) {
+        if (result.ok) {
+            // Le classement suit la base même si le client s'est déconnecté entre-temps
+            if (PlayerConnection *conn = m_connections.value(connId, nullptr)) conn->isAnonymous = anonymous;
+            refreshLeaderboard("coinche", pseudo, anonymous);
+            refreshLeaderboard("belote", pseudo, anonymous);
+        }
+        if (!socket) return;
+        if (result.ok) {
+            QJsonObject response;
+            response["type"] = "setAnonymousSuccess";
+            response["anonymous"] = anonymous;
+            sendMessage(socket, response);
+            qDebug() << "Anonymisation mise à jour pour:" << pseudo << "->" << anonymous;
+        } else {
+            QJsonObject response;
+            response["type"] = "setAnonymousFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+            qDebug() << "Echec anonymisation:" << result.errorMsg;
+        }
+    });
 }
 
 void GameServer::handleSendContactMessage(QWebSocket *socket, const QJsonObject &data) {
@@ -1664,7 +1939,7 @@ void GameServer::handleReportCrash(QWebSocket *socket, const QJsonObject &data)
     qWarning() << "CRASH REPORT reçu de:" << playerName << "- Erreur:" << errorMsg;
 
     // Enregistrer le crash dans les statistiques
-    m_dbManager->recordCrash();
+    m_dbWorker.post([](DatabaseManager &db) { db.recordCrash(); });
 
     // Log détaillé pour debug
     if (!stackTrace.isEmpty()) {
@@ -1761,64 +2036,94 @@ void GameServer::handleSendEmoji(QWebSocket *socket, const QJsonObject &data) {
     broadcastToRoom(conn->gameRoomId, msg);
 }
 
+void GameServer::loadMatchmakingRatings(const QString &connectionId, const QString &playerName) {
+    m_dbWorker.readAfterWrites<DatabaseManager::PlayerStats>(this, [playerName](DatabaseManager &db) {
+        return db.getPlayerStats(playerName);
+    }, [this, connectionId](const DatabaseManager::PlayerStats &stats) {
+        PlayerConnection *conn = m_connections.value(connectionId);
+        if (!conn) return;
+        // Cote Glicko-2 si le joueur en a une, sinon estimation d'après son bilan
+        conn->ratingCoinche = m_ratingsCoinche.contains(conn->playerName)
+            ? m_ratingsCoinche[conn->playerName].rating
+            : Matchmaker<QString>::ratingFromRecord(stats.gamesPlayed, stats.gamesWon);
+        conn->ratingBelote = m_ratingsBelote.contains(conn->playerName)
+            ? m_ratingsBelote[conn->playerName].rating
+            : Matchmaker<QString>::ratingFromRecord(stats.beloteGamesPlayed, stats.beloteGamesWon);
+
+        // Déjà en file (stats arrivées après joinMatchmaking) : replacer le joueur
+        if (m_matchmakingQueueCoinche.contains(connectionId)) {
+            m_matchmakingQueueCoinche.setRating(connectionId, conn->ratingCoinche);
+        }
+        if (m_matchmakingQueueBelote.contains(connectionId)) {
+            m_matchmakingQueueBelote.setRating(connectionId, conn->ratingBelote);
+        }
+    });
+}
+
 void GameServer::handleGetStats(QWebSocket *socket, const QJsonObject &data) {
     QString pseudo = data["pseudo"].toString();
 
     qDebug() << "GameServer - Demande de stats pour:" << pseudo;
 
-    DatabaseManager::PlayerStats stats = m_dbManager->getPlayerStats(pseudo);
-
     // Vérifier si le demandeur est ami avec le joueur consulté
     QString requesterPseudo;
     QString connectionId = getConnectionIdBySocket(socket);
     if (!connectionId.isEmpty() && m_connections.contains(connectionId)) {
         requesterPseudo = m_connections[connectionId]->playerName;
     }
-    bool isFriend = false;
-    if (!requesterPseudo.isEmpty() && requesterPseudo != pseudo) {
-        QJsonArray friends = m_dbManager->getFriendsList(requesterPseudo);
-        for (int i = 0; i < friends.size(); i++) {
-            if (friends[i].toObject()["pseudo"].toString() == pseudo) {
-                isFriend = true;
-                break;
+
+    m_dbWorker.readAfterWrites<StatsData>(this, [pseudo, requesterPseudo](DatabaseManager &db) {
+        StatsData result;
+        result.stats = db.getPlayerStats(pseudo);
+        if (!requesterPseudo.isEmpty() && requesterPseudo != pseudo) {
+            QJsonArray friends = db.getFriendsList(requesterPseudo);
+            for (int i = 0; i < friends.size(); i++) {
+                if (friends[i].toObject()["pseudo"].toString() == pseudo) {
+                    result.isFriend = true;
+                    break;
+                }
             }
         }
-    }
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), pseudo](const StatsData &result) {
+        if (!socket) return;
 
-    QJsonObject response;
-    response["type"] = "statsData";
-    response["isFriend"] = isFriend;
-    response["gamesPlayed"] = stats.gamesPlayed;
-    response["gamesWon"] = stats.gamesWon;
-    response["winRatio"] = stats.winRatio;
-    response["coincheAttempts"] = stats.coincheAttempts;
-    response["coincheSuccess"] = stats.coincheSuccess;
-    response["capotRealises"] = stats.capotRealises;
-    response["capotAnnoncesRealises"] = stats.capotAnnoncesRealises;
-    response["capotAnnoncesTentes"] = stats.capotAnnoncesTentes;
-    response["generaleAttempts"] = stats.generaleAttempts;
-    response["generaleSuccess"] = stats.generaleSuccess;
-    response["annoncesCoinchees"] = stats.annoncesCoinchees;
-    response["annoncesCoincheesgagnees"] = stats.annoncesCoincheesgagnees;
-    response["surcoincheAttempts"] = stats.surcoincheAttempts;
-    response["surcoincheSuccess"] = stats.surcoincheSuccess;
-    response["annoncesSurcoinchees"] = stats.annoncesSurcoinchees;
-    response["annoncesSurcoincheesGagnees"] = stats.annoncesSurcoincheesGagnees;
-    response["maxWinStreak"] = stats.maxWinStreak;
-    response["beloteGamesPlayed"] = stats.beloteGamesPlayed;
-    response["beloteGamesWon"] = stats.beloteGamesWon;
-    response["beloteMaxWinStreak"] = stats.beloteMaxWinStreak;
-    response["beloteCapots"] = stats.beloteCapots;
-
-    qDebug() << "Stats envoyees pour:" << pseudo
-                << "- Parties:" << stats.gamesPlayed
-                << "Victoires:" << stats.gamesWon
-                << "Ratio:" << stats.winRatio
-                << "Capots:" << stats.capotRealises
-                << "Generales:" << stats.generaleSuccess
-                << "Annonces coinchées:" << stats.annoncesCoinchees;
+        const DatabaseManager::PlayerStats &stats = result.stats;
+        QJsonObject response;
+        response["type"] = "statsData";
+        response["isFriend"] = result.isFriend;
+        response["gamesPlayed"] = stats.gamesPlayed;
+        response["gamesWon"] = stats.gamesWon;
+        response["winRatio"] = stats.winRatio;
+        response["coincheAttempts"] = stats.coincheAttempts;
+        response["coincheSuccess"] = stats.coincheSuccess;
+        response["capotRealises"] = stats.capotRealises;
+        response["capotAnnoncesRealises"] = stats.capotAnnoncesRealises;
+        response["capotAnnoncesTentes"] = stats.capotAnnoncesTentes;
+        response["generaleAttempts"] = stats.generaleAttempts;
+        response["generaleSuccess"] = stats.generaleSuccess;
+        response["annoncesCoinchees"] = stats.annoncesCoinchees;
+        response["annoncesCoincheesgagnees"] = stats.annoncesCoincheesgagnees;
+        response["surcoincheAttempts"] = stats.surcoincheAttempts;
+        response["surcoincheSuccess"] = stats.surcoincheSuccess;
+        response["annoncesSurcoinchees"] = stats.annoncesSurcoinchees;
+        response["annoncesSurcoincheesGagnees"] = stats.annoncesSurcoincheesGagnees;
+        response["maxWinStreak"] = stats.maxWinStreak;
+        response["beloteGamesPlayed"] = stats.beloteGamesPlayed;
+        response["beloteGamesWon"] = stats.beloteGamesWon;
+        response["beloteMaxWinStreak"] = stats.beloteMaxWinStreak;
+        response["beloteCapots"] = stats.beloteCapots;
+
+        qDebug() << "Stats envoyees pour:" << pseudo
+                    << "- Parties:" << stats.gamesPlayed
+                    << "Victoires:" << stats.gamesWon
+                    << "Ratio:" << stats.winRatio
+                    << "Capots:" << stats.capotRealises
+                    << "Generales:" << stats.generaleSuccess
+                    << "Annonces coinchées:" << stats.annoncesCoinchees;
 
-    sendMessage(socket, response);
+        sendMessage(socket, response);
+    });
 }
 
 void GameServer::handleJoinMatchmaking(QWebSocket *socket, const QJsonObject &data) {
@@ -1831,11 +2136,19 @@ void GameServer::handleJoinMatchmaking(QWebSocket *socket, const QJsonObject &da
         m_connections[connectionId]->preferredGameMode = gameMode;
     }
 
+    // Multi-processus : un seul serveur remplit la prochaine table de ce mode
+    // (pas de seconde redirection pour un client qui vient d'être redirigé)
+    if (m_broker && !data.value("redirected").toBool(false)) {
+        QJsonObject resume;
+        resume["resume"] = "joinMatchmaking";
+        resume["gameMode"] = gameMode;
+        if (redirectClient(socket, m_broker->urlForMatchmaking(gameMode), resume)) return;
+    }
+
     // Router vers la file du mode correspondant
-    QQueue<QString>& targetQueue = (gameMode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
+    Matchmaker<QString>& targetQueue = (gameMode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
 
-    if (!targetQueue.contains(connectionId)) {
-        targetQueue.enqueue(connectionId);
+    if (targetQueue.enqueue(connectionId, matchmakingRating(m_connections[connectionId], gameMode), m_timingClock.elapsed())) {
         qDebug() << "Joueur en attente [" << gameMode << "]:" << connectionId
                     << "Coinche queue:" << m_matchmakingQueueCoinche.size()
                     << "Belote queue:" << m_matchmakingQueueBelote.size();
@@ -1849,6 +2162,7 @@ void GameServer::handleJoinMatchmaking(QWebSocket *socket, const QJsonObject &da
         modeCountdownTimer->stop();
         modeMainTimer->start();
         qDebug() << "Timer matchmaking [" << gameMode << "] démarré/redémarré - 25s + 9s countdown avant création avec bots";
+        brokerStateChanged();
 
         // Essaye de créer une partie si 4 joueurs dans cette queue
         tryCreateGame();
@@ -1867,8 +2181,8 @@ void GameServer::handleLeaveMatchmaking(QWebSocket *socket) {
     QString lobbyCode = conn->lobbyCode;
     QString gameMode = conn->preferredGameMode;
 
-    m_matchmakingQueueCoinche.removeAll(connectionId);
-    m_matchmakingQueueBelote.removeAll(connectionId);
+    m_matchmakingQueueCoinche.remove(connectionId);
+    m_matchmakingQueueBelote.remove(connectionId);
     qDebug() << "Joueur quitte la queue:" << connectionId
                 << "Coinche queue:" << m_matchmakingQueueCoinche.size()
                 << "Belote queue:" << m_matchmakingQueueBelote.size();
@@ -1876,8 +2190,8 @@ void GameServer::handleLeaveMatchmaking(QWebSocket *socket) {
     // Si le joueur avait un partenaire de lobby, retirer aussi le partenaire et restaurer le lobby
     if (!partnerId.isEmpty() && !lobbyCode.isEmpty()) {
         // Retirer le partenaire du matchmaking aussi
-        m_matchmakingQueueCoinche.removeAll(partnerId);
-        m_matchmakingQueueBelote.removeAll(partnerId);
+        m_matchmakingQueueCoinche.remove(partnerId);
+        m_matchmakingQueueBelote.remove(partnerId);
         qDebug() << "Partenaire de lobby retiré de la queue:" << partnerId;
 
         // Réinitialiser les marqueurs de partenariat
@@ -1938,78 +2252,37 @@ void GameServer::handleLeaveMatchmaking(QWebSocket *socket) {
 
     // Notifier les joueurs restants de la même queue
     notifyQueueStatus(gameMode);
+    brokerStateChanged();
 }
 
 void GameServer::tryCreateGame() {
+    bool created = false;
+
     // Essayer de créer une partie pour chaque queue qui a assez de joueurs
     for (int mode = 0; mode < 2; mode++) {
-        QQueue<QString>& queue = (mode == 0) ? m_matchmakingQueueCoinche : m_matchmakingQueueBelote;
+        Matchmaker<QString>& queue = (mode == 0) ? m_matchmakingQueueCoinche : m_matchmakingQueueBelote;
         if (queue.size() < 4) continue;
 
-        // Prendre 4 joueurs de la queue
-        QList<QString> queuedPlayers;
-        for (int i = 0; i < 4; i++) {
-            queuedPlayers.append(queue.dequeue());
-        }
-
-        // Organiser les joueurs pour que les partenaires de lobby soient ensemble
-        QList<QString> connectionIds(4);
-
-        // Chercher une paire de partenaires
-        QString partner1, partner2;
-        for (const QString &playerId : queuedPlayers) {
-            PlayerConnection* conn = m_connections[playerId];
-            if (!conn->lobbyPartnerId.isEmpty() && queuedPlayers.contains(conn->lobbyPartnerId)) {
-                partner1 = playerId;
-                partner2 = conn->lobbyPartnerId;
-                qDebug() << "Paire de partenaires trouvée:" << conn->playerName << "et" << m_connections[partner2]->playerName;
-                break;
+        // Meilleure table de 4 (niveaux proches, équipes équilibrées, partenaires de lobby
+        // dans la même équipe), ou aucune tant que les fenêtres de niveau ne le permettent pas
+        std::vector<QString> table = queue.takeTable(m_timingClock.elapsed());
+        if (table.empty()) continue;
+        QList<QString> connectionIds(table.begin(), table.end());
+        created = true;
+
+        // Réinitialiser les marqueurs de partenariat et supprimer les lobbies d'origine
+        for (const QString &playerId : connectionIds) {
+            PlayerConnection* conn = m_connections.value(playerId);
+            if (!conn) continue;
+            if (!conn->lobbyCode.isEmpty() && m_privateLobbies.contains(conn->lobbyCode)) {
+                delete m_privateLobbies[conn->lobbyCode];
+                m_privateLobbies.remove(conn->lobbyCode);
+                qDebug() << "Lobby" << conn->lobbyCode << "supprimé après création de partie";
             }
+            conn->lobbyPartnerId = "";
+            conn->lobbyCode = "";
         }
-
-        if (!partner1.isEmpty()) {
-            // Placer les partenaires aux positions 0 et 2
-            connectionIds[0] = partner1;
-            connectionIds[2] = partner2;
-
-            // Réinitialiser les marqueurs de partenariat et supprimer le lobby
-            QString lobbyCodeToRemove = m_connections[partner1]->lobbyCode;
-            m_connections[partner1]->lobbyPartnerId = "";
-            m_connections[partner1]->lobbyCode = "";
-            m_connections[partner2]->lobbyPartnerId = "";
-            m_connections[partner2]->lobbyCode = "";
-            if (!lobbyCodeToRemove.isEmpty() && m_privateLobbies.contains(lobbyCodeToRemove)) {
-                delete m_privateLobbies[lobbyCodeToRemove];
-                m_privateLobbies.remove(lobbyCodeToRemove);
-                qDebug() << "Lobby" << lobbyCodeToRemove << "supprimé après création de partie";
-            }
-
-            // Placer les autres joueurs aux positions 1 et 3
-            // (peuvent eux-mêmes être une 2e paire de partenaires → ils jouent bien ensemble)
-            int otherIndex = 1;
-            for (const QString &playerId : queuedPlayers) {
-                if (playerId != partner1 && playerId != partner2) {
-                    connectionIds[otherIndex] = playerId;
-                    // Nettoyer leurs marqueurs de partenariat aussi
-                    PlayerConnection* conn = m_connections.value(playerId);
-                    if (conn) {
-                        if (!conn->lobbyCode.isEmpty() && m_privateLobbies.contains(conn->lobbyCode)) {
-                            delete m_privateLobbies[conn->lobbyCode];
-                            m_privateLobbies.remove(conn->lobbyCode);
-                        }
-                        conn->lobbyPartnerId = "";
-                        conn->lobbyCode = "";
-                    }
-                    otherIndex = 3;
-                }
-            }
-
-            qDebug() << "Partie créée avec partenaires de lobby aux positions 0 et 2";
-        } else {
-            // Pas de partenaires, utiliser l'ordre normal
-            connectionIds = queuedPlayers;
-            qDebug() << "Partie créée sans partenaires de lobby";
-        }
+        qDebug() << "Table formée [" << (mode == 0 ? "coinche" : "belote") << "] - reste en file:" << queue.size();
 
         int roomId = m_nextRoomId++;
         GameRoom* room = new GameRoom();  // Créé sur le heap
@@ -2019,7 +2292,7 @@ void GameServer::tryCreateGame() {
         room->gameState = "waiting";
 
         // Enregistrer la création de GameRoom dans les statistiques quotidiennes
-        m_dbManager->recordGameRoomCreated();
+        m_dbWorker.post([](DatabaseManager &db) { db.recordGameRoomCreated(); });
 
         // Crée les joueurs du jeu
         for (int i = 0; i < 4; i++) {
@@ -2067,6 +2340,7 @@ void GameServer::tryCreateGame() {
         }
 
         m_gameRooms[roomId] = room;  // Stock le pointeur
+        room->clockSpeed = m_defaultRoomClockSpeed;
         if (m_gameRooms.size() > m_maxSimultaneousGames) {
             m_maxSimultaneousGames = m_gameRooms.size();
             m_statsReporter->setMaxSimultaneous(m_maxSimultaneousConnections, m_maxSimultaneousGames);
@@ -2091,7 +2365,7 @@ void GameServer::tryCreateGame() {
         // (attendre la fin de l'animation "Bonne partie !" + distribution)
         bool isBelote = room->isBeloteMode;
         if (room->isBot[room->currentPlayerIndex]) {
-            QTimer::singleShot(FIRST_GAME_BOT_DELAY_MS, this, [this, roomId, isBelote]() {
+            scheduleRoomEvent(roomId, FIRST_GAME_BOT_DELAY_MS, [this, roomId, isBelote]() {
                 GameRoom* room = m_gameRooms.value(roomId);
                 if (room && room->gameState == "bidding") {
                     if (isBelote) {
@@ -2104,7 +2378,7 @@ void GameServer::tryCreateGame() {
         } else {
             // Joueur humain : démarrer le timer de timeout pour les enchères
             // (attendre la fin de l'animation "Bonne partie !" + distribution)
-            QTimer::singleShot(FIRST_GAME_BOT_DELAY_MS, this, [this, roomId]() {
+            scheduleRoomEvent(roomId, FIRST_GAME_BOT_DELAY_MS, [this, roomId]() {
                 GameRoom* room = m_gameRooms.value(roomId);
                 if (room && room->gameState == "bidding") {
                     startBidTimeout(roomId, room->currentPlayerIndex);
@@ -2125,6 +2399,13 @@ void GameServer::tryCreateGame() {
         m_matchmakingTimerBelote->stop();
         m_countdownTimerBelote->stop();
     }
+
+    // Encore 4 joueurs ou plus : autre table tout de suite, ou plus tard avec des fenêtres plus larges
+    if (m_matchmakingQueueCoinche.size() >= 4 || m_matchmakingQueueBelote.size() >= 4) {
+        m_matchmakingRetryTimer->start(created ? 0 : MATCHMAKING_RETRY_MS);
+    } else {
+        m_matchmakingRetryTimer->stop();
+    }
 }
 
 void GameServer::handlePlayCard(QWebSocket *socket, const QJsonObject &data) {
@@ -2154,12 +2435,8 @@ void GameServer::handlePlayCard(QWebSocket *socket, const QJsonObject &data) {
     qDebug() << "handlePlayCard - Réception: joueur" << conn->playerIndex << "veut jouer carte" << data["cardIndex"].toInt()
                 << "currentPlayer:" << room->currentPlayerIndex << "gameState:" << room->gameState;
 
-    // Arrêter le timer de timeout du tour et invalider les anciens callbacks
-    if (room->turnTimeout) {
-        room->turnTimeout->stop();
-        room->turnTimeoutGeneration++;  // Invalider les anciens callbacks en queue
-        qDebug() << "GameServer - Timer de timeout arrêté (joueur a joué), génération:" << room->turnTimeoutGeneration;
-    }
+    // Annuler le timeout du tour (le joueur a joué)
+    cancelRoomEvent(room, room->turnTimeout);
 
     int playerIndex = conn->playerIndex;
     int cardIndex = data["cardIndex"].toInt();
@@ -2206,30 +2483,8 @@ void GameServer::handlePlayCard(QWebSocket *socket, const QJsonObject &data) {
         return;
     }
 
-    // Détermine la carte la plus forte du pli actuel
-    Carte* carteGagnante = nullptr;
-    int idxPlayerWinning = -1;
-    if (!room->currentPli.empty()) {
-        carteGagnante = room->currentPli[0].second;
-        idxPlayerWinning = room->currentPli[0].first;
-
-        for (size_t i = 1; i < room->currentPli.size(); i++) {
-            Carte* c = room->currentPli[i].second;
-            if (*carteGagnante < *c) {
-                carteGagnante = c;
-                idxPlayerWinning = room->currentPli[i].first;
-            }
-        }
-    }
-
     // Check si la carte est jouable
-    bool isPlayable = player->isCartePlayable(
-        cardIndex,
-        room->couleurDemandee,
-        room->couleurAtout,
-        carteGagnante,
-        idxPlayerWinning
-    );
+    bool isPlayable = getPlayableCards(room, playerIndex).contains(makeCardId(*player->getMain()[cardIndex]));
 
     if (!isPlayable) {
         qWarning() << "[PLAY_CARD] Validation échouée - Carte non jouable selon règles - joueur:" << playerIndex << "carte:" << cardIndex << "room:" << roomId;
@@ -2255,11 +2510,8 @@ void GameServer::handlePlayCard(QWebSocket *socket, const QJsonObject &data) {
         room->couleurDemandee = cartePlayed->getCouleur();
     }
 
-    // Ajoute au pli courant
-    room->currentPli.push_back(std::make_pair(playerIndex, cartePlayed));
-
-    // Marquer la carte comme jouée pour le tracking IA
-    room->markCardAsPlayed(cartePlayed);
+    // Ajoute au pli courant (et marque la carte comme jouée pour le tracking IA)
+    room->addCardToPli(playerIndex, cartePlayed);
 
     // IMPORTANT : Retirer la carte de la main du joueur côté serveur
     // Cela maintient la synchronisation avec les clients
@@ -2375,12 +2627,8 @@ void GameServer::handleMakeBid(QWebSocket *socket, const QJsonObject &data) {
     qDebug() << "handleMakeBid - Réception: joueur" << conn->playerIndex << "veut annoncer" << data["bidValue"].toInt()
                 << "couleur:" << data["suit"].toInt() << "currentPlayer:" << room->currentPlayerIndex;
 
-    // Arrêter le timer de timeout des enchères et invalider les anciens callbacks
-    if (room->bidTimeout) {
-        room->bidTimeout->stop();
-        room->bidTimeoutGeneration++;
-        qDebug() << "handleMakeBid - Timer de timeout enchères arrêté (joueur a annoncé), génération:" << room->bidTimeoutGeneration;
-    }
+    // Annuler le timeout des enchères (le joueur a annoncé)
+    cancelRoomEvent(room, room->bidTimeout);
 
     int playerIndex = conn->playerIndex;
     int bidValue = data["bidValue"].toInt();
@@ -2418,7 +2666,9 @@ void GameServer::handleMakeBid(QWebSocket *socket, const QJsonObject &data) {
         if (!room->isTraining && !room->isBot[playerIndex]) {
             PlayerConnection* coincheConn = m_connections[room->connectionIds[playerIndex]];
             if (coincheConn && !coincheConn->playerName.isEmpty()) {
-                m_dbManager->updateCoincheStats(coincheConn->playerName, true, false);
+                m_dbWorker.post([pseudo = coincheConn->playerName](DatabaseManager &db) {
+                    db.updateCoincheStats(pseudo, true, false);
+                });
             }
         }
 
@@ -2465,7 +2715,9 @@ void GameServer::handleMakeBid(QWebSocket *socket, const QJsonObject &data) {
         if (!room->isTraining && !room->isBot[playerIndex]) {
             PlayerConnection* surcoincheConn = m_connections[room->connectionIds[playerIndex]];
             if (surcoincheConn && !surcoincheConn->playerName.isEmpty()) {
-                m_dbManager->updateSurcoincheStats(surcoincheConn->playerName, true, false);
+                m_dbWorker.post([pseudo = surcoincheConn->playerName](DatabaseManager &db) {
+                    db.updateSurcoincheStats(pseudo, true, false);
+                });
             }
         }
 
@@ -2482,7 +2734,7 @@ void GameServer::handleMakeBid(QWebSocket *socket, const QJsonObject &data) {
 
         // Attendre 2 secondes pour afficher l'animation "Surcoinche !"
         qDebug() << "GameServer - Attente de 2 secondes pour afficher l'animation Surcoinche";
-        QTimer::singleShot(2000, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, 2000, [this, roomId]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (!room) return;
 
@@ -2596,12 +2848,15 @@ void GameServer::handleForfeit(QWebSocket *socket) {
 
     // Incrémenter le compteur de parties jouées (défaite) pour ce joueur
     if (!conn->playerName.isEmpty() && !room->isTraining) {
-        if (room->isBeloteMode)
-            m_dbManager->updateBeloteGameStats(conn->playerName, false, false);
-        else
-            m_dbManager->updateGameStats(conn->playerName, false);
+        m_dbWorker.post([pseudo = conn->playerName, belote = room->isBeloteMode](DatabaseManager &db) {
+            if (belote)
+                db.updateBeloteGameStats(pseudo, false, false);
+            else
+                db.updateGameStats(pseudo, false);
+        });
         qDebug() << "Stats mises a jour pour" << conn->playerName << "- Defaite enregistree";
     }
+    recordLeaver(room, playerIndex, conn);
 
     // Remplacer le joueur par un bot
     room->isBot[playerIndex] = true;
@@ -2629,8 +2884,8 @@ void GameServer::handleForfeit(QWebSocket *socket) {
     m_playerNameToRoomId.remove(conn->playerName);
 
     // Retirer de la file de matchmaking si le joueur y était (évite une partie normale après forfait)
-    m_matchmakingQueueCoinche.removeAll(connectionId);
-    m_matchmakingQueueBelote.removeAll(connectionId);
+    m_matchmakingQueueCoinche.remove(connectionId);
+    m_matchmakingQueueBelote.remove(connectionId);
 
     qInfo() << "Forfait - Joueur" << conn->playerName << "abandonne la partie" << roomId;
 
@@ -2663,10 +2918,14 @@ void GameServer::handleForfeit(QWebSocket *socket) {
             // Tous les joueurs humains ont quitté volontairement - supprimer la GameRoom
             qDebug() << "Tous les joueurs ont quitté volontairement la partie" << roomId << "- Suppression de la GameRoom";
 
+            // Partie abandonnée : les joueurs partis sont cotés maintenant
+            if (!room->isTraining) updateRatings(roomId, 0);
+
             // Retirer la room des maps
             m_gameRooms.remove(roomId);
 
-            // Supprimer la room (le destructeur nettoie les timers automatiquement)
+            // Annuler ses événements planifiés (timeouts, coups de bots) puis la supprimer
+            cancelRoomEvents(room);
             delete room;
 
             qDebug() << "GameRoom" << roomId << "supprimée";
@@ -2679,7 +2938,7 @@ void GameServer::handleForfeit(QWebSocket *socket) {
         if (room->gameState == "bidding") {
             // Phase d'enchères : passer automatiquement
             bool isBelote = room->isBeloteMode;
-            QTimer::singleShot(3000, this, [this, roomId, playerIndex, isBelote]() {
+            scheduleRoomEvent(roomId, 3000, [this, roomId, playerIndex, isBelote]() {
                 if (isBelote) {
                     playBotBeloteBid(roomId, playerIndex);
                 } else {
@@ -2688,7 +2947,7 @@ void GameServer::handleForfeit(QWebSocket *socket) {
             });
         } else if (room->gameState == "playing") {
             // Phase de jeu : jouer une carte aléatoire
-            QTimer::singleShot(500, this, [this, roomId, playerIndex]() {
+            scheduleRoomEvent(roomId, 500, [this, roomId, playerIndex]() {
                 playBotCard(roomId, playerIndex);
             });
         }
@@ -2717,14 +2976,17 @@ void GameServer::handlePlayerDisconnect(const QString &connectionId) {
 
     // Incrémenter le compteur de parties jouées (défaite) pour ce joueur
     if (!conn->playerName.isEmpty() && !room->isTraining) {
-        if (room->isBeloteMode)
-            m_dbManager->updateBeloteGameStats(conn->playerName, false, false);
-        else
-            m_dbManager->updateGameStats(conn->playerName, false);
+        m_dbWorker.post([pseudo = conn->playerName, belote = room->isBeloteMode](DatabaseManager &db) {
+            if (belote)
+                db.updateBeloteGameStats(pseudo, false, false);
+            else
+                db.updateGameStats(pseudo, false);
+        });
         qDebug() << "Stats mises a jour pour" << conn->playerName << "- Defaite enregistree (deconnexion)";
+        recordLeaver(room, playerIndex, conn);
 
         // Enregistrer l'abandon dans les statistiques quotidiennes
-        m_dbManager->recordPlayerQuit();
+        m_dbWorker.post([](DatabaseManager &db) { db.recordPlayerQuit(); });
     }
 }
 
@@ -2770,6 +3032,7 @@ void GameServer::handleCreatePrivateLobby(QWebSocket *socket) {
     lobby->readyStatus.append(false);
 
     m_privateLobbies[code] = lobby;
+    brokerStateChanged();
 
     qDebug() << "Lobby privé créé - Code:" << code << "Hôte:" << conn->playerName;
 
@@ -2792,6 +3055,14 @@ void GameServer::handleJoinPrivateLobby(QWebSocket *socket, const QJsonObject &o
 
     QString code = obj["code"].toString().toUpper();
 
+    // Lobby créé sur un autre serveur (multi-processus) : le client l'y rejoint
+    if (m_broker && !m_privateLobbies.contains(code)) {
+        QJsonObject resume;
+        resume["resume"] = "joinPrivateLobby";
+        resume["code"] = code;
+        if (redirectClient(socket, m_broker->urlForLobby(code), resume)) return;
+    }
+
     // Vérifier que le lobby existe
     if (!m_privateLobbies.contains(code)) {
         QJsonObject error;
@@ -3073,22 +3344,26 @@ void GameServer::handleLeaveLobby(QWebSocket *socket) {
 void GameServer::createGameWithBots(const QString& mode) {
     // Traiter uniquement la queue du mode donné
     {
-        QQueue<QString>& queue = (mode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
+        Matchmaker<QString>& queue = (mode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
         if (queue.isEmpty()) return;
 
-        int humanPlayers = queue.size();
+        // Le plus ancien et les joueurs de niveau compatible (fenêtre du matchmaking) :
+        // les autres restent en file, avec un nouveau délai avant les bots
+        std::vector<QString> groupe = queue.takeGroup(m_timingClock.elapsed());
+        QList<QString> connectionIds(groupe.begin(), groupe.end());
+        if (!queue.isEmpty()) {
+            QTimer* mainTimer = (mode == "belote") ? m_matchmakingTimerBelote : m_matchmakingTimerCoinche;
+            mainTimer->start();
+            notifyQueueStatus(mode);
+        }
+
+        int humanPlayers = connectionIds.size();
         int botsNeeded = 4 - humanPlayers;
         bool isBelote = (mode == "belote");
 
         qDebug() << "Création d'une partie [" << (isBelote ? "Belote" : "Coinche") << "] avec"
                  << humanPlayers << "humain(s) et" << botsNeeded << "bot(s)";
 
-        // Prendre tous les joueurs humains de la queue
-        QList<QString> connectionIds;
-        while (!queue.isEmpty()) {
-            connectionIds.append(queue.dequeue());
-        }
-
     // Si une paire de partenaires est présente, les placer aux positions 0 et 2
     // Les autres humains (non-partenaires) occupent les positions 1 et 3 avant les bots
     QString partner1, partner2;
@@ -3137,7 +3412,7 @@ void GameServer::createGameWithBots(const QString& mode) {
     room->gameState = "waiting";
 
     // Enregistrer la création de GameRoom dans les statistiques quotidiennes
-    m_dbManager->recordGameRoomCreated();
+    m_dbWorker.post([](DatabaseManager &db) { db.recordGameRoomCreated(); });
 
     // Ajouter les 4 joueurs : humains aux positions définies, bots aux positions vides
     for (int i = 0; i < 4; i++) {
@@ -3200,6 +3475,7 @@ void GameServer::createGameWithBots(const QString& mode) {
     }
 
     m_gameRooms[roomId] = room;
+    room->clockSpeed = m_defaultRoomClockSpeed;
     if (m_gameRooms.size() > m_maxSimultaneousGames)
         m_maxSimultaneousGames = m_gameRooms.size();
 
@@ -3218,7 +3494,7 @@ void GameServer::createGameWithBots(const QString& mode) {
     // (attendre la fin de l'animation "Bonne partie !" + distribution)
     isBelote = room->isBeloteMode;
     if (room->isBot[room->currentPlayerIndex]) {
-        QTimer::singleShot(FIRST_GAME_BOT_DELAY_MS, this, [this, roomId, isBelote]() {
+        scheduleRoomEvent(roomId, FIRST_GAME_BOT_DELAY_MS, [this, roomId, isBelote]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (room && room->gameState == "bidding") {
                 if (isBelote) {
@@ -3231,7 +3507,7 @@ void GameServer::createGameWithBots(const QString& mode) {
     } else {
         // Joueur humain : démarrer le timer de timeout pour les enchères
         // (attendre la fin de l'animation "Bonne partie !" + distribution)
-        QTimer::singleShot(FIRST_GAME_BOT_DELAY_MS, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, FIRST_GAME_BOT_DELAY_MS, [this, roomId]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (room && room->gameState == "bidding") {
                 startBidTimeout(roomId, room->currentPlayerIndex);
@@ -3259,7 +3535,9 @@ void GameServer::handleJoinTraining(QWebSocket *socket, const QJsonObject &data)
     room->roomId = roomId;
     room->gameState = "waiting";
     room->isTraining = true;  // Partie d'entraînement : stats non comptabilisées
+    room->pimcBots = true;    // Bots par échantillonnage en fin de manche
     room->isBeloteMode = (gameMode == "belote");
+    room->animationAcks = data.value("animationAcks").toBool(false);  // Client qui signale la fin de ses animations
 
     // Joueur humain à la position 0
     conn->gameRoomId = roomId;
@@ -3316,6 +3594,9 @@ void GameServer::handleJoinTraining(QWebSocket *socket, const QJsonObject &data)
     }
 
     m_gameRooms[roomId] = room;
+    // Seul humain de la room : il peut en accélérer l'horloge (tests, replays)
+    room->clockSpeed = data.contains("clockSpeed") ? qMax(0.0, data.value("clockSpeed").toDouble())
+                                                   : m_defaultRoomClockSpeed;
     if ((int)m_gameRooms.size() > m_maxSimultaneousGames)
         m_maxSimultaneousGames = m_gameRooms.size();
 
@@ -3334,7 +3615,7 @@ void GameServer::handleJoinTraining(QWebSocket *socket, const QJsonObject &data)
     // Démarrer les enchères (attendre la fin de l'animation "Bonne partie !" + distribution)
     bool isBeloteTraining = room->isBeloteMode;
     if (room->isBot[room->currentPlayerIndex]) {
-        QTimer::singleShot(FIRST_GAME_BOT_DELAY_MS, this, [this, roomId, isBeloteTraining]() {
+        scheduleRoomEvent(roomId, FIRST_GAME_BOT_DELAY_MS, [this, roomId, isBeloteTraining]() {
             GameRoom* r = m_gameRooms.value(roomId);
             if (!r || r->gameState != "bidding") return;
             if (isBeloteTraining) {
@@ -3344,7 +3625,7 @@ void GameServer::handleJoinTraining(QWebSocket *socket, const QJsonObject &data)
             }
         });
     } else {
-        QTimer::singleShot(FIRST_GAME_BOT_DELAY_MS, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, FIRST_GAME_BOT_DELAY_MS, [this, roomId]() {
             GameRoom* r = m_gameRooms.value(roomId);
             if (r && r->gameState == "bidding") startBidTimeout(roomId, r->currentPlayerIndex);
         });
@@ -3355,6 +3636,9 @@ void GameServer::notifyGameStart(int roomId, const QList<QString> &connectionIds
     GameRoom* room = m_gameRooms[roomId];
     if (!room) return;
 
+    // Nouveaux joueurs en partie ici (routage des reconnexions, charge du serveur)
+    brokerStateChanged();
+
     qDebug() << "Envoi des notifications gameFound à" << connectionIds.size() << "joueurs humains";
 
     // Parcourir uniquement les joueurs humains (ceux avec une connexion)
@@ -3375,6 +3659,8 @@ void GameServer::notifyGameStart(int roomId, const QList<QString> &connectionIds
         msg["roomId"] = roomId;
         msg["playerPosition"] = playerPosition;
         msg["gameMode"] = room->isBeloteMode ? QString("belote") : QString("coinche");
+        msg["seq"] = static_cast<qint64>(room->stateSeq);
+        if (room->animationAcks) msg["animationAcks"] = true;
         qWarning() << "notifyGameStart - isBeloteMode:" << room->isBeloteMode << "gameMode sent:" << msg["gameMode"].toString();
 
         // Retournée (Belote uniquement)
@@ -3432,24 +3718,25 @@ void GameServer::finishPli(int roomId) {
     GameRoom* room = m_gameRooms.value(roomId);
     if (!room) return;
 
-    // Détermine le gagnant du pli
-    Carte* carteGagnante = room->currentPli[0].second;
-    int gagnantIndex = room->currentPli[0].first;
-    qDebug() << "***************************GameServer - Determination du gagnant du pli";
-    qDebug() << "Carte gagnante initiale:";
-    //carteGagnante->printCarte();
-
-    for (size_t i = 1; i < room->currentPli.size(); i++) {
-        Carte* c = room->currentPli[i].second;
-        qDebug() << "Comparaison avec la carte du joueur" << room->currentPli[i].first << ":";
-        //c->printCarte();
-        if (*carteGagnante < *c) {
-            carteGagnante = c;
-            gagnantIndex = room->currentPli[i].first;
-            carteGagnante->printCarte();
+    // Le pli est terminé quand tous les joueurs n'ont plus de cartes : c'est le dernier de la manche
+    bool mancheTerminee = true;
+    for (const auto& player : room->players) {
+        if (!player->getMain().empty()) {
+            mancheTerminee = false;
+            break;
         }
     }
 
+    // Gagnant et points du pli (valeurs TA/SA ou normales selon le mode, +10 au dernier pli)
+    std::array<CardId, 4> cartes;
+    for (int i = 0; i < 4; i++) {
+        cartes[i] = makeCardId(*room->currentPli[i].second);
+    }
+    GameEngine::ResultatPli resultatPli = GameEngine::resoudrePli(cartes, room->currentPli[0].first,
+                                                                  room->trumpContract(), mancheTerminee);
+    int gagnantIndex = resultatPli.gagnant;
+    int pointsPli = resultatPli.points;
+
     qDebug() << "GameServer - Pli termine, gagnant: joueur" << gagnantIndex;
 
     // Incrementer le compteur de plis du gagnant
@@ -3460,22 +3747,6 @@ void GameServer::finishPli(int roomId) {
         case 3: room->plisCountPlayer3++; break;
     }
 
-    // Calculer les points de ce pli
-    int pointsPli = 0;
-    for (const auto& pair : room->currentPli) {
-        Carte* carte = pair.second;
-        if (room->isToutAtout) {
-            // Mode Tout Atout: valeurs spéciales
-            pointsPli += getCardValueToutAtout(carte);
-        } else if (room->isSansAtout) {
-            // Mode Sans Atout: valeurs spéciales
-            pointsPli += getCardValueSansAtout(carte);
-        } else {
-            // Mode normal
-            pointsPli += carte->getValeurDeLaCarte();
-        }
-    }
-
     // Ajouter les cartes du pli à l'équipe gagnante et mettre à jour le score de manche
     // Les cartes sont stockées dans plisTeam1/plisTeam2 dans l'ordre des plis gagnés
     // Équipe 1: joueurs 0 et 2, Équipe 2: joueurs 1 et 3
@@ -3493,31 +3764,10 @@ void GameServer::finishPli(int roomId) {
         room->scoreMancheTeam2 += pointsPli;
     }
 
-    qDebug() << "GameServer - Points du pli:" << pointsPli;
+    qDebug() << "GameServer - Points du pli:" << pointsPli << (mancheTerminee ? "(dont dix de der)" : "");
     qDebug() << "GameServer - Scores de manche: Team1 =" << room->scoreMancheTeam1
                 << ", Team2 =" << room->scoreMancheTeam2;
 
-    // Vérifier si la manche est terminée (tous les joueurs n'ont plus de cartes)
-    bool mancheTerminee = true;
-    for (const auto& player : room->players) {
-        if (!player->getMain().empty()) {
-            mancheTerminee = false;
-            break;
-        }
-    }
-
-    // Si c'est le dernier pli, ajouter le bonus de 10 points AVANT d'envoyer pliFinished
-    if (mancheTerminee) {
-        if (gagnantIndex == 0 || gagnantIndex == 2) {
-            room->scoreMancheTeam1 += 10;
-        } else {
-            room->scoreMancheTeam2 += 10;
-        }
-        qDebug() << "GameServer - Dernier pli, ajout du bonus +10 points";
-        qDebug() << "GameServer - Scores de manche finaux: Team1 =" << room->scoreMancheTeam1
-                    << ", Team2 =" << room->scoreMancheTeam2;
-    }
-
     // Notifie le gagnant du pli avec les scores de manche mis à jour
     QJsonObject pliFinishedMsg;
     pliFinishedMsg["type"] = "pliFinished";
@@ -3533,7 +3783,7 @@ void GameServer::finishPli(int roomId) {
         qDebug() << "GameServer - Manche terminee, attente de 1500ms avant de commencer la nouvelle manche...";
 
         // Attendre 1500ms pour laisser les joueurs voir le dernier pli
-        QTimer::singleShot(1500, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, 1500, [this, roomId]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (room) room->waitingForNextPli = false;  // Débloquer les requêtes
             qDebug() << "GameServer - Calcul des scores de la manche...";
@@ -3543,7 +3793,7 @@ void GameServer::finishPli(int roomId) {
         qDebug() << "GameServer - Pli termine, attente de 1500ms avant le prochain pli...";
 
         // Attendre 1500ms pour laisser les joueurs voir le pli gagné
-        QTimer::singleShot(1500, this, [this, roomId, gagnantIndex]() {
+        scheduleRoomEvent(roomId, 1500, [this, roomId, gagnantIndex]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (!room) return;
 
@@ -3551,7 +3801,7 @@ void GameServer::finishPli(int roomId) {
             room->waitingForNextPli = false;
 
             // Réinitialise pour le prochain pli
-            room->currentPli.clear();
+            room->clearPli();
             room->couleurDemandee = Carte::COULEURINVALIDE;
             room->currentPlayerIndex = gagnantIndex;  // Le gagnant commence le prochain pli
 
@@ -3582,253 +3832,100 @@ void GameServer::finishManche(int roomId) {
     qDebug() << "  Joueur 2:" << room->plisCountPlayer2 << "plis";
     qDebug() << "  Joueur 3:" << room->plisCountPlayer3 << "plis";
 
-    // Détermine quelle équipe a fait l'enchère
+    // Score de la manche et réussite du contrat : règles de GameEngine
+    // (capot, générale, coinche/surcoinche, mode Belote)
     // Équipe 1: joueurs 0 et 2, Équipe 2: joueurs 1 et 3
     bool team1HasBid = (room->lastBidderIndex == 0 || room->lastBidderIndex == 2);
-    int valeurContrat = Player::getContractValue(room->lastBidAnnonce);
+    int beloteTeam1 = room->beloteTeam1 ? 20 : 0;
+    int beloteTeam2 = room->beloteTeam2 ? 20 : 0;
+
+    GameEngine::Prise prise;
+    prise.preneur = room->lastBidderIndex;
+    prise.annonce = room->lastBidAnnonce;
+    prise.coinche = room->coinched;
+    prise.surcoinche = room->surcoinched;
+    prise.modeBelote = room->isBeloteMode;
+    GameEngine::Resolution resolution = GameEngine::resoudreManche(
+        prise,
+        {{ pointsRealisesTeam1, pointsRealisesTeam2 }},
+        {{ room->plisCountPlayer0, room->plisCountPlayer1, room->plisCountPlayer2, room->plisCountPlayer3 }},
+        {{ beloteTeam1, beloteTeam2 }});
+
+    int valeurContrat = resolution.valeurContrat;
+    bool isCapotAnnonce = resolution.capotAnnonce;
+    bool isGeneraleAnnonce = resolution.generaleAnnonce;
+    bool capotReussi = resolution.capotReussi;
+    bool generaleReussie = resolution.generaleReussie;
+    bool contractReussi = resolution.contratReussi;
+    room->lastMancheCapotTeam1 = resolution.capot[0];
+    room->lastMancheCapotTeam2 = resolution.capot[1];
+
+    int scoreToAddTeam1 = resolution.score[0];
+    int scoreToAddTeam2 = resolution.score[1];
 
     qDebug() << "GameServer - Contrat: valeur =" << valeurContrat
                 << ", equipe =" << (team1HasBid ? 1 : 2)
-                << ", annonce =" << static_cast<int>(room->lastBidAnnonce);
-
-    // Verification des conditions speciales CAPOT et GENERALE
-    bool isCapotAnnonce = (room->lastBidAnnonce == Player::CAPOT);
-    bool isGeneraleAnnonce = (room->lastBidAnnonce == Player::GENERALE);
-    bool capotReussi = false;
-    bool generaleReussie = false;
-
-    // Vérifier si une équipe a fait un CAPOT (8 plis) même sans l'avoir annoncé
-    int plisTeam1 = room->plisCountPlayer0 + room->plisCountPlayer2;
-    int plisTeam2 = room->plisCountPlayer1 + room->plisCountPlayer3;
-    bool capotNonAnnonceTeam1 = (!isCapotAnnonce && !isGeneraleAnnonce && plisTeam1 == 8);
-    bool capotNonAnnonceTeam2 = (!isCapotAnnonce && !isGeneraleAnnonce && plisTeam2 == 8);
-
-    // Si un capot non annoncé est réalisé, on doit le marquer comme réussi pour les stats
-    if (capotNonAnnonceTeam1 || capotNonAnnonceTeam2) {
-        capotReussi = true;
-    }
-
-    if (isCapotAnnonce) {
-        // CAPOT: l'equipe qui a annonce doit faire tous les 8 plis
-        int plisTeamAnnonceur = 0;
-        if (team1HasBid) {
-            plisTeamAnnonceur = plisTeam1;
-        } else {
-            plisTeamAnnonceur = plisTeam2;
-        }
-        capotReussi = (plisTeamAnnonceur == 8);
-        qDebug() << "GameServer - CAPOT annonce: equipe a fait" << plisTeamAnnonceur << "/8 plis -"
-                    << (capotReussi ? "REUSSI" : "ECHOUE");
-    } else if (isGeneraleAnnonce) {
-        // GENERALE: le joueur qui a annonce doit faire tous les 8 plis seul
-        int plisJoueurAnnonceur = 0;
-        switch (room->lastBidderIndex) {
-            case 0: plisJoueurAnnonceur = room->plisCountPlayer0; break;
-            case 1: plisJoueurAnnonceur = room->plisCountPlayer1; break;
-            case 2: plisJoueurAnnonceur = room->plisCountPlayer2; break;
-            case 3: plisJoueurAnnonceur = room->plisCountPlayer3; break;
-        }
-        generaleReussie = (plisJoueurAnnonceur == 8);
-        qDebug() << "GameServer - GENERALE annoncee par joueur" << room->lastBidderIndex
-                    << ": a fait" << plisJoueurAnnonceur << "/8 plis -"
-                    << (generaleReussie ? "REUSSIE" : "ECHOUEE");
-    }
-
-    // Utiliser le bon calculateur selon le mode de jeu
-    ScoreCalculator::ScoreResult scoreResult;
-    if (room->isBeloteMode) {
-        bool capotByTeam1 = (plisTeam1 == 8);
-        bool capotByTeam2 = (plisTeam2 == 8);
-        room->lastMancheCapotTeam1 = capotByTeam1;
-        room->lastMancheCapotTeam2 = capotByTeam2;
-        scoreResult = ScoreCalculator::calculateBeloteMancheScore(
-            pointsRealisesTeam1,
-            pointsRealisesTeam2,
-            team1HasBid,
-            capotByTeam1,
-            capotByTeam2,
-            room->beloteTeam1 ? 20 : 0,
-            room->beloteTeam2 ? 20 : 0
-        );
-        qDebug() << "GameServer - Score Belote calculé:"
-                    << "Team1=" << scoreResult.scoreTeam1
-                    << "Team2=" << scoreResult.scoreTeam2;
-    } else {
-        scoreResult = ScoreCalculator::calculateMancheScore(
-            pointsRealisesTeam1,
-            pointsRealisesTeam2,
-            valeurContrat,
-            team1HasBid,
-            room->coinched,
-            room->surcoinched,
-            isCapotAnnonce,
-            capotReussi,
-            isGeneraleAnnonce,
-            generaleReussie,
-            capotNonAnnonceTeam1,
-            capotNonAnnonceTeam2,
-            room->beloteTeam1 ? 20 : 0,
-            room->beloteTeam2 ? 20 : 0
-        );
-    }
-
-    int scoreToAddTeam1 = scoreResult.scoreTeam1;
-    int scoreToAddTeam2 = scoreResult.scoreTeam2;
-
-    // Log des scores calculés
+                << ", annonce =" << static_cast<int>(room->lastBidAnnonce)
+                << (contractReussi ? "- REUSSI" : "- CHUTE");
     qDebug() << "GameServer - Scores calcules:";
     qDebug() << "  Team1 marque:" << scoreToAddTeam1;
     qDebug() << "  Team2 marque:" << scoreToAddTeam2;
 
-    // Gestion des stats pour coinche/surcoinche (code existant maintenu)
-    int multiplicateur = 1;
-    if (room->surcoinched) {
-        multiplicateur = 4;
-    } else if (room->coinched) {
-        multiplicateur = 2;
-    }
-
-    // Belote bonus pour vérification du contrat (cohérent avec ScoreCalculator)
-    int beloteTeam1 = room->beloteTeam1 ? 20 : 0;
-    int beloteTeam2 = room->beloteTeam2 ? 20 : 0;
+    // Stats de la manche, appliquées en une seule transaction (cf. postStatsDeltas)
+    QHash<QString, DatabaseManager::StatsDelta> statsDeltas;
 
     // Gestion des stats (ignorées en mode entraînement)
     if (!room->isTraining && (room->coinched || room->surcoinched)) {
-        if (team1HasBid) {
-            // Team1 a annoncé, vérifie si elle réussit (belote compte pour le contrat)
-            bool contractReussi = ((pointsRealisesTeam1 + beloteTeam1) >= valeurContrat);
-
-            if (contractReussi) {
-                // Mettre à jour les stats de surcoinche réussie (le contrat a réussi)
-                if (room->surcoinched && room->surcoinchePlayerIndex != -1 && !room->isBot[room->surcoinchePlayerIndex]) {
-                    QString connId = room->connectionIds[room->surcoinchePlayerIndex];
-                    PlayerConnection* surcoincheConn = connId.isEmpty() ? nullptr : m_connections.value(connId);
-                    if (surcoincheConn && !surcoincheConn->playerName.isEmpty()) {
-                        if (!m_dbManager->updateSurcoincheStats(surcoincheConn->playerName, false, true)) {
-                            qWarning() << "[STATS] Échec mise à jour stats surcoinche réussie - joueur:" << surcoincheConn->playerName;
-                        } else {
-                            qDebug() << "Stats surcoinche réussie pour:" << surcoincheConn->playerName;
-                        }
-                    }
-                }
-            } else {
-                // Mettre à jour les stats de coinche réussie (le contrat a échoué, donc la coinche a réussi)
-                if (room->coinched && room->coinchePlayerIndex != -1 && !room->isBot[room->coinchePlayerIndex]) {
-                    QString connId = room->connectionIds[room->coinchePlayerIndex];
-                    PlayerConnection* coincheConn = connId.isEmpty() ? nullptr : m_connections.value(connId);
-                    if (coincheConn && !coincheConn->playerName.isEmpty()) {
-                        if (!m_dbManager->updateCoincheStats(coincheConn->playerName, false, true)) {
-                            qWarning() << "[STATS] Échec mise à jour stats coinche réussie - joueur:" << coincheConn->playerName;
-                        } else {
-                            qDebug() << "Stats coinche réussie pour:" << coincheConn->playerName;
-                        }
-                    }
-                }
-
-                // Note: La surcoinche n'est PAS réussie ici car le contrat a échoué
-                // (la surcoinche est faite par l'équipe qui annonce, donc si elle échoue son contrat, la surcoinche échoue aussi)
-            }
-
-            // Mettre à jour les stats d'annonces coinchées pour les joueurs de l'équipe 1
-            for (int i = 0; i < room->connectionIds.size(); i++) {
-                if (room->isBot[i]) continue;  // Skip bots
-                QString connId = room->connectionIds[i];
-                if (connId.isEmpty()) continue;  // Skip déconnectés
-                PlayerConnection* conn = m_connections.value(connId);
-                if (!conn || conn->playerName.isEmpty()) continue;
-
-                int playerTeam = (i % 2 == 0) ? 1 : 2;
-                if (playerTeam == 1) {
-                    // Ce joueur fait partie de l'équipe 1 qui a fait l'annonce coinchée
-                    if (!m_dbManager->updateAnnonceCoinchee(conn->playerName, contractReussi)) {
-                        qWarning() << "[STATS] Échec mise à jour stats annonce coinchée - joueur:" << conn->playerName << "réussie:" << contractReussi;
-                    } else {
-                        qDebug() << "Stats annonce coinchée pour:" << conn->playerName << "Réussie:" << contractReussi;
-                    }
+        if (contractReussi) {
+            // Mettre à jour les stats de surcoinche réussie (le contrat a réussi)
+            if (room->surcoinched && room->surcoinchePlayerIndex != -1 && !room->isBot[room->surcoinchePlayerIndex]) {
+                QString connId = room->connectionIds[room->surcoinchePlayerIndex];
+                PlayerConnection* surcoincheConn = connId.isEmpty() ? nullptr : m_connections.value(connId);
+                if (surcoincheConn && !surcoincheConn->playerName.isEmpty()) {
+                    statsDeltas[surcoincheConn->playerName].surcoincheSuccess++;
                 }
             }
-
-            // Si surcoinchée, mettre à jour les stats du joueur qui avait coinché
-            if (room->surcoinched && room->coinchePlayerIndex != -1 && !room->isBot[room->coinchePlayerIndex]) {
-                PlayerConnection* coincheConn = m_connections[room->connectionIds[room->coinchePlayerIndex]];
+        } else {
+            // Mettre à jour les stats de coinche réussie (le contrat a échoué, donc la coinche a réussi)
+            if (room->coinched && room->coinchePlayerIndex != -1 && !room->isBot[room->coinchePlayerIndex]) {
+                QString connId = room->connectionIds[room->coinchePlayerIndex];
+                PlayerConnection* coincheConn = connId.isEmpty() ? nullptr : m_connections.value(connId);
                 if (coincheConn && !coincheConn->playerName.isEmpty()) {
-                    // Le joueur qui a coinché subit maintenant une surcoinche
-                    // Si le contrat réussit → le joueur qui a coinché perd (won = false)
-                    // Si le contrat échoue → le joueur qui a coinché gagne quand même (won = true)
-                    if (!m_dbManager->updateAnnonceSurcoinchee(coincheConn->playerName, !contractReussi)) {
-                        qWarning() << "[STATS] Échec mise à jour stats annonce surcoinchée - joueur:" << coincheConn->playerName << "gagnée:" << !contractReussi;
-                    } else {
-                        qDebug() << "Stats surcoinche subie pour:" << coincheConn->playerName << "Gagnée:" << !contractReussi;
-                    }
+                    statsDeltas[coincheConn->playerName].coincheSuccess++;
                 }
             }
-        } else {
-            // Team2 a annoncé, vérifie si elle réussit (belote compte pour le contrat)
-            bool contractReussi = ((pointsRealisesTeam2 + beloteTeam2) >= valeurContrat);
-
-            if (contractReussi) {
-                // Mettre à jour les stats de surcoinche réussie (le contrat a réussi)
-                if (room->surcoinched && room->surcoinchePlayerIndex != -1 && !room->isBot[room->surcoinchePlayerIndex]) {
-                    QString connId = room->connectionIds[room->surcoinchePlayerIndex];
-                    PlayerConnection* surcoincheConn = connId.isEmpty() ? nullptr : m_connections.value(connId);
-                    if (surcoincheConn && !surcoincheConn->playerName.isEmpty()) {
-                        if (!m_dbManager->updateSurcoincheStats(surcoincheConn->playerName, false, true)) {
-                            qWarning() << "[STATS] Échec mise à jour stats surcoinche réussie - joueur:" << surcoincheConn->playerName;
-                        } else {
-                            qDebug() << "Stats surcoinche réussie pour:" << surcoincheConn->playerName;
-                        }
-                    }
-                }
-            } else {
-                // Mettre à jour les stats de coinche réussie (le contrat a échoué, donc la coinche a réussi)
-                if (room->coinched && room->coinchePlayerIndex != -1 && !room->isBot[room->coinchePlayerIndex]) {
-                    QString connId = room->connectionIds[room->coinchePlayerIndex];
-                    PlayerConnection* coincheConn = connId.isEmpty() ? nullptr : m_connections.value(connId);
-                    if (coincheConn && !coincheConn->playerName.isEmpty()) {
-                        if (!m_dbManager->updateCoincheStats(coincheConn->playerName, false, true)) {
-                            qWarning() << "[STATS] Échec mise à jour stats coinche réussie - joueur:" << coincheConn->playerName;
-                        } else {
-                            qDebug() << "Stats coinche réussie pour:" << coincheConn->playerName;
-                        }
-                    }
-                }
 
-                // Note: La surcoinche n'est PAS réussie ici car le contrat a échoué
-                // (la surcoinche est faite par l'équipe qui annonce, donc si elle échoue son contrat, la surcoinche échoue aussi)
-            }
+            // Note: La surcoinche n'est PAS réussie ici car le contrat a échoué
+            // (la surcoinche est faite par l'équipe qui annonce, donc si elle échoue son contrat, la surcoinche échoue aussi)
+        }
 
-            // Mettre à jour les stats d'annonces coinchées pour les joueurs de l'équipe 2
-            for (int i = 0; i < room->connectionIds.size(); i++) {
-                if (room->isBot[i]) continue;  // Skip bots
-                QString connId = room->connectionIds[i];
-                if (connId.isEmpty()) continue;  // Skip déconnectés
-                PlayerConnection* conn = m_connections.value(connId);
-                if (!conn || conn->playerName.isEmpty()) continue;
-
-                int playerTeam = (i % 2 == 0) ? 1 : 2;
-                if (playerTeam == 2) {
-                    // Ce joueur fait partie de l'équipe 2 qui a fait l'annonce coinchée
-                    if (!m_dbManager->updateAnnonceCoinchee(conn->playerName, contractReussi)) {
-                        qWarning() << "[STATS] Échec mise à jour stats annonce coinchée - joueur:" << conn->playerName << "réussie:" << contractReussi;
-                    } else {
-                        qDebug() << "Stats annonce coinchée pour:" << conn->playerName << "Réussie:" << contractReussi;
-                    }
-                }
+        // Mettre à jour les stats d'annonces coinchées pour les joueurs de l'équipe qui a annoncé
+        int biddingTeam = team1HasBid ? 1 : 2;
+        for (int i = 0; i < room->connectionIds.size(); i++) {
+            if (room->isBot[i]) continue;  // Skip bots
+            QString connId = room->connectionIds[i];
+            if (connId.isEmpty()) continue;  // Skip déconnectés
+            PlayerConnection* conn = m_connections.value(connId);
+            if (!conn || conn->playerName.isEmpty()) continue;
+
+            int playerTeam = (i % 2 == 0) ? 1 : 2;
+            if (playerTeam == biddingTeam) {
+                DatabaseManager::StatsDelta &delta = statsDeltas[conn->playerName];
+                delta.annoncesCoinchees++;
+                if (contractReussi) delta.annoncesCoincheesGagnees++;
             }
+        }
 
-            // Si surcoinchée, mettre à jour les stats du joueur qui avait coinché
-            if (room->surcoinched && room->coinchePlayerIndex != -1 && !room->isBot[room->coinchePlayerIndex]) {
-                PlayerConnection* coincheConn = m_connections[room->connectionIds[room->coinchePlayerIndex]];
-                if (coincheConn && !coincheConn->playerName.isEmpty()) {
-                    // Le joueur qui a coinché subit maintenant une surcoinche
-                    // Si le contrat réussit → le joueur qui a coinché perd (won = false)
-                    // Si le contrat échoue → le joueur qui a coinché gagne quand même (won = true)
-                    if (!m_dbManager->updateAnnonceSurcoinchee(coincheConn->playerName, !contractReussi)) {
-                        qWarning() << "[STATS] Échec mise à jour stats annonce surcoinchée - joueur:" << coincheConn->playerName << "gagnée:" << !contractReussi;
-                    } else {
-                        qDebug() << "Stats surcoinche subie pour:" << coincheConn->playerName << "Gagnée:" << !contractReussi;
-                    }
-                }
+        // Si surcoinchée, mettre à jour les stats du joueur qui avait coinché
+        if (room->surcoinched && room->coinchePlayerIndex != -1 && !room->isBot[room->coinchePlayerIndex]) {
+            PlayerConnection* coincheConn = m_connections[room->connectionIds[room->coinchePlayerIndex]];
+            if (coincheConn && !coincheConn->playerName.isEmpty()) {
+                // Le joueur qui a coinché subit maintenant une surcoinche
+                // Si le contrat réussit → le joueur qui a coinché perd (won = false)
+                // Si le contrat échoue → le joueur qui a coinché gagne quand même (won = true)
+                DatabaseManager::StatsDelta &delta = statsDeltas[coincheConn->playerName];
+                delta.annoncesSurcoinchees++;
+                if (!contractReussi) delta.annoncesSurcoincheesGagnees++;
             }
         }
     }
@@ -3855,15 +3952,11 @@ void GameServer::finishManche(int roomId) {
 
             if (isPlayerInBiddingTeam) {
                 // Ce joueur fait partie de l'équipe qui a annoncé le capot
-                if (!m_dbManager->updateCapotAnnonceTente(conn->playerName)) {
-                    qWarning() << "[STATS] Échec mise à jour stats capot annoncé tenté - joueur:" << conn->playerName;
-                }
+                DatabaseManager::StatsDelta &delta = statsDeltas[conn->playerName];
+                delta.capotAnnoncesTentes++;
                 if (capotReussi) {
-                    if (!m_dbManager->updateCapotStats(conn->playerName, true)) {  // Capot annoncé réussi
-                        qWarning() << "[STATS] Échec mise à jour stats capot annoncé réussi - joueur:" << conn->playerName;
-                    } else {
-                        qDebug() << "Stats capot annoncé réussi pour:" << conn->playerName;
-                    }
+                    delta.capotRealises++;
+                    delta.capotAnnoncesRealises++;
                 }
             }
         }
@@ -3880,11 +3973,7 @@ void GameServer::finishManche(int roomId) {
 
             if (plisTeamRealisateur == 8) {
                 // Ce joueur fait partie de l'équipe qui a réalisé le capot
-                if (!m_dbManager->updateCapotStats(conn->playerName, false)) {  // Capot non annoncé
-                    qWarning() << "[STATS] Échec mise à jour stats capot non annoncé - joueur:" << conn->playerName;
-                } else {
-                    qDebug() << "Stats capot non annoncé pour:" << conn->playerName;
-                }
+                statsDeltas[conn->playerName].capotRealises++;  // Capot non annoncé
             }
         }
     }
@@ -3895,11 +3984,9 @@ void GameServer::finishManche(int roomId) {
             QString connId = room->connectionIds[room->lastBidderIndex];
             PlayerConnection* conn = connId.isEmpty() ? nullptr : m_connections.value(connId);
             if (conn && !conn->playerName.isEmpty()) {
-                if (!m_dbManager->updateGeneraleStats(conn->playerName, generaleReussie)) {
-                    qWarning() << "[STATS] Échec mise à jour stats générale - joueur:" << conn->playerName << "réussite:" << generaleReussie;
-                } else {
-                    qDebug() << "Stats générale pour:" << conn->playerName << "(joueur" << room->lastBidderIndex << ") - Réussite:" << generaleReussie;
-                }
+                DatabaseManager::StatsDelta &delta = statsDeltas[conn->playerName];
+                delta.generaleAttempts++;
+                if (generaleReussie) delta.generaleSuccess++;
             }
         }
     }
@@ -3917,61 +4004,26 @@ void GameServer::finishManche(int roomId) {
     scoreMsg["scoreTotalTeam2"] = room->scoreTeam2;
     scoreMsg["scoreMancheTeam1"] = scoreToAddTeam1;  // Points finaux attribués pour cette manche
     scoreMsg["scoreMancheTeam2"] = scoreToAddTeam2;  // Points finaux attribués pour cette manche
-    // Ajouter l'information du capot pour l'animation
-    if (capotNonAnnonceTeam1) {
-        scoreMsg["capotTeam"] = 1;
-        qDebug() << "GameServer - Envoi notification CAPOT Team1 aux clients";
-    } else if (capotNonAnnonceTeam2) {
-        scoreMsg["capotTeam"] = 2;
-        qDebug() << "GameServer - Envoi notification CAPOT Team2 aux clients";
-    } else if (isCapotAnnonce && capotReussi) {
-        scoreMsg["capotTeam"] = team1HasBid ? 1 : 2;
-        qDebug() << "GameServer - Envoi notification CAPOT annoncé réussi Team" << (team1HasBid ? 1 : 2) << "aux clients";
-    } else {
-        scoreMsg["capotTeam"] = 0;
-    }
+    // Ajouter l'information du capot pour l'animation (0 : pas de capot)
+    scoreMsg["capotTeam"] = resolution.equipeCapot + 1;
     // Ajouter les données recap pour l'animation nouvelle manche
     scoreMsg["lastBidderIndex"] = room->lastBidderIndex;
     scoreMsg["bidValue"] = valeurContrat;
-    int attackerPoints = team1HasBid ? pointsRealisesTeam1 : pointsRealisesTeam2;
-    int attackerBelote = team1HasBid ? beloteTeam1 : beloteTeam2;
-    bool contractSuccess;
-    if (room->isBeloteMode) {
-        // En Belote : succès si le preneur atteint >= 81 pts (belote incluse)
-        contractSuccess = ((attackerPoints + attackerBelote) >= 81);
-    } else if (isCapotAnnonce) {
-        contractSuccess = capotReussi;
-    } else if (isGeneraleAnnonce) {
-        contractSuccess = generaleReussie;
-    } else {
-        contractSuccess = ((attackerPoints + attackerBelote) >= valeurContrat);
-    }
-    scoreMsg["contractSuccess"] = contractSuccess;
+    scoreMsg["contractSuccess"] = contractReussi;
     scoreMsg["pointsRealisesTeam1"] = pointsRealisesTeam1;
     scoreMsg["pointsRealisesTeam2"] = pointsRealisesTeam2;
     broadcastToRoom(roomId, scoreMsg);
 
     // Vérifier si une équipe a atteint le score de victoire (500 en Belote, 1000 en Coinche)
     int winningScore = room->isBeloteMode ? 500 : 1000;
-    bool team1Won = room->scoreTeam1 >= winningScore;
-    bool team2Won = room->scoreTeam2 >= winningScore;
+    int vainqueur = GameEngine::vainqueur({{ room->scoreTeam1, room->scoreTeam2 }}, winningScore);
 
-    if (team1Won || team2Won) {
+    if (vainqueur >= 0) {
         // Une ou les deux équipes ont dépassé le score de victoire
-        int winner = 0;
-        if (team1Won && team2Won) {
-            // Les deux équipes ont dépassé le seuil, celle avec le plus de points gagne
-            winner = (room->scoreTeam1 > room->scoreTeam2) ? 1 : 2;
-            qInfo() << "Partie terminée - Room" << roomId << "- Les deux équipes >" << winningScore;
-            qInfo() << "  Équipe" << winner << "gagne avec"
-                    << ((winner == 1) ? room->scoreTeam1 : room->scoreTeam2) << "points";
-        } else if (team1Won) {
-            winner = 1;
-            qInfo() << "Partie terminée - Room" << roomId << "- Équipe 1 gagne -" << room->scoreTeam1 << "vs" << room->scoreTeam2;
-        } else {
-            winner = 2;
-            qInfo() << "Partie terminée - Room" << roomId << "- Équipe 2 gagne -" << room->scoreTeam1 << "vs" << room->scoreTeam2;
-        }
+        // (si les deux l'ont dépassé, celle avec le plus de points gagne)
+        int winner = vainqueur + 1;
+        qInfo() << "Partie terminée - Room" << roomId << "- Équipe" << winner << "gagne -"
+                << room->scoreTeam1 << "vs" << room->scoreTeam2 << "(victoire à" << winningScore << ")";
 
         // Mettre à jour les statistiques pour tous les joueurs enregistrés (ignorées en mode entraînement)
         if (!room->isTraining)
@@ -3989,20 +4041,15 @@ void GameServer::finishManche(int roomId) {
             if (room->isBeloteMode) {
                 // Capot : l'équipe du joueur a fait tous les plis
                 bool capotForPlayer = (playerTeam == 1) ? room->lastMancheCapotTeam1 : room->lastMancheCapotTeam2;
-                if (!m_dbManager->updateBeloteGameStats(conn->playerName, won, capotForPlayer)) {
-                    qCritical() << "[STATS] ÉCHEC - Mise à jour stats Belote - joueur:" << conn->playerName;
-                } else {
-                    qInfo() << "[STATS] Stats Belote mises à jour - joueur:" << conn->playerName << "won:" << won << "capot:" << capotForPlayer;
-                }
+                DatabaseManager::StatsDelta &delta = statsDeltas[conn->playerName];
+                delta.partieBelote = won ? DatabaseManager::StatsDelta::VICTOIRE : DatabaseManager::StatsDelta::DEFAITE;
+                if (capotForPlayer) delta.beloteCapots++;
             } else {
-                if (!m_dbManager->updateGameStats(conn->playerName, won)) {
-                    qCritical() << "[STATS] ÉCHEC CRITIQUE - Mise à jour stats de partie - joueur:" << conn->playerName << "won:" << won << "room:" << roomId;
-                } else {
-                    qInfo() << "[STATS] Stats de partie mises à jour - joueur:" << conn->playerName << "won:" << won;
-                }
+                statsDeltas[conn->playerName].partie = won ? DatabaseManager::StatsDelta::VICTOIRE : DatabaseManager::StatsDelta::DEFAITE;
             }
         }
-
+        postStatsDeltas(statsDeltas, roomId);
+        if (!room->isTraining) updateRatings(roomId, winner);
 
         QJsonObject gameOverMsg;
         gameOverMsg["type"] = "gameOver";
@@ -4019,11 +4066,186 @@ void GameServer::finishManche(int roomId) {
         }
     } else {
         // Aucune équipe n'a atteint 1000 points, on démarre une nouvelle manche
+        postStatsDeltas(statsDeltas, roomId);
         qDebug() << "GameServer - Demarrage d'une nouvelle manche...";
         startNewManche(roomId);
     }
 }
 
+void GameServer::postStatsDeltas(const QHash<QString, DatabaseManager::StatsDelta> &deltas, int roomId) {
+    if (deltas.isEmpty()) return;
+
+    m_dbWorker.post([deltas, roomId](DatabaseManager &db) {
+        if (!db.applyStatsDeltas(deltas)) {
+            qCritical() << "[STATS] ÉCHEC CRITIQUE - Stats de manche non enregistrées - room:" << roomId << "joueurs:" << deltas.keys();
+        } else {
+            qInfo() << "[STATS] Stats de manche enregistrées - room:" << roomId << "joueurs:" << deltas.size();
+        }
+    });
+}
+
+void GameServer::updateRatings(int roomId, int winner) {
+    GameRoom* room = m_gameRooms.value(roomId);
+    if (!room) return;
+    if (!m_ratingsLoaded) {
+        qWarning() << "[RATING] Cotes pas encore chargées, partie non cotée - room:" << roomId;
+        return;
+    }
+
+    const QString mode = room->isBeloteMode ? "belote" : "coinche";
+    QHash<QString, Glicko2::Rating> &ratings = ratingsFor(mode);
+
+    // Joueurs encore à la table : résultat de leur équipe (aucun si winner vaut 0, partie
+    // abandonnée). Joueurs partis avant la fin (room->leavers) : défaite, comme dans les stats.
+    // Les autres places (bots) comptent avec la cote des bots, sans changer
+    Glicko2::Rating bot;
+    bot.rating = BOT_RATING;
+    bot.rd = BOT_RD;
+    std::array<Glicko2::Rating, 4> places = {bot, bot, bot, bot};
+    std::array<DatabaseManager::RatedSeat, 4> seats;
+    std::array<PlayerConnection*, 4> joueurs = {nullptr, nullptr, nullptr, nullptr};
+    auto coteDepart = [&ratings](const QString &pseudo, double estimation) {
+        if (ratings.contains(pseudo)) return ratings[pseudo];
+        // Première partie cotée : on part de l'estimation du matchmaking (bilan)
+        Glicko2::Rating depart;
+        depart.rating = estimation;
+        return depart;
+    };
+    for (int i = 0; i < 4 && i < room->connectionIds.size(); i++) {
+        const QString &connId = room->connectionIds[i];
+        PlayerConnection* conn = connId.isEmpty() ? nullptr : m_connections.value(connId);
+        if (conn && !conn->playerName.isEmpty()) {
+            places[i] = coteDepart(conn->playerName, matchmakingRating(conn, mode));
+            if (winner == 0) continue;
+            joueurs[i] = conn;
+            seats[i].pseudo = conn->playerName;
+            seats[i].isAnonymous = conn->isAnonymous;
+            seats[i].score = ((i % 2 == 0) == (winner == 1)) ? 1.0 : 0.0;
+        } else if (room->leavers.contains(i)) {
+            const RoomLeaver &partant = room->leavers[i];
+            places[i] = coteDepart(partant.pseudo, partant.startRating);
+            seats[i].pseudo = partant.pseudo;
+            seats[i].isAnonymous = partant.isAnonymous;
+            seats[i].score = 0.0;
+        } else if (i < room->playerNames.size() && ratings.contains(room->playerNames[i])) {
+            places[i] = ratings[room->playerNames[i]];
+        }
+    }
+    room->leavers.clear();  // Cotés une seule fois
+
+    // Cotes appliquées tout de suite en mémoire (matchmaking) ; le thread SQLite
+    // refait le calcul sur les cotes en base, que d'autres serveurs ont pu changer
+    std::array<double, 4> scores;
+    for (int i = 0; i < 4; i++) scores[i] = seats[i].score;
+    const std::array<Glicko2::Rating, 4> apres = Glicko2::rateTeamGame(places, scores);
+    bool aEnregistrer = false;
+    for (int i = 0; i < 4; i++) {
+        seats[i].rating = places[i];
+        if (seats[i].pseudo.isEmpty()) continue;
+        ratings[seats[i].pseudo] = apres[i];
+        if (joueurs[i]) (mode == "belote" ? joueurs[i]->ratingBelote : joueurs[i]->ratingCoinche) = apres[i].rating;
+        aEnregistrer = true;
+        qDebug() << "[RATING]" << mode << seats[i].pseudo << qRound(places[i].rating) << "->" << qRound(apres[i].rating)
+                 << "RD" << qRound(apres[i].rd) << (joueurs[i] ? "" : "(parti)");
+    }
+    if (!aEnregistrer) return;
+
+    m_dbWorker.request<DatabaseManager::RatingsSave>(this, [mode, seats, roomId](DatabaseManager &db) {
+        DatabaseManager::RatingsSave save;
+        for (int essai = 1; essai <= RATINGS_SAVE_ATTEMPTS && !save.ok; essai++) {
+            save = db.rateGame(mode, seats);
+            if (!save.ok) qWarning() << "[RATING] Échec d'enregistrement - room:" << roomId << "essai" << essai;
+        }
+        return save;
+    }, [this, mode, seats, roomId](const DatabaseManager::RatingsSave &save) {
+        if (!save.ok) {
+            // Les cotes calculées en mémoire restent valables jusqu'au prochain redémarrage
+            QStringList pseudos;
+            for (const DatabaseManager::RatedSeat &seat : seats) {
+                if (seat.pseudo.isEmpty()) continue;
+                pseudos.append(seat.pseudo);
+                refreshLeaderboard(mode, seat.pseudo, seat.isAnonymous);
+            }
+            qCritical() << "[RATING] ÉCHEC CRITIQUE - Cotes non enregistrées - room:" << roomId << "joueurs:" << pseudos;
+            return;
+        }
+
+        QHash<QString, Glicko2::Rating> &ratings = ratingsFor(mode);
+        QSet<QString> enregistres;
+        for (const DatabaseManager::PlayerRating &rating : save.saved) {
+            ratings[rating.pseudo] = {rating.rating, rating.rd, rating.volatility, rating.games};
+            refreshLeaderboard(mode, rating.pseudo, rating.isAnonymous);
+            enregistres.insert(rating.pseudo);
+        }
+        for (const DatabaseManager::RatedSeat &seat : seats) {
+            if (seat.pseudo.isEmpty() || enregistres.contains(seat.pseudo)) continue;
+            // Invité (pas de compte) : cote gardée pour la session seulement
+            ratings.remove(seat.pseudo);
+        }
+    });
+}
+
+void GameServer::loadRatings() {
+    m_dbWorker.readAfterWrites<RatingsData>(this, [](DatabaseManager &db) {
+        RatingsData result;
+        result.coinche = db.getAllRatings("coinche");
+        result.belote = db.getAllRatings("belote");
+        return result;
+    }, [this](const RatingsData &result) {
+        auto charger = [this](const QString &mode, const QList<DatabaseManager::PlayerRating> &liste) {
+            QHash<QString, Glicko2::Rating> &ratings = ratingsFor(mode);
+            for (const DatabaseManager::PlayerRating &rating : liste) {
+                ratings.insert(rating.pseudo, {rating.rating, rating.rd, rating.volatility, rating.games});
+                refreshLeaderboard(mode, rating.pseudo, rating.isAnonymous);
+            }
+        };
+        charger("coinche", result.coinche);
+        charger("belote", result.belote);
+        m_ratingsLoaded = true;
+        qInfo() << "[RATING] Cotes chargées - coinche:" << m_ratingsCoinche.size() << "(classés:" << m_leaderboardCoinche.size()
+                << ") belote:" << m_ratingsBelote.size() << "(classés:" << m_leaderboardBelote.size() << ")";
+    });
+}
+
+void GameServer::handleGetLeaderboard(QWebSocket *socket, const QJsonObject &data) {
+    QString mode = data["gameMode"].toString("coinche");
+    if (mode != "belote") mode = "coinche";
+    int limit = qBound(1, data["limit"].toInt(LEADERBOARD_DEFAULT_SIZE), LEADERBOARD_MAX_SIZE);
+
+    const QHash<QString, Glicko2::Rating> &ratings = ratingsFor(mode);
+    const LeaderboardIndex<QString> &index = leaderboardFor(mode);
+
+    QJsonArray entries;
+    for (const auto &entry : index.top(limit)) {
+        QJsonObject ligne;
+        ligne["rank"] = entry.rank;
+        ligne["playerName"] = entry.key;
+        ligne["rating"] = entry.score;
+        ligne["games"] = ratings.value(entry.key).games;
+        entries.append(ligne);
+    }
+
+    QJsonObject response;
+    response["type"] = "leaderboard";
+    response["gameMode"] = mode;
+    response["entries"] = entries;
+    response["rankedPlayers"] = index.size();
+
+    // Position du demandeur (rang 0 : pas encore classé)
+    QString connectionId = getConnectionIdBySocket(socket);
+    PlayerConnection* conn = m_connections.value(connectionId);
+    if (conn && ratings.contains(conn->playerName)) {
+        const Glicko2::Rating mienne = ratings.value(conn->playerName);
+        response["myRank"] = index.rank(conn->playerName);
+        response["myRating"] = qRound(mienne.rating);
+        response["myGames"] = mienne.games;
+    } else {
+        response["myRank"] = 0;
+        response["myGames"] = 0;
+    }
+    sendMessage(socket, response);
+}
+
 void GameServer::doStartNewManche(int roomId) {
     GameRoom* room = m_gameRooms.value(roomId);
     if (!room) return;
@@ -4136,7 +4358,7 @@ void GameServer::doStartNewManche(int roomId) {
     room->coinched = false;
     room->surcoinched = false;
     room->coinchePlayerIndex = -1;
-    room->currentPli.clear();
+    room->clearPli();
     room->couleurDemandee = Carte::COULEURINVALIDE;
 
     // Le joueur suivant commence les enchères (rotation)
@@ -4154,7 +4376,7 @@ void GameServer::doStartNewManche(int roomId) {
     bool isBelote = room->isBeloteMode;
     if (room->isBot[room->currentPlayerIndex]) {
         int firstBidder = room->currentPlayerIndex;
-        QTimer::singleShot(NEW_MANCHE_BOT_DELAY_MS, this, [this, roomId, firstBidder, isBelote]() {
+        scheduleRoomEvent(roomId, NEW_MANCHE_BOT_DELAY_MS, [this, roomId, firstBidder, isBelote]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (!room || room->gameState != "bidding") return;
 
@@ -4173,7 +4395,7 @@ void GameServer::doStartNewManche(int roomId) {
     } else {
         // Joueur humain : démarrer le timer de timeout pour les enchères
         // (attendre la fin de la distribution de la nouvelle manche)
-        QTimer::singleShot(NEW_MANCHE_BOT_DELAY_MS, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, NEW_MANCHE_BOT_DELAY_MS, [this, roomId]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (room && room->gameState == "bidding") {
                 startBidTimeout(roomId, room->currentPlayerIndex);
@@ -4186,15 +4408,12 @@ void GameServer::startPlayingPhase(int roomId) {
     GameRoom* room = m_gameRooms.value(roomId);
     if (!room) return;
 
-    // Arrêter le timer de timeout des enchères si actif
-    if (room->bidTimeout) {
-        room->bidTimeout->stop();
-        room->bidTimeoutGeneration++;
-        qDebug() << "startPlayingPhase - Timer de timeout enchères arrêté, génération:" << room->bidTimeoutGeneration;
-    }
+    // Annuler le timeout des enchères si actif
+    cancelRoomEvent(room, room->bidTimeout);
 
     room->gameState = "playing";
     room->waitingForNextPli = false;  // S'assurer que le flag est désactivé au début de la phase de jeu
+    room->playPhaseSent = false;      // Le premier gameState de la phase porte l'atout et le mode
 
     // Définir couleurAtout selon le mode de jeu actuel
     // IMPORTANT: S'assurer que couleurAtout reflète bien le mode de jeu final
@@ -4227,28 +4446,8 @@ void GameServer::startPlayingPhase(int roomId) {
                 << "(Gagnant encheres:" << room->lastBidderIndex << ")";
 
     // Verifier la Belote (Dame + Roi de l'atout) pour chaque equipe
-    room->beloteTeam1 = false;
-    room->beloteTeam2 = false;
-
-    // Verifier joueurs de l'equipe 1 (joueurs 0 et 2)
-    if (room->players[0]->hasBelotte(room->couleurAtout)) {
-        room->beloteTeam1 = true;
-        qDebug() << "GameServer - Belote detectee pour le joueur 0 (Equipe 1)";
-    }
-    if (room->players[2]->hasBelotte(room->couleurAtout)) {
-        room->beloteTeam1 = true;
-        qDebug() << "GameServer - Belote detectee pour le joueur 2 (Equipe 1)";
-    }
-
-    // Verifier joueurs de l'equipe 2 (joueurs 1 et 3)
-    if (room->players[1]->hasBelotte(room->couleurAtout)) {
-        room->beloteTeam2 = true;
-        qDebug() << "GameServer - Belote detectee pour le joueur 1 (Equipe 2)";
-    }
-    if (room->players[3]->hasBelotte(room->couleurAtout)) {
-        room->beloteTeam2 = true;
-        qDebug() << "GameServer - Belote detectee pour le joueur 3 (Equipe 2)";
-    }
+    room->detectBelote();
+    qDebug() << "GameServer - Belote: Equipe 1 =" << room->beloteTeam1 << ", Equipe 2 =" << room->beloteTeam2;
 
     // Notifie tous les joueurs du changement de phase avec cartes jouables
     notifyPlayersWithPlayableCards(roomId);
@@ -4263,15 +4462,19 @@ void GameServer::notifyPlayersWithPlayableCards(int roomId) {
     // Calcule les cartes jouables pour le joueur actuel
     QJsonArray playableCards = calculatePlayableCards(room, currentPlayer);
 
-    // Envoi à tous les joueurs
+    // Envoi à tous les joueurs : seulement ce qui change d'un tour à l'autre.
+    // L'atout et le mode ne sont envoyés qu'au premier tour de la phase de jeu
+    // (un client qui en a manqué une partie les récupère par resync)
     QJsonObject stateMsg;
     stateMsg["type"] = "gameState";
-    stateMsg["biddingPhase"] = false;
     stateMsg["currentPlayer"] = currentPlayer;
-    stateMsg["atout"] = static_cast<int>(room->couleurAtout);
-    stateMsg["isToutAtout"] = room->isToutAtout;
-    stateMsg["isSansAtout"] = room->isSansAtout;
-    stateMsg["playableCards"] = playableCards;  // Liste des indices des cartes jouables
+    if (!room->playPhaseSent) {
+        stateMsg["biddingPhase"] = false;
+        stateMsg["atout"] = static_cast<int>(room->couleurAtout);
+        stateMsg["isToutAtout"] = room->isToutAtout;
+        stateMsg["isSansAtout"] = room->isSansAtout;
+        room->playPhaseSent = true;
+    }
 
     // Si on est au début de la phase de jeu, inclure les infos d'enchères
     if (room->currentPli.empty() && currentPlayer == room->firstPlayerIndex) {
@@ -4279,7 +4482,10 @@ void GameServer::notifyPlayersWithPlayableCards(int roomId) {
         stateMsg["biddingWinnerAnnonce"] = static_cast<int>(room->lastBidAnnonce);
     }
 
-    broadcastToRoom(roomId, stateMsg);
+    // Les cartes jouables ne concernent que le joueur dont c'est le tour
+    QJsonObject privateFields;
+    privateFields["playableCards"] = playableCards;
+    broadcastRoomState(roomId, stateMsg, currentPlayer, privateFields);
 
     // Si le joueur actuel est déjà marqué comme bot, le faire jouer automatiquement
     if (room->isBot[currentPlayer]) {
@@ -4289,7 +4495,7 @@ void GameServer::notifyPlayersWithPlayableCards(int roomId) {
         // pour laisser le temps au pli précédent d'être nettoyé côté client
         int delay = room->currentPli.empty() ? 2000 : 1100;
 
-        QTimer::singleShot(delay, this, [this, roomId, currentPlayer]() {
+        scheduleRoomEvent(roomId, delay, [this, roomId, currentPlayer]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (!room || room->gameState != "playing") return;
 
@@ -4318,33 +4524,16 @@ void GameServer::notifyPlayersWithPlayableCards(int roomId) {
         return;
     }
 
-    // Pour les joueurs humains, démarrer un timer de 15 secondes
+    // Pour les joueurs humains, armer un timeout de 15 secondes
     // Si le joueur ne joue pas dans les temps, le marquer comme bot et jouer automatiquement
-    if (!room->turnTimeout) {
-        room->turnTimeout = new QTimer(this);
-        room->turnTimeout->setSingleShot(true);
-    }
-
-    // TOUJOURS arrêter et déconnecter l'ancien timer avant d'en créer un nouveau
-    // Cela évite que d'anciens signaux en queue ne se déclenchent pour le mauvais joueur
-    room->turnTimeout->stop();
-    disconnect(room->turnTimeout, nullptr, this, nullptr);
-
-    // Incrémenter la génération pour invalider les anciens callbacks en queue
-    room->turnTimeoutGeneration++;
-    int currentGeneration = room->turnTimeoutGeneration;
+    // L'ancien timeout est annulé : il ne peut plus se déclencher pour le mauvais joueur
+    cancelRoomEvent(room, room->turnTimeout);
 
-    // Démarrer le nouveau timer
-    connect(room->turnTimeout, &QTimer::timeout, this, [this, roomId, currentPlayer, currentGeneration]() {
+    room->turnTimeout = scheduleRoomEvent(roomId, 15000, [this, roomId, currentPlayer]() {  // 15 secondes (cohérent avec le timer client)
         GameRoom* room = m_gameRooms.value(roomId);
-        if (!room || room->gameState != "playing") return;
-
-        // Vérifier que ce timeout est toujours valide (pas un ancien signal en queue)
-        if (room->turnTimeoutGeneration != currentGeneration) {
-            qDebug() << "TIMEOUT - Ignoré (ancienne génération:" << currentGeneration
-                        << "actuelle:" << room->turnTimeoutGeneration << ")";
-            return;
-        }
+        if (!room) return;
+        room->turnTimeout = 0;  // Déclenché : plus rien à annuler
+        if (room->gameState != "playing") return;
 
         // Vérifier que c'est toujours le même joueur (qu'aucune carte n'a été jouée entre-temps)
         if (room->currentPlayerIndex == currentPlayer && !room->isBot[currentPlayer]) {
@@ -4361,7 +4550,7 @@ void GameServer::notifyPlayersWithPlayableCards(int roomId) {
                     QJsonObject notification;
                     notification["type"] = "botReplacement";
                     notification["message"] = "Un bot a pris le relais car vous n'avez pas joué à temps.";
-                    conn->socket->sendTextMessage(QJsonDocument(notification).toJson(QJsonDocument::Compact));
+                    sendMessage(conn->socket, notification);
                     qDebug() << "TIMEOUT - Notification botReplacement envoyée au joueur" << currentPlayer;
                 }
             }
@@ -4369,10 +4558,8 @@ void GameServer::notifyPlayersWithPlayableCards(int roomId) {
             // Faire jouer le bot immédiatement
             playBotCard(roomId, currentPlayer);
         }
-    });
-
-    room->turnTimeout->start(15000);  // 15 secondes (cohérent avec le timer client)
-    qDebug() << "notifyPlayersWithPlayableCards - Timer de 15s démarré pour joueur" << currentPlayer << "(génération:" << currentGeneration << ")";
+    }, RoomDelay::PlayerTimeout);
+    qDebug() << "notifyPlayersWithPlayableCards - Timeout de 15s armé pour joueur" << currentPlayer;
 
     // Si c'est le dernier pli (tous les joueurs n'ont qu'une carte), jouer automatiquement après un délai
     // IMPORTANT: Ne jouer automatiquement que si on est bien dans la phase de jeu
@@ -4387,7 +4574,7 @@ void GameServer::notifyPlayersWithPlayableCards(int roomId) {
         int delay = room->currentPli.empty() ? 2000 : 800;
 
         // Jouer automatiquement après le délai approprié
-        QTimer::singleShot(delay, this, [this, roomId, currentPlayer]() {
+        scheduleRoomEvent(roomId, delay, [this, roomId, currentPlayer]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (!room || room->currentPlayerIndex != currentPlayer || room->gameState != "playing") return;
 
@@ -4404,11 +4591,8 @@ void GameServer::notifyPlayersWithPlayableCards(int roomId) {
                 room->couleurDemandee = cartePlayed->getCouleur();
             }
 
-            // Ajouter au pli courant
-            room->currentPli.push_back(std::make_pair(currentPlayer, cartePlayed));
-
-            // Marquer la carte comme jouée pour le tracking IA
-            room->markCardAsPlayed(cartePlayed);
+            // Ajouter au pli courant (et marque la carte comme jouée pour le tracking IA)
+            room->addCardToPli(currentPlayer, cartePlayed);
 
             // Retirer la carte de la main
             player->removeCard(0);
@@ -4445,34 +4629,12 @@ QJsonArray GameServer::calculatePlayableCards(GameRoom* room, int playerIndex) {
     Player* player = room->players[playerIndex].get();
     if (!player) return playableIndices;
 
-    // Détermine la carte gagnante actuelle du pli
-    Carte* carteGagnante = nullptr;
-    int idxPlayerWinning = -1;
-    if (!room->currentPli.empty()) {
-        carteGagnante = room->currentPli[0].second;
-        idxPlayerWinning = room->currentPli[0].first;
-
-        for (size_t i = 1; i < room->currentPli.size(); i++) {
-            Carte* c = room->currentPli[i].second;
-            if (*carteGagnante < *c) {
-                carteGagnante = c;
-                idxPlayerWinning = room->currentPli[i].first;
-            }
-        }
-    }
-
     // Vérifie chaque carte
+    CardSet jouables = getPlayableCards(room, playerIndex);
     const auto& main = player->getMain();
 
     for (size_t i = 0; i < main.size(); i++) {
-        bool isPlayable = player->isCartePlayable(
-            static_cast<int>(i),
-            room->couleurDemandee,
-            room->couleurAtout,
-            carteGagnante,
-            idxPlayerWinning,
-            room->isToutAtout  // Passer explicitement le flag isToutAtout
-        );
+        bool isPlayable = jouables.contains(makeCardId(*main[i]));
 
         if (isPlayable) {
             // Envoyer l'identité (value+suit) pour que le client puisse résoudre
@@ -4501,29 +4663,35 @@ void GameServer::handleSendFriendRequest(QWebSocket *socket, const QJsonObject &
     QString requester = conn->playerName;
     QString target = data["targetPseudo"].toString();
 
-    QString errorMsg;
-    if (m_dbManager->sendFriendRequest(requester, target, errorMsg)) {
-        QJsonObject response;
-        response["type"] = "friendRequestSent";
-        sendMessage(socket, response);
+    m_dbWorker.request<DbResult>(this, [requester, target](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.sendFriendRequest(requester, target, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), requester, target, avatar = conn->avatar](const DbResult &result) {
+        // sendMessage ignore le socket s'il a été fermé : l'autre joueur est notifié quand même
+        if (result.ok) {
+            QJsonObject response;
+            response["type"] = "friendRequestSent";
+            sendMessage(socket, response);
 
-        // Notifier la cible si elle est en ligne
-        for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-            if (it.value() && it.value()->playerName == target) {
-                QJsonObject notif;
-                notif["type"] = "friendRequestReceived";
-                notif["fromPseudo"] = requester;
-                notif["fromAvatar"] = conn->avatar;
-                sendMessage(it.value()->socket, notif);
-                break;
+            // Notifier la cible si elle est en ligne
+            for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
+                if (it.value() && it.value()->playerName == target) {
+                    QJsonObject notif;
+                    notif["type"] = "friendRequestReceived";
+                    notif["fromPseudo"] = requester;
+                    notif["fromAvatar"] = avatar;
+                    sendMessage(it.value()->socket, notif);
+                    break;
+                }
             }
+        } else {
+            QJsonObject response;
+            response["type"] = "friendRequestFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
         }
-    } else {
-        QJsonObject response;
-        response["type"] = "friendRequestFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-    }
+    });
 }
 
 void GameServer::handleAcceptFriendRequest(QWebSocket *socket, const QJsonObject &data) {
@@ -4535,29 +4703,35 @@ void GameServer::handleAcceptFriendRequest(QWebSocket *socket, const QJsonObject
     QString requester = data["requesterPseudo"].toString();
     QString accepter = conn->playerName;
 
-    QString errorMsg;
-    if (m_dbManager->acceptFriendRequest(requester, accepter, errorMsg)) {
-        QJsonObject response;
-        response["type"] = "friendRequestAccepted";
-        response["pseudo"] = requester;
-        sendMessage(socket, response);
+    m_dbWorker.request<DbResult>(this, [requester, accepter](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.acceptFriendRequest(requester, accepter, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), requester, accepter](const DbResult &result) {
+        // sendMessage ignore le socket s'il a été fermé : l'autre joueur est notifié quand même
+        if (result.ok) {
+            QJsonObject response;
+            response["type"] = "friendRequestAccepted";
+            response["pseudo"] = requester;
+            sendMessage(socket, response);
 
-        // Notifier le demandeur si en ligne
-        for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-            if (it.value() && it.value()->playerName == requester) {
-                QJsonObject notif;
-                notif["type"] = "friendRequestAccepted";
-                notif["pseudo"] = accepter;
-                sendMessage(it.value()->socket, notif);
-                break;
+            // Notifier le demandeur si en ligne
+            for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
+                if (it.value() && it.value()->playerName == requester) {
+                    QJsonObject notif;
+                    notif["type"] = "friendRequestAccepted";
+                    notif["pseudo"] = accepter;
+                    sendMessage(it.value()->socket, notif);
+                    break;
+                }
             }
+        } else {
+            QJsonObject response;
+            response["type"] = "friendRequestFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
         }
-    } else {
-        QJsonObject response;
-        response["type"] = "friendRequestFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-    }
+    });
 }
 
 void GameServer::handleRejectFriendRequest(QWebSocket *socket, const QJsonObject &data) {
@@ -4569,17 +4743,23 @@ void GameServer::handleRejectFriendRequest(QWebSocket *socket, const QJsonObject
     QString requester = data["requesterPseudo"].toString();
     QString rejecter = conn->playerName;
 
-    QString errorMsg;
-    if (m_dbManager->rejectFriendRequest(requester, rejecter, errorMsg)) {
-        QJsonObject response;
-        response["type"] = "friendRequestRejected";
-        sendMessage(socket, response);
-    } else {
-        QJsonObject response;
-        response["type"] = "friendRequestFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-    }
+    m_dbWorker.request<DbResult>(this, [requester, rejecter](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.rejectFriendRequest(requester, rejecter, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket)](const DbResult &result) {
+        if (!socket) return;
+        if (result.ok) {
+            QJsonObject response;
+            response["type"] = "friendRequestRejected";
+            sendMessage(socket, response);
+        } else {
+            QJsonObject response;
+            response["type"] = "friendRequestFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+        }
+    });
 }
 
 void GameServer::handleGetFriendsList(QWebSocket *socket) {
@@ -4589,8 +4769,17 @@ void GameServer::handleGetFriendsList(QWebSocket *socket) {
     if (!conn) return;
 
     QString pseudo = conn->playerName;
-    QJsonArray friends = m_dbManager->getFriendsList(pseudo);
+    m_dbWorker.readAfterWrites<FriendsData>(this, [pseudo](DatabaseManager &db) {
+        FriendsData result;
+        result.friends = db.getFriendsList(pseudo);
+        result.pendingRequests = db.getPendingFriendRequests(pseudo);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket)](const FriendsData &result) {
+        if (socket) sendFriendsList(socket, result.friends, result.pendingRequests);
+    });
+}
 
+void GameServer::sendFriendsList(QWebSocket *socket, QJsonArray friends, const QJsonArray &pendingRequests) {
     // Marquer le statut en ligne
     for (int i = 0; i < friends.size(); i++) {
         QJsonObject f = friends[i].toObject();
@@ -4606,12 +4795,10 @@ void GameServer::handleGetFriendsList(QWebSocket *socket) {
         friends[i] = f;
     }
 
-    QJsonArray pending = m_dbManager->getPendingFriendRequests(pseudo);
-
     QJsonObject response;
     response["type"] = "friendsList";
     response["friends"] = friends;
-    response["pendingRequests"] = pending;
+    response["pendingRequests"] = pendingRequests;
     sendMessage(socket, response);
 }
 
@@ -4624,18 +4811,24 @@ void GameServer::handleRemoveFriend(QWebSocket *socket, const QJsonObject &data)
     QString pseudo1 = conn->playerName;
     QString pseudo2 = data["pseudo"].toString();
 
-    QString errorMsg;
-    if (m_dbManager->removeFriend(pseudo1, pseudo2, errorMsg)) {
-        QJsonObject response;
-        response["type"] = "friendRemoved";
-        response["pseudo"] = pseudo2;
-        sendMessage(socket, response);
-    } else {
-        QJsonObject response;
-        response["type"] = "friendRemoveFailed";
-        response["error"] = errorMsg;
-        sendMessage(socket, response);
-    }
+    m_dbWorker.request<DbResult>(this, [pseudo1, pseudo2](DatabaseManager &db) {
+        DbResult result;
+        result.ok = db.removeFriend(pseudo1, pseudo2, result.errorMsg);
+        return result;
+    }, [this, socket = QPointer<QWebSocket>(socket), pseudo2](const DbResult &result) {
+        if (!socket) return;
+        if (result.ok) {
+            QJsonObject response;
+            response["type"] = "friendRemoved";
+            response["pseudo"] = pseudo2;
+            sendMessage(socket, response);
+        } else {
+            QJsonObject response;
+            response["type"] = "friendRemoveFailed";
+            response["error"] = result.errorMsg;
+            sendMessage(socket, response);
+        }
+    });
 }
 
 void GameServer::handleInviteToLobby(QWebSocket *socket, const QJsonObject &data) {
@@ -4711,11 +4904,8 @@ void GameServer::handleBeloteBid(int roomId, int playerIndex, int bidValue, int
         return;
     }
 
-    // Arrêter le timer d'enchère
-    if (room->bidTimeout) {
-        room->bidTimeout->stop();
-        room->bidTimeoutGeneration++;
-    }
+    // Annuler le timeout d'enchère
+    cancelRoomEvent(room, room->bidTimeout);
 
     if (bidValue == 0) {
         // Passe
@@ -4757,7 +4947,7 @@ void GameServer::handleBeloteBid(int roomId, int playerIndex, int bidValue, int
 
                 qDebug() << "Belote - Passage au tour 2 des enchères";
                 // Démarrer le timer pour le prochain joueur
-                QTimer::singleShot(3000, this, [this, roomId]() {
+                scheduleRoomEvent(roomId, 3000, [this, roomId]() {
                     GameRoom* r = m_gameRooms.value(roomId);
                     if (!r || r->gameState != "bidding") return;
                     if (r->isBot[r->currentPlayerIndex]) {
@@ -4787,7 +4977,7 @@ void GameServer::handleBeloteBid(int roomId, int playerIndex, int bidValue, int
         stateMsg["biddingPhase"] = true;
         broadcastToRoom(roomId, stateMsg);
 
-        QTimer::singleShot(3000, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, 3000, [this, roomId]() {
             GameRoom* r = m_gameRooms.value(roomId);
             if (!r || r->gameState != "bidding") return;
             if (r->isBot[r->currentPlayerIndex]) {
@@ -4871,10 +5061,7 @@ void GameServer::completeBeloteDistribution(int roomId, int takerIndex) {
     }
 
     // Détecter la Belote (Roi + Dame d'atout)
-    room->beloteTeam1 = room->players[0]->hasBelotte(room->couleurAtout) ||
-                        room->players[2]->hasBelotte(room->couleurAtout);
-    room->beloteTeam2 = room->players[1]->hasBelotte(room->couleurAtout) ||
-                        room->players[3]->hasBelotte(room->couleurAtout);
+    room->detectBelote();
 
     // Notifier les joueurs de la distribution complète et du début du jeu
     QJsonObject distMsg;
@@ -4922,7 +5109,7 @@ void GameServer::completeBeloteDistribution(int roomId, int takerIndex) {
 
     // Laisser le temps au client d'animer la distribution complète (retournée + round-robin)
     // avant de lancer la phase de jeu (sinon les bots joueraient pendant l'animation).
-    QTimer::singleShot(BELOTE_COMPLETE_DEAL_DURATION_MS, this, [this, roomId]() {
+    scheduleRoomEvent(roomId, BELOTE_COMPLETE_DEAL_DURATION_MS, [this, roomId]() {
         GameRoom* r = m_gameRooms.value(roomId);
         if (!r) return;
         startPlayingPhase(roomId);
@@ -9,20 +9,37 @@
 #include <QSslKey>
 #include <QFile>
 #include <QMap>
-#include <QQueue>
+#include <QSet>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QRandomGenerator>
+#include <QThreadPool>
+#include <QPointer>
 #include "Player.h"
 #include "Deck.h"
 #include "Carte.h"
+#include "CardSet.h"
+#include "CardTables.h"
+#include "LegalMoves.h"
+#include "PimcBot.h"
+#include "BidEvaluator.h"
+#include "GameEngine.h"
 #include "GameModel.h"
 #include "DatabaseManager.h"
+#include "DatabaseWorker.h"
 #include "SmtpClient.h"
 #include "StatsReporter.h"
 #include "ScoreCalculator.h"
+#include "MessageDispatcher.h"
+#include "WireProtocol.h"
+#include "TimingWheel.h"
+#include "Matchmaker.h"
+#include "Glicko2.h"
+#include "LeaderboardIndex.h"
+#include "Broker.h"
 
 // Connexion réseau d'un joueur (pas la logique métier)
 struct PlayerConnection {
@@ -37,6 +54,9 @@ struct PlayerConnection {
     bool isAnonymous = false;  // RGPD - droit à l'opposition
     qint64 lastEmojiTimestamp = 0;  // Rate limit emojis (ms since epoch)
     QString preferredGameMode = "coinche";  // "coinche" ou "belote"
+    // Cotes de matchmaking (cf. Matchmaker), chargées après l'enregistrement
+    double ratingCoinche = Matchmaker<QString>::DEFAULT_RATING;
+    double ratingBelote = Matchmaker<QString>::DEFAULT_RATING;
 };
 
 // Vérification email en attente (inscription en 2 étapes)
@@ -51,6 +71,65 @@ struct PendingVerification {
     int attempts;           // tentatives erronées
 };
 
+// Résultats des requêtes sur le thread SQLite (DatabaseWorker::request)
+struct DbResult {
+    bool ok = false;
+    QString errorMsg;
+};
+
+struct LoginResult {
+    bool ok = false;
+    QString pseudo;
+    QString avatar;
+    QString errorMsg;
+    bool usingTempPassword = false;
+    bool isAnonymous = false;
+    QJsonArray friends;
+    QJsonArray pendingRequests;
+};
+
+// Message sortant encodé une seule fois, quel que soit le nombre de destinataires
+// (JSON ou CBOR, chacun calculé à la première demande)
+struct EncodedMessage {
+    explicit EncodedMessage(const QJsonObject &m) : message(m) {}
+
+    const QString &textFrame() {
+        if (text.isNull()) text = QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact));
+        return text;
+    }
+
+    const QByteArray &binaryFrame() {
+        if (binary.isNull()) binary = WireProtocol::encode(message);
+        return binary;
+    }
+
+    const QJsonObject &message;
+    QString text;
+    QByteArray binary;
+};
+
+struct FriendsData {
+    QJsonArray friends;
+    QJsonArray pendingRequests;
+};
+
+struct StatsData {
+    DatabaseManager::PlayerStats stats = {};
+    bool isFriend = false;
+};
+
+struct RatingsData {
+    QList<DatabaseManager::PlayerRating> coinche;
+    QList<DatabaseManager::PlayerRating> belote;
+};
+
+// Joueur parti d'une partie cotée avant la fin (forfait, déconnexion)
+struct RoomLeaver {
+    QString pseudo;
+    bool isAnonymous = false;
+    double startRating = 0.0;  // Estimation du matchmaking, pour une première partie cotée
+};
+
 // Une partie de jeu avec la vraie logique
 struct GameRoom {
     int roomId;
@@ -65,6 +144,9 @@ struct GameRoom {
     std::vector<bool> isBot;  // true si le joueur à cet index est un bot
     bool isTraining = false;  // true si partie d'entraînement (stats non enregistrées)
     bool isBeloteMode = false;  // true = règles Belote, false = règles Coinche
+    // Joueurs partis avant la fin, par place : cotés perdants en fin de partie ou à
+    // l'abandon de la room (cf. GameServer::updateRatings), sauf s'ils sont revenus
+    QMap<int, RoomLeaver> leavers;
 
     // Belote : état des enchères Prendre/Passer
     Carte* retournee = nullptr;       // Carte retournée face visible au centre (non retirée du deck)
@@ -77,6 +159,19 @@ struct GameRoom {
     Carte::Couleur couleurAtout = Carte::COULEURINVALIDE;
     bool isToutAtout = false;  // Mode Tout Atout : toutes les cartes sont des atouts
     bool isSansAtout = false;  // Mode Sans Atout : aucune carte n'est atout
+
+    // Mode de jeu courant, pour indexer les tables de force/points
+    CardTables::Mode trumpMode() const {
+        if (isToutAtout) return CardTables::MODE_TOUT_ATOUT;
+        if (isSansAtout) return CardTables::MODE_SANS_ATOUT;
+        return CardTables::MODE_COULEUR;
+    }
+
+    // Contrat en cours pour les règles de GameEngine (gagnant et points des plis, belote)
+    PlayoutPolicy::Contrat trumpContract() const {
+        return PlayoutPolicy::makeContrat(couleurAtout, trumpMode());
+    }
+
     int currentPlayerIndex = 0;
     int biddingPlayer = 0;
     int firstPlayerIndex = 0;  // Joueur qui commence les enchères ET qui jouera en premier
@@ -89,24 +184,40 @@ struct GameRoom {
     int lastBidderIndex = -1;
     bool coinched = false;  // True si COINCHE a été annoncé
     bool surcoinched = false;  // True si SURCOINCHE a été annoncé
-    QTimer* surcoincheTimer = nullptr;  // Timer pour le timeout de surcoinche
+    TimingWheel::TimerId surcoincheTimer = 0;  // Tic du compte à rebours de surcoinche (1 s)
     int surcoincheTimeLeft = 0;  // Temps restant en secondes
     int coinchePlayerIndex = -1;  // Index du joueur qui a coinché
     int surcoinchePlayerIndex = -1;  // Index du joueur qui a surcoinché
 
-    // Timer pour détecter les joueurs qui ne répondent pas
-    QTimer* turnTimeout = nullptr;  // Timer pour timeout du tour (15 secondes)
-    int turnTimeoutGeneration = 0;  // Compteur pour invalider les anciens timeouts
+    // Timeouts des joueurs qui ne répondent pas (événements de la roue temporelle, 0 = aucun)
+    // Annuler l'événement suffit : un timeout annulé ne peut plus se déclencher
+    TimingWheel::TimerId turnTimeout = 0;  // Timeout du tour (15 secondes)
+    TimingWheel::TimerId bidTimeout = 0;   // Timeout des enchères (20 secondes)
+
+    // Événements planifiés pour la room (cf. GameServer::scheduleRoomEvent), annulés à sa suppression
+    QSet<TimingWheel::TimerId> scheduledEvents;
 
-    // Timer pour détecter les joueurs qui ne répondent pas pendant les enchères
-    QTimer* bidTimeout = nullptr;  // Timer pour timeout des enchères (15 secondes)
-    int bidTimeoutGeneration = 0;  // Compteur pour invalider les anciens timeouts d'enchères
+    // Horloge de la room : les délais d'animation (distribution, pli suivant, réflexion
+    // des bots) sont divisés par clockSpeed, 0 = immédiat. Les timeouts des joueurs
+    // humains ne changent pas.
+    double clockSpeed = 1.0;
+    // Entraînement : le client signale la fin de ses animations (animationDone), les
+    // délais d'animation planifiés jusque-là n'attendent pas leur échéance
+    bool animationAcks = false;
+    QList<QPair<TimingWheel::TimerId, quint32>> ackableEvents;  // (événement, stateSeq à la planification)
 
     // Pli en cours
     std::vector<std::pair<int, Carte*>> currentPli;  // pair<playerIndex, carte>
+    CardSet currentPliCards;  // Cartes du pli en cours (masque)
     Carte::Couleur couleurDemandee = Carte::COULEURINVALIDE;
     bool waitingForNextPli = false;  // True pendant l'attente de 1500ms entre les plis
 
+    // Synchronisation : chaque message d'état diffusé porte un numéro (seq) ; les derniers
+    // sont gardés pour renvoyer à un client exactement ce qu'il a manqué (resync)
+    quint32 stateSeq = 0;
+    QList<QJsonObject> stateHistory;
+    bool playPhaseSent = false;  // Atout et mode déjà envoyés pour la phase de jeu en cours
+
     // Scores
     int scoreTeam1 = 0;  // Équipe 0: Joueurs 0 et 2
     int scoreTeam2 = 0;  // Équipe 1: Joueurs 1 et 3
@@ -135,60 +246,81 @@ struct GameRoom {
     bool beloteRoiJoue = false;   // Roi de l'atout joué
     bool beloteDameJouee = false; // Dame de l'atout jouée
 
-    // Tracking des cartes jouées pour l'IA des bots
-    // Structure: playedCards[couleur][chiffre] = true si la carte a été jouée
-    std::map<Carte::Couleur, std::map<Carte::Chiffre, bool>> playedCards;
+    // Tracking des cartes jouées pour l'IA des bots (1 bit par carte jouée)
+    CardSet playedCards;
+    std::array<CardSet, 4> playedByPlayer;   // Cartes jouées par chaque joueur
+    std::array<CardSet, 4> impossibleCards;  // Cartes qu'un joueur ne peut plus avoir (défausses, coupes)
+
+    // Bots par échantillonnage (PimcBot)
+    bool pimcBots = false;
+    bool botThinking = false;
+
+    // Prise de risque des bots aux enchères (voir BidEvaluator::Options::risque)
+    double botBidRisk = 0.25;
 
     // Initialise le tracking des cartes jouées (à appeler au début de chaque manche)
     void resetPlayedCards() {
         playedCards.clear();
-        std::array<Carte::Couleur, 4> couleurs = {Carte::COEUR, Carte::TREFLE, Carte::CARREAU, Carte::PIQUE};
-        std::array<Carte::Chiffre, 8> chiffres = {Carte::SEPT, Carte::HUIT, Carte::NEUF, Carte::DIX,
-                                                   Carte::VALET, Carte::DAME, Carte::ROI, Carte::AS};
-        for (auto couleur : couleurs) {
-            for (auto chiffre : chiffres) {
-                playedCards[couleur][chiffre] = false;
-            }
-        }
+        playedByPlayer.fill(CardSet());
+        impossibleCards.fill(CardSet());
     }
 
     // Marque une carte comme jouée
     void markCardAsPlayed(Carte* carte) {
         if (carte) {
-            playedCards[carte->getCouleur()][carte->getChiffre()] = true;
+            playedCards.add(makeCardId(*carte));
         }
     }
 
     // Vérifie si une carte a été jouée
     bool isCardPlayed(Carte::Couleur couleur, Carte::Chiffre chiffre) const {
-        auto itCouleur = playedCards.find(couleur);
-        if (itCouleur != playedCards.end()) {
-            auto itChiffre = itCouleur->second.find(chiffre);
-            if (itChiffre != itCouleur->second.end()) {
-                return itChiffre->second;
-            }
-        }
-        return false;
+        return playedCards.contains(makeCardId(couleur, chiffre));
     }
 
-    // Destructeur pour nettoyer les ressources
-    ~GameRoom() {
-        // Nettoyer les timers pour éviter les fuites mémoire
-        if (turnTimeout) {
-            turnTimeout->stop();
-            delete turnTimeout;
-            turnTimeout = nullptr;
+    // Ajoute une carte au pli en cours et la marque comme jouée
+    void addCardToPli(int playerIndex, Carte* carte) {
+        CardId id = makeCardId(*carte);
+
+        // Ce que la carte révèle de la main du joueur (couleur non fournie, pas coupé...)
+        if (!currentPli.empty()) {
+            std::pair<int, Carte*> gagnant = getPliWinner();
+            impossibleCards[playerIndex] |= LegalMoves::cartesExclues(
+                id, currentPli[0].second->getCouleur(), makeCardId(*gagnant.second),
+                (gagnant.first + 2) % 4 == playerIndex, couleurAtout, trumpMode());
         }
-        if (bidTimeout) {
-            bidTimeout->stop();
-            delete bidTimeout;
-            bidTimeout = nullptr;
+
+        currentPli.push_back(std::make_pair(playerIndex, carte));
+        currentPliCards.add(id);
+        playedByPlayer[playerIndex].add(id);
+        markCardAsPlayed(carte);
+    }
+
+    // Joueur et carte maîtres du pli en cours ({-1, nullptr} si pli vide)
+    std::pair<int, Carte*> getPliWinner() const {
+        if (currentPli.empty()) return {-1, nullptr};
+        PlayoutPolicy::Contrat contrat = trumpContract();
+        PlayoutPolicy::Pli pli;
+        for (const auto &carte : currentPli) {
+            pli.poser(makeCardId(*carte.second), contrat);
         }
-        if (surcoincheTimer) {
-            surcoincheTimer->stop();
-            delete surcoincheTimer;
-            surcoincheTimer = nullptr;
+        return currentPli[pli.gagnant];
+    }
+
+    // Belote de chaque équipe (Roi et Dame d'atout dans une même main), cf. GameEngine::belote
+    void detectBelote() {
+        std::array<CardSet, 4> mains;
+        for (int i = 0; i < 4; i++) {
+            mains[i] = players[i]->getMainSet();
         }
+        std::array<int, 2> belote = GameEngine::belote(mains, trumpContract());
+        beloteTeam1 = belote[0] > 0;
+        beloteTeam2 = belote[1] > 0;
+    }
+
+    // Vide le pli en cours
+    void clearPli() {
+        currentPli.clear();
+        currentPliCards.clear();
     }
 
     GameModel* gameModel = nullptr;
@@ -236,13 +368,20 @@ public:
         : QObject(parent)
         , m_server(nullptr)
         , m_nextRoomId(1)
-        , m_dbManager(new DatabaseManager(this))
         , m_smtpPassword(smtpPassword)
     {
         // Initialiser la base de donnees
-        if (!m_dbManager->initialize("coinche.db")) {
+        // La base vit dans son propre thread : les parties n'attendent jamais le disque
+        // (+ threads de lecture pour les stats et listes d'amis)
+        if (!m_dbWorker.start("coinche.db", DB_READER_THREADS)) {
             qCritical() << "Echec de l'initialisation de la base de donnees";
         }
+        loadRatings();
+
+        // Hachage des mots de passe : la moitié des cœurs au plus (parties et bots gardent le reste)
+        m_hashPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+
+        registerMessageHandlers();
 
         // Déterminer le mode (sécurisé ou non)
         bool useSecureMode = !certPath.isEmpty() && !keyPath.isEmpty();
@@ -293,6 +432,19 @@ public:
             qDebug() << "Erreur: impossible de demarrer le serveur";
         }
 
+        // Événements des rooms (coups de bots, timeouts, pli suivant) : une seule roue
+        // temporelle et un seul timer système, actif tant qu'un événement est planifié
+        m_timingClock.start();
+        m_timingWheelTimer = new QTimer(this);
+        m_timingWheelTimer->setInterval(TIMING_WHEEL_TICK_MS);
+        m_timingWheelTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_timingWheelTimer, &QTimer::timeout, this, [this]() {
+            m_timingWheel.advance(m_timingClock.elapsed());
+            if (m_timingWheel.empty()) {
+                m_timingWheelTimer->stop();
+            }
+        });
+
         // Timers de matchmaking indépendants par mode (Coinche et Belote)
         // Chaque queue a son propre timer principal (25s) et son propre timer de countdown (1s)
         m_lastQueueSize = 0;
@@ -315,11 +467,24 @@ public:
         m_countdownTimerBelote->setInterval(1000);
         connect(m_countdownTimerBelote, &QTimer::timeout, this, [this]() { onCountdownTickForMode("belote"); });
 
+        // Files de 4 joueurs ou plus sans table acceptable : réessayer quand les fenêtres s'élargissent
+        m_matchmakingRetryTimer = new QTimer(this);
+        m_matchmakingRetryTimer->setSingleShot(true);
+        connect(m_matchmakingRetryTimer, &QTimer::timeout, this, [this]() { tryCreateGame(); });
+
         // Initialiser le StatsReporter (rapports quotidiens)
-        m_statsReporter = new StatsReporter(m_dbManager, m_smtpPassword, this);
+        m_statsReporter = new StatsReporter(&m_dbWorker, m_smtpPassword, this);
         connect(m_statsReporter, &StatsReporter::maxCountersReset, this, [this]() {
             m_maxSimultaneousConnections = 0;
             m_maxSimultaneousGames = 0;
+
+            // Volume et durée de traitement des messages sur la journée écoulée
+            m_dispatcher.logStats();
+            m_dispatcher.resetStats();
+            qInfo() << "[OUTBOUND] Messages regroupés:" << m_outboundStats.coalesced
+                    << "ignorés (clients lents):" << m_outboundStats.dropped
+                    << "clients coupés:" << m_outboundStats.disconnected;
+            m_outboundStats = OutboundStats();
         });
         qInfo() << "StatsReporter initialisé - Rapports quotidiens activés";
     }
@@ -327,13 +492,21 @@ public:
     ~GameServer() {
         m_server->close();
 
-        // Libére toutes les GameRooms
+        // Terminer les écritures en attente (les callbacks visent ce GameServer)
+        m_dbWorker.stop();
+
+        // Attendre la fin des calculs de bots et de mots de passe en cours
+        m_botPool.waitForDone();
+        m_hashPool.waitForDone();
+
+        // Libére toutes les GameRooms (leurs événements partent avec m_timingWheel)
         qDeleteAll(m_gameRooms.values());
         m_gameRooms.clear();
 
         // Libére toutes les connexions
         qDeleteAll(m_connections.values());
         m_connections.clear();
+        m_connectionIdBySocket.clear();
 
         // Libére tous les lobbies privés
         qDeleteAll(m_privateLobbies.values());
@@ -349,53 +522,70 @@ public:
         return m_statsReporter;
     }
 
+    // Vitesse d'horloge par défaut des rooms créées ensuite (serveurs de charge) :
+    // 1 = rythme normal, 0 = délais d'animation supprimés
+    void setDefaultRoomClockSpeed(double speed) {
+        m_defaultRoomClockSpeed = speed > 0 ? speed : 0;
+    }
+
+    // Vitesse d'horloge d'une room existante (tests) ; false si la room n'existe pas.
+    // Vaut pour les délais planifiés ensuite
+    bool setRoomClockSpeed(int roomId, double speed) {
+        GameRoom *room = m_gameRooms.value(roomId);
+        if (!room) return false;
+        room->clockSpeed = speed > 0 ? speed : 0;
+        return true;
+    }
+
+    // Mode multi-processus : se coordonner avec les autres serveurs via le broker (cf. Broker.h)
+    // publicUrl est l'adresse à laquelle les clients redirigés joignent ce serveur
+    void enableBroker(const QString &socketPath, const QString &serverId, const QString &publicUrl) {
+        if (m_broker) return;
+        m_broker = std::make_unique<BrokerClient>(socketPath, serverId, publicUrl);
+        m_broker->setStateProvider([this]() { return brokerState(); });
+        m_broker->connectToBroker();
+    }
+
 private slots:
     void onNewConnection();
 
     void onTextMessageReceived(const QString &message);
 
+    void onBinaryMessageReceived(const QByteArray &message);
+
     void onDisconnected();
 
 private:
-    // Calcule la valeur d'une carte en mode Tout Atout
-    int getCardValueToutAtout(Carte* carte) const {
-        if (!carte) return 0;
+    // Associe chaque type de message client à son handler (voir dispatchMessage)
+    void registerMessageHandlers();
 
-        Carte::Chiffre chiffre = carte->getChiffre();
-        switch (chiffre) {
-            case Carte::SEPT:   return 0;
-            case Carte::HUIT:   return 0;
-            case Carte::DAME:   return 2;  // Dame vaut 2 point en TA
-            case Carte::ROI:    return 3;
-            case Carte::DIX:    return 4;
-            case Carte::AS:     return 6;  // As vaut 6 points en TA
-            case Carte::NEUF:   return 9;
-            case Carte::VALET:  return 14;
-            default:            return 0;
-        }
-    }
+    // Point d'entrée commun des messages texte (JSON) et binaires (CBOR)
+    void dispatchMessage(QWebSocket *sender, const QJsonObject &obj);
 
-    // Calcule la valeur d'une carte en mode Sans Atout
-    int getCardValueSansAtout(Carte* carte) const {
+    // Calcule la valeur d'une carte selon le mode de jeu (TA, SA ou couleur)
+    int getCardValue(Carte* carte, CardTables::Mode mode) const {
         if (!carte) return 0;
+        return CardTables::points(mode, carte->isAtout(), carte->getChiffre());
+    }
 
-        Carte::Chiffre chiffre = carte->getChiffre();
-        switch (chiffre) {
-            case Carte::SEPT:   return 0;
-            case Carte::HUIT:   return 0;
-            case Carte::NEUF:   return 0;
-            case Carte::VALET:  return 2;
-            case Carte::DAME:   return 3;
-            case Carte::ROI:    return 4;
-            case Carte::DIX:    return 10;
-            case Carte::AS:     return 19;
-            default:            return 0;
-        }
+    // Cartes jouables du joueur selon le pli en cours et le mode (couleur, TA, SA)
+    // Source unique des règles pour la validation, l'IA et la liste envoyée au client
+    CardSet getPlayableCards(GameRoom* room, int playerIndex) const {
+        Player* player = room->players[playerIndex].get();
+        if (!player) return CardSet();
+        return LegalMoves::legalMoves(player->getMainSet(), room->currentPli, playerIndex,
+                                      room->couleurAtout, room->trumpMode());
     }
 
     void handleRegister(QWebSocket *socket, const QJsonObject &data);  
 
     void handleReconnection(const QString& connectionId, int roomId, int playerIndex);
+
+    // Le client a détecté un trou dans les numéros (seq) : rattrapage ou état complet
+    void handleResync(QWebSocket *socket, const QJsonObject &data);
+
+    // Le client a fini d'animer les messages jusqu'à seq (rooms avec animationAcks)
+    void handleAnimationDone(QWebSocket *socket, const QJsonObject &data);
         
     void handleUpdateAvatar(QWebSocket *socket, const QJsonObject &data);
 
@@ -405,15 +595,47 @@ private:
     void handleSendContactMessage(QWebSocket *socket, const QJsonObject &data);
 
     void handleRegisterAccount(QWebSocket *socket, const QJsonObject &data);
+    // Insertion d'un compte dont le mot de passe a été haché sur m_hashPool
+    // failureType : type du message d'échec attendu par le client
+    void createHashedAccount(const QPointer<QWebSocket> &socket, const QString &pseudo, const QString &email,
+                             const QString &salt, const QString &passwordHash, const QString &avatar,
+                             const QString &failureType);
 
     void handleRequestVerificationCode(QWebSocket *socket, const QJsonObject &data);
+    // Suite de handleRequestVerificationCode une fois l'email et le pseudo vérifiés libres
+    void sendVerificationCode(QWebSocket *socket, const QString &pseudo, const QString &email,
+                              const QString &password, const QString &avatar);
     void handleVerifyCodeAndRegister(QWebSocket *socket, const QJsonObject &data);
 
     void handleLoginAccount(QWebSocket *socket, const QJsonObject &data);
+    void completeLoginAccount(const QPointer<QWebSocket> &socket, const QString &email,
+                              const DatabaseManager::Credentials &credentials,
+                              const DatabaseManager::PasswordCheck &check);
+    void sendLoginFailed(QWebSocket *socket, const QString &error);
+
+    // Exécute job sur m_hashPool puis done(résultat) dans le thread réseau
+    // Retourne false sans rien lancer si trop de calculs sont déjà en attente
+    template<typename Result>
+    bool runPasswordJob(std::function<Result()> job, std::function<void(const Result &result)> done) {
+        if (m_pendingPasswordJobs >= MAX_PENDING_PASSWORD_JOBS) {
+            qWarning() << "GameServer - File de hachage pleine (" << m_pendingPasswordJobs << "calculs en attente)";
+            return false;
+        }
+        m_pendingPasswordJobs++;
+        m_hashPool.start([this, job = std::move(job), done = std::move(done)]() {
+            auto result = std::make_shared<Result>(job());
+            QMetaObject::invokeMethod(this, [this, done, result]() {
+                m_pendingPasswordJobs--;
+                done(*result);
+            }, Qt::QueuedConnection);
+        });
+        return true;
+    }
 
     void handleDeleteAccount(QWebSocket *socket, const QJsonObject &data);
 
     void handleForgotPassword(QWebSocket *socket, const QJsonObject &data);
+    void sendTempPasswordEmail(const QPointer<QWebSocket> &socket, const QString &email, const QString &tempPassword);
 
     void handleChangePassword(QWebSocket *socket, const QJsonObject &data);
 
@@ -422,6 +644,8 @@ private:
     void handleChangeEmail(QWebSocket *socket, const QJsonObject &data);
 
     void handleRequestEmailChangeCode(QWebSocket *socket, const QJsonObject &data);
+    // Suite de handleRequestEmailChangeCode une fois la nouvelle adresse vérifiée libre
+    void sendEmailChangeCode(QWebSocket *socket, const QString &pseudo, const QString &newEmail);
 
     void handleVerifyCodeAndChangeEmail(QWebSocket *socket, const QJsonObject &data);
 
@@ -437,6 +661,7 @@ private:
     void handleAcceptFriendRequest(QWebSocket *socket, const QJsonObject &data);
     void handleRejectFriendRequest(QWebSocket *socket, const QJsonObject &data);
     void handleGetFriendsList(QWebSocket *socket);
+    void sendFriendsList(QWebSocket *socket, QJsonArray friends, const QJsonArray &pendingRequests);
     void handleRemoveFriend(QWebSocket *socket, const QJsonObject &data);
     void handleInviteToLobby(QWebSocket *socket, const QJsonObject &data);
 
@@ -446,14 +671,20 @@ private:
     void handleLeaveMatchmaking(QWebSocket *socket);
 
     void tryCreateGame();
-        
+
+    double matchmakingRating(const PlayerConnection *conn, const QString &mode) const {
+        return mode == "belote" ? conn->ratingBelote : conn->ratingCoinche;
+    }
+
+    // Cotes de matchmaking du joueur, estimées d'après ses stats (invités : cote par défaut)
+    void loadMatchmakingRatings(const QString &connectionId, const QString &playerName);
 
     // Démarre le compte à rebours de 9 secondes pour une queue donnée
     void startCountdownForMode(const QString& mode) {
         QTimer* mainTimer = (mode == "belote") ? m_matchmakingTimerBelote : m_matchmakingTimerCoinche;
         QTimer* countdownTimer = (mode == "belote") ? m_countdownTimerBelote : m_countdownTimerCoinche;
         int& countdownSeconds = (mode == "belote") ? m_countdownSecondsBelote : m_countdownSecondsCoinche;
-        QQueue<QString>& queue = (mode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
+        Matchmaker<QString>& queue = (mode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
 
         qDebug() << "MATCHMAKING [" << mode << "] - Début du compte à rebours de 9 secondes, joueurs:" << queue.size();
         mainTimer->stop();
@@ -469,7 +700,7 @@ private:
     void onCountdownTickForMode(const QString& mode) {
         int& countdownSeconds = (mode == "belote") ? m_countdownSecondsBelote : m_countdownSecondsCoinche;
         QTimer* countdownTimer = (mode == "belote") ? m_countdownTimerBelote : m_countdownTimerCoinche;
-        QQueue<QString>& queue = (mode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
+        Matchmaker<QString>& queue = (mode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
 
         countdownSeconds--;
         qDebug() << "MATCHMAKING COUNTDOWN [" << mode << "]:" << countdownSeconds << "secondes";
@@ -494,7 +725,7 @@ private:
                          .arg(seconds)
                          .arg(seconds > 1 ? "s" : "");
 
-        QQueue<QString>& queue = (mode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
+        Matchmaker<QString>& queue = (mode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
         for (const QString& connectionId : queue) {
             if (m_connections.contains(connectionId)) {
                 PlayerConnection* conn = m_connections[connectionId];
@@ -507,7 +738,7 @@ private:
 
     // Notifie les joueurs d'une queue de leur nombre
     void notifyQueueStatus(const QString& gameMode) {
-        QQueue<QString>& queue = (gameMode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
+        Matchmaker<QString>& queue = (gameMode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
         QJsonObject response;
         response["type"] = "matchmakingStatus";
         response["status"] = "searching";
@@ -536,6 +767,44 @@ private:
 
     void finishManche(int roomId);
 
+    // Envoie au thread SQLite les stats de fin de manche de tous les joueurs (une transaction)
+    void postStatsDeltas(const QHash<QString, DatabaseManager::StatsDelta> &deltas, int roomId);
+
+    // Cotes Glicko-2 (cf. Glicko2.h) des joueurs de la partie, puis classement.
+    // winner 0 : partie abandonnée, seuls les joueurs partis sont cotés
+    void updateRatings(int roomId, int winner);
+
+    // Joueur qui quitte une partie cotée avant la fin : il sera coté perdant
+    void recordLeaver(GameRoom *room, int playerIndex, const PlayerConnection *conn) {
+        if (room->isTraining || room->gameState == "finished" || conn->playerName.isEmpty()) return;
+        const QString mode = room->isBeloteMode ? "belote" : "coinche";
+        room->leavers.insert(playerIndex, RoomLeaver{conn->playerName, conn->isAnonymous, matchmakingRating(conn, mode)});
+    }
+
+    // Charge toutes les cotes au démarrage et construit les classements
+    void loadRatings();
+
+    void handleGetLeaderboard(QWebSocket *socket, const QJsonObject &data);
+
+    QHash<QString, Glicko2::Rating> &ratingsFor(const QString &mode) {
+        return mode == "belote" ? m_ratingsBelote : m_ratingsCoinche;
+    }
+
+    LeaderboardIndex<QString> &leaderboardFor(const QString &mode) {
+        return mode == "belote" ? m_leaderboardBelote : m_leaderboardCoinche;
+    }
+
+    // Classé s'il a assez de parties cotées et n'a pas demandé l'anonymat (RGPD)
+    void refreshLeaderboard(const QString &mode, const QString &pseudo, bool isAnonymous) {
+        const QHash<QString, Glicko2::Rating> &ratings = ratingsFor(mode);
+        auto it = ratings.constFind(pseudo);
+        if (it == ratings.constEnd() || isAnonymous || it->games < LEADERBOARD_MIN_GAMES) {
+            leaderboardFor(mode).remove(pseudo);
+        } else {
+            leaderboardFor(mode).set(pseudo, it->rating);
+        }
+    }
+
     void startNewManche(int roomId) {
         GameRoom* room = m_gameRooms.value(roomId);
         if (!room) return;
@@ -558,7 +827,7 @@ private:
         // Attendre pour l'animation avant de distribuer les cartes
         // 3.5s si tout le monde a passé (pas de recap), 7.5s sinon (recap + nouvelle manche)
         int animDelay = (room->lastBidderIndex < 0) ? 3500 : 7500;
-        QTimer::singleShot(animDelay, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, animDelay, [this, roomId]() {
             doStartNewManche(roomId);
         });
     }
@@ -700,106 +969,6 @@ private:
         return score;
     }
 
-    // Évalue la main pour soutenir l'annonce du partenaire
-    // Retourne un score bonus à ajouter si le bot veut surenchérir sur l'atout du partenaire
-    int evaluateHandForPartnerSuit(Player* player, Carte::Couleur partnerAtout) {
-        int score = 0;
-        int atoutCount = 0;
-        bool hasValetAtout = false;
-        bool hasNeufAtout = false;
-        bool hasRoiAtout = false;
-        bool hasDameAtout = false;
-
-        const auto& main = player->getMain();
-
-        for (Carte* carte : main) {
-            Carte::Couleur couleur = carte->getCouleur();
-            Carte::Chiffre chiffre = carte->getChiffre();
-
-            if (couleur == partnerAtout) {
-                // C'est un atout (la couleur du partenaire)
-                atoutCount++;
-
-                if (chiffre == Carte::VALET) {
-                    hasValetAtout = true;
-                    score += 15; // Valet d'atout pour soutien : +15
-                } else if (chiffre == Carte::NEUF) {
-                    hasNeufAtout = true;
-                    score += 10; // 9 d'atout pour soutien : +10
-                } else if (chiffre == Carte::ROI) {
-                    hasRoiAtout = true;
-                } else if (chiffre == Carte::DAME) {
-                    hasDameAtout = true;
-                }
-            } else {
-                // Hors atout - les As sont très utiles pour le partenaire
-                if (chiffre == Carte::AS) {
-                    score += 10; // As hors atout : +10 (on peut faire des plis)
-                }
-            }
-        }
-
-        // Bonus pour la belote (Roi + Dame de l'atout du partenaire)
-        if (hasRoiAtout && hasDameAtout) {
-            score += 15; // Belote pour soutien : +15
-        }
-
-        // Bonus si on a des atouts pour soutenir
-        if (hasNeufAtout && atoutCount >= 2) {
-            score += 10; // 9 + autres atouts : bon soutien
-        }
-
-        // Bonus si on a le Valet (très fort pour soutenir)
-        if (hasValetAtout) {
-            score += 5; // Bonus additionnel si on a le Valet
-        }
-
-        return score;
-    }
-
-    // Convertit un score d'évaluation en annonce
-    Player::Annonce scoreToAnnonce(int score, Player::Annonce currentBid) {
-        Player::Annonce annonce = Player::PASSE;
-
-        // Définir l'annonce en fonction du score
-        if (score >= 140) {
-            annonce = Player::CENTSOIXANTE;
-        } else if (score >= 130) {
-            annonce = Player::CENTCINQUANTE;
-        } else if (score >= 120) {
-            annonce = Player::CENTQUARANTE;
-        } else if (score >= 110) {
-            annonce = Player::CENTTRENTE;
-        } else if (score >= 100) {
-            annonce = Player::CENTVINGT;
-        } else if (score >= 90) {
-            annonce = Player::CENTDIX;
-        } else if (score >= 80) {
-            annonce = Player::CENT;
-        } else if (score >= 70) {
-            annonce = Player::QUATREVINGTDIX;
-        } else if (score >= 60) {
-            annonce = Player::QUATREVINGT;
-        }
-
-        // S'assurer que l'annonce est supérieure à l'annonce actuelle
-        if (annonce != Player::PASSE && annonce <= currentBid) {
-            // Essayer d'annoncer un cran au-dessus si le score le permet
-            if (currentBid < Player::CENTSOIXANTE && score >= 60) {
-                annonce = static_cast<Player::Annonce>(static_cast<int>(currentBid) + 1);
-                // Vérifier qu'on ne dépasse pas nos moyens
-                int requiredScore = 60 + (static_cast<int>(annonce) - 1) * 10;
-                if (score < requiredScore) {
-                    annonce = Player::PASSE;
-                }
-            } else {
-                annonce = Player::PASSE;
-            }
-        }
-
-        return annonce;
-    }
-
     void playBotBid(int roomId, int playerIndex) {
         GameRoom* room = m_gameRooms.value(roomId);
         if (!room || room->currentPlayerIndex != playerIndex) return;
@@ -817,12 +986,8 @@ private:
             return;
         }
 
-        // Arrêter le timer de timeout et invalider les anciens callbacks
-        if (room->bidTimeout) {
-            room->bidTimeout->stop();
-            room->bidTimeoutGeneration++;
-            qDebug() << "playBotBid - Timer de timeout enchères arrêté, génération:" << room->bidTimeoutGeneration;
-        }
+        // Annuler le timeout des enchères
+        cancelRoomEvent(room, room->bidTimeout);
 
         // IMPORTANT: Vérifier si une COINCHE est en cours
         if (room->coinched) {
@@ -835,59 +1000,32 @@ private:
 
         Player* player = room->players[playerIndex].get();
 
-        // Évaluer la main pour chaque couleur d'atout possible (annonce propre)
-        int bestOwnScore = 0;
-        Carte::Couleur bestOwnCouleur = Carte::COULEURINVALIDE;
+        // Simulation des 6 atouts possibles (4 couleurs, Tout Atout, Sans Atout)
+        BidEvaluator::Options options;
+        options.risque = room->botBidRisk;
+        options.entame = (room->firstPlayerIndex - playerIndex + 4) % 4;
+        options.seed = QRandomGenerator::global()->generate();
 
-        std::array<Carte::Couleur, 4> couleurs = {Carte::COEUR, Carte::TREFLE, Carte::CARREAU, Carte::PIQUE};
-
-        for (Carte::Couleur couleur : couleurs) {
-            int score = evaluateHandForSuit(player, couleur);
-            qDebug() << "Bot" << playerIndex << "- Evaluation couleur" << static_cast<int>(couleur) << ":" << score;
-            if (score > bestOwnScore) {
-                bestOwnScore = score;
-                bestOwnCouleur = couleur;
-            }
+        // Si le partenaire a annoncé une couleur, on lui suppose des atouts
+        int partnerIndex = (playerIndex + 2) % 4;
+        if (room->lastBidderIndex == partnerIndex && room->lastBidAnnonce != Player::ANNONCEINVALIDE) {
+            options.couleurPartenaire = room->lastBidCouleur;
         }
 
-        // Vérifier si le partenaire a déjà annoncé
-        int partnerIndex = (playerIndex + 2) % 4;
-        bool partnerHasBid = (room->lastBidderIndex == partnerIndex &&
-                              room->lastBidAnnonce != Player::ANNONCEINVALIDE);
-
-        int bestScore = bestOwnScore;
-        Carte::Couleur bestCouleur = bestOwnCouleur;
-
-        if (partnerHasBid) {
-            // Le partenaire a annoncé - évaluer si on peut soutenir
-            Carte::Couleur partnerCouleur = room->lastBidCouleur;
-            int supportScore = evaluateHandForPartnerSuit(player, partnerCouleur);
-
-            qDebug() << "Bot" << playerIndex << "- Partenaire a annoncé en"
-                     << static_cast<int>(partnerCouleur) << ", score soutien:" << supportScore;
-
-            // Si on a un bon soutien, calculer le score équivalent pour comparer
-            if (supportScore >= 25) {
-                int supportTotalScore = supportScore + 60; // Score équivalent pour surenchérir
-
-                // Comparer : soutenir le partenaire vs annoncer soi-même
-                if (supportTotalScore > bestOwnScore) {
-                    qDebug() << "Bot" << playerIndex << "- Préfère soutenir le partenaire ("
-                             << supportTotalScore << ") vs propre annonce (" << bestOwnScore << ")";
-                    bestScore = supportTotalScore;
-                    bestCouleur = partnerCouleur;
-                } else {
-                    qDebug() << "Bot" << playerIndex << "- Préfère sa propre annonce ("
-                             << bestOwnScore << ") vs soutien (" << supportTotalScore << ")";
-                }
-            }
+        std::array<BidEvaluator::Estimation, BidEvaluator::NB_OPTIONS> estimations =
+            BidEvaluator::evaluate(player->getMainSet(), options);
+        for (int o = 0; o < BidEvaluator::NB_OPTIONS; o++) {
+            qDebug() << "Bot" << playerIndex << "- Option" << BidEvaluator::bidSuit(static_cast<BidEvaluator::Option>(o))
+                     << ": points moyens" << estimations[o].pointsMoyens << "capot" << estimations[o].probaCapot;
         }
 
-        // Déterminer l'annonce en fonction du score
-        Player::Annonce annonce = scoreToAnnonce(bestScore, room->lastBidAnnonce);
+        BidEvaluator::Decision decision = BidEvaluator::choisirAnnonce(estimations, room->lastBidAnnonce, options.risque);
+        Player::Annonce annonce = decision.annonce;
+        int bidSuit = BidEvaluator::bidSuit(decision.option);
+        Carte::Couleur bestCouleur = BidEvaluator::couleurAtout(decision.option);
 
-        qDebug() << "GameServer - Bot joueur" << playerIndex << "meilleur score:" << bestScore
-                 << "couleur:" << static_cast<int>(bestCouleur) << "annonce:" << static_cast<int>(annonce);
+        qDebug() << "GameServer - Bot joueur" << playerIndex << "réussite estimée:" << decision.probaReussite
+                 << "couleur:" << bidSuit << "annonce:" << static_cast<int>(annonce);
 
         if (annonce == Player::PASSE) {
             // Le bot passe
@@ -939,30 +1077,18 @@ private:
             room->lastBidCouleur = bestCouleur;
             room->lastBidderIndex = playerIndex;
             room->couleurAtout = bestCouleur;
+            room->lastBidSuit = bidSuit;
 
-            // IMPORTANT: Quand un joueur annonce TA (7) ou SA (8), lastBidCouleur est COULEURINVALIDE
-            // Donc si le bot soutient son partenaire TA/SA, bestCouleur sera COULEURINVALIDE
-            if (bestCouleur == Carte::COULEURINVALIDE) {
-                // Le bot soutient une enchère TA ou SA du partenaire
-                // Conserver les flags isToutAtout/isSansAtout existants (ne rien changer)
-                // Ne pas toucher à lastBidSuit non plus (conserve 7 ou 8)
-                qDebug() << "GameServer - Bot soutient enchère TA/SA du partenaire (isToutAtout="
-                         << room->isToutAtout << ", isSansAtout=" << room->isSansAtout << ")";
-            } else {
-                // Le bot annonce une couleur normale (COEUR, TREFLE, CARREAU, PIQUE)
-                // Désactiver les modes TA/SA et mettre à jour lastBidSuit
-                room->isToutAtout = false;
-                room->isSansAtout = false;
-                room->lastBidSuit = static_cast<int>(bestCouleur);
-                qDebug() << "GameServer - Bot annonce couleur normale, désactivation TA/SA";
-            }
+            // TA (7) et SA (8) : lastBidCouleur reste COULEURINVALIDE, comme pour une annonce joueur
+            room->isToutAtout = (decision.option == BidEvaluator::OPTION_TOUT_ATOUT);
+            room->isSansAtout = (decision.option == BidEvaluator::OPTION_SANS_ATOUT);
 
             // Broadcast l'enchère à tous
             QJsonObject msg;
             msg["type"] = "bidMade";
             msg["playerIndex"] = playerIndex;
             msg["bidValue"] = static_cast<int>(annonce);
-            msg["suit"] = static_cast<int>(bestCouleur);
+            msg["suit"] = bidSuit;
             broadcastToRoom(roomId, msg);
 
             // Passer au joueur suivant
@@ -994,7 +1120,7 @@ private:
 
         // Si le prochain joueur est aussi un bot, le faire jouer
         if (room->isBot[room->currentPlayerIndex]) {
-            QTimer::singleShot(3000, this, [this, roomId]() {
+            scheduleRoomEvent(roomId, 3000, [this, roomId]() {
                 GameRoom* room = m_gameRooms.value(roomId);
                 if (room && room->gameState == "bidding") {
                     playBotBid(roomId, room->currentPlayerIndex);
@@ -1006,38 +1132,74 @@ private:
         }
     }
 
-    // Démarre le timer de timeout pour la phase d'enchères (20 secondes)
-    void startBidTimeout(int roomId, int currentBidder) {
+    enum class RoomDelay {
+        Animation,      // Rythme de la partie, suit l'horloge de la room
+        PlayerTimeout   // Temps laissé à un joueur humain, toujours en temps réel
+    };
+
+    // Planifie un événement de la room sur la roue temporelle ; l'identifiant rendu
+    // permet de l'annuler (cancelRoomEvent). Tous sont annulés avec la room.
+    TimingWheel::TimerId scheduleRoomEvent(int roomId, int delayMs, std::function<void()> callback,
+                                           RoomDelay kind = RoomDelay::Animation) {
         GameRoom* room = m_gameRooms.value(roomId);
-        if (!room || room->gameState != "bidding") return;
+        if (!room) return 0;
 
-        // Créer le timer si nécessaire
-        if (!room->bidTimeout) {
-            room->bidTimeout = new QTimer(this);
-            room->bidTimeout->setSingleShot(true);
+        if (kind == RoomDelay::Animation && room->clockSpeed != 1.0) {
+            delayMs = room->clockSpeed > 0 ? qRound(delayMs / room->clockSpeed) : 0;
         }
 
-        // Arrêter et déconnecter l'ancien timer
-        room->bidTimeout->stop();
-        disconnect(room->bidTimeout, nullptr, this, nullptr);
+        // Oublier de temps en temps les événements déjà exécutés (coût amorti constant)
+        if (room->scheduledEvents.size() >= 32) {
+            for (auto it = room->scheduledEvents.begin(); it != room->scheduledEvents.end();) {
+                it = m_timingWheel.isPending(*it) ? std::next(it) : room->scheduledEvents.erase(it);
+            }
+            room->ackableEvents.removeIf([this](const QPair<TimingWheel::TimerId, quint32> &event) {
+                return !m_timingWheel.isPending(event.first);
+            });
+        }
 
-        // Incrémenter la génération pour invalider les anciens callbacks en queue
-        room->bidTimeoutGeneration++;
-        int currentGeneration = room->bidTimeoutGeneration;
+        TimingWheel::TimerId id = m_timingWheel.schedule(m_timingClock.elapsed(), delayMs, std::move(callback));
+        room->scheduledEvents.insert(id);
+        if (kind == RoomDelay::Animation && room->animationAcks) {
+            room->ackableEvents.append(qMakePair(id, room->stateSeq));
+        }
+        if (!m_timingWheelTimer->isActive()) {
+            m_timingWheelTimer->start();
+        }
+        return id;
+    }
 
-        qDebug() << "startBidTimeout - Timer de 20s démarré pour joueur" << currentBidder << "(génération:" << currentGeneration << ")";
+    void cancelRoomEvent(GameRoom* room, TimingWheel::TimerId &id) {
+        if (id == 0) return;
+        m_timingWheel.cancel(id);
+        room->scheduledEvents.remove(id);
+        id = 0;
+    }
 
-        // Démarrer le nouveau timer
-        connect(room->bidTimeout, &QTimer::timeout, this, [this, roomId, currentBidder, currentGeneration]() {
-            GameRoom* room = m_gameRooms.value(roomId);
-            if (!room || room->gameState != "bidding") return;
+    void cancelRoomEvents(GameRoom* room) {
+        for (TimingWheel::TimerId id : std::as_const(room->scheduledEvents)) {
+            m_timingWheel.cancel(id);
+        }
+        room->scheduledEvents.clear();
+        room->ackableEvents.clear();
+    }
 
-            // Vérifier que ce timeout est toujours valide (pas un ancien signal en queue)
-            if (room->bidTimeoutGeneration != currentGeneration) {
-                qDebug() << "BID TIMEOUT - Ignoré (ancienne génération:" << currentGeneration
-                         << "actuelle:" << room->bidTimeoutGeneration << ")";
-                return;
-            }
+    // Démarre le timer de timeout pour la phase d'enchères (20 secondes)
+    void startBidTimeout(int roomId, int currentBidder) {
+        GameRoom* room = m_gameRooms.value(roomId);
+        if (!room || room->gameState != "bidding") return;
+
+        // Remplacer l'ancien timeout (annulé, il ne peut plus se déclencher)
+        cancelRoomEvent(room, room->bidTimeout);
+
+        qDebug() << "startBidTimeout - Timeout de 20s armé pour joueur" << currentBidder;
+
+        // Un peu apres 20 secondes (20 sec dans le front end mais avec 250ms de delais réseau et de traitement pour laisser une petite marge)
+        room->bidTimeout = scheduleRoomEvent(roomId, 20250, [this, roomId, currentBidder]() {
+            GameRoom* room = m_gameRooms.value(roomId);
+            if (!room) return;
+            room->bidTimeout = 0;  // Déclenché : plus rien à annuler
+            if (room->gameState != "bidding") return;
 
             // Vérifier que c'est toujours le tour de ce joueur
             if (room->currentPlayerIndex != currentBidder) {
@@ -1072,9 +1234,7 @@ private:
             } else {
                 playBotBid(roomId, currentBidder);
             }
-        });
-
-        room->bidTimeout->start(20250);  // Un peu apres 20 secondes (20 sec dans le front end mais avec 250ms de delais réseau et de traitement pour laisser une petite marge)
+        }, RoomDelay::PlayerTimeout);
     }
 
     // Vérifie si le partenaire est le joueur qui gagne actuellement le pli
@@ -1084,10 +1244,11 @@ private:
     }
 
     // Calcule la valeur totale des points dans le pli actuel
-    int calculatePliPoints(const std::vector<std::pair<int, Carte*>>& pli) {
+    int calculatePliPoints(const std::vector<std::pair<int, Carte*>>& pli,
+                           CardTables::Mode mode = CardTables::MODE_COULEUR) {
         int points = 0;
         for (const auto& pair : pli) {
-            points += pair.second->getValeurDeLaCarte();
+            points += getCardValue(pair.second, mode);
         }
         return points;
     }
@@ -1264,28 +1425,9 @@ private:
     // Choisit la meilleure carte à jouer selon la stratégie
     // Compte le nombre d'atouts restants chez les autres joueurs
     int countRemainingTrumps(GameRoom* room, Player* player) {
-        int remaining = 0;
-        Carte::Couleur atout = room->couleurAtout;
-
-        std::array<Carte::Chiffre, 8> chiffres = {Carte::SEPT, Carte::HUIT, Carte::NEUF, Carte::DIX,
-                                                   Carte::VALET, Carte::DAME, Carte::ROI, Carte::AS};
-
-        for (auto chiffre : chiffres) {
-            // Si la carte n'a pas été jouée et n'est pas dans ma main, elle est chez un autre
-            if (!room->isCardPlayed(atout, chiffre)) {
-                bool inMyHand = false;
-                for (Carte* c : player->getMain()) {
-                    if (c->getCouleur() == atout && c->getChiffre() == chiffre) {
-                        inMyHand = true;
-                        break;
-                    }
-                }
-                if (!inMyHand) {
-                    remaining++;
-                }
-            }
-        }
-        return remaining;
+        // Les atouts ni joués ni dans ma main sont chez un autre joueur
+        CardSet known = room->playedCards | player->getMainSet();
+        return (CardSet::suit(room->couleurAtout) & ~known).size();
     }
 
     // Vérifie si l'As d'une couleur a été joué
@@ -1305,20 +1447,9 @@ private:
     // Vérifie si une carte a été jouée dans les plis PRÉCÉDENTS (pas dans le pli actuel)
     // Utile pour déterminer si une carte est vraiment "maître" ou si une carte supérieure est dans le pli actuel
     bool isCardPlayedInPreviousTricks(GameRoom* room, Carte::Couleur couleur, Carte::Chiffre chiffre) {
-        // Vérifier si la carte a été jouée globalement
-        if (!room->isCardPlayed(couleur, chiffre)) {
-            return false; // Pas jouée du tout
-        }
-
-        // Vérifier si la carte est dans le pli actuel
-        for (const auto& pair : room->currentPli) {
-            Carte* carte = pair.second;
-            if (carte->getCouleur() == couleur && carte->getChiffre() == chiffre) {
-                return false; // La carte est dans le pli actuel, donc pas "morte"
-            }
-        }
-
-        return true; // La carte a été jouée dans un pli précédent
+        // Jouée globalement mais absente du pli actuel
+        CardId id = makeCardId(couleur, chiffre);
+        return room->playedCards.contains(id) && !room->currentPliCards.contains(id);
     }
 
     bool isMasterCard(GameRoom* room, Carte* carte) {
@@ -1372,18 +1503,7 @@ private:
 
     // Compte le nombre d'atouts déjà joués (tombés)
     int countPlayedTrumps(GameRoom* room) {
-        int count = 0;
-        Carte::Couleur atout = room->couleurAtout;
-
-        std::array<Carte::Chiffre, 8> chiffres = {Carte::SEPT, Carte::HUIT, Carte::NEUF, Carte::DIX,
-                                                   Carte::VALET, Carte::DAME, Carte::ROI, Carte::AS};
-
-        for (auto chiffre : chiffres) {
-            if (room->isCardPlayed(atout, chiffre)) {
-                count++;
-            }
-        }
-        return count;
+        return room->playedCards.ofSuit(room->couleurAtout).size();
     }
 
     // Stratégie pour SANS ATOUT (SA): pas d'atout, les cartes maîtres sont très importantes
@@ -1913,7 +2033,7 @@ private:
 
             // Si c'est le dernier joueur et le pli a beaucoup de points, charger
             if (room->currentPli.size() == 3) {
-                int pliPoints = calculatePliPoints(room->currentPli);
+                int pliPoints = calculatePliPoints(room->currentPli, room->trumpMode());
                 if (pliPoints >= 15) {
                     // Charger avec une carte à points (10 ou As)
                     for (int idx : playableIndices) {
@@ -1995,7 +2115,7 @@ private:
             }
         }
 
-        int pliPoints = calculatePliPoints(room->currentPli);
+        int pliPoints = calculatePliPoints(room->currentPli, room->trumpMode());
 
         // Si le pli contient des points significatifs (> 10), essayer de prendre
         if (pliPoints >= 10 || room->currentPli.size() == 3) {
@@ -2012,7 +2132,7 @@ private:
         return findLowestValueCardAvoidMasters(room, player, playableIndices);
     }
 
-    void playBotCard(int roomId, int playerIndex) {
+    void playBotCard(int roomId, int playerIndex, bool allowPimc = true) {
         qDebug() << "===== playBotCard appele pour joueur" << playerIndex << "isBot:" << (m_gameRooms.value(roomId) ? m_gameRooms.value(roomId)->isBot[playerIndex] : false);
 
         GameRoom* room = m_gameRooms.value(roomId);
@@ -2030,45 +2150,23 @@ private:
             return;
         }
 
-        // Arrêter le timer de timeout et invalider les anciens callbacks
-        if (room->turnTimeout) {
-            room->turnTimeout->stop();
-            room->turnTimeoutGeneration++;  // Invalider les anciens callbacks en queue
-            qDebug() << "playBotCard - Timer de timeout arrêté, génération:" << room->turnTimeoutGeneration;
-        }
+        // Annuler le timeout du tour
+        cancelRoomEvent(room, room->turnTimeout);
 
         Player* player = room->players[playerIndex].get();
         if (!player || player->getMain().empty()) return;
 
-        // Calculer les cartes jouables
-        Carte* carteGagnante = nullptr;
-        int idxPlayerWinning = -1;
-        if (!room->currentPli.empty()) {
-            carteGagnante = room->currentPli[0].second;
-            idxPlayerWinning = room->currentPli[0].first;
-
-            for (size_t i = 1; i < room->currentPli.size(); i++) {
-                Carte* c = room->currentPli[i].second;
-                if (*carteGagnante < *c) {
-                    carteGagnante = c;
-                    idxPlayerWinning = room->currentPli[i].first;
-                }
-            }
-        }
+        // Carte maîtresse du pli (utilisée par la stratégie)
+        std::pair<int, Carte*> gagnant = room->getPliWinner();
+        int idxPlayerWinning = gagnant.first;
+        Carte* carteGagnante = gagnant.second;
 
         // Trouver toutes les cartes jouables
+        CardSet jouables = getPlayableCards(room, playerIndex);
         std::vector<int> playableIndices;
         const auto& main = player->getMain();
         for (size_t i = 0; i < main.size(); i++) {
-            bool isPlayable = player->isCartePlayable(
-                static_cast<int>(i),
-                room->couleurDemandee,
-                room->couleurAtout,
-                carteGagnante,
-                idxPlayerWinning
-            );
-
-            if (isPlayable) {
+            if (jouables.contains(makeCardId(*main[i]))) {
                 playableIndices.push_back(static_cast<int>(i));
             }
         }
@@ -2078,10 +2176,103 @@ private:
             return;
         }
 
+        // Parties d'entraînement : fin de manche jouée par échantillonnage sur le pool de threads
+        if (allowPimc && room->pimcBots && playableIndices.size() > 1 && static_cast<int>(main.size()) <= PIMC_MAX_HAND_SIZE) {
+            if (!room->botThinking) {
+                startPimcBotCard(roomId, room, playerIndex);
+            }
+            return;
+        }
+
         // Stratégie de jeu intelligente
         int cardIndex = chooseBestCard(room, player, playerIndex, playableIndices,
                                         carteGagnante, idxPlayerWinning);
 
+        applyBotCard(roomId, playerIndex, cardIndex);
+    }
+
+    // Lance le calcul PimcBot en arrière-plan ; le coup est joué au retour dans le thread principal
+    void startPimcBotCard(int roomId, GameRoom* room, int playerIndex) {
+        PimcBot::Contexte contexte;
+        contexte.joueur = playerIndex;
+        contexte.main = room->players[playerIndex]->getMainSet();
+        for (int p = 0; p < 4; p++) {
+            contexte.nbCartes[p] = static_cast<int>(room->players[p]->getMain().size());
+            contexte.exclues[p] = room->impossibleCards[p];
+        }
+        contexte.jouees = room->playedCards & ~room->currentPliCards;
+        contexte.pliSize = static_cast<int>(room->currentPli.size());
+        for (int i = 0; i < contexte.pliSize; i++) {
+            contexte.pli[i] = makeCardId(*room->currentPli[i].second);
+        }
+        contexte.leader = room->currentPli.empty() ? playerIndex : room->currentPli[0].first;
+        contexte.couleurAtout = room->couleurAtout;
+        contexte.mode = room->trumpMode();
+
+        // Le preneur a annoncé : on lui suppose au moins 3 atouts au départ
+        int preneur = room->lastBidderIndex;
+        if (contexte.mode == CardTables::MODE_COULEUR && preneur >= 0 && preneur != playerIndex) {
+            int atoutsJoues = (room->playedByPlayer[preneur] & CardSet::suit(room->couleurAtout)).size();
+            contexte.atoutsMin[preneur] = std::max(0, PIMC_TAKER_MIN_TRUMPS - atoutsJoues);
+        }
+
+        PimcBot::Options options;
+        options.seed = QRandomGenerator::global()->generate();
+
+        room->botThinking = true;
+        int pliSize = contexte.pliSize;
+        m_botPool.start([this, roomId, playerIndex, pliSize, contexte, options]() {
+            PimcBot::Resultat resultat = PimcBot::chooseCard(contexte, options);
+            QMetaObject::invokeMethod(this, [this, roomId, playerIndex, pliSize, resultat]() {
+                finishPimcBotCard(roomId, playerIndex, pliSize, resultat);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    void finishPimcBotCard(int roomId, int playerIndex, int pliSize, const PimcBot::Resultat &resultat) {
+        GameRoom* room = m_gameRooms.value(roomId);
+        if (!room) return;
+        room->botThinking = false;
+
+        // La partie a pu avancer pendant le calcul (abandon, réhumanisation...)
+        if (room->gameState != "playing" || room->currentPlayerIndex != playerIndex
+            || !room->isBot[playerIndex] || static_cast<int>(room->currentPli.size()) != pliSize) {
+            qDebug() << "finishPimcBotCard - Coup ignoré, la partie a changé pendant le calcul";
+            return;
+        }
+
+        Player* player = room->players[playerIndex].get();
+        if (!player) return;
+
+        int cardIndex = -1;
+        if (resultat.carte != CARD_ID_INVALIDE && getPlayableCards(room, playerIndex).contains(resultat.carte)) {
+            const auto& main = player->getMain();
+            for (size_t i = 0; i < main.size(); i++) {
+                if (makeCardId(*main[i]) == resultat.carte) {
+                    cardIndex = static_cast<int>(i);
+                    break;
+                }
+            }
+        }
+
+        if (cardIndex < 0) {
+            // Aucune distribution cohérente trouvée : stratégie heuristique
+            qDebug() << "finishPimcBotCard - Pas de résultat PIMC, retour à la stratégie heuristique";
+            playBotCard(roomId, playerIndex, false);
+            return;
+        }
+
+        qDebug() << "GameServer - Bot PIMC joueur" << playerIndex << ":" << resultat.samples
+                 << "donnes, espérance" << resultat.esperance;
+        applyBotCard(roomId, playerIndex, cardIndex);
+    }
+
+    // Joue la carte choisie par un bot (belote, broadcast, fin de pli)
+    void applyBotCard(int roomId, int playerIndex, int cardIndex) {
+        GameRoom* room = m_gameRooms.value(roomId);
+        if (!room) return;
+        Player* player = room->players[playerIndex].get();
+
         qDebug() << "GameServer - Bot joueur" << playerIndex << "joue la carte a l'index" << cardIndex;
 
         Carte* cartePlayed = player->getMain()[cardIndex];
@@ -2091,11 +2282,8 @@ private:
             room->couleurDemandee = cartePlayed->getCouleur();
         }
 
-        // Ajouter au pli courant
-        room->currentPli.push_back(std::make_pair(playerIndex, cartePlayed));
-
-        // Marquer la carte comme jouée pour le tracking IA
-        room->markCardAsPlayed(cartePlayed);
+        // Ajouter au pli courant (et marque la carte comme jouée pour le tracking IA)
+        room->addCardToPli(playerIndex, cartePlayed);
 
         // Retirer la carte de la main
         player->removeCard(cardIndex);
@@ -2171,23 +2359,17 @@ private:
         qDebug() << "GameServer - Attente de 7 secondes avant d'afficher le bouton Surcoinche (animation fusée + Coinche)";
 
         // Attendre 7 secondes et demie pour permettre l'animation fusée en spirale (3s) + explosion "Coinche !" (2s)
-        QTimer::singleShot(5650, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, 5650, [this, roomId]() {
             GameRoom* room = m_gameRooms.value(roomId);
             if (!room) return;
 
             // Initialiser le temps restant à 10 secondes
             room->surcoincheTimeLeft = 10;
 
-            // Créer le timer s'il n'existe pas
-            if (!room->surcoincheTimer) {
-                room->surcoincheTimer = new QTimer(this);
-                connect(room->surcoincheTimer, &QTimer::timeout, this, [this, roomId]() {
-                    onSurcoincheTimerTick(roomId);
-                });
-            }
-
-            // Démarrer le timer (tick chaque seconde)
-            room->surcoincheTimer->start(1000);
+            // Premier tic dans une seconde (onSurcoincheTimerTick réarme le suivant)
+            cancelRoomEvent(room, room->surcoincheTimer);
+            room->surcoincheTimer = scheduleRoomEvent(roomId, 1000, [this, roomId]() { onSurcoincheTimerTick(roomId); },
+                                                      RoomDelay::PlayerTimeout);
 
             qDebug() << "GameServer - Timer de surcoinche démarré pour la room" << roomId;
 
@@ -2224,7 +2406,7 @@ private:
         if (!room) return;
 
         if (room->surcoincheTimer) {
-            room->surcoincheTimer->stop();
+            cancelRoomEvent(room, room->surcoincheTimer);
             qDebug() << "GameServer - Timer de surcoinche arrêté pour la room" << roomId;
         }
 
@@ -2235,6 +2417,7 @@ private:
         GameRoom* room = m_gameRooms.value(roomId);
         if (!room) return;
 
+        room->surcoincheTimer = 0;  // Tic en cours, le suivant est réarmé plus bas
         room->surcoincheTimeLeft--;
 
         qDebug() << "GameServer - Surcoinche timer tick, temps restant:" << room->surcoincheTimeLeft;
@@ -2290,6 +2473,9 @@ private:
 
                 sendMessage(conn->socket, msg);
             }
+
+            room->surcoincheTimer = scheduleRoomEvent(roomId, 1000, [this, roomId]() { onSurcoincheTimerTick(roomId); },
+                                                      RoomDelay::PlayerTimeout);
         }
     }
 
@@ -2297,6 +2483,9 @@ private:
 
     void notifyPlayersWithPlayableCards(int roomId);
 
+    // État complet de la partie pour un joueur (reconnexion, ou resync hors historique)
+    void sendGameSnapshot(PlayerConnection *conn, GameRoom *room, int playerIndex);
+
     QJsonArray calculatePlayableCards(GameRoom* room, int playerIndex);
 
     void handlePlayerDisconnect(const QString &connectionId);
@@ -2306,14 +2495,34 @@ private:
         if (!socket) {
             return QString();
         }
+        return m_connectionIdBySocket.value(socket);
+    }
 
-        for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
-            // Vérifier que la connexion existe et n'a pas été supprimée
-            if (it.value() && it.value()->socket == socket) {
-                return it.key();
-            }
+    // Vide si la connexion de ce socket n'est pas celle du joueur (contrôle de session)
+    QString getConnectionIdBySocket(QWebSocket *socket, const QString &playerName) {
+        QString connectionId = getConnectionIdBySocket(socket);
+        PlayerConnection *conn = m_connections.value(connectionId);
+        return conn && conn->playerName == playerName ? connectionId : QString();
+    }
+
+    // Enregistre une connexion authentifiée et l'indexe par socket
+    void addConnection(PlayerConnection *conn) {
+        m_connections[conn->connectionId] = conn;
+        m_connectionIdBySocket[conn->socket] = conn->connectionId;  // La plus récente pour ce socket
+        if (m_connections.size() > m_maxSimultaneousConnections) {
+            m_maxSimultaneousConnections = m_connections.size();
+            m_statsReporter->setMaxSimultaneous(m_maxSimultaneousConnections, m_maxSimultaneousGames);
         }
-        return QString();
+    }
+
+    // Retire la connexion des deux index et la libère
+    void removeConnection(PlayerConnection *conn) {
+        m_connections.remove(conn->connectionId);
+        auto it = m_connectionIdBySocket.find(conn->socket);
+        if (it != m_connectionIdBySocket.end() && it.value() == conn->connectionId) {
+            m_connectionIdBySocket.erase(it);
+        }
+        delete conn;
     }
 
     // ========================================
@@ -2326,8 +2535,8 @@ private:
         for (int i = 0; i < 4; i++) {
             code += chars[QRandomGenerator::global()->bounded(chars.length())];
         }
-        // Vérifier que le code n'existe pas déjà
-        if (m_privateLobbies.contains(code)) {
+        // Vérifier que le code n'existe pas déjà (ici ou sur un autre serveur)
+        if (m_privateLobbies.contains(code) || (m_broker && m_broker->isLobbyCodeTaken(code))) {
             return generateLobbyCode();  // Régénérer si collision
         }
         return code;
@@ -2470,6 +2679,7 @@ private:
         }
 
         m_gameRooms[roomId] = room;
+        room->clockSpeed = m_defaultRoomClockSpeed;
 
         // Init le premier joueur (celui qui commence les enchères)
         room->firstPlayerIndex = 0;
@@ -2489,7 +2699,7 @@ private:
         notifyGameStart(roomId, orderedIds);
 
         // Démarrer le timer après l'animation "Bonne partie!" + distribution
-        QTimer::singleShot(FIRST_GAME_BOT_DELAY_MS, this, [this, roomId]() {
+        scheduleRoomEvent(roomId, FIRST_GAME_BOT_DELAY_MS, [this, roomId]() {
             GameRoom* r = m_gameRooms.value(roomId);
             if (r && r->gameState == "bidding") startBidTimeout(roomId, r->currentPlayerIndex);
         });
@@ -2531,13 +2741,13 @@ private:
 
         // Ajouter à la queue de matchmaking du bon mode
         QString lobbyGameMode = lobby->gameMode;
-        QQueue<QString>& targetQueue = (lobbyGameMode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
+        Matchmaker<QString>& targetQueue = (lobbyGameMode == "belote") ? m_matchmakingQueueBelote : m_matchmakingQueueCoinche;
         for (const QString &connId : lobbyConnectionIds) {
-            if (!targetQueue.contains(connId)) {
-                targetQueue.enqueue(connId);
+            if (targetQueue.enqueue(connId, matchmakingRating(m_connections[connId], lobbyGameMode), m_timingClock.elapsed())) {
                 qDebug() << "Joueur du lobby ajouté à la queue [" << lobbyGameMode << "]:" << m_connections[connId]->playerName;
             }
         }
+        targetQueue.pair(lobbyConnectionIds[0], lobbyConnectionIds[1]);
 
         // Notifier les joueurs de la queue
         notifyQueueStatus(lobbyGameMode);
@@ -2553,7 +2763,52 @@ private:
         tryCreateGame();
     }
 
+    // État publié au broker : ce dont les autres serveurs ont besoin pour rediriger
+    QJsonObject brokerState() const {
+        QJsonArray joueurs;
+        for (auto it = m_playerNameToRoomId.constBegin(); it != m_playerNameToRoomId.constEnd(); ++it) {
+            joueurs.append(it.key());
+        }
+        QJsonArray lobbies;
+        for (auto it = m_privateLobbies.constBegin(); it != m_privateLobbies.constEnd(); ++it) {
+            lobbies.append(it.key());
+        }
+        QJsonObject files;
+        files["coinche"] = m_matchmakingQueueCoinche.size();
+        files["belote"] = m_matchmakingQueueBelote.size();
+
+        QJsonObject etat;
+        etat["players"] = joueurs;
+        etat["lobbies"] = lobbies;
+        etat["queues"] = files;
+        etat["rooms"] = static_cast<int>(m_gameRooms.size());
+        return etat;
+    }
+
+    // Files, lobbies ou parties ont changé : prévenir le broker sans attendre la synchro périodique
+    void brokerStateChanged() {
+        if (m_broker) m_broker->publishSoon();
+    }
+
+    // Envoie le client vers le serveur qui doit traiter sa demande (resume : action à y rejouer)
+    // false si aucun autre serveur n'est concerné ou si le client ne sait pas suivre
+    bool redirectClient(QWebSocket *socket, const QString &url, const QJsonObject &resume = QJsonObject()) {
+        if (url.isEmpty() || !m_redirectSockets.contains(socket)) return false;
+        QJsonObject msg = resume;
+        msg["type"] = "redirect";
+        msg["url"] = url;
+        sendMessage(socket, msg);
+        qInfo() << "Broker - Client redirigé vers" << url << resume.value("resume").toString();
+        return true;
+    }
+
     void sendMessage(QWebSocket *socket, const QJsonObject &message) {
+        EncodedMessage encoded(message);
+        sendEncoded(socket, encoded);
+    }
+
+    // Envoi d'un message déjà (ou bientôt) encodé : broadcastToRoom encode une seule fois
+    void sendEncoded(QWebSocket *socket, EncodedMessage &encoded) {
         // Protection contre les sockets null ou déconnectés
         if (!socket) {
             qCritical() << "SEGFAULT évité - Tentative d'envoi à socket null";
@@ -2565,8 +2820,123 @@ private:
             return;
         }
 
-        QJsonDocument doc(message);
-        socket->sendTextMessage(doc.toJson(QJsonDocument::Compact));
+        if (!acceptOutbound(socket, encoded.message)) {
+            return;
+        }
+
+        if (m_binarySockets.contains(socket)) {
+            if (m_batchSockets.contains(socket)) {
+                queueBatchedFrame(socket, encoded.binaryFrame());
+            } else {
+                socket->sendBinaryMessage(encoded.binaryFrame());
+            }
+            return;
+        }
+
+        socket->sendTextMessage(encoded.textFrame());
+    }
+
+    // Contre-pression : bytesToWrite() grossit quand le client ne lit pas assez vite
+    // (réseau mobile) ; au lieu de tout garder en mémoire, on ignore d'abord les
+    // messages secondaires, puis on coupe la connexion (le client se reconnecte et
+    // reçoit l'état complet de la partie)
+    bool acceptOutbound(QWebSocket *socket, const QJsonObject &message) {
+        auto pending = m_pendingFrames.constFind(socket);
+        qint64 enAttente = socket->bytesToWrite() + (pending != m_pendingFrames.constEnd() ? pending->bytes : 0);
+        if (enAttente < OUTBOUND_SOFT_LIMIT) {
+            return true;
+        }
+
+        if (enAttente >= OUTBOUND_HARD_LIMIT) {
+            if (!m_slowSockets.contains(socket)) {
+                m_slowSockets.insert(socket);
+                m_outboundStats.disconnected++;
+                qWarning() << "Client trop lent -" << enAttente << "octets en attente, déconnexion du socket" << socket;
+                // Différé : onDisconnected ne doit pas s'exécuter au milieu d'un broadcast
+                QMetaObject::invokeMethod(socket, [socket]() { socket->abort(); }, Qt::QueuedConnection);
+            }
+            return false;
+        }
+
+        if (isSecondaryMessage(message["type"].toString())) {
+            m_outboundStats.dropped++;
+            return false;
+        }
+        return true;
+    }
+
+    // Messages de confort (compte à rebours, réactions) : ni numérotés ni indispensables
+    static bool isSecondaryMessage(const QString &type) {
+        static const QSet<QString> secondaires = {
+            "emojiReaction", "surcoincheTimeUpdate", "surcoincheWaitingUpdate",
+            "matchmakingStatus", "matchmakingCountdown"
+        };
+        return secondaires.contains(type);
+    }
+
+    // Regroupe les trames d'un socket jusqu'à la fin de l'itération de la boucle d'événements
+    void queueBatchedFrame(QWebSocket *socket, const QByteArray &frame) {
+        PendingFrames &pending = m_pendingFrames[socket];
+        pending.socket = socket;
+        pending.frames.append(frame);
+        pending.bytes += frame.size();
+
+        if (!m_flushScheduled) {
+            m_flushScheduled = true;
+            QMetaObject::invokeMethod(this, [this]() { flushPendingFrames(); }, Qt::QueuedConnection);
+        }
+    }
+
+    void flushPendingFrames() {
+        m_flushScheduled = false;
+        QHash<QWebSocket*, PendingFrames> pendingFrames;
+        pendingFrames.swap(m_pendingFrames);
+
+        for (const PendingFrames &pending : std::as_const(pendingFrames)) {
+            if (!pending.socket || pending.socket->state() != QAbstractSocket::ConnectedState) {
+                continue;
+            }
+            if (pending.frames.size() == 1) {
+                pending.socket->sendBinaryMessage(pending.frames.first());
+            } else {
+                pending.socket->sendBinaryMessage(WireProtocol::encodeBatch(pending.frames));
+                m_outboundStats.coalesced += pending.frames.size() - 1;
+            }
+        }
+    }
+
+    void sequenceRoomMessage(GameRoom *room, QJsonObject &message) {
+        message["seq"] = static_cast<qint64>(++room->stateSeq);
+        room->stateHistory.append(message);
+        while (room->stateHistory.size() > STATE_HISTORY_SIZE) {
+            room->stateHistory.removeFirst();
+        }
+    }
+
+    // Comme broadcastToRoom, avec des champs réservés au joueur privateIndex (ex. ses cartes
+    // jouables) : un seul numéro, l'historique ne garde que la partie publique
+    void broadcastRoomState(int roomId, const QJsonObject &message, int privateIndex, const QJsonObject &privateFields) {
+        GameRoom* room = m_gameRooms.value(roomId);
+        if (!room) return;
+
+        QJsonObject publicMsg = message;
+        sequenceRoomMessage(room, publicMsg);
+        EncodedMessage encoded(publicMsg);
+
+        QJsonObject privateMsg = publicMsg;
+        for (auto it = privateFields.constBegin(); it != privateFields.constEnd(); ++it) {
+            privateMsg.insert(it.key(), it.value());
+        }
+
+        for (int i = 0; i < room->connectionIds.size(); i++) {
+            PlayerConnection *conn = m_connections.value(room->connectionIds[i]);
+            if (!conn || !conn->socket) continue;
+            if (i == privateIndex) {
+                sendMessage(conn->socket, privateMsg);
+            } else {
+                sendEncoded(conn->socket, encoded);
+            }
+        }
     }
 
     void broadcastToRoom(int roomId, const QJsonObject &message,
@@ -2576,6 +2946,15 @@ private:
         GameRoom* room = m_gameRooms[roomId];
         QString msgType = message["type"].toString();
 
+        // Message d'état reçu par toute la room : numéroté et conservé pour un resync
+        QJsonObject numerote;
+        bool sequence = excludeConnectionId.isEmpty() && !isSecondaryMessage(msgType);
+        if (sequence) {
+            numerote = message;
+            sequenceRoomMessage(room, numerote);
+        }
+        EncodedMessage encoded(sequence ? numerote : message);  // Sérialisé une fois pour les 4 joueurs
+
         // Log détaillé pour les messages de jeu importants
         bool isImportantMsg = (msgType == "gameState" || msgType == "cardPlayed" || msgType == "pliFinished");
         if (isImportantMsg) {
@@ -2599,7 +2978,7 @@ private:
 
             PlayerConnection *conn = m_connections.value(connId);
             if (conn && conn->socket) {
-                sendMessage(conn->socket, message);
+                sendEncoded(conn->socket, encoded);
                 if (isImportantMsg) {
                     qDebug() << "  Joueur" << i << ": message envoyé OK";
                 }
@@ -2613,14 +2992,29 @@ private:
 
     QWebSocketServer *m_server;
     QMap<QString, PlayerConnection*> m_connections; // connectionId → PlayerConnection
-    QQueue<QString> m_matchmakingQueueCoinche;    // File matchmaking Coinche
-    QQueue<QString> m_matchmakingQueueBelote;     // File matchmaking Belote
+    QHash<QWebSocket*, QString> m_connectionIdBySocket;  // socket → connectionId (index de m_connections)
+    Matchmaker<QString> m_matchmakingQueueCoinche;    // File matchmaking Coinche (par niveau)
+    Matchmaker<QString> m_matchmakingQueueBelote;     // File matchmaking Belote (par niveau)
+    // Cotes Glicko-2 par mode (pseudo → cote) et classements correspondants (cf. loadRatings)
+    QHash<QString, Glicko2::Rating> m_ratingsCoinche;
+    QHash<QString, Glicko2::Rating> m_ratingsBelote;
+    LeaderboardIndex<QString> m_leaderboardCoinche;
+    LeaderboardIndex<QString> m_leaderboardBelote;
+    bool m_ratingsLoaded = false;  // Parties non cotées avant la fin du chargement
+    static constexpr int LEADERBOARD_MIN_GAMES = 5;   // Parties cotées avant d'apparaître au classement
+    static constexpr int LEADERBOARD_DEFAULT_SIZE = 20;
+    static constexpr int LEADERBOARD_MAX_SIZE = 100;
+    static constexpr double BOT_RATING = 1500.0;      // Cote fixe des bots (jamais mise à jour)
+    static constexpr double BOT_RD = 100.0;
+    static constexpr int RATINGS_SAVE_ATTEMPTS = 3;   // Cotes d'une partie : relues et recalculées à chaque essai
     QMap<int, GameRoom*> m_gameRooms;
     QMap<QString, int> m_playerNameToRoomId;  // playerName → roomId pour reconnexion
     QMap<QString, PrivateLobby*> m_privateLobbies;  // code → PrivateLobby
     QMap<QString, PendingVerification*> m_pendingVerifications; // email → pending verification
     int m_nextRoomId;
-    DatabaseManager *m_dbManager;
+    DatabaseWorker m_dbWorker;  // Toutes les requêtes SQLite passent par ce thread
+    static constexpr int STATE_HISTORY_SIZE = 128;  // Messages d'état gardés par room (~ une manche)
+    static constexpr int DB_READER_THREADS = 2;  // Connexions de lecture (getStats, amis)
     QString m_smtpPassword;  // Mot de passe SMTP pour l'envoi d'emails
     StatsReporter *m_statsReporter;  // Rapports quotidiens de statistiques
 
@@ -2633,9 +3027,55 @@ private:
     QTimer *m_matchmakingTimerBelote;
     QTimer *m_countdownTimerCoinche;
     QTimer *m_countdownTimerBelote;
+    QTimer *m_matchmakingRetryTimer;  // Nouvelle tentative de tryCreateGame (fenêtres élargies)
+    static constexpr int MATCHMAKING_RETRY_MS = 1000;
+    static constexpr int TIMING_WHEEL_TICK_MS = 10;
+    TimingWheel m_timingWheel{TIMING_WHEEL_TICK_MS};
+    QTimer *m_timingWheelTimer;  // Fait avancer m_timingWheel
+    QElapsedTimer m_timingClock;
+    double m_defaultRoomClockSpeed = 1.0;  // cf. setDefaultRoomClockSpeed
+    std::unique_ptr<BrokerClient> m_broker;  // Mode multi-processus uniquement (cf. enableBroker)
+    int m_guestCounter = 0;  // Noms des invités (cf. handleRegister)
     int m_countdownSecondsCoinche;
     int m_countdownSecondsBelote;
     int m_lastQueueSize;
+
+    // Bots PIMC : calculs hors du thread réseau
+    static constexpr int PIMC_MAX_HAND_SIZE = 7;       // Au-delà, stratégie heuristique (premier pli)
+    static constexpr int PIMC_TAKER_MIN_TRUMPS = 3;    // Atouts supposés en main du preneur
+    QThreadPool m_botPool;
+
+    // Hachage des mots de passe (PBKDF2, cf. PasswordHasher) : lent par construction,
+    // donc hors du thread réseau et borné (au-delà, connexions refusées temporairement)
+    static constexpr int MAX_PENDING_PASSWORD_JOBS = 256;
+    static constexpr const char *SERVER_BUSY_MESSAGE = "Serveur très sollicité, veuillez réessayer dans quelques instants";
+    QThreadPool m_hashPool;
+    int m_pendingPasswordJobs = 0;
+
+    // Dispatch des messages clients par type
+    MessageDispatcher m_dispatcher;
+
+    // Sockets ayant négocié le protocole binaire (WireProtocol), dont ceux qui acceptent les lots
+    QSet<QWebSocket*> m_binarySockets;
+    QSet<QWebSocket*> m_batchSockets;
+    QSet<QWebSocket*> m_redirectSockets;  // Clients qui suivent "redirect" (Broker::REDIRECT_MIN_VERSION)
+
+    // File d'envoi par socket (cf. sendEncoded)
+    static constexpr qint64 OUTBOUND_SOFT_LIMIT = 64 * 1024;    // Au-delà, messages secondaires ignorés
+    static constexpr qint64 OUTBOUND_HARD_LIMIT = 1024 * 1024;  // Au-delà, client déconnecté
+    struct PendingFrames {
+        QPointer<QWebSocket> socket;
+        QList<QByteArray> frames;
+        qint64 bytes = 0;
+    };
+    QHash<QWebSocket*, PendingFrames> m_pendingFrames;  // Trames regroupées en attente de flush
+    bool m_flushScheduled = false;
+    QSet<QWebSocket*> m_slowSockets;  // Déconnexion en cours (file pleine)
+    struct OutboundStats {
+        quint64 coalesced = 0;     // Messages envoyés dans la trame d'un autre
+        quint64 dropped = 0;       // Messages secondaires ignorés (client lent)
+        quint64 disconnected = 0;  // Clients coupés (file pleine)
+    } m_outboundStats;
 };
 
 #endif // GAMESERVER_H
\ No newline at end of file
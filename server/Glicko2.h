@@ -0,0 +1,144 @@
+#ifndef GLICKO2_H
+#define GLICKO2_H
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Cote Glicko-2 (Glickman, "Example of the Glicko-2 system"), adaptée au 2 contre 2
+//
+// Chaque joueur a une cote, un écart (RD, incertitude : grand pour un nouveau joueur,
+// il diminue avec les parties) et une volatilité. En équipe, l'espérance de victoire
+// d'un joueur est celle de son équipe (moyenne des cotes) contre l'équipe adverse
+// (moyenne des cotes, RD quadratique moyen) ; la mise à jour porte ensuite sur sa
+// propre cote et son propre RD. Gagner avec un partenaire plus fort rapporte moins,
+// et un nouveau joueur bouge vite quand son partenaire confirmé bouge peu.
+namespace Glicko2 {
+
+constexpr double DEFAULT_RATING = 1500.0;
+constexpr double DEFAULT_RD = 350.0;
+constexpr double DEFAULT_VOLATILITY = 0.06;
+constexpr double MIN_RD = 30.0;       // Un joueur régulier garde un peu de mobilité
+constexpr double TAU = 0.5;           // Contrainte sur la variation de volatilité
+constexpr double SCALE = 173.7178;    // Échelle Glicko → Glicko-2
+constexpr double PI = 3.14159265358979323846;
+
+struct Rating {
+    double rating = DEFAULT_RATING;
+    double rd = DEFAULT_RD;
+    double volatility = DEFAULT_VOLATILITY;
+    int games = 0;
+};
+
+// Un résultat de la période : ownRating est la cote qui joue (le joueur seul, ou son équipe)
+struct Result {
+    double ownRating;
+    double opponentRating;
+    double opponentRd;
+    double score;  // 1 victoire, 0 défaite
+};
+
+namespace detail {
+
+inline double g(double phi) {
+    return 1.0 / std::sqrt(1.0 + 3.0 * phi * phi / (PI * PI));
+}
+
+// Étape 5 : nouvelle volatilité (algorithme d'Illinois)
+inline double volatility(double sigma, double phi, double v, double delta) {
+    const double a = std::log(sigma * sigma);
+    auto f = [&](double x) {
+        double ex = std::exp(x);
+        double d = phi * phi + v + ex;
+        return ex * (delta * delta - phi * phi - v - ex) / (2.0 * d * d) - (x - a) / (TAU * TAU);
+    };
+
+    double A = a;
+    double B;
+    if (delta * delta > phi * phi + v) {
+        B = std::log(delta * delta - phi * phi - v);
+    } else {
+        int k = 1;
+        while (f(a - k * TAU) < 0 && k < 100) k++;
+        B = a - k * TAU;
+    }
+    double fA = f(A);
+    double fB = f(B);
+    for (int i = 0; i < 100 && std::abs(B - A) > 1e-6; i++) {
+        double C = A + (A - B) * fA / (fB - fA);
+        double fC = f(C);
+        if (fC * fB <= 0) {
+            A = B;
+            fA = fB;
+        } else {
+            fA /= 2.0;
+        }
+        B = C;
+        fB = fC;
+    }
+    return std::exp(A / 2.0);
+}
+
+} // namespace detail
+
+// Nouvelle cote du joueur après une période de résultats
+inline Rating update(const Rating &player, const std::vector<Result> &results) {
+    const double phi = player.rd / SCALE;
+    Rating next = player;
+    if (results.empty()) {
+        // Pas de partie : seule l'incertitude augmente
+        next.rd = std::min(DEFAULT_RD, SCALE * std::sqrt(phi * phi + player.volatility * player.volatility));
+        return next;
+    }
+
+    double inverseV = 0.0;
+    double somme = 0.0;
+    for (const Result &result : results) {
+        double gPhi = detail::g(result.opponentRd / SCALE);
+        double expected = 1.0 / (1.0 + std::exp(-gPhi * (result.ownRating - result.opponentRating) / SCALE));
+        inverseV += gPhi * gPhi * expected * (1.0 - expected);
+        somme += gPhi * (result.score - expected);
+    }
+    const double v = 1.0 / inverseV;
+    const double delta = v * somme;
+
+    const double sigma = detail::volatility(player.volatility, phi, v, delta);
+    const double phiStar = std::sqrt(phi * phi + sigma * sigma);
+    const double phiNext = 1.0 / std::sqrt(1.0 / (phiStar * phiStar) + 1.0 / v);
+
+    next.rating = player.rating + SCALE * phiNext * phiNext * somme;
+    next.rd = std::clamp(SCALE * phiNext, MIN_RD, DEFAULT_RD);
+    next.volatility = sigma;
+    next.games = player.games + static_cast<int>(results.size());
+    return next;
+}
+
+// Partie en équipes : places 0 et 2 contre 1 et 3, avec le résultat de chaque place
+// (1 victoire, 0 défaite : un joueur parti en cours de partie perd même si son équipe
+// gagne). Rend les nouvelles cotes des 4 places
+inline std::array<Rating, 4> rateTeamGame(const std::array<Rating, 4> &seats, const std::array<double, 4> &scores) {
+    double moyenne[2] = {0.0, 0.0};
+    double rdQuadratique[2] = {0.0, 0.0};
+    for (int i = 0; i < 4; i++) {
+        moyenne[i % 2] += seats[i].rating / 2.0;
+        rdQuadratique[i % 2] += seats[i].rd * seats[i].rd / 2.0;
+    }
+
+    std::array<Rating, 4> next;
+    for (int i = 0; i < 4; i++) {
+        int equipe = i % 2;
+        int adverse = 1 - equipe;
+        next[i] = update(seats[i], {{moyenne[equipe], moyenne[adverse], std::sqrt(rdQuadratique[adverse]), scores[i]}});
+    }
+    return next;
+}
+
+inline std::array<Rating, 4> rateTeamGame(const std::array<Rating, 4> &seats, bool team1Won) {
+    const double equipe1 = team1Won ? 1.0 : 0.0;
+    return rateTeamGame(seats, {equipe1, 1.0 - equipe1, equipe1, 1.0 - equipe1});
+}
+
+} // namespace Glicko2
+
+#endif // GLICKO2_H
@@ -0,0 +1,64 @@
+#ifndef INDEXEDQUEUE_H
+#define INDEXEDQUEUE_H
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// File FIFO sans doublon avec index : contains() et remove() en O(1)
+//
+// Remplace QQueue<QString> pour les files de matchmaking, où QQueue::contains() et
+// removeAll() parcouraient toute la file à chaque entrée, sortie ou déconnexion.
+// L'ordre d'arrivée est conservé (parcours, dequeue()). Une clé déjà présente
+// n'est pas ajoutée une seconde fois.
+template<typename Key, typename Hash = std::hash<Key>>
+class IndexedQueue
+{
+public:
+    using const_iterator = typename std::list<Key>::const_iterator;
+
+    // false si la clé était déjà dans la file (sa place ne change pas)
+    bool enqueue(const Key &key) {
+        if (m_index.count(key)) return false;
+        m_ordre.push_back(key);
+        m_index.emplace(key, std::prev(m_ordre.end()));
+        return true;
+    }
+
+    // Retire et rend la clé la plus ancienne (file non vide)
+    Key dequeue() {
+        Key key = std::move(m_ordre.front());
+        m_index.erase(key);
+        m_ordre.pop_front();
+        return key;
+    }
+
+    // false si la clé n'était pas dans la file
+    bool remove(const Key &key) {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return false;
+        m_ordre.erase(it->second);
+        m_index.erase(it);
+        return true;
+    }
+
+    bool contains(const Key &key) const { return m_index.count(key) > 0; }
+
+    int size() const { return static_cast<int>(m_index.size()); }
+    bool isEmpty() const { return m_index.empty(); }
+
+    void clear() {
+        m_index.clear();
+        m_ordre.clear();
+    }
+
+    const_iterator begin() const { return m_ordre.cbegin(); }
+    const_iterator end() const { return m_ordre.cend(); }
+
+private:
+    std::list<Key> m_ordre;  // Ordre d'arrivée
+    std::unordered_map<Key, typename std::list<Key>::iterator, Hash> m_index;
+};
+
+#endif // INDEXEDQUEUE_H
@@ -0,0 +1,113 @@
+#ifndef LEADERBOARDINDEX_H
+#define LEADERBOARDINDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Classement en mémoire : top N et rang d'un joueur en O(log n)
+//
+// Un ORDER BY sur tous les comptes à chaque consultation ne tiendrait pas avec le
+// nombre de joueurs ; SQLite ne sait pas non plus compter les cotes supérieures
+// sans parcourir l'index. Ici les cotes sont arrondies à l'entier (0..MAX_SCORE) :
+// - un arbre de Fenwick compte les joueurs par score → rang en O(log MAX_SCORE)
+// - les scores occupés, du plus haut au plus bas → top N en O(log n + N)
+// Les ex aequo partagent le même rang (1, 2, 2, 4...) et sont listés par clé.
+template<typename Key, typename Hash = std::hash<Key>>
+class LeaderboardIndex
+{
+public:
+    static constexpr int MAX_SCORE = 4000;
+
+    struct Entry {
+        Key key;
+        int score;
+        int rank;
+    };
+
+    LeaderboardIndex() : m_fenwick(MAX_SCORE + 2, 0) {}
+
+    static int scoreOf(double rating) {
+        return std::clamp(static_cast<int>(std::lround(rating)), 0, MAX_SCORE);
+    }
+
+    // Ajoute le joueur ou met sa cote à jour
+    void set(const Key &key, double rating) {
+        remove(key);
+        int score = scoreOf(rating);
+        m_scores.emplace(key, score);
+        m_parScore[score].insert(key);
+        ajouter(score, 1);
+    }
+
+    // false si le joueur n'était pas classé
+    bool remove(const Key &key) {
+        auto it = m_scores.find(key);
+        if (it == m_scores.end()) return false;
+        int score = it->second;
+        auto groupe = m_parScore.find(score);
+        groupe->second.erase(key);
+        if (groupe->second.empty()) m_parScore.erase(groupe);
+        ajouter(score, -1);
+        m_scores.erase(it);
+        return true;
+    }
+
+    // Rang à partir de 1, 0 si le joueur n'est pas classé
+    int rank(const Key &key) const {
+        auto it = m_scores.find(key);
+        if (it == m_scores.end()) return 0;
+        return 1 + size() - compterJusqua(it->second);
+    }
+
+    int score(const Key &key) const {
+        auto it = m_scores.find(key);
+        return it == m_scores.end() ? -1 : it->second;
+    }
+
+    // Les n premiers, du meilleur au moins bon
+    std::vector<Entry> top(int n) const {
+        std::vector<Entry> resultat;
+        int rang = 1;
+        for (auto groupe = m_parScore.rbegin(); groupe != m_parScore.rend() && static_cast<int>(resultat.size()) < n; ++groupe) {
+            for (const Key &key : groupe->second) {
+                if (static_cast<int>(resultat.size()) >= n) break;
+                resultat.push_back({key, groupe->first, rang});
+            }
+            rang += static_cast<int>(groupe->second.size());
+        }
+        return resultat;
+    }
+
+    bool contains(const Key &key) const { return m_scores.count(key) > 0; }
+    int size() const { return static_cast<int>(m_scores.size()); }
+
+    void clear() {
+        m_scores.clear();
+        m_parScore.clear();
+        std::fill(m_fenwick.begin(), m_fenwick.end(), 0);
+    }
+
+private:
+    void ajouter(int score, int delta) {
+        for (int i = score + 1; i < static_cast<int>(m_fenwick.size()); i += i & -i) m_fenwick[i] += delta;
+    }
+
+    // Joueurs de score <= score
+    int compterJusqua(int score) const {
+        int total = 0;
+        for (int i = score + 1; i > 0; i -= i & -i) total += m_fenwick[i];
+        return total;
+    }
+
+    std::unordered_map<Key, int, Hash> m_scores;  // clé → score
+    std::map<int, std::set<Key>> m_parScore;      // scores occupés
+    std::vector<int> m_fenwick;
+};
+
+#endif // LEADERBOARDINDEX_H
@@ -0,0 +1,350 @@
+#ifndef MATCHMAKER_H
+#define MATCHMAKER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "IndexedQueue.h"
+
+// File de matchmaking par niveau : forme des tables de 4 joueurs de niveaux proches
+//
+// Remplace le FIFO de tryCreateGame (les 4 premiers arrivés), qui donnait aux heures
+// pleines des parties déséquilibrées, souvent abandonnées avant la fin.
+//
+// - Chaque joueur a une cote (échelle Elo) et une fenêtre de tolérance qui s'élargit
+//   avec l'attente : BASE_WINDOW points, + WIDEN_PER_SECOND par seconde, sans limite
+//   après UNBOUNDED_AFTER_MS (personne n'attend indéfiniment une table parfaite)
+// - Une table est acceptable si l'écart de cote entre ses 4 joueurs tient dans la
+//   fenêtre du plus ancien ; on garde la meilleure note : écart + déséquilibre entre
+//   les équipes, moins un bonus par seconde d'attente et par paire de lobby
+// - Les partenaires de lobby (pair()) sont pris ensemble, dans la même équipe
+//
+// Les joueurs sont indexés par cote : enqueue(), remove() et setRating() sont en
+// O(log n). takeTable() ne regarde que les NEIGHBOURS voisins de cote de quelques
+// joueurs (nouveaux arrivés, puis les plus anciens dont la fenêtre a grandi), donc
+// une tentative coûte O(log n) quelle que soit la taille de la file.
+//
+// Parcours et dequeue() suivent l'ordre d'arrivée, comme IndexedQueue.
+template<typename Key, typename Hash = std::hash<Key>>
+class Matchmaker
+{
+public:
+    static constexpr double DEFAULT_RATING = 1500.0;
+    static constexpr double BASE_WINDOW = 100.0;
+    static constexpr double WIDEN_PER_SECOND = 20.0;
+    static constexpr std::int64_t UNBOUNDED_AFTER_MS = 30000;
+    static constexpr double WAIT_BONUS_PER_SECOND = 2.0;
+    static constexpr double PAIR_BONUS = 50.0;
+    static constexpr int NEIGHBOURS = 6;        // Voisins de cote examinés de chaque côté
+    static constexpr int OLDEST_ANCHORS = 4;    // Plus anciens réexaminés à chaque tentative
+
+    using const_iterator = typename IndexedQueue<Key, Hash>::const_iterator;
+
+    // Cote estimée d'après le bilan, faute de mieux : ratio de victoires lissé
+    // vers 50 % (peu de parties = peu d'information), converti en écart Elo
+    static double ratingFromRecord(int played, int won) {
+        double p = (won + 5.0) / (played + 10.0);
+        p = std::clamp(p, 0.05, 0.95);
+        return DEFAULT_RATING + 400.0 * std::log10(p / (1.0 - p));
+    }
+
+    // Écart de cote toléré après waitedMs d'attente
+    static double window(std::int64_t waitedMs) {
+        if (waitedMs >= UNBOUNDED_AFTER_MS) return std::numeric_limits<double>::infinity();
+        return BASE_WINDOW + WIDEN_PER_SECOND * std::max<std::int64_t>(0, waitedMs) / 1000.0;
+    }
+
+    // false si la clé était déjà dans la file (sa place et sa cote ne changent pas)
+    bool enqueue(const Key &key, double rating, std::int64_t nowMs) {
+        if (!m_ordre.enqueue(key)) return false;
+        Entry &entry = m_entries[key];
+        entry.since = nowMs;
+        entry.index = m_parCote.emplace(std::make_pair(rating, m_nextSeq++), key).first;
+        m_nouveaux.push_back(key);
+        return true;
+    }
+
+    // Les deux joueurs (déjà dans la file) seront placés ensemble, dans la même équipe
+    bool pair(const Key &a, const Key &b) {
+        auto itA = m_entries.find(a);
+        auto itB = m_entries.find(b);
+        if (itA == m_entries.end() || itB == m_entries.end() || a == b) return false;
+        itA->second.partner = b;
+        itA->second.hasPartner = true;
+        itB->second.partner = a;
+        itB->second.hasPartner = true;
+        return true;
+    }
+
+    // Nouvelle cote (chargée après l'entrée en file) : le joueur est réexaminé
+    void setRating(const Key &key, double rating) {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) return;
+        m_parCote.erase(it->second.index);
+        it->second.index = m_parCote.emplace(std::make_pair(rating, m_nextSeq++), key).first;
+        m_nouveaux.push_back(key);
+    }
+
+    // false si la clé n'était pas dans la file ; un partenaire restant redevient seul
+    bool remove(const Key &key) {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) return false;
+        if (it->second.hasPartner) {
+            auto partner = m_entries.find(it->second.partner);
+            if (partner != m_entries.end()) partner->second.hasPartner = false;
+        }
+        m_parCote.erase(it->second.index);
+        m_entries.erase(it);
+        m_ordre.remove(key);
+        return true;
+    }
+
+    // Retire et rend la clé la plus ancienne (file non vide)
+    Key dequeue() {
+        Key key = *m_ordre.begin();
+        remove(key);
+        return key;
+    }
+
+    // Forme la meilleure table disponible et la retire de la file.
+    // Rend les 4 clés dans l'ordre des places (0 et 2 contre 1 et 3), vide si aucune
+    // table n'est acceptable pour l'instant (réessayer plus tard : les fenêtres grandissent)
+    std::vector<Key> takeTable(std::int64_t nowMs) {
+        if (size() < 4) {
+            m_nouveaux.clear();  // Le prochain arrivé aura tous les autres pour voisins
+            return {};
+        }
+
+        // D'abord autour des nouveaux arrivés...
+        while (!m_nouveaux.empty()) {
+            Key anchor = m_nouveaux.front();
+            m_nouveaux.pop_front();
+            if (!contains(anchor)) continue;
+            std::vector<Key> table = tableAround(anchor, nowMs);
+            if (!table.empty()) return take(table);
+        }
+
+        // ...puis autour des plus anciens, dont la fenêtre s'est élargie
+        std::vector<Key> anciens;
+        for (auto it = m_ordre.begin(); it != m_ordre.end() && static_cast<int>(anciens.size()) < OLDEST_ANCHORS; ++it) {
+            anciens.push_back(*it);
+        }
+        for (const Key &anchor : anciens) {
+            std::vector<Key> table = tableAround(anchor, nowMs);
+            if (!table.empty()) return take(table);
+        }
+        return {};
+    }
+
+    // Joueurs à compléter avec des bots : le plus ancien (avec son partenaire) et, dans
+    // l'ordre d'arrivée, ceux dont la cote tient dans sa fenêtre, au plus maxPlayers.
+    // Rend les clés retirées de la file ; les autres y restent pour une autre table
+    std::vector<Key> takeGroup(std::int64_t nowMs, int maxPlayers = 3) {
+        if (isEmpty()) return {};
+        const Key &plusAncien = *m_ordre.begin();
+        const double fenetre = window(nowMs - m_entries.at(plusAncien).since);
+
+        std::vector<Key> groupe;
+        double coteMin = std::numeric_limits<double>::infinity();
+        double coteMax = -std::numeric_limits<double>::infinity();
+        for (const Key &key : m_ordre) {
+            if (std::find(groupe.begin(), groupe.end(), key) != groupe.end()) continue;
+            const Unit unit = unitOf(key);
+            if (static_cast<int>(groupe.size()) + unit.size > maxPlayers) continue;
+            double min = coteMin;
+            double max = coteMax;
+            for (int i = 0; i < unit.size; i++) {
+                min = std::min(min, rating(unit.members[i]));
+                max = std::max(max, rating(unit.members[i]));
+            }
+            // Le plus ancien est toujours pris, avec son partenaire quel que soit leur écart
+            if (!groupe.empty() && max - min > fenetre) continue;
+            coteMin = min;
+            coteMax = max;
+            for (int i = 0; i < unit.size; i++) groupe.push_back(unit.members[i]);
+        }
+        return take(groupe);
+    }
+
+    double rating(const Key &key) const {
+        auto it = m_entries.find(key);
+        return it == m_entries.end() ? DEFAULT_RATING : it->second.index->first.first;
+    }
+
+    bool contains(const Key &key) const { return m_entries.count(key) > 0; }
+
+    int size() const { return m_ordre.size(); }
+    bool isEmpty() const { return m_ordre.isEmpty(); }
+
+    void clear() {
+        m_ordre.clear();
+        m_entries.clear();
+        m_parCote.clear();
+        m_nouveaux.clear();
+    }
+
+    const_iterator begin() const { return m_ordre.begin(); }
+    const_iterator end() const { return m_ordre.end(); }
+
+private:
+    using Index = std::map<std::pair<double, std::uint64_t>, Key>;  // (cote, n° d'entrée) → clé
+
+    struct Entry {
+        std::int64_t since = 0;
+        typename Index::iterator index;
+        Key partner{};
+        bool hasPartner = false;
+    };
+
+    // Joueur seul ou paire de lobby : pris en entier ou pas du tout
+    struct Unit {
+        Key members[2];
+        int size = 1;
+    };
+
+    Unit unitOf(const Key &key) const {
+        Unit unit;
+        unit.members[0] = key;
+        const Entry &entry = m_entries.at(key);
+        if (entry.hasPartner && contains(entry.partner)) {
+            unit.members[1] = entry.partner;
+            unit.size = 2;
+        }
+        return unit;
+    }
+
+    static bool inUnit(const Unit &unit, const Key &key) {
+        for (int i = 0; i < unit.size; i++) {
+            if (unit.members[i] == key) return true;
+        }
+        return false;
+    }
+
+    // Meilleure table contenant anchor, parmi ses voisins de cote
+    std::vector<Key> tableAround(const Key &anchor, std::int64_t nowMs) const {
+        const Unit anchorUnit = unitOf(anchor);
+
+        // Voisins de part et d'autre dans l'index, regroupés par unité
+        std::vector<Unit> candidats;
+        auto ajouter = [&](const Key &key) {
+            if (inUnit(anchorUnit, key)) return;
+            for (const Unit &unit : candidats) {
+                if (inUnit(unit, key)) return;
+            }
+            candidats.push_back(unitOf(key));
+        };
+        const auto centre = m_entries.at(anchor).index;
+        auto gauche = centre;
+        for (int i = 0; i < NEIGHBOURS && gauche != m_parCote.begin(); i++) {
+            --gauche;
+            ajouter(gauche->second);
+        }
+        auto droite = centre;
+        for (int i = 0; i < NEIGHBOURS && ++droite != m_parCote.end(); i++) {
+            ajouter(droite->second);
+        }
+
+        std::vector<Key> meilleure;
+        double meilleureNote = std::numeric_limits<double>::infinity();
+        std::vector<Unit> choix = {anchorUnit};
+        // Combinaisons d'unités complétant exactement 4 places (au plus 3 unités à choisir)
+        std::function<void(std::size_t, int)> explorer = [&](std::size_t debut, int places) {
+            if (places == 0) {
+                std::vector<Key> table;
+                double note = 0.0;
+                if (evaluer(choix, nowMs, table, note) && note < meilleureNote) {
+                    meilleureNote = note;
+                    meilleure = table;
+                }
+                return;
+            }
+            for (std::size_t i = debut; i < candidats.size(); i++) {
+                if (candidats[i].size > places) continue;
+                choix.push_back(candidats[i]);
+                explorer(i + 1, places - candidats[i].size);
+                choix.pop_back();
+            }
+        };
+        explorer(0, 4 - anchorUnit.size);
+        return meilleure;
+    }
+
+    // Note d'une table (plus basse = meilleure), false si elle n'est pas acceptable.
+    // table reçoit les joueurs dans l'ordre des places
+    bool evaluer(const std::vector<Unit> &units, std::int64_t nowMs, std::vector<Key> &table, double &note) const {
+        Key joueurs[4];
+        double cotes[4];
+        int paireDe[4];  // Indice du partenaire dans joueurs[], -1 si seul
+        int n = 0;
+        int paires = 0;
+        std::int64_t plusAncien = nowMs;
+        double attente = 0.0;
+        for (const Unit &unit : units) {
+            if (unit.size == 2) paires++;
+            for (int i = 0; i < unit.size; i++) {
+                const Key &key = unit.members[i];
+                const Entry &entry = m_entries.at(key);
+                joueurs[n] = key;
+                cotes[n] = entry.index->first.first;
+                paireDe[n] = unit.size == 2 ? (i == 0 ? n + 1 : n - 1) : -1;
+                plusAncien = std::min(plusAncien, entry.since);
+                attente += (nowMs - entry.since) / 1000.0;
+                n++;
+            }
+        }
+
+        const double ecart = *std::max_element(cotes, cotes + 4) - *std::min_element(cotes, cotes + 4);
+        if (ecart > window(nowMs - plusAncien)) return false;
+
+        // Équipes : le joueur 0 avec 1, 2 ou 3 ; les paires de lobby restent ensemble
+        int meilleurCoequipier = -1;
+        double desequilibre = std::numeric_limits<double>::infinity();
+        for (int coequipier = 1; coequipier < 4; coequipier++) {
+            bool separePaire = false;
+            for (int i = 0; i < 4; i++) {
+                bool equipeI = (i == 0 || i == coequipier);
+                if (paireDe[i] >= 0 && equipeI != (paireDe[i] == 0 || paireDe[i] == coequipier)) separePaire = true;
+            }
+            if (separePaire) continue;
+            double equipeA = cotes[0] + cotes[coequipier];
+            double equipeB = 0.0;
+            for (int i = 1; i < 4; i++) {
+                if (i != coequipier) equipeB += cotes[i];
+            }
+            double diff = std::abs(equipeA - equipeB) / 2.0;
+            if (diff < desequilibre) {
+                desequilibre = diff;
+                meilleurCoequipier = coequipier;
+            }
+        }
+        if (meilleurCoequipier < 0) return false;
+
+        std::vector<int> adversaires;
+        for (int i = 1; i < 4; i++) {
+            if (i != meilleurCoequipier) adversaires.push_back(i);
+        }
+        table = {joueurs[0], joueurs[adversaires[0]], joueurs[meilleurCoequipier], joueurs[adversaires[1]]};
+        note = ecart + desequilibre - WAIT_BONUS_PER_SECOND * attente - PAIR_BONUS * paires;
+        return true;
+    }
+
+    std::vector<Key> take(const std::vector<Key> &table) {
+        for (const Key &key : table) remove(key);
+        return table;
+    }
+
+    IndexedQueue<Key, Hash> m_ordre;  // Ordre d'arrivée
+    std::unordered_map<Key, Entry, Hash> m_entries;
+    Index m_parCote;
+    std::deque<Key> m_nouveaux;  // Entrés (ou recotés) depuis la dernière tentative
+    std::uint64_t m_nextSeq = 0;
+};
+
+#endif // MATCHMAKER_H
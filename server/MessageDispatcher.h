@@ -0,0 +1,124 @@
+#ifndef MESSAGEDISPATCHER_H
+#define MESSAGEDISPATCHER_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <utility>
+
+class QWebSocket;
+
+// Table de dispatch des messages clients : type → handler
+// Une seule recherche par message (le type est haché une fois), au lieu
+// d'une chaîne de comparaisons de QString. Compte aussi les messages reçus
+// et la durée de traitement de chaque type (histogramme par puissances de 2).
+class MessageDispatcher
+{
+public:
+    using Handler = std::function<void(QWebSocket*, const QJsonObject&)>;
+
+    // Tranches de latence : < 1 µs, < 2 µs, < 4 µs, ... , >= 2^(NB_TRANCHES-2) µs
+    static constexpr int NB_TRANCHES = 24;
+
+    struct Stats {
+        quint64 count = 0;
+        quint64 totalNs = 0;
+        quint64 maxNs = 0;
+        std::array<quint64, NB_TRANCHES> histogram = {};
+
+        void record(quint64 ns) {
+            count++;
+            totalNs += ns;
+            if (ns > maxNs) maxNs = ns;
+            quint64 us = ns / 1000;
+            int tranche = 0;
+            while (us > 0 && tranche < NB_TRANCHES - 1) {
+                us >>= 1;
+                tranche++;
+            }
+            histogram[tranche]++;
+        }
+
+        // Percentile approché (borne haute de la tranche, en µs)
+        quint64 percentileUs(double p) const {
+            if (count == 0) return 0;
+            quint64 seuil = static_cast<quint64>(p * count);
+            quint64 cumul = 0;
+            for (int i = 0; i < NB_TRANCHES; i++) {
+                cumul += histogram[i];
+                if (cumul > seuil) return quint64(1) << i;
+            }
+            return quint64(1) << (NB_TRANCHES - 1);
+        }
+    };
+
+    struct Route {
+        Handler handler;
+        bool checkVersion = false;  // Message d'authentification : version client vérifiée avant
+        Stats stats;
+    };
+
+    void registerHandler(const QString &type, Handler handler, bool checkVersion = false) {
+        Route route;
+        route.handler = std::move(handler);
+        route.checkVersion = checkVersion;
+        m_routes.insert(type, std::move(route));
+    }
+
+    // nullptr si le type n'est pas enregistré
+    Route* find(const QString &type) {
+        auto it = m_routes.find(type);
+        return it != m_routes.end() ? &it.value() : nullptr;
+    }
+
+    // Exécute le handler et mesure sa durée
+    void invoke(Route &route, QWebSocket *socket, const QJsonObject &data) {
+        QElapsedTimer timer;
+        timer.start();
+        route.handler(socket, data);
+        route.stats.record(static_cast<quint64>(timer.nsecsElapsed()));
+    }
+
+    const Stats* stats(const QString &type) const {
+        auto it = m_routes.constFind(type);
+        return it != m_routes.constEnd() ? &it.value().stats : nullptr;
+    }
+
+    QStringList types() const { return m_routes.keys(); }
+
+    // Résumé des types reçus (du plus fréquent au moins fréquent)
+    void logStats() const {
+        QList<QPair<quint64, QString>> tri;
+        for (auto it = m_routes.constBegin(); it != m_routes.constEnd(); ++it) {
+            if (it.value().stats.count > 0) tri.append(qMakePair(it.value().stats.count, it.key()));
+        }
+        std::sort(tri.begin(), tri.end(), [](const QPair<quint64, QString> &a, const QPair<quint64, QString> &b) {
+            return a.first > b.first;
+        });
+        for (const auto &entree : tri) {
+            const Stats &s = m_routes.value(entree.second).stats;
+            qInfo() << "[MSG_STATS]" << entree.second << "- reçus:" << s.count
+                    << "moyenne:" << (s.totalNs / s.count / 1000) << "µs"
+                    << "p50:" << s.percentileUs(0.50) << "µs"
+                    << "p99:" << s.percentileUs(0.99) << "µs"
+                    << "max:" << (s.maxNs / 1000) << "µs";
+        }
+    }
+
+    void resetStats() {
+        for (auto it = m_routes.begin(); it != m_routes.end(); ++it) {
+            it.value().stats = Stats();
+        }
+    }
+
+private:
+    QHash<QString, Route> m_routes;
+};
+
+#endif // MESSAGEDISPATCHER_H
@@ -6,6 +6,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QMetaMethod>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QTimer>
@@ -15,6 +16,7 @@
 #include <QSslConfiguration>
 #include <QNetworkRequest>
 #include "GameModel.h"
+#include "WireProtocol.h"
 
 class NetworkManager : public QObject {
     Q_OBJECT
@@ -144,6 +146,10 @@ public:
             forfeitGame();
         });
 
+        // Entraînement : signaler la fin des animations pour que les bots n'attendent pas
+        connect(m_gameModel, &GameModel::gameInitialized, this, &NetworkManager::sendAnimationDone);
+        connect(m_gameModel, &GameModel::pliCleared, this, &NetworkManager::sendAnimationDone);
+
         // Propager le mode Belote, la retournée et le tour d'enchères AVANT initOnlineGame
         // (initOnlineGame déclenche l'animation de distribution qui lit isBeloteMode)
         m_gameModel->setIsBeloteMode(m_gameMode == "belote");
@@ -182,7 +188,7 @@ public:
     }
 
     // Version du client — incrémenter à chaque mise à jour qui casse la compatibilité serveur
-    static constexpr int CLIENT_VERSION = 8;
+    static constexpr int CLIENT_VERSION = 11;
 
     Q_INVOKABLE void registerPlayer(const QString &playerName, const QString &avatar = "avataaars1.svg") {
         QJsonObject msg;
@@ -190,6 +196,7 @@ public:
         msg["playerName"] = playerName;
         msg["avatar"] = avatar;
         msg["version"] = CLIENT_VERSION;
+        msg["binary"] = true;  // Demande le protocole binaire (WireProtocol)
         // Indiquer si on avait un GameModel actif (pour détecter les parties terminées)
         msg["wasInGame"] = (m_gameModel != nullptr);
         sendMessage(msg);
@@ -212,6 +219,7 @@ public:
         QJsonObject msg;
         msg["type"] = "joinTraining";
         msg["gameMode"] = m_gameMode;
+        msg["animationAcks"] = true;
         sendMessage(msg);
         m_isTraining = true;
         emit isTrainingChanged();
@@ -251,6 +259,7 @@ public:
         msg["password"] = password;
         msg["avatar"] = avatar;
         msg["version"] = CLIENT_VERSION;
+        msg["binary"] = true;  // Demande le protocole binaire (WireProtocol)
         if (!sendMessage(msg)) {
             emit registerFailed("Connexion au serveur perdue. Veuillez réessayer.");
         }
@@ -266,6 +275,7 @@ public:
         msg["password"] = password;
         msg["avatar"] = avatar;
         msg["version"] = CLIENT_VERSION;
+        msg["binary"] = true;  // Demande le protocole binaire (WireProtocol)
         if (!sendMessage(msg)) {
             emit verificationCodeFailed("Connexion au serveur perdue. Veuillez réessayer.");
         }
@@ -277,6 +287,7 @@ public:
         msg["email"] = email;
         msg["code"] = code;
         msg["version"] = CLIENT_VERSION;
+        msg["binary"] = true;  // Demande le protocole binaire (WireProtocol)
         if (!sendMessage(msg)) {
             emit verificationCodeFailed("Connexion au serveur perdue. Veuillez réessayer.");
         }
@@ -290,6 +301,7 @@ public:
         msg["email"] = email;
         msg["password"] = password;
         msg["version"] = CLIENT_VERSION;
+        msg["binary"] = true;  // Demande le protocole binaire (WireProtocol)
         if (!sendMessage(msg)) {
             emit loginFailed("Connexion au serveur perdue. Veuillez réessayer.");
         }
@@ -373,6 +385,15 @@ public:
         sendMessage(msg);
     }
 
+    // Réponse "leaderboard" via messageReceived (top N + rang du joueur)
+    Q_INVOKABLE void requestLeaderboard(const QString &gameMode, int limit = 20) {
+        QJsonObject msg;
+        msg["type"] = "getLeaderboard";
+        msg["gameMode"] = gameMode;
+        msg["limit"] = limit;
+        sendMessage(msg);
+    }
+
     // Friends system
     Q_INVOKABLE void sendFriendRequest(const QString &targetPseudo) {
         QJsonObject msg;
@@ -670,6 +691,9 @@ private slots:
         // qDebug() << "Connecte au serveur";
         m_connected = true;
 
+        // Nouveau socket : JSON jusqu'à ce que le serveur confirme le protocole binaire
+        m_binaryProtocol = false;
+
         // Démarrer le heartbeat pour détecter les connexions mortes
         m_lastPongReceived = QDateTime::currentMSecsSinceEpoch();
         m_heartbeatTimer->start();
@@ -721,13 +745,80 @@ private slots:
 
     void onMessageReceived(const QString &message) {
         QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
-        QJsonObject obj = doc.object();
+        handleMessage(doc.object(), message);
+    }
+
+    // Trame binaire (protocole négocié) : les messages décodés sont traités directement
+    // Une trame peut regrouper plusieurs messages (lot), traités dans l'ordre
+    void onBinaryMessageReceived(const QByteArray &message) {
+        QList<QJsonObject> messages;
+        if (!WireProtocol::decodeBatch(message, messages)) {
+            qWarning() << "Trame binaire invalide recue - taille:" << message.size();
+            return;
+        }
+        for (const QJsonObject &obj : messages) {
+            handleMessage(obj);
+        }
+    }
+
+private:
+    // texte : message reçu en JSON, vide pour une trame binaire (sérialisé seulement pour QML)
+    void handleMessage(const QJsonObject &obj, const QString &texte = QString()) {
         QString type = obj["type"].toString();
 
         // qDebug() << "NetWorkManager - Message recu:" << type;
 
+        // Messages d'état numérotés par le serveur (seq) : doublon ignoré, trou → resync.
+        // gameFound donne le point de départ (début de partie ou état complet)
+        if (obj.contains("seq")) {
+            qint64 seq = obj["seq"].toInteger();
+            if (type == "gameFound" || m_lastSeq < 0) {
+                m_lastSeq = seq;
+                m_resyncPending = false;
+            } else if (seq <= m_lastSeq) {
+                return;
+            } else if (seq > m_lastSeq + 1) {
+                // Ne pas appliquer un état qui suppose des messages manqués
+                if (!m_resyncPending) {
+                    qWarning() << "NetworkManager - Messages manquants (attendu" << m_lastSeq + 1 << "reçu" << seq << "), resync";
+                    m_resyncPending = true;
+                    QJsonObject resync;
+                    resync["type"] = "resync";
+                    resync["lastSeq"] = m_lastSeq;
+                    sendMessage(resync);
+                }
+                return;
+            } else {
+                m_lastSeq = seq;
+                m_resyncPending = false;
+            }
+        }
+
         // Émettre le message pour que QML puisse l'écouter (ex: StatsView)
-        emit messageReceived(message);
+        static const QMetaMethod signalMessage = QMetaMethod::fromSignal(&NetworkManager::messageReceived);
+        if (!texte.isEmpty()) {
+            emit messageReceived(texte);
+        } else if (isSignalConnected(signalMessage)) {
+            emit messageReceived(QString::fromUtf8(QJsonDocument(obj).toJson(QJsonDocument::Compact)));
+        }
+
+        if (type == "protocol") {
+            m_binaryProtocol = (obj["format"].toString() == "cbor");
+            return;
+        }
+
+        // Le joueur (ou sa file, son lobby) est sur un autre serveur : s'y reconnecter,
+        // puis reprendre l'action interrompue une fois réenregistré (cf. "registered")
+        if (type == "redirect") {
+            QString url = obj["url"].toString();
+            if (!url.isEmpty() && m_socket) {
+                qDebug() << "NetworkManager - Redirection vers" << url;
+                m_serverUrl = url;
+                m_pendingResume = obj;
+                m_socket->close();  // onDisconnected() rouvre sur m_serverUrl
+            }
+            return;
+        }
 
         if (type == "versionError") {
             QString msg = obj["message"].toString();
@@ -754,6 +845,20 @@ private slots:
             } else {
                 // qDebug() << "Enregistre avec ID:" << m_playerId << "Pseudo:" << m_playerPseudo;
             }
+
+            // Reprendre l'action qui a provoqué une redirection
+            QString resume = m_pendingResume["resume"].toString();
+            if (!resume.isEmpty()) {
+                QJsonObject msg;
+                msg["type"] = resume;
+                msg["redirected"] = true;
+                msg["gameMode"] = m_pendingResume["gameMode"].toString(m_gameMode);
+                if (m_pendingResume.contains("code")) {
+                    msg["code"] = m_pendingResume["code"].toString();
+                }
+                m_pendingResume = QJsonObject();
+                sendMessage(msg);
+            }
         }
         else if (type == "matchmakingStatus") {
             m_matchmakingStatus = obj["status"].toString();
@@ -775,6 +880,7 @@ private slots:
             // qDebug() << "=============== GAME FOUND ===============";
 
             bool isReconnection = obj["reconnection"].toBool(false);
+            m_animationAcks = obj["animationAcks"].toBool(false);
             m_myPosition = obj["playerPosition"].toInt();
             m_myCards = obj["myCards"].toArray();
             m_opponents = obj["opponents"].toArray();
@@ -1371,6 +1477,8 @@ private:
         connect(m_socket, &QWebSocket::disconnected, this, &NetworkManager::onDisconnected);
         connect(m_socket, &QWebSocket::textMessageReceived,
                 this, &NetworkManager::onMessageReceived);
+        connect(m_socket, &QWebSocket::binaryMessageReceived,
+                this, &NetworkManager::onBinaryMessageReceived);
 
         // Réception du pong pour le heartbeat
         connect(m_socket, &QWebSocket::pong, this, [this](quint64 elapsedTime, const QByteArray &payload) {
@@ -1450,12 +1558,26 @@ private:
         }
     }
 
+    // Animations affichées jusqu'au dernier message reçu (si le serveur l'a demandé dans gameFound)
+    void sendAnimationDone() {
+        if (!m_animationAcks) return;
+        QJsonObject msg;
+        msg["type"] = "animationDone";
+        msg["seq"] = m_lastSeq;
+        sendMessage(msg);
+    }
+
     bool sendMessage(const QJsonObject &message) {
         if (!m_connected) {
             qWarning() << "sendMessage - Non connecte au serveur, message perdu:" << message["type"].toString();
             return false;
         }
 
+        if (m_binaryProtocol) {
+            m_socket->sendBinaryMessage(WireProtocol::encode(message));
+            return true;
+        }
+
         QJsonDocument doc(message);
         m_socket->sendTextMessage(doc.toJson(QJsonDocument::Compact));
         return true;
@@ -1463,6 +1585,10 @@ private:
 
     QWebSocket *m_socket;
     bool m_connected;
+    bool m_binaryProtocol = false;  // Trames CBOR confirmées par le serveur
+    qint64 m_lastSeq = -1;          // Dernier message d'état appliqué (-1 : pas encore en partie)
+    bool m_resyncPending = false;   // resync demandé, en attente du message manquant
+    bool m_animationAcks = false;   // Le serveur attend animationDone (entraînement)
     QString m_playerId;
     QString m_matchmakingStatus;
     int m_playersInQueue;
@@ -1485,6 +1611,7 @@ private:
 
     // Reconnexion automatique
     QString m_serverUrl;
+    QJsonObject m_pendingResume;  // Action à reprendre après une redirection ("redirect")
     bool m_wasInGame;
     bool m_isTraining = false;
     QString m_gameMode = "coinche";  // "coinche" ou "belote"
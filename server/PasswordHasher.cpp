@@ -0,0 +1,128 @@
+#include "PasswordHasher.h"
+#include <QCryptographicHash>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtEndian>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+const QString PREFIXE_PBKDF2 = QStringLiteral("pbkdf2-sha256");
+
+std::atomic<int> g_iterations{PasswordHasher::DEFAULT_ITERATIONS};
+
+// Comparaison sans sortie anticipée (durée indépendante du premier octet différent)
+bool egalTempsConstant(const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size()) return false;
+    char difference = 0;
+    for (int i = 0; i < a.size(); i++) {
+        difference |= a[i] ^ b[i];
+    }
+    return difference == 0;
+}
+
+} // namespace
+
+void PasswordHasher::setIterations(int iterations)
+{
+    g_iterations.store(std::max(MIN_ITERATIONS, iterations));
+}
+
+int PasswordHasher::iterations()
+{
+    return g_iterations.load();
+}
+
+QString PasswordHasher::generateSalt()
+{
+    // Générer un salt aléatoire de 32 caractères
+    QString salt;
+    const QString chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+    for (int i = 0; i < 32; i++) {
+        salt += chars[QRandomGenerator::global()->bounded(chars.length())];
+    }
+
+    return salt;
+}
+
+QString PasswordHasher::hash(const QString &password, const QString &salt)
+{
+    return hash(password, salt, iterations());
+}
+
+QString PasswordHasher::hash(const QString &password, const QString &salt, int iterations)
+{
+    QByteArray cle = pbkdf2Sha256(password.toUtf8(), salt.toUtf8(), iterations);
+    return QString("%1$%2$%3").arg(PREFIXE_PBKDF2).arg(iterations).arg(QString::fromLatin1(cle.toHex()));
+}
+
+PasswordHasher::Verification PasswordHasher::verify(const QString &password, const QString &salt, const QString &stored)
+{
+    Verification verification;
+    if (stored.isEmpty()) {
+        return verification;
+    }
+
+    if (!stored.startsWith(PREFIXE_PBKDF2 + '$')) {
+        // Ancien format : SHA-256 simple
+        verification.ok = egalTempsConstant(legacyHash(password, salt).toLatin1(), stored.toLatin1());
+        verification.needsRehash = verification.ok;
+        return verification;
+    }
+
+    QStringList parties = stored.split('$');
+    bool nombreOk = false;
+    int iterationsStockees = parties.size() == 3 ? parties[1].toInt(&nombreOk) : 0;
+    if (!nombreOk || iterationsStockees < 1) {
+        return verification;
+    }
+
+    QByteArray attendu = QByteArray::fromHex(parties[2].toLatin1());
+    QByteArray calcule = pbkdf2Sha256(password.toUtf8(), salt.toUtf8(), iterationsStockees,
+                                      static_cast<int>(attendu.size()));
+    verification.ok = !attendu.isEmpty() && egalTempsConstant(calcule, attendu);
+    verification.needsRehash = verification.ok && iterationsStockees < iterations();
+    return verification;
+}
+
+QByteArray PasswordHasher::pbkdf2Sha256(const QByteArray &password, const QByteArray &salt, int iterations, int keyLength)
+{
+    QMessageAuthenticationCode hmac(QCryptographicHash::Sha256, password);
+    QByteArray cle;
+
+    for (quint32 bloc = 1; cle.size() < keyLength; bloc++) {
+        // U1 = HMAC(P, S || INT(bloc)), Ui = HMAC(P, Ui-1), T = U1 ^ ... ^ Uc
+        QByteArray indice(4, '\0');
+        qToBigEndian(bloc, indice.data());
+
+        hmac.reset();
+        hmac.addData(salt);
+        hmac.addData(indice);
+        QByteArray u = hmac.result();
+        QByteArray t = u;
+
+        for (int i = 1; i < iterations; i++) {
+            hmac.reset();
+            hmac.addData(u);
+            u = hmac.result();
+            for (int j = 0; j < t.size(); j++) {
+                t[j] = static_cast<char>(t[j] ^ u[j]);
+            }
+        }
+        cle.append(t);
+    }
+
+    return cle.left(keyLength);
+}
+
+QString PasswordHasher::legacyHash(const QString &password, const QString &salt)
+{
+    // Combiner le mot de passe et le salt, puis hasher avec SHA-256
+    QString combined = password + salt;
+    QByteArray hash = QCryptographicHash::hash(combined.toUtf8(), QCryptographicHash::Sha256);
+    return QString(hash.toHex());
+}
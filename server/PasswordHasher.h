@@ -0,0 +1,48 @@
+#ifndef PASSWORDHASHER_H
+#define PASSWORDHASHER_H
+
+#include <QByteArray>
+#include <QString>
+
+// Hachage des mots de passe (CPU uniquement, sans accès à la base)
+//
+// Format stocké dans users.password_hash (le salt reste dans users.salt) :
+// - "pbkdf2-sha256$<itérations>$<clé hex>" : PBKDF2-HMAC-SHA256, format courant
+// - 64 caractères hex sans préfixe : ancien SHA-256(mot de passe + salt)
+// verify() reconnaît les deux et signale les hash à recalculer (ancien format ou
+// coût inférieur au coût courant), recalculés à la connexion suivante.
+//
+// Le coût est réglable (--pbkdf2-iterations / COINCHE_PBKDF2_ITERATIONS) ;
+// coinche_dbbench --kdf mesure la durée d'un hash pour plusieurs coûts.
+// Ces calculs sont lents par construction : le serveur les exécute sur un pool dédié.
+class PasswordHasher
+{
+public:
+    static constexpr int DEFAULT_ITERATIONS = 100000;
+    static constexpr int MIN_ITERATIONS = 1000;
+
+    struct Verification {
+        bool ok = false;
+        bool needsRehash = false;  // Correct mais à recalculer au format/coût courant
+    };
+
+    // Coût utilisé pour les nouveaux hash (partagé par tous les threads)
+    static void setIterations(int iterations);
+    static int iterations();
+
+    static QString generateSalt();
+
+    // Hash au format courant
+    static QString hash(const QString &password, const QString &salt);
+    static QString hash(const QString &password, const QString &salt, int iterations);
+
+    static Verification verify(const QString &password, const QString &salt, const QString &stored);
+
+    // PBKDF2-HMAC-SHA256 (RFC 8018)
+    static QByteArray pbkdf2Sha256(const QByteArray &password, const QByteArray &salt, int iterations, int keyLength = 32);
+
+private:
+    static QString legacyHash(const QString &password, const QString &salt);
+};
+
+#endif // PASSWORDHASHER_H
@@ -4,9 +4,9 @@
 #include <cmath>
 #include <numeric>
 
-StatsReporter::StatsReporter(DatabaseManager *dbManager, const QString &smtpPassword, QObject *parent)
+StatsReporter::StatsReporter(DatabaseWorker *dbWorker, const QString &smtpPassword, QObject *parent)
     : QObject(parent)
-    , m_dbManager(dbManager)
+    , m_dbWorker(dbWorker)
     , m_smtpPassword(smtpPassword)
     , m_dailyTimer(new QTimer(this))
     , m_reportHour(0)  // Minuit par défaut
@@ -82,20 +82,34 @@ void StatsReporter::sendDailyReport()
 
     // Récupérer les stats de la journée qui vient de se terminer (hier) et de l'avant-veille
     // Le rapport est envoyé à minuit, donc "aujourd'hui" est vide
-    DatabaseManager::DailyStats today = m_dbManager->getYesterdayStats();  // Journée terminée
-    DatabaseManager::DailyStats yesterday = m_dbManager->getDailyStats(
-        QDate::currentDate().addDays(-2).toString("yyyy-MM-dd")  // Avant-veille
-    );
-
-    // Récupérer les taux de rétention
-    DatabaseManager::RetentionStats retention = m_dbManager->getRetentionStats();
+    m_dbWorker->request<ReportData>(this, [](DatabaseManager &db) {
+        ReportData data;
+        data.today = db.getYesterdayStats();  // Journée terminée
+        data.yesterday = db.getDailyStats(
+            QDate::currentDate().addDays(-2).toString("yyyy-MM-dd")  // Avant-veille
+        );
+
+        // Récupérer les taux de rétention
+        data.retention = db.getRetentionStats();
+
+        // Récupérer les tendances : une seule lecture sur 30 jours, les 7 derniers en sont extraits
+        data.trends30d = db.getTrendStats(30);
+        QString debut7d = QDateTime::currentDateTimeUtc().date().addDays(-7).toString("yyyy-MM-dd");
+        for (const DatabaseManager::DailyStats &jour : data.trends30d) {
+            if (jour.date >= debut7d) data.trends7d.append(jour);
+        }
+        return data;
+    }, [this](const ReportData &data) {
+        sendReport(data);
+    });
+}
 
-    // Récupérer les tendances (7 jours et 30 jours)
-    QList<DatabaseManager::DailyStats> trends7d = m_dbManager->getTrendStats(7);
-    QList<DatabaseManager::DailyStats> trends30d = m_dbManager->getTrendStats(30);
+void StatsReporter::sendReport(const ReportData &data)
+{
+    const DatabaseManager::DailyStats &today = data.today;
 
     // Générer le contenu HTML
-    QString htmlContent = generateReportHtml(today, yesterday, retention, trends7d, trends30d);
+    QString htmlContent = generateReportHtml(today, data.yesterday, data.retention, data.trends7d, data.trends30d);
 
     // Réinitialiser les compteurs de maximums après capture dans le rapport
     m_maxSimultaneousConnections = 0;
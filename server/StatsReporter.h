@@ -5,6 +5,7 @@
 #include <QTimer>
 #include <QString>
 #include "DatabaseManager.h"
+#include "DatabaseWorker.h"
 #include "SmtpClient.h"
 
 class StatsReporter : public QObject
@@ -12,7 +13,7 @@ class StatsReporter : public QObject
     Q_OBJECT
 
 public:
-    explicit StatsReporter(DatabaseManager *dbManager, const QString &smtpPassword, QObject *parent = nullptr);
+    explicit StatsReporter(DatabaseWorker *dbWorker, const QString &smtpPassword, QObject *parent = nullptr);
     ~StatsReporter();
 
     // Envoyer le rapport quotidien manuellement (pour test)
@@ -32,7 +33,16 @@ private slots:
     void checkAndSendReport();
 
 private:
-    DatabaseManager *m_dbManager;
+    // Données du rapport, lues en une requête sur le thread SQLite
+    struct ReportData {
+        DatabaseManager::DailyStats today;
+        DatabaseManager::DailyStats yesterday;
+        DatabaseManager::RetentionStats retention;
+        QList<DatabaseManager::DailyStats> trends7d;
+        QList<DatabaseManager::DailyStats> trends30d;
+    };
+
+    DatabaseWorker *m_dbWorker;
     QString m_smtpPassword;
     QTimer *m_dailyTimer;
     int m_reportHour;
@@ -40,6 +50,9 @@ private:
     int m_maxSimultaneousConnections = 0;
     int m_maxSimultaneousGames = 0;
 
+    // Générer et envoyer l'email une fois les données lues
+    void sendReport(const ReportData &data);
+
     // Générer le contenu HTML de l'email
     QString generateReportHtml(
         const DatabaseManager::DailyStats &today,
@@ -0,0 +1,166 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Roue temporelle hiérarchique : planification des événements des rooms (coups de
+// bots, timeouts, pli suivant) sans un QTimer par événement
+//
+// Le temps est découpé en ticks de tickMs. NIVEAUX roues de CASES cases chacune :
+// le niveau 0 couvre les CASES prochains ticks, le niveau 1 les CASES² suivants, etc.
+// Un événement lointain est rangé dans un niveau haut puis redescend (cascade)
+// quand le temps s'en approche. Avec tickMs = 10 : 640 ms, 41 s, 44 min, 46 h.
+//
+// - schedule(), cancel() et take() en O(1) ; cancel() retire l'entrée de la table, la case
+//   garde un identifiant mort qui est ignoré à son passage
+// - advance(nowMs) exécute dans l'ordre les événements échus ; un callback peut
+//   planifier ou annuler d'autres événements (y compris lui-même)
+// - Un événement n'est jamais exécuté en avance, au plus un tick en retard
+//
+// Pas de thread ni de timer système ici : le propriétaire appelle advance()
+// (GameServer : un seul QTimer pour tout le serveur).
+class TimingWheel
+{
+public:
+    using TimerId = std::uint64_t;  // 0 = aucun événement
+    using Callback = std::function<void()>;
+
+    static constexpr int BITS = 6;
+    static constexpr int CASES = 1 << BITS;
+    static constexpr int NIVEAUX = 4;
+
+    explicit TimingWheel(std::int64_t tickMs = 10, std::int64_t nowMs = 0)
+        : m_tickMs(tickMs > 0 ? tickMs : 1)
+        , m_current(static_cast<std::uint64_t>(nowMs / m_tickMs))
+    {
+    }
+
+    // Exécute callback à nowMs + delayMs (délai borné à la portée de la roue)
+    TimerId schedule(std::int64_t nowMs, std::int64_t delayMs, Callback callback) {
+        // Roue restée vide (timer système arrêté) : reprendre à l'heure actuelle
+        const std::uint64_t maintenant = static_cast<std::uint64_t>(nowMs / m_tickMs);
+        if (m_entrees.empty() && maintenant > m_current) {
+            viderCases();
+            m_current = maintenant;
+        }
+
+        std::int64_t echeanceMs = nowMs + (delayMs > 0 ? delayMs : 0);
+        // Arrondi au tick supérieur : jamais en avance
+        std::uint64_t echeance = static_cast<std::uint64_t>((echeanceMs + m_tickMs - 1) / m_tickMs);
+        if (echeance <= m_current) echeance = m_current + 1;
+        const std::uint64_t portee = (std::uint64_t(1) << (BITS * NIVEAUX)) - 1;
+        if (echeance - m_current > portee) echeance = m_current + portee;
+
+        TimerId id = ++m_nextId;
+        m_entrees.emplace(id, Entree{echeance, std::move(callback)});
+        ranger(id, echeance);
+        return id;
+    }
+
+    // false si l'événement a déjà été exécuté ou annulé
+    bool cancel(TimerId id) {
+        return id != 0 && m_entrees.erase(id) > 0;
+    }
+
+    // Retire l'événement et rend son callback, pour l'exécuter sans attendre l'échéance
+    // (callback vide si l'événement a déjà été exécuté ou annulé)
+    Callback take(TimerId id) {
+        auto it = m_entrees.find(id);
+        if (it == m_entrees.end()) return Callback();
+        Callback callback = std::move(it->second.callback);
+        m_entrees.erase(it);
+        return callback;
+    }
+
+    bool isPending(TimerId id) const {
+        return id != 0 && m_entrees.count(id) > 0;
+    }
+
+    // Exécute les événements échus jusqu'à nowMs ; renvoie leur nombre
+    int advance(std::int64_t nowMs) {
+        const std::uint64_t cible = static_cast<std::uint64_t>(nowMs / m_tickMs);
+        int executes = 0;
+        while (m_current < cible) {
+            // Roue vide : inutile de parcourir les cases une à une
+            if (m_entrees.empty()) {
+                viderCases();
+                m_current = cible;
+                break;
+            }
+            m_current++;
+            cascader();
+            executes += executerCase(m_cases[0][m_current & (CASES - 1)]);
+        }
+        return executes;
+    }
+
+    std::size_t size() const { return m_entrees.size(); }
+    bool empty() const { return m_entrees.empty(); }
+    std::int64_t tickMs() const { return m_tickMs; }
+
+private:
+    struct Entree {
+        std::uint64_t echeance;  // En ticks
+        Callback callback;
+    };
+
+    void ranger(TimerId id, std::uint64_t echeance) {
+        std::uint64_t delta = echeance - m_current;
+        int niveau = 0;
+        while (niveau < NIVEAUX - 1 && delta >= (std::uint64_t(1) << (BITS * (niveau + 1)))) {
+            niveau++;
+        }
+        m_cases[niveau][(echeance >> (BITS * niveau)) & (CASES - 1)].push_back(id);
+    }
+
+    // Quand un niveau boucle, la case courante du niveau supérieur redescend
+    void cascader() {
+        for (int niveau = 1; niveau < NIVEAUX; niveau++) {
+            if ((m_current & ((std::uint64_t(1) << (BITS * niveau)) - 1)) != 0) break;
+            std::vector<TimerId> ids;
+            ids.swap(m_cases[niveau][(m_current >> (BITS * niveau)) & (CASES - 1)]);
+            for (TimerId id : ids) {
+                auto it = m_entrees.find(id);
+                if (it != m_entrees.end()) ranger(id, it->second.echeance);
+            }
+        }
+    }
+
+    int executerCase(std::vector<TimerId> &caseCourante) {
+        std::vector<TimerId> ids;
+        ids.swap(caseCourante);
+        int executes = 0;
+        for (TimerId id : ids) {
+            auto it = m_entrees.find(id);
+            if (it == m_entrees.end()) continue;  // Annulé
+            if (it->second.echeance > m_current) {
+                ranger(id, it->second.echeance);
+                continue;
+            }
+            Callback callback = std::move(it->second.callback);
+            m_entrees.erase(it);
+            callback();
+            executes++;
+        }
+        return executes;
+    }
+
+    void viderCases() {
+        for (auto &niveau : m_cases) {
+            for (auto &caseTemps : niveau) caseTemps.clear();
+        }
+    }
+
+    std::int64_t m_tickMs;
+    std::uint64_t m_current;  // Dernier tick traité
+    TimerId m_nextId = 0;
+    std::unordered_map<TimerId, Entree> m_entrees;
+    std::array<std::array<std::vector<TimerId>, CASES>, NIVEAUX> m_cases;
+};
+
+#endif // TIMINGWHEEL_H
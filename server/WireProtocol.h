@@ -0,0 +1,286 @@
+#ifndef WIREPROTOCOL_H
+#define WIREPROTOCOL_H
+
+#include <QByteArray>
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <cmath>
+
+// Protocole binaire client ↔ serveur (CBOR), alternative aux trames texte JSON
+//
+// Les messages restent des QJsonObject des deux côtés : seul l'encodage change.
+// - Les clés connues sont remplacées par leur index dans cles() (entier sur 1 octet)
+// - La valeur de "type" est remplacée par son index dans types() quand elle est connue
+// - Une carte {"value": v, "suit": s} devient un entier étiqueté (id 5 bits, cf. CardSet)
+// Le reste (clés ou types inconnus, chaînes, tableaux) est encodé tel quel, donc
+// un message ajouté plus tard passe sans modifier les dictionnaires.
+//
+// Négociation : le client (version >= BINARY_MIN_VERSION) ajoute "binary": true à
+// ses messages d'authentification ; le serveur répond {"type": "protocol",
+// "format": "cbor"} en texte, puis n'envoie plus que des trames binaires à ce
+// socket. Les deux côtés acceptent toujours les deux formats en réception.
+//
+// Lots : un client binaire de version >= BATCH_MIN_VERSION accepte aussi une trame
+// contenant un tableau CBOR de messages (encodeBatch). Le serveur y regroupe les
+// messages destinés à un même socket pendant une itération de sa boucle d'événements.
+//
+// IMPORTANT : cles() et types() sont partagés avec les clients déjà publiés,
+// on ne peut qu'ajouter des entrées à la fin. Tout type envoyé par le serveur doit
+// figurer dans types() (vérifié par wireprotocol_test).
+namespace WireProtocol {
+
+constexpr int BINARY_MIN_VERSION = 9;
+constexpr int BATCH_MIN_VERSION = 10;
+
+// Étiquette CBOR des cartes (plage "premier arrivé" de l'IANA, non enregistrée)
+constexpr quint64 TAG_CARTE = 3084;
+
+// Bornes de Carte::Couleur (COEUR..PIQUE) et Carte::Chiffre (SEPT..AS)
+constexpr int COULEUR_MIN = 3;
+constexpr int COULEUR_MAX = 6;
+constexpr int CHIFFRE_MIN = 7;
+constexpr int CHIFFRE_MAX = 14;
+
+inline const QStringList &cles() {
+    static const QStringList liste = {
+        "type", "playerIndex", "cardIndex", "cardValue", "cardSuit",
+        "currentPlayer", "biddingPhase", "atout", "isToutAtout", "isSansAtout",
+        "playableCards", "winnerId", "scoreMancheTeam1", "scoreMancheTeam2", "bidValue",
+        "suit", "value", "playerName", "avatar", "message",
+        "error", "biddingPlayer", "lastBidderIndex", "lastBidSuit", "lastBidAnnonce",
+        "biddingWinnerId", "biddingWinnerAnnonce", "myCards", "opponents", "playerPosition",
+        "firstPlayerIndex", "timeLeft", "isCoinched", "isSurcoinched", "beloteBidRound",
+        "retournee", "gameMode", "connectionId", "roomId", "version",
+        "binary", "emojiId", "scoreTeam1", "scoreTeam2", "capotTeam",
+        "coinchedByPlayerIndex", "surcoinchedByPlayerIndex", "bidderIndex", "cardCount", "seconds",
+        "seq", "lastSeq", "animationAcks"
+    };
+    return liste;
+}
+
+inline const QStringList &types() {
+    static const QStringList liste = {
+        "gameState", "cardPlayed", "pliFinished", "bidMade", "mancheFinished",
+        "playCard", "makeBid", "sendEmoji", "belote", "rebelote",
+        "gameFound", "matchmakingStatus", "botReplacement", "surcoincheOffer", "surcoincheTimeUpdate",
+        "surcoincheWaiting", "surcoincheWaitingUpdate", "surcoincheTimeout", "gameOver", "emojiReaction",
+        "registered", "protocol", "resync", "animationDone", "redirect",
+        "avatarUpdated", "beloteBidRoundChanged", "beloteDistributionComplete", "beloteHandComplete", "changeEmailFailed",
+        "changeEmailSuccess", "changePasswordFailed", "changePasswordSuccess", "changePseudoFailed", "changePseudoSuccess",
+        "connected", "contactMessageFailed", "contactMessageSuccess", "crashReported", "deleteAccountFailed",
+        "deleteAccountSuccess", "error", "forgotPasswordFailed", "forgotPasswordSuccess", "friendRemoveFailed",
+        "friendRemoved", "friendRequestAccepted", "friendRequestFailed", "friendRequestReceived", "friendRequestRejected",
+        "friendRequestSent", "friendsList", "gameNoLongerExists", "leaderboard", "lobbyCreated",
+        "lobbyError", "lobbyGameStart", "lobbyInviteReceived", "lobbyInviteSent", "lobbyJoined",
+        "lobbyRestored", "lobbyUpdate", "loginAccountFailed", "loginAccountSuccess", "matchmakingCountdown",
+        "newManche", "newMancheAnimation", "playerForfeited", "playerReconnected", "registerAccountFailed",
+        "registerAccountSuccess", "rehumanizeSuccess", "requestEmailChangeCodeFailed", "requestEmailChangeCodeSuccess", "requestVerificationCodeFailed",
+        "requestVerificationCodeSuccess", "setAnonymousFailed", "setAnonymousSuccess", "statsData", "verifyCodeFailed",
+        "verifyEmailChangeFailed", "versionError"
+    };
+    return liste;
+}
+
+namespace detail {
+
+inline QHash<QString, int> indexer(const QStringList &liste) {
+    QHash<QString, int> table;
+    for (int i = 0; i < liste.size(); i++) table.insert(liste[i], i);
+    return table;
+}
+
+inline const QHash<QString, int> &indexCles() {
+    static const QHash<QString, int> table = indexer(cles());
+    return table;
+}
+
+inline const QHash<QString, int> &indexTypes() {
+    static const QHash<QString, int> table = indexer(types());
+    return table;
+}
+
+inline QCborValue encodeValue(const QJsonValue &valeur);
+
+inline QCborValue encodeObject(const QJsonObject &objet) {
+    // Carte : exactement {value, suit} dans les bornes du jeu
+    if (objet.size() == 2 && objet.contains("value") && objet.contains("suit")) {
+        int chiffre = objet.value("value").toInt(-1);
+        int couleur = objet.value("suit").toInt(-1);
+        if (chiffre >= CHIFFRE_MIN && chiffre <= CHIFFRE_MAX && couleur >= COULEUR_MIN && couleur <= COULEUR_MAX) {
+            qint64 id = (couleur - COULEUR_MIN) * 8 + (chiffre - CHIFFRE_MIN);
+            return QCborValue(QCborTag(TAG_CARTE), QCborValue(id));
+        }
+    }
+
+    QCborMap map;
+    for (auto it = objet.constBegin(); it != objet.constEnd(); ++it) {
+        auto indexCle = indexCles().constFind(it.key());
+        QCborValue cle = indexCle != indexCles().constEnd() ? QCborValue(qint64(indexCle.value()))
+                                                             : QCborValue(it.key());
+        auto indexType = it.key() == QLatin1String("type") ? indexTypes().constFind(it.value().toString())
+                                                            : indexTypes().constEnd();
+        if (indexType != indexTypes().constEnd()) {
+            map.insert(cle, QCborValue(qint64(indexType.value())));
+        } else {
+            map.insert(cle, encodeValue(it.value()));
+        }
+    }
+    return map;
+}
+
+inline QCborValue encodeValue(const QJsonValue &valeur) {
+    switch (valeur.type()) {
+        case QJsonValue::Object:
+            return encodeObject(valeur.toObject());
+        case QJsonValue::Array: {
+            QCborArray tableau;
+            const QJsonArray source = valeur.toArray();
+            for (const QJsonValue &element : source) tableau.append(encodeValue(element));
+            return tableau;
+        }
+        case QJsonValue::Double: {
+            // Les entiers JSON sont des doubles : on les remet en entiers CBOR (1 à 9 octets)
+            double d = valeur.toDouble();
+            if (std::trunc(d) == d && std::fabs(d) < 9007199254740992.0) {
+                return QCborValue(static_cast<qint64>(d));
+            }
+            return QCborValue(d);
+        }
+        case QJsonValue::String:
+            return QCborValue(valeur.toString());
+        case QJsonValue::Bool:
+            return QCborValue(valeur.toBool());
+        default:
+            return QCborValue(QCborValue::Null);
+    }
+}
+
+inline QJsonValue decodeValue(const QCborValue &valeur);
+
+inline QJsonObject decodeMap(const QCborMap &map) {
+    const QStringList &listeCles = cles();
+    const QStringList &listeTypes = types();
+
+    QJsonObject objet;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        QString cle;
+        if (it.key().isInteger()) {
+            qint64 index = it.key().toInteger();
+            if (index < 0 || index >= listeCles.size()) continue;  // Clé d'une version plus récente
+            cle = listeCles[static_cast<int>(index)];
+        } else {
+            cle = it.key().toString();
+        }
+
+        if (cle == QLatin1String("type") && it.value().isInteger()) {
+            qint64 index = it.value().toInteger();
+            objet.insert(cle, index >= 0 && index < listeTypes.size() ? listeTypes[static_cast<int>(index)]
+                                                                     : QString());
+        } else {
+            objet.insert(cle, decodeValue(it.value()));
+        }
+    }
+    return objet;
+}
+
+inline QJsonValue decodeValue(const QCborValue &valeur) {
+    if (valeur.isTag() && valeur.tag() == QCborTag(TAG_CARTE)) {
+        qint64 id = valeur.taggedValue().toInteger(-1);
+        if (id < 0 || id >= 32) return QJsonValue();
+        QJsonObject carte;
+        carte["value"] = static_cast<int>(CHIFFRE_MIN + id % 8);
+        carte["suit"] = static_cast<int>(COULEUR_MIN + id / 8);
+        return carte;
+    }
+    if (valeur.isMap()) return decodeMap(valeur.toMap());
+    if (valeur.isArray()) {
+        QJsonArray tableau;
+        const QCborArray source = valeur.toArray();
+        for (const QCborValue &element : source) tableau.append(decodeValue(element));
+        return tableau;
+    }
+    if (valeur.isInteger()) return QJsonValue(valeur.toInteger());
+    if (valeur.isDouble()) return QJsonValue(valeur.toDouble());
+    if (valeur.isString()) return QJsonValue(valeur.toString());
+    if (valeur.isBool()) return QJsonValue(valeur.toBool());
+    return QJsonValue();
+}
+
+} // namespace detail
+
+// Encode un message pour une trame binaire
+inline QByteArray encode(const QJsonObject &message) {
+    return detail::encodeObject(message).toCbor();
+}
+
+// Regroupe des messages déjà encodés par encode() en une trame : en-tête de tableau
+// CBOR (type majeur 4) suivi des messages tels quels, sans les réencoder
+inline QByteArray encodeBatch(const QList<QByteArray> &messages) {
+    qsizetype taille = 9;
+    for (const QByteArray &message : messages) taille += message.size();
+
+    QByteArray trame;
+    trame.reserve(taille);
+    const quint64 n = static_cast<quint64>(messages.size());
+    if (n < 24) {
+        trame.append(static_cast<char>(0x80 | n));
+    } else if (n <= 0xff) {
+        trame.append(static_cast<char>(0x98));
+        trame.append(static_cast<char>(n));
+    } else if (n <= 0xffff) {
+        trame.append(static_cast<char>(0x99));
+        trame.append(static_cast<char>(n >> 8));
+        trame.append(static_cast<char>(n));
+    } else {
+        trame.append(static_cast<char>(0x9a));
+        for (int decalage = 24; decalage >= 0; decalage -= 8) {
+            trame.append(static_cast<char>(n >> decalage));
+        }
+    }
+    for (const QByteArray &message : messages) trame.append(message);
+    return trame;
+}
+
+// Décode une trame binaire, message seul ou lot ; false si elle n'est pas valide
+inline bool decodeBatch(const QByteArray &trame, QList<QJsonObject> &messages) {
+    QCborParserError erreur;
+    QCborValue valeur = QCborValue::fromCbor(trame, &erreur);
+    if (erreur.error != QCborError::NoError) {
+        return false;
+    }
+    if (valeur.isMap()) {
+        messages.append(detail::decodeMap(valeur.toMap()));
+        return true;
+    }
+    if (!valeur.isArray()) {
+        return false;
+    }
+    const QCborArray lot = valeur.toArray();
+    for (const QCborValue &element : lot) {
+        if (!element.isMap()) return false;
+        messages.append(detail::decodeMap(element.toMap()));
+    }
+    return true;
+}
+
+// Décode une trame binaire ; false si elle n'est pas un message valide
+inline bool decode(const QByteArray &trame, QJsonObject &message) {
+    QCborParserError erreur;
+    QCborValue valeur = QCborValue::fromCbor(trame, &erreur);
+    if (erreur.error != QCborError::NoError || !valeur.isMap()) {
+        return false;
+    }
+    message = detail::decodeMap(valeur.toMap());
+    return true;
+}
+
+} // namespace WireProtocol
+
+#endif // WIREPROTOCOL_H
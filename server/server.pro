@@ -1,4 +1,4 @@
-QT += core websockets sql
+QT += core websockets sql network
 QT -= gui
 
 CONFIG += c++17 console
@@ -13,10 +13,28 @@ SOURCES += \
 # Headers
 HEADERS += \
     GameServer.h \
+    MessageDispatcher.h \
+    WireProtocol.h \
+    TimingWheel.h \
+    IndexedQueue.h \
+    Matchmaker.h \
+    Glicko2.h \
+    LeaderboardIndex.h \
+    Broker.h \
     DatabaseManager.h \
+    DatabaseWorker.h \
+    PasswordHasher.h \
     ../Player.h \
     ../Deck.h \
     ../Carte.h \
+    ../CardSet.h \
+    ../CardTables.h \
+    ../LegalMoves.h \
+    ../DoubleDummySolver.h \
+    ../PimcBot.h \
+    ../BidEvaluator.h \
+    ../PlayoutPolicy.h \
+    ../GameEngine.h \
     ../GameModel.h
 
 # Fichiers sources des classes partagées
@@ -24,8 +42,15 @@ SOURCES += \
     ../Player.cpp \
     ../Deck.cpp \
     ../Carte.cpp \
+    ../DoubleDummySolver.cpp \
+    ../PimcBot.cpp \
+    ../BidEvaluator.cpp \
+    ../PlayoutPolicy.cpp \
+    ../GameEngine.cpp \
     ../GameModel.cpp \
-    DatabaseManager.cpp
+    DatabaseManager.cpp \
+    DatabaseWorker.cpp \
+    PasswordHasher.cpp
 
 # Définir le répertoire de sortie
 DESTDIR = $$PWD
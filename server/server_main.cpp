@@ -8,6 +8,7 @@
 #include <csignal>
 #include "GameServer.h"
 #include "SmtpClient.h"
+#include "PasswordHasher.h"
 
 // Includes pour stack trace (Unix/Linux)
 #ifdef Q_OS_UNIX
@@ -292,6 +293,13 @@ int main(int argc, char *argv[]) {
     QString sslKeyPath;
     QString smtpPassword;
     quint16 serverPort = 1234;  // Port par défaut
+    int pbkdf2Iterations = 0;   // 0 = PasswordHasher::DEFAULT_ITERATIONS
+    double roomClockSpeed = -1; // -1 = temps réel (1.0), 0 = sans délai d'animation
+    // Multi-processus (cf. Broker.h) : socket Unix du broker, identifiant et URL publique de ce serveur
+    QString brokerSocket;
+    QString serverId;
+    QString publicUrl;
+    bool brokerOnly = false;    // Ce processus est le broker, sans serveur de jeu
 
     for (int i = 1; i < argc; ++i) {
         QString arg = QString::fromLocal8Bit(argv[i]);
@@ -305,6 +313,18 @@ int main(int argc, char *argv[]) {
             smtpPassword = QString::fromLocal8Bit(argv[++i]);
         } else if (arg == "--port" && i + 1 < argc) {
             serverPort = QString::fromLocal8Bit(argv[++i]).toUShort();
+        } else if (arg == "--pbkdf2-iterations" && i + 1 < argc) {
+            pbkdf2Iterations = QString::fromLocal8Bit(argv[++i]).toInt();
+        } else if (arg == "--room-clock-speed" && i + 1 < argc) {
+            roomClockSpeed = QString::fromLocal8Bit(argv[++i]).toDouble();
+        } else if (arg == "--broker" && i + 1 < argc) {
+            brokerSocket = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg == "--broker-only") {
+            brokerOnly = true;
+        } else if (arg == "--server-id" && i + 1 < argc) {
+            serverId = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg == "--public-url" && i + 1 < argc) {
+            publicUrl = QString::fromLocal8Bit(argv[++i]);
         }
     }
     if (!verboseLogging) {
@@ -326,6 +346,31 @@ int main(int argc, char *argv[]) {
     if (serverPort == 1234 && qEnvironmentVariableIsSet("COINCHE_PORT")) {
         serverPort = qEnvironmentVariable("COINCHE_PORT").toUShort();
     }
+    // Coût du hachage des mots de passe (cf. coinche_dbbench --kdf-samples pour le choisir)
+    if (pbkdf2Iterations == 0 && qEnvironmentVariableIsSet("COINCHE_PBKDF2_ITERATIONS")) {
+        pbkdf2Iterations = qEnvironmentVariable("COINCHE_PBKDF2_ITERATIONS").toInt();
+    }
+    if (pbkdf2Iterations > 0) {
+        PasswordHasher::setIterations(pbkdf2Iterations);
+    }
+    // Accélération des délais d'animation des rooms (tests de charge, simulations)
+    if (roomClockSpeed < 0 && qEnvironmentVariableIsSet("COINCHE_ROOM_CLOCK_SPEED")) {
+        roomClockSpeed = qEnvironmentVariable("COINCHE_ROOM_CLOCK_SPEED").toDouble();
+    }
+    // Plusieurs serveurs sur la même machine, coordonnés par un broker
+    if (brokerSocket.isEmpty()) {
+        brokerSocket = qEnvironmentVariable("COINCHE_BROKER");
+    }
+    if (serverId.isEmpty()) {
+        serverId = qEnvironmentVariable("COINCHE_SERVER_ID", QString("server_%1").arg(serverPort));
+    }
+    if (publicUrl.isEmpty()) {
+        publicUrl = qEnvironmentVariable("COINCHE_PUBLIC_URL",
+            QString("%1://localhost:%2").arg(sslCertPath.isEmpty() ? "ws" : "wss").arg(serverPort));
+    }
+    if (brokerOnly && brokerSocket.isEmpty()) {
+        brokerSocket = "/tmp/coinche_broker.sock";
+    }
 
     // Sauvegarder pour le crash handler
     g_smtpPassword = smtpPassword;
@@ -380,10 +425,25 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "ERREUR CRITIQUE: Impossible d'ouvrir le fichier de log: %s\n", qPrintable(logFilePath));
     }
 
-    // Créer le serveur avec ou sans SSL, et mot de passe SMTP pour les emails de contact
-    GameServer server(serverPort, nullptr, sslCertPath, sslKeyPath, smtpPassword);
+    int result;
+    if (brokerOnly) {
+        // Coordinateur seul : pas de serveur de jeu dans ce processus
+        MatchmakingBroker broker;
+        result = broker.listen(brokerSocket) ? app.exec() : 1;
+    } else {
+        // Créer le serveur avec ou sans SSL, et mot de passe SMTP pour les emails de contact
+        GameServer server(serverPort, nullptr, sslCertPath, sslKeyPath, smtpPassword);
+        if (roomClockSpeed >= 0) {
+            server.setDefaultRoomClockSpeed(roomClockSpeed);
+            qInfo() << "Vitesse d'horloge des rooms:" << roomClockSpeed;
+        }
+        if (!brokerSocket.isEmpty()) {
+            server.enableBroker(brokerSocket, serverId, publicUrl);
+            qInfo() << "Broker:" << brokerSocket << "- serveur" << serverId << publicUrl;
+        }
 
-    int result = app.exec();
+        result = app.exec();
+    }
 
     // Nettoyer à la fin
     if (logStream) {
@@ -3,8 +3,11 @@
 #include <QDir>
 #include <QFile>
 #include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QCryptographicHash>
 #include <QJsonObject>
 #include "../server/DatabaseManager.h"
+#include "../server/PasswordHasher.h"
 
 // Variable globale pour QCoreApplication (Qt SQL)
 static int auth_argc = 1;
@@ -243,6 +246,24 @@ TEST_F(AuthTest, ForgotPassword_EmailInexistant_RetourneFalse) {
     EXPECT_TRUE(tempPwd.isEmpty());
 }
 
+TEST_F(AuthTest, ForgotPassword_HashCalculeHorsBase) {
+    // Chemin du serveur : salt lu, hash calculé hors du thread SQLite, puis enregistré
+    DatabaseManager::Credentials credentials = db->getCredentials("alice@test.com");
+    ASSERT_TRUE(credentials.found);
+    QString tempPwd = DatabaseManager::generateTempPassword();
+    QString err;
+    ASSERT_TRUE(db->setTempPasswordHash("alice@test.com", PasswordHasher::hash(tempPwd, credentials.salt),
+                                        credentials.salt, err)) << qPrintable(err);
+    EXPECT_TRUE(login("alice@test.com", tempPwd));
+
+    // Mot de passe changé entre la lecture du salt et l'écriture : le hash est refusé
+    ASSERT_TRUE(db->updatePassword("alice@test.com", "DefinitifMdp1!", err));
+    QString autreTemp = DatabaseManager::generateTempPassword();
+    EXPECT_FALSE(db->setTempPasswordHash("alice@test.com", PasswordHasher::hash(autreTemp, credentials.salt),
+                                         credentials.salt, err));
+    EXPECT_FALSE(login("alice@test.com", autreTemp));
+}
+
 TEST_F(AuthTest, ForgotPassword_PlusieursAppels_DernierTempValide) {
     // Si on appelle setTempPassword deux fois, le dernier temp doit être valide
     QString temp1, temp2, err;
@@ -385,3 +406,37 @@ TEST_F(AuthTest, Login_EmailInexistant_Echec) {
 TEST_F(AuthTest, Login_Succes) {
     EXPECT_TRUE(login("alice@test.com", "Password1!"));
 }
+
+// ============================================================
+// 9. HACHAGE — migration des anciens hash SHA-256
+// ============================================================
+
+TEST_F(AuthTest, AncienHash_RecalculeALaConnexion) {
+    // Compte créé avant PBKDF2 : password_hash = SHA-256(mot de passe + salt)
+    QSqlDatabase connexion = QSqlDatabase::database("coinche_connection");
+    QSqlQuery query(connexion);
+    query.prepare("SELECT salt FROM users WHERE email = 'alice@test.com'");
+    ASSERT_TRUE(query.exec() && query.next());
+    QString salt = query.value(0).toString();
+    query.finish();
+
+    QString ancien = QString(QCryptographicHash::hash(QString("Password1!" + salt).toUtf8(),
+                                                      QCryptographicHash::Sha256).toHex());
+    QSqlQuery update(connexion);
+    update.prepare("UPDATE users SET password_hash = :hash WHERE email = 'alice@test.com'");
+    update.bindValue(":hash", ancien);
+    ASSERT_TRUE(update.exec());
+
+    EXPECT_FALSE(login("alice@test.com", "Mauvais123!"));
+    ASSERT_TRUE(login("alice@test.com", "Password1!"));
+
+    // Le hash a été remplacé au format courant, le mot de passe reste le même
+    QSqlQuery apres(connexion);
+    apres.prepare("SELECT password_hash FROM users WHERE email = 'alice@test.com'");
+    ASSERT_TRUE(apres.exec() && apres.next());
+    EXPECT_TRUE(apres.value(0).toString().startsWith("pbkdf2-sha256$"));
+    apres.finish();
+
+    EXPECT_TRUE(login("alice@test.com", "Password1!"));
+    EXPECT_FALSE(login("alice@test.com", "Mauvais123!"));
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "../BidEvaluator.h"
+
+static CardSet mainDe(std::initializer_list<std::pair<Carte::Couleur, Carte::Chiffre>> cartes) {
+    CardSet main;
+    for (const auto &carte : cartes) main.add(makeCardId(carte.first, carte.second));
+    return main;
+}
+
+TEST(BidEvaluatorTest, GrosJeuAnnonceSaCouleur) {
+    // Valet, 9, As, 10 de pique + belote + As de coeur et de carreau
+    CardSet main = mainDe({{Carte::PIQUE, Carte::VALET}, {Carte::PIQUE, Carte::NEUF}, {Carte::PIQUE, Carte::AS},
+                           {Carte::PIQUE, Carte::DIX}, {Carte::PIQUE, Carte::ROI}, {Carte::PIQUE, Carte::DAME},
+                           {Carte::COEUR, Carte::AS}, {Carte::CARREAU, Carte::AS}});
+    BidEvaluator::Options options;
+    options.seed = 1;
+    auto estimations = BidEvaluator::evaluate(main, options);
+    EXPECT_EQ(estimations[BidEvaluator::OPTION_PIQUE].belote, 20);
+    EXPECT_GT(estimations[BidEvaluator::OPTION_PIQUE].pointsMoyens, estimations[BidEvaluator::OPTION_COEUR].pointsMoyens);
+
+    BidEvaluator::Decision decision = BidEvaluator::choisirAnnonce(estimations, Player::ANNONCEINVALIDE, options.risque);
+    EXPECT_EQ(decision.option, BidEvaluator::OPTION_PIQUE);
+    EXPECT_GE(decision.annonce, Player::CENTVINGT);
+    EXPECT_NE(decision.annonce, Player::PASSE);
+}
+
+TEST(BidEvaluatorTest, PetitJeuPasse) {
+    CardSet main = mainDe({{Carte::PIQUE, Carte::SEPT}, {Carte::PIQUE, Carte::HUIT}, {Carte::COEUR, Carte::SEPT},
+                           {Carte::COEUR, Carte::HUIT}, {Carte::TREFLE, Carte::SEPT}, {Carte::TREFLE, Carte::DAME},
+                           {Carte::CARREAU, Carte::SEPT}, {Carte::CARREAU, Carte::HUIT}});
+    BidEvaluator::Options options;
+    options.seed = 2;
+    auto estimations = BidEvaluator::evaluate(main, options);
+    EXPECT_EQ(BidEvaluator::choisirAnnonce(estimations, Player::ANNONCEINVALIDE, options.risque).annonce, Player::PASSE);
+}
+
+TEST(BidEvaluatorTest, AnnonceSuperieureEtRisque) {
+    BidEvaluator::Estimation estimation;
+    for (int p = 0; p < BidEvaluator::NB_PALIERS; p++) {
+        estimation.probaContrat[p] = 1.0 - 0.1 * p;  // 80 sûr, 160 à 20 %
+    }
+    std::array<BidEvaluator::Estimation, BidEvaluator::NB_OPTIONS> estimations;
+    estimations[BidEvaluator::OPTION_CARREAU] = estimation;
+
+    // Prudent : 90 % de réussite exigés -> 90
+    EXPECT_EQ(BidEvaluator::choisirAnnonce(estimations, Player::ANNONCEINVALIDE, 0.1).annonce, Player::QUATREVINGTDIX);
+    // Plus de risque : 50 % -> 130
+    BidEvaluator::Decision decision = BidEvaluator::choisirAnnonce(estimations, Player::ANNONCEINVALIDE, 0.5);
+    EXPECT_EQ(decision.annonce, Player::CENTTRENTE);
+    EXPECT_EQ(decision.option, BidEvaluator::OPTION_CARREAU);
+    // Toujours au-dessus de l'enchère en cours
+    EXPECT_EQ(BidEvaluator::choisirAnnonce(estimations, Player::CENTTRENTE, 0.5).annonce, Player::PASSE);
+    EXPECT_EQ(BidEvaluator::choisirAnnonce(estimations, Player::CENT, 0.1).annonce, Player::PASSE);
+}
+
+TEST(BidEvaluatorTest, SixAtoutsReproductibles) {
+    // Le temps d'évaluation se mesure avec coinche_selfplay --bid-bench
+    CardSet main = mainDe({{Carte::COEUR, Carte::VALET}, {Carte::COEUR, Carte::NEUF}, {Carte::TREFLE, Carte::AS},
+                           {Carte::TREFLE, Carte::DIX}, {Carte::CARREAU, Carte::ROI}, {Carte::CARREAU, Carte::DAME},
+                           {Carte::PIQUE, Carte::AS}, {Carte::PIQUE, Carte::SEPT}});
+    BidEvaluator::Options options;
+    options.seed = 7;
+    auto estimations = BidEvaluator::evaluate(main, options);
+
+    // Même graine, mêmes donnes simulées : résultat reproductible
+    auto deuxieme = BidEvaluator::evaluate(main, options);
+    for (int o = 0; o < BidEvaluator::NB_OPTIONS; o++) {
+        EXPECT_DOUBLE_EQ(estimations[o].pointsMoyens, deuxieme[o].pointsMoyens);
+        EXPECT_EQ(estimations[o].probaContrat, deuxieme[o].probaContrat);
+    }
+
+    for (const auto &estimation : estimations) {
+        EXPECT_GE(estimation.pointsMoyens, 0.0);
+        EXPECT_LE(estimation.pointsMoyens, 162.0);
+        EXPECT_GE(estimation.probaContrat[0], estimation.probaContrat[BidEvaluator::NB_PALIERS - 1]);
+    }
+}
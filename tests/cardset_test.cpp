@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "../CardSet.h"
+#include "../Deck.h"
+#include "../Player.h"
+
+// ========================================
+// Tests de l'encodage CardId
+// ========================================
+
+TEST(CardSetTest, CardIdAllerRetour) {
+    // Chaque couleur x chiffre donne un identifiant unique dans [0, 31]
+    CardSet vus;
+    for (int co = Carte::COEUR; co <= Carte::PIQUE; co++) {
+        for (int ch = Carte::SEPT; ch <= Carte::AS; ch++) {
+            CardId id = makeCardId(static_cast<Carte::Couleur>(co), static_cast<Carte::Chiffre>(ch));
+            EXPECT_LT(id, NB_CARTES);
+            EXPECT_FALSE(vus.contains(id)) << "Identifiant en double: " << int(id);
+            vus.add(id);
+            EXPECT_EQ(couleurOf(id), co);
+            EXPECT_EQ(chiffreOf(id), ch);
+        }
+    }
+    EXPECT_EQ(vus, CardSet::full());
+}
+
+// ========================================
+// Tests des opérations ensemblistes
+// ========================================
+
+TEST(CardSetTest, AjoutRetraitEtTaille) {
+    CardSet set;
+    EXPECT_TRUE(set.empty());
+
+    set.add(makeCardId(Carte::PIQUE, Carte::VALET));
+    set.add(makeCardId(Carte::COEUR, Carte::AS));
+    EXPECT_EQ(set.size(), 2);
+    EXPECT_TRUE(set.hasSuit(Carte::PIQUE));
+    EXPECT_FALSE(set.hasSuit(Carte::TREFLE));
+
+    set.remove(makeCardId(Carte::PIQUE, Carte::VALET));
+    EXPECT_EQ(set.size(), 1);
+    EXPECT_FALSE(set.hasSuit(Carte::PIQUE));
+}
+
+TEST(CardSetTest, CouleurInvalideDonneEnsembleVide) {
+    EXPECT_TRUE(CardSet::suit(Carte::COULEURINVALIDE).empty());
+    EXPECT_FALSE(CardSet::full().hasSuit(Carte::COULEURINVALIDE));
+    EXPECT_FALSE(CardSet::full().contains(CARD_ID_INVALIDE));
+}
+
+TEST(CardSetTest, IterationPopFirst) {
+    CardSet set = CardSet::suit(Carte::CARREAU);
+    int count = 0;
+    while (!set.empty()) {
+        CardId id = set.popFirst();
+        EXPECT_EQ(couleurOf(id), Carte::CARREAU);
+        count++;
+    }
+    EXPECT_EQ(count, 8);
+    EXPECT_EQ(set.first(), CARD_ID_INVALIDE);
+}
+
+// ========================================
+// Cohérence avec Deck et Player
+// ========================================
+
+TEST(CardSetTest, MasqueDeLaMainSuitLesCartes) {
+    Deck deck;
+    std::vector<Carte*> main1, main2, main3, main4;
+    deck.distribute(main1, main2, main3, main4);
+
+    Player player("Joueur", main1, 0);
+    CardSet attendu;
+    for (Carte* c : main1) {
+        attendu.add(makeCardId(*c));
+    }
+    EXPECT_EQ(player.getMainSet(), attendu);
+    EXPECT_EQ(player.getMainSet().size(), 8);
+
+    Carte* retiree = main1[0];
+    player.removeCard(0);
+    EXPECT_FALSE(player.getMainSet().contains(makeCardId(*retiree)));
+    EXPECT_EQ(player.getMainSet().size(), 7);
+}
+
+TEST(CardSetTest, DeckReutiliseLesMemesCartes) {
+    // resetDeck ne réalloue pas : les pointeurs restent dans le pool du deck
+    Deck deck;
+    std::vector<Carte*> main1, main2, main3, main4;
+    deck.distribute(main1, main2, main3, main4);
+    Carte* premiere = main1[0];
+
+    deck.resetDeck();
+    std::vector<Carte*> m1, m2, m3, m4;
+    deck.distribute(m1, m2, m3, m4);
+
+    bool retrouvee = false;
+    for (auto* main : {&m1, &m2, &m3, &m4}) {
+        for (Carte* c : *main) {
+            if (c == premiere) retrouvee = true;
+        }
+    }
+    EXPECT_TRUE(retrouvee);
+    EXPECT_EQ(deck.getCardSet(), CardSet::full());
+}
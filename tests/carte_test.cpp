@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../Carte.h"
+#include "../CardTables.h"
 
 class CarteTest : public ::testing::Test {
 protected:
@@ -230,3 +231,33 @@ TEST_F(CarteTest, PrintCarteNeCrashePas) {
     // Ce test vérifie juste que printCarte() ne crash pas
     EXPECT_NO_THROW(carte.printCarte());
 }
+
+// ========================================
+// Tests des tables de force et de points
+// ========================================
+
+TEST_F(CarteTest, TotalDesPointsParMode) {
+    // Une manche vaut 152 points hors dix de der, quel que soit le mode
+    auto totalCouleur = [](CardTables::Mode mode, bool isAtout) {
+        int total = 0;
+        for (int ch = Carte::SEPT; ch <= Carte::AS; ch++) {
+            total += CardTables::points(mode, isAtout, static_cast<Carte::Chiffre>(ch));
+        }
+        return total;
+    };
+
+    EXPECT_EQ(totalCouleur(CardTables::MODE_COULEUR, true) + 3 * totalCouleur(CardTables::MODE_COULEUR, false), 152);
+    EXPECT_EQ(4 * totalCouleur(CardTables::MODE_TOUT_ATOUT, true), 152);
+    EXPECT_EQ(4 * totalCouleur(CardTables::MODE_SANS_ATOUT, false), 152);
+}
+
+TEST_F(CarteTest, TablesCoherentesAvecCarte) {
+    for (int ch = Carte::SEPT; ch <= Carte::AS; ch++) {
+        for (bool isAtout : {false, true}) {
+            Carte carte(Carte::COEUR, static_cast<Carte::Chiffre>(ch));
+            carte.setAtout(isAtout);
+            EXPECT_EQ(carte.getValeurDeLaCarte(), CardTables::points(CardTables::MODE_COULEUR, isAtout, carte.getChiffre()));
+            EXPECT_EQ(carte.getOrdreCarteForte(), CardTables::force(CardTables::MODE_COULEUR, isAtout, carte.getChiffre()));
+        }
+    }
+}
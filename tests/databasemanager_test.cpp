@@ -3,6 +3,7 @@
 #include <QDir>
 #include <QFile>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 #include "../server/DatabaseManager.h"
 
 // Variable globale pour QCoreApplication (nécessaire pour Qt SQL)
@@ -424,6 +425,56 @@ TEST_F(DatabaseManagerTest, RecordLogin_Success) {
     EXPECT_GE(stats.logins, 2) << "Au moins 2 logins uniques devraient être enregistrés";
 }
 
+TEST_F(DatabaseManagerTest, DailyCounters_FlushConserveLesTotaux) {
+    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+
+    dbManager->recordLogin("user1");
+    dbManager->recordLogin("user2");
+    dbManager->recordCrash();
+
+    // Pas encore écrits : getDailyStats ajoute les compteurs en mémoire
+    DatabaseManager::DailyStats avant = dbManager->getDailyStats(today);
+    EXPECT_EQ(avant.logins, 2);
+    EXPECT_EQ(avant.crashes, 1);
+
+    ASSERT_TRUE(dbManager->flushDailyCounters());
+    dbManager->recordLogin("user3");
+    ASSERT_TRUE(dbManager->flushDailyCounters());
+    ASSERT_TRUE(dbManager->flushDailyCounters());  // Rien en attente : aucune écriture
+
+    DatabaseManager::DailyStats apres = dbManager->getDailyStats(today);
+    EXPECT_EQ(apres.logins, 3);
+    EXPECT_EQ(apres.crashes, 1);
+
+    QList<DatabaseManager::DailyStats> trends = dbManager->getTrendStats(1);
+    ASSERT_FALSE(trends.isEmpty());
+    EXPECT_EQ(trends.last().logins, 3);
+}
+
+TEST_F(DatabaseManagerTest, DailyCounters_VeilleNonEcriteResteSeparee) {
+    QString today = QDate::currentDate().toString("yyyy-MM-dd");
+    QString demain = QDate::currentDate().addDays(1).toString("yyyy-MM-dd");
+    QSqlDatabase db = QSqlDatabase::database("coinche_connection");
+
+    dbManager->recordLogin("user1");
+    dbManager->recordLogin("user2");
+
+    // Écriture impossible au changement de jour
+    ASSERT_TRUE(QSqlQuery(db).exec("ALTER TABLE daily_stats RENAME TO daily_stats_hors_ligne"));
+    dbManager->rollDailyCounters(demain);
+    EXPECT_FALSE(dbManager->flushDailyCounters());
+
+    ASSERT_TRUE(QSqlQuery(db).exec("ALTER TABLE daily_stats_hors_ligne RENAME TO daily_stats"));
+
+    // Les compteurs de la veille restent datés de la veille, le nouveau jour part de zéro
+    EXPECT_EQ(dbManager->getDailyStats(today).logins, 2);
+    EXPECT_EQ(dbManager->getDailyStats(demain).logins, 0);
+
+    EXPECT_TRUE(dbManager->flushDailyCounters());
+    EXPECT_EQ(dbManager->getDailyStats(today).logins, 2);
+    EXPECT_EQ(dbManager->getDailyStats(demain).logins, 0);
+}
+
 TEST_F(DatabaseManagerTest, RecordGameRoomCreated_Success) {
     // Créer plusieurs parties
     dbManager->recordGameRoomCreated();
@@ -544,6 +595,37 @@ TEST_F(DatabaseManagerTest, GetRetentionStats_Success) {
     EXPECT_GE(stats.d30Retention, 0.0);
 }
 
+TEST_F(DatabaseManagerTest, GetRetentionStats_MigrationDepuisUserSessions) {
+    // Historique antérieur à daily_active_users : 2 joueurs actifs il y a 2 jours, 1 revenu hier
+    {
+        QSqlQuery query(QSqlDatabase::database("coinche_connection"));
+        ASSERT_TRUE(query.exec("INSERT INTO user_sessions (pseudo, login_time) VALUES "
+                               "('ancien1', datetime('now', '-2 days')), "
+                               "('ancien2', datetime('now', '-2 days')), "
+                               "('ancien1', datetime('now', '-1 days')), "
+                               "('ancien1', datetime('now', '-1 days'))"));
+        ASSERT_TRUE(query.exec("DELETE FROM daily_active_users"));
+    }
+
+    // Réouverture : la migration remplit daily_active_users
+    delete dbManager;
+    QSqlDatabase::removeDatabase("coinche_connection");
+    dbManager = new DatabaseManager();
+    ASSERT_TRUE(dbManager->initialize(testDbPath));
+
+    DatabaseManager::RetentionStats stats = dbManager->getRetentionStats();
+    EXPECT_DOUBLE_EQ(stats.d1Retention, 50.0);
+    EXPECT_DOUBLE_EQ(stats.d7Retention, 0.0);
+
+    // Les nouvelles sessions alimentent la table (une entrée par jour)
+    dbManager->recordSessionStart("nouveau");
+    dbManager->recordSessionStart("nouveau");
+    QSqlQuery query(QSqlDatabase::database("coinche_connection"));
+    ASSERT_TRUE(query.exec("SELECT COUNT(*) FROM daily_active_users WHERE pseudo = 'nouveau'"));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(query.value(0).toInt(), 1);
+}
+
 TEST_F(DatabaseManagerTest, GetTrendStats_7Days) {
     // Enregistrer des statistiques pour créer une tendance
     dbManager->recordLogin("trendUser");
@@ -664,3 +746,112 @@ TEST_F(DatabaseManagerTest, BeloteStats_WinAndLoss_CountedSeparately) {
     EXPECT_EQ(stats.beloteCapots,      1);
     EXPECT_EQ(stats.gamesPlayed,       0) << "Les stats Coinche ne doivent pas être affectées";
 }
+
+// ========================================
+// Tests pour les stats de manche groupées (StatsDelta)
+// ========================================
+
+TEST_F(DatabaseManagerTest, ApplyStatsDeltas_EquivalentAuxMisesAJourUnitaires) {
+    QString errorMsg;
+    dbManager->createAccount("batchUser", "batch@test.com", "password123", "avatar.svg", errorMsg);
+    dbManager->createAccount("unitUser", "unit@test.com", "password123", "avatar.svg", errorMsg);
+
+    // Même séquence : victoire, victoire, défaite, victoire + stats de manche à chaque fois
+    const DatabaseManager::StatsDelta::Partie parties[] = {
+        DatabaseManager::StatsDelta::VICTOIRE, DatabaseManager::StatsDelta::VICTOIRE,
+        DatabaseManager::StatsDelta::DEFAITE, DatabaseManager::StatsDelta::VICTOIRE
+    };
+    for (DatabaseManager::StatsDelta::Partie partie : parties) {
+        QHash<QString, DatabaseManager::StatsDelta> deltas;
+        DatabaseManager::StatsDelta &delta = deltas["batchUser"];
+        delta.partie = partie;
+        delta.coincheSuccess = 1;
+        delta.annoncesCoinchees = 1;
+        delta.annoncesCoincheesGagnees = 1;
+        delta.capotAnnoncesTentes = 1;
+        delta.capotRealises = 1;
+        delta.capotAnnoncesRealises = 1;
+        delta.generaleAttempts = 1;
+        ASSERT_TRUE(dbManager->applyStatsDeltas(deltas));
+
+        dbManager->updateCoincheStats("unitUser", false, true);
+        dbManager->updateAnnonceCoinchee("unitUser", true);
+        dbManager->updateCapotAnnonceTente("unitUser");
+        dbManager->updateCapotStats("unitUser", true);
+        dbManager->updateGeneraleStats("unitUser", false);
+        dbManager->updateGameStats("unitUser", partie == DatabaseManager::StatsDelta::VICTOIRE);
+    }
+
+    DatabaseManager::PlayerStats batch = dbManager->getPlayerStats("batchUser");
+    DatabaseManager::PlayerStats unit = dbManager->getPlayerStats("unitUser");
+    EXPECT_EQ(batch.gamesPlayed, 4);
+    EXPECT_EQ(batch.gamesWon, 3);
+    EXPECT_EQ(batch.maxWinStreak, 2);
+    EXPECT_EQ(batch.gamesPlayed, unit.gamesPlayed);
+    EXPECT_EQ(batch.gamesWon, unit.gamesWon);
+    EXPECT_EQ(batch.maxWinStreak, unit.maxWinStreak);
+    EXPECT_EQ(batch.coincheSuccess, unit.coincheSuccess);
+    EXPECT_EQ(batch.annoncesCoinchees, unit.annoncesCoinchees);
+    EXPECT_EQ(batch.annoncesCoincheesgagnees, unit.annoncesCoincheesgagnees);
+    EXPECT_EQ(batch.capotRealises, unit.capotRealises);
+    EXPECT_EQ(batch.capotAnnoncesRealises, unit.capotAnnoncesRealises);
+    EXPECT_EQ(batch.capotAnnoncesTentes, unit.capotAnnoncesTentes);
+    EXPECT_EQ(batch.generaleAttempts, unit.generaleAttempts);
+    EXPECT_EQ(batch.generaleSuccess, 0);
+}
+
+TEST_F(DatabaseManagerTest, ApplyStatsDeltas_BeloteEtJoueurInconnu) {
+    QString errorMsg;
+    dbManager->createAccount("beloteBatch", "bbatch@test.com", "password123", "avatar.svg", errorMsg);
+
+    QHash<QString, DatabaseManager::StatsDelta> deltas;
+    deltas["beloteBatch"].partieBelote = DatabaseManager::StatsDelta::VICTOIRE;
+    deltas["beloteBatch"].beloteCapots = 1;
+    deltas["inconnu"].partie = DatabaseManager::StatsDelta::VICTOIRE;  // Compte supprimé : ignoré
+
+    EXPECT_TRUE(dbManager->applyStatsDeltas(deltas));
+
+    DatabaseManager::PlayerStats stats = dbManager->getPlayerStats("beloteBatch");
+    EXPECT_EQ(stats.beloteGamesPlayed, 1);
+    EXPECT_EQ(stats.beloteGamesWon, 1);
+    EXPECT_EQ(stats.beloteMaxWinStreak, 1);
+    EXPECT_EQ(stats.beloteCapots, 1);
+    EXPECT_EQ(stats.gamesPlayed, 0);
+}
+
+TEST_F(DatabaseManagerTest, RateGame_RelitLesCotesEnBase) {
+    QString errorMsg;
+    for (int i = 1; i <= 3; i++) {
+        ASSERT_TRUE(dbManager->createAccount(QString("cote%1").arg(i), QString("cote%1@test.com").arg(i),
+                                             "password123", "avatar.svg", errorMsg));
+    }
+
+    std::array<DatabaseManager::RatedSeat, 4> seats;
+    seats[0].pseudo = "cote1";
+    seats[1].pseudo = "cote2";
+    seats[2].pseudo = "cote3";
+    seats[3].pseudo = "invite";  // Pas de compte : coté mais pas enregistré
+    seats[0].score = 1.0;
+    seats[2].score = 1.0;
+
+    DatabaseManager::RatingsSave premiere = dbManager->rateGame("coinche", seats);
+    ASSERT_TRUE(premiere.ok);
+    ASSERT_EQ(premiere.saved.size(), 3);
+    EXPECT_EQ(premiere.saved[0].pseudo, "cote1");
+    EXPECT_EQ(premiere.saved[0].games, 1);
+
+    // Un autre serveur sur la même base, qui n'a pas vu la première partie
+    DatabaseManager autre(nullptr, "coinche_connection_autre");
+    ASSERT_TRUE(autre.initialize(testDbPath));
+    DatabaseManager::RatingsSave seconde = autre.rateGame("coinche", seats);
+    ASSERT_TRUE(seconde.ok);
+    ASSERT_EQ(seconde.saved.size(), 3);
+    EXPECT_EQ(seconde.saved[0].games, 2);
+    EXPECT_GT(seconde.saved[0].rating, premiere.saved[0].rating);
+
+    QList<DatabaseManager::PlayerRating> enBase = dbManager->getAllRatings("coinche");
+    ASSERT_EQ(enBase.size(), 3);
+    for (const DatabaseManager::PlayerRating &rating : enBase) {
+        EXPECT_EQ(rating.games, 2) << rating.pseudo.toStdString();
+    }
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include "../server/DatabaseWorker.h"
+
+static int argc = 1;
+static char* argv[] = {(char*)"test_databaseworker", nullptr};
+static QCoreApplication* app = nullptr;
+
+class DatabaseWorkerTest : public ::testing::Test {
+protected:
+    DatabaseWorker* worker;
+    QString testDbPath;
+    static int testCounter;
+
+    static void SetUpTestSuite() {
+        if (!app) {
+            app = new QCoreApplication(argc, argv);
+        }
+    }
+
+    void SetUp() override {
+        testDbPath = QDir::temp().filePath(QString("test_coinche_worker_%1.db").arg(++testCounter));
+        QFile::remove(testDbPath);
+
+        worker = new DatabaseWorker("coinche_worker_test");
+        ASSERT_TRUE(worker->start(testDbPath));
+    }
+
+    void TearDown() override {
+        delete worker;
+        worker = nullptr;
+        QFile::remove(testDbPath);
+    }
+
+    // Traite les callbacks de request() jusqu'à ce que condition() soit vraie
+    static bool attendre(const std::function<bool()> &condition, int timeoutMs = 5000) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!condition() && timer.elapsed() < timeoutMs) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        }
+        return condition();
+    }
+
+    // request() suivi de l'attente du callback : passe derrière les écritures déjà postées
+    template<typename Result>
+    Result demander(std::function<Result(DatabaseManager &db)> job) {
+        QObject context;
+        bool recu = false;
+        Result result{};
+        worker->request<Result>(&context, std::move(job), [&](const Result &r) {
+            result = r;
+            recu = true;
+        });
+        EXPECT_TRUE(attendre([&]() { return recu; }));
+        return result;
+    }
+};
+
+int DatabaseWorkerTest::testCounter = 0;
+
+TEST_F(DatabaseWorkerTest, PostConserveLOrdreDesEcritures) {
+    worker->post([](DatabaseManager &db) {
+        QString errorMsg;
+        db.createAccount("joueur", "joueur@test.com", "password123", "avatar1.svg", errorMsg);
+    });
+    for (int i = 0; i < 10; i++) {
+        worker->post([won = (i % 2 == 0)](DatabaseManager &db) { db.updateGameStats("joueur", won); });
+    }
+
+    DatabaseManager::PlayerStats stats = demander<DatabaseManager::PlayerStats>([](DatabaseManager &db) {
+        return db.getPlayerStats("joueur");
+    });
+    EXPECT_EQ(stats.gamesPlayed, 10);
+    EXPECT_EQ(stats.gamesWon, 5);
+    // Le compteur est décrémenté dans le thread du worker, après l'envoi du callback
+    EXPECT_TRUE(attendre([&]() { return worker->pending() == 0; }));
+}
+
+TEST_F(DatabaseWorkerTest, RequestAppelleLeCallbackDansLeThreadAppelant) {
+    QObject context;
+    bool recu = false;
+    bool existe = true;
+    Qt::HANDLE threadCallback = nullptr;
+
+    worker->request<bool>(&context,
+        [](DatabaseManager &db) { return db.pseudoExists("inconnu"); },
+        [&](const bool &result) {
+            recu = true;
+            existe = result;
+            threadCallback = QThread::currentThreadId();
+        });
+
+    ASSERT_TRUE(attendre([&]() { return recu; }));
+    EXPECT_FALSE(existe);
+    EXPECT_EQ(threadCallback, QThread::currentThreadId());
+}
+
+TEST_F(DatabaseWorkerTest, StopExecuteLesRequetesEnAttente) {
+    worker->post([](DatabaseManager &db) {
+        QString errorMsg;
+        db.createAccount("persistant", "persistant@test.com", "password123", "avatar1.svg", errorMsg);
+    });
+    worker->stop();
+    EXPECT_FALSE(worker->isRunning());
+
+    // La base rouverte contient l'écriture postée avant stop()
+    ASSERT_TRUE(worker->start(testDbPath));
+    EXPECT_TRUE(demander<bool>([](DatabaseManager &db) { return db.pseudoExists("persistant"); }));
+}
+
+TEST_F(DatabaseWorkerTest, ReadRequestSurThreadsDeLecture) {
+    worker->stop();
+    ASSERT_TRUE(worker->start(testDbPath, 2));
+
+    // L'écriture est faite avant les lectures
+    ASSERT_TRUE(demander<bool>([](DatabaseManager &db) {
+        QString errorMsg;
+        return db.createAccount("lecteur", "lecteur@test.com", "password123", "avatar1.svg", errorMsg);
+    }));
+
+    QObject context;
+    int trouves = 0;
+    int recus = 0;
+    for (int i = 0; i < 6; i++) {
+        worker->readRequest<bool>(&context,
+            [](DatabaseManager &db) { return db.pseudoExists("lecteur"); },
+            [&](const bool &existe) {
+                recus++;
+                if (existe) trouves++;
+            });
+    }
+
+    ASSERT_TRUE(attendre([&]() { return recus == 6; }));
+    EXPECT_EQ(trouves, 6);
+
+    // Les connexions de lecture refusent les écritures
+    worker->readRequest<bool>(&context,
+        [](DatabaseManager &db) { return db.updateGameStats("lecteur", true); },
+        [&](const bool &ok) {
+            recus++;
+            EXPECT_FALSE(ok);
+        });
+    ASSERT_TRUE(attendre([&]() { return recus == 7; }));
+}
+
+TEST_F(DatabaseWorkerTest, ReadAfterWritesVoitLesEcrituresPostees) {
+    worker->stop();
+    ASSERT_TRUE(worker->start(testDbPath, 2));
+
+    // Écritures postées sans attendre, relues aussitôt : chaque lecture doit les voir
+    QObject context;
+    int vus = 0;
+    int recus = 0;
+    for (int i = 0; i < 20; i++) {
+        QString pseudo = QString("joueur%1").arg(i);
+        worker->post([pseudo](DatabaseManager &db) {
+            QString errorMsg;
+            db.createAccount(pseudo, pseudo + "@test.com", "password123", "avatar1.svg", errorMsg);
+        });
+        worker->readAfterWrites<bool>(&context,
+            [pseudo](DatabaseManager &db) { return db.pseudoExists(pseudo); },
+            [&](const bool &existe) {
+                recus++;
+                if (existe) vus++;
+            });
+    }
+
+    ASSERT_TRUE(attendre([&]() { return recus == 20; }));
+    EXPECT_EQ(vus, 20);
+}
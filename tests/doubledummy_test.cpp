@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "../DoubleDummySolver.h"
+#include "../LegalMoves.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+// Minimax exhaustif (sans élagage) servant de référence sur les petites fins de partie
+static int minimaxReference(DoubleDummySolver::Position p) {
+    bool vide = (p.mains[0] | p.mains[1] | p.mains[2] | p.mains[3]).empty();
+    if (vide && p.pliSize == 0) return 0;
+
+    int joueur = p.currentPlayer();
+    Carte::Couleur demandee = Carte::COULEURINVALIDE;
+    CardId gagnante = CARD_ID_INVALIDE;
+    bool partenaire = false;
+    if (p.pliSize > 0) {
+        int g = DoubleDummySolver::pliWinner(p.pli.data(), p.pliSize, p.couleurAtout, p.mode);
+        demandee = couleurOf(p.pli[0]);
+        gagnante = p.pli[g];
+        partenaire = (p.leader + g + 2) % 4 == joueur;
+    }
+    CardSet legaux = LegalMoves::legalMoves(p.mains[joueur], demandee, gagnante, partenaire, p.couleurAtout, p.mode);
+
+    int best = (joueur % 2 == 0) ? -1000 : 1000;
+    while (!legaux.empty()) {
+        CardId id = legaux.popFirst();
+        DoubleDummySolver::Position c = p;
+        c.mains[joueur].remove(id);
+        c.pli[c.pliSize++] = id;
+        int v;
+        if (c.pliSize == 4) {
+            int g = (c.leader + DoubleDummySolver::pliWinner(c.pli.data(), 4, c.couleurAtout, c.mode)) % 4;
+            bool dernier = (c.mains[0] | c.mains[1] | c.mains[2] | c.mains[3]).empty();
+            int gain = dernier ? 10 : 0;
+            for (int i = 0; i < 4; i++) gain += DoubleDummySolver::cardPoints(c.pli[i], c.couleurAtout, c.mode);
+            c.leader = g;
+            c.pliSize = 0;
+            v = (g % 2 == 0 ? gain : 0) + minimaxReference(c);
+        } else {
+            v = minimaxReference(c);
+        }
+        best = (joueur % 2 == 0) ? std::max(best, v) : std::min(best, v);
+    }
+    return best;
+}
+
+static DoubleDummySolver::Position donneAleatoire(std::mt19937& rng, int cartesParJoueur, int modeIndex) {
+    std::vector<int> ids(NB_CARTES);
+    for (int i = 0; i < NB_CARTES; i++) ids[i] = i;
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    DoubleDummySolver::Position p;
+    for (int j = 0; j < 4; j++) {
+        for (int k = 0; k < cartesParJoueur; k++) {
+            p.mains[j].add(static_cast<CardId>(ids[j * cartesParJoueur + k]));
+        }
+    }
+    p.mode = static_cast<CardTables::Mode>(modeIndex);
+    p.couleurAtout = (p.mode == CardTables::MODE_COULEUR) ? Carte::PIQUE : Carte::COULEURINVALIDE;
+    p.leader = static_cast<int>(rng() % 4);
+    return p;
+}
+
+TEST(DoubleDummySolverTest, DernierPliCompteLeDixDeDer) {
+    DoubleDummySolver::Position p;
+    p.couleurAtout = Carte::PIQUE;
+    p.mains[0].add(makeCardId(Carte::PIQUE, Carte::VALET));
+    p.mains[1].add(makeCardId(Carte::COEUR, Carte::AS));
+    p.mains[2].add(makeCardId(Carte::COEUR, Carte::SEPT));
+    p.mains[3].add(makeCardId(Carte::TREFLE, Carte::DIX));
+    p.leader = 0;
+
+    DoubleDummySolver solver(10);
+    // Valet d'atout (20) + As (11) + 7 (0) + 10 (10) + dix de der
+    EXPECT_EQ(solver.solve(p), 51);
+}
+
+TEST(DoubleDummySolverTest, IdentiqueAuMinimaxExhaustif) {
+    std::mt19937 rng(1234);
+    DoubleDummySolver solver(12);
+    for (int essai = 0; essai < 60; essai++) {
+        DoubleDummySolver::Position p = donneAleatoire(rng, 3, essai % CardTables::NB_MODES);
+        EXPECT_EQ(solver.solve(p), minimaxReference(p)) << "Donne " << essai;
+    }
+}
+
+TEST(DoubleDummySolverTest, PliEnCoursEtMeilleurCoup) {
+    std::mt19937 rng(99);
+    DoubleDummySolver solver(12);
+    for (int essai = 0; essai < 30; essai++) {
+        DoubleDummySolver::Position p = donneAleatoire(rng, 3, essai % CardTables::NB_MODES);
+
+        // Le premier joueur entame avec sa plus petite carte
+        CardId entame = p.mains[p.leader].first();
+        p.mains[p.leader].remove(entame);
+        p.pli[0] = entame;
+        p.pliSize = 1;
+
+        int joueur = p.currentPlayer();
+        int reference = minimaxReference(p);
+        int valeur = 0;
+        CardId meilleur = solver.bestMove(p, &valeur);
+        ASSERT_NE(meilleur, CARD_ID_INVALIDE);
+        EXPECT_TRUE(p.mains[joueur].contains(meilleur));
+
+        // La valeur est exprimée côté équipe du joueur qui doit jouer
+        int enJeu = 10 + DoubleDummySolver::cardPoints(entame, p.couleurAtout, p.mode);
+        for (const CardSet& main : p.mains) {
+            CardSet reste = main;
+            while (!reste.empty()) enJeu += DoubleDummySolver::cardPoints(reste.popFirst(), p.couleurAtout, p.mode);
+        }
+        EXPECT_EQ(valeur, joueur % 2 == 0 ? reference : enJeu - reference) << "Donne " << essai;
+    }
+}
+
+TEST(DoubleDummySolverTest, DonneCompleteEnTempsRaisonnable) {
+    std::mt19937 rng(7);
+    DoubleDummySolver solver;
+    for (int mode = 0; mode < CardTables::NB_MODES; mode++) {
+        DoubleDummySolver::Position p = donneAleatoire(rng, 8, mode);
+        int valeur = solver.solve(p);
+        EXPECT_GE(valeur, 0);
+        EXPECT_LE(valeur, 162);
+    }
+}
+
+TEST(DoubleDummySolverTest, EcheancePasseeInterromptLaRecherche) {
+    std::mt19937 rng(11);
+    DoubleDummySolver solver;
+    DoubleDummySolver::Position p = donneAleatoire(rng, 8, CardTables::MODE_COULEUR);
+
+    solver.setDeadline(std::chrono::steady_clock::now());
+    EXPECT_TRUE(solver.evaluateMoves(p).empty());
+    EXPECT_TRUE(solver.aborted());
+
+    // Interruption en cours de recherche : la table laissée reste juste
+    solver.setDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(2));
+    solver.evaluateMoves(p);
+    solver.clearDeadline();
+    EXPECT_FALSE(solver.aborted());
+    DoubleDummySolver neuf;
+    EXPECT_EQ(solver.solve(p), neuf.solve(p));
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "../GameEngine.h"
+
+TEST(GameEngineTest, MancheDistribueTousLesPoints) {
+    GameEngine::Config config;
+    config.bidSamples = 16;
+    GameEngine engine(config, 11);
+
+    int manchesJouees = 0;
+    for (int m = 0; m < 40; m++) {
+        GameEngine::ResultatManche manche = engine.playManche(m % 4);
+        if (manche.preneur < 0) {
+            EXPECT_EQ(manche.score[0] + manche.score[1], 0);
+            continue;
+        }
+        manchesJouees++;
+        EXPECT_EQ(manche.plis[0] + manche.plis[1], 8);
+        EXPECT_EQ(manche.points[0] + manche.points[1], 162) << "Manche " << m;
+        EXPECT_NE(manche.annonce, Player::PASSE);
+
+        // Contrat réussi : le preneur marque au moins son contrat ; chuté : il ne marque que sa belote
+        int equipe = manche.preneur % 2;
+        if (manche.contratReussi) {
+            EXPECT_GE(manche.score[equipe], Player::getContractValue(manche.annonce));
+        } else {
+            EXPECT_EQ(manche.score[equipe], manche.belote[equipe]);
+        }
+    }
+    EXPECT_GT(manchesJouees, 0);
+}
+
+TEST(GameEngineTest, PartieReproductible) {
+    GameEngine::Config config;
+    config.bidSamples = 16;
+    config.bots[1] = config.bots[3] = GameEngine::BOT_ALEATOIRE;
+
+    GameEngine::ResultatPartie a = GameEngine(config, 5).playGame();
+    GameEngine::ResultatPartie b = GameEngine(config, 5).playGame();
+    EXPECT_EQ(a.score, b.score);
+    EXPECT_EQ(a.manches, b.manches);
+
+    ASSERT_GE(a.vainqueur, 0);
+    EXPECT_GE(a.score[a.vainqueur], config.scoreVictoire);
+    EXPECT_EQ(a.contrats[0] + a.contrats[1] + a.manchesPassees, a.manches);
+}
+
+TEST(GameEngineTest, PliToutAtoutSansCoupe) {
+    // Tout Atout : le Valet de pique ne prend pas un pli entamé à cœur
+    PlayoutPolicy::Contrat toutAtout = PlayoutPolicy::makeContrat(Carte::COULEURINVALIDE, CardTables::MODE_TOUT_ATOUT);
+    std::array<CardId, 4> pli = {{ makeCardId(Carte::COEUR, Carte::NEUF), makeCardId(Carte::PIQUE, Carte::VALET),
+                                   makeCardId(Carte::COEUR, Carte::VALET), makeCardId(Carte::COEUR, Carte::AS) }};
+    GameEngine::ResultatPli resultat = GameEngine::resoudrePli(pli, 1, toutAtout, false);
+    EXPECT_EQ(resultat.gagnant, 3);
+    EXPECT_EQ(resultat.points, 9 + 14 + 14 + 6);
+
+    // À la couleur, l'atout coupe ; dix de der au dernier pli
+    PlayoutPolicy::Contrat pique = PlayoutPolicy::makeContrat(Carte::PIQUE, CardTables::MODE_COULEUR);
+    resultat = GameEngine::resoudrePli(pli, 1, pique, true);
+    EXPECT_EQ(resultat.gagnant, 2);
+    EXPECT_EQ(resultat.points, 0 + 20 + 2 + 11 + 10);
+}
+
+TEST(GameEngineTest, BeloteRoiDameDansUneMain) {
+    std::array<CardSet, 4> mains;
+    mains[1].add(makeCardId(Carte::TREFLE, Carte::ROI));
+    mains[1].add(makeCardId(Carte::TREFLE, Carte::DAME));
+    mains[2].add(makeCardId(Carte::COEUR, Carte::ROI));
+    mains[0].add(makeCardId(Carte::COEUR, Carte::DAME));
+
+    auto trefle = GameEngine::belote(mains, PlayoutPolicy::makeContrat(Carte::TREFLE, CardTables::MODE_COULEUR));
+    EXPECT_EQ(trefle, (std::array<int, 2>{{ 0, 20 }}));
+    auto coeur = GameEngine::belote(mains, PlayoutPolicy::makeContrat(Carte::COEUR, CardTables::MODE_COULEUR));
+    EXPECT_EQ(coeur, (std::array<int, 2>{{ 0, 0 }}));
+    auto sansAtout = GameEngine::belote(mains, PlayoutPolicy::makeContrat(Carte::COULEURINVALIDE, CardTables::MODE_SANS_ATOUT));
+    EXPECT_EQ(sansAtout, (std::array<int, 2>{{ 0, 0 }}));
+}
+
+TEST(GameEngineTest, ResolutionCoincheEtSurcoinche) {
+    GameEngine::Prise prise;
+    prise.preneur = 1;
+    prise.annonce = Player::CENT;
+    prise.coinche = true;
+    std::array<int, 4> plis = {{ 2, 2, 1, 3 }};
+
+    // La belote compte pour atteindre le contrat : 82 + 20 >= 100
+    GameEngine::Resolution reussi = GameEngine::resoudreManche(prise, {{ 80, 82 }}, plis, {{ 0, 20 }});
+    EXPECT_TRUE(reussi.contratReussi);
+    EXPECT_EQ(reussi.score, (std::array<int, 2>{{ 0, 160 + 100 * 2 + 20 }}));
+
+    prise.surcoinche = true;
+    GameEngine::Resolution chute = GameEngine::resoudreManche(prise, {{ 90, 72 }}, plis, {{ 0, 0 }});
+    EXPECT_FALSE(chute.contratReussi);
+    EXPECT_EQ(chute.score, (std::array<int, 2>{{ 160 + 100 * 4, 0 }}));
+}
+
+TEST(GameEngineTest, ResolutionCapotEtGenerale) {
+    GameEngine::Prise prise;
+    prise.preneur = 0;
+    prise.annonce = Player::CAPOT;
+    GameEngine::Resolution capot = GameEngine::resoudreManche(prise, {{ 162, 0 }}, {{ 5, 0, 3, 0 }}, {{ 0, 0 }});
+    EXPECT_TRUE(capot.capotAnnonce);
+    EXPECT_TRUE(capot.contratReussi);
+    EXPECT_EQ(capot.equipeCapot, 0);
+    EXPECT_EQ(capot.score, (std::array<int, 2>{{ 500, 0 }}));
+
+    // Générale : les 8 plis à deux ne suffisent pas
+    prise.annonce = Player::GENERALE;
+    GameEngine::Resolution generale = GameEngine::resoudreManche(prise, {{ 162, 0 }}, {{ 5, 0, 3, 0 }}, {{ 0, 0 }});
+    EXPECT_FALSE(generale.contratReussi);
+    EXPECT_FALSE(generale.capotNonAnnonce[0]);
+    EXPECT_EQ(generale.equipeCapot, -1);
+
+    // Capot non annoncé sur un contrat simple
+    prise.annonce = Player::QUATREVINGT;
+    GameEngine::Resolution nonAnnonce = GameEngine::resoudreManche(prise, {{ 162, 0 }}, {{ 4, 0, 4, 0 }}, {{ 0, 0 }});
+    EXPECT_TRUE(nonAnnonce.capotNonAnnonce[0]);
+    EXPECT_TRUE(nonAnnonce.capotReussi);
+    EXPECT_EQ(nonAnnonce.equipeCapot, 0);
+    EXPECT_EQ(nonAnnonce.score, (std::array<int, 2>{{ 250 + 80, 0 }}));
+}
+
+TEST(GameEngineTest, ResolutionModeBelote) {
+    GameEngine::Prise prise;
+    prise.preneur = 3;
+    prise.modeBelote = true;
+    std::array<int, 4> plis = {{ 2, 2, 2, 2 }};
+
+    // 81 points : la moitié ne suffit pas, il faut dépasser
+    GameEngine::Resolution chute = GameEngine::resoudreManche(prise, {{ 81, 81 }}, plis, {{ 0, 0 }});
+    EXPECT_FALSE(chute.contratReussi);
+    EXPECT_EQ(chute.score, (std::array<int, 2>{{ 162, 0 }}));
+
+    GameEngine::Resolution reussi = GameEngine::resoudreManche(prise, {{ 81, 81 }}, plis, {{ 0, 20 }});
+    EXPECT_TRUE(reussi.contratReussi);
+    EXPECT_EQ(reussi.score, (std::array<int, 2>{{ 81, 101 }}));
+
+    // Contre-capot de la défense
+    GameEngine::Resolution contreCapot = GameEngine::resoudreManche(prise, {{ 162, 0 }}, {{ 4, 0, 4, 0 }}, {{ 0, 0 }});
+    EXPECT_FALSE(contreCapot.contratReussi);
+    EXPECT_EQ(contreCapot.equipeCapot, 0);
+    EXPECT_EQ(contreCapot.score, (std::array<int, 2>{{ 250, 0 }}));
+}
+
+TEST(GameEngineTest, VainqueurAuScoreDeVictoire) {
+    EXPECT_EQ(GameEngine::vainqueur({{ 990, 400 }}, 1000), -1);
+    EXPECT_EQ(GameEngine::vainqueur({{ 400, 1010 }}, 1000), 1);
+    EXPECT_EQ(GameEngine::vainqueur({{ 1080, 1020 }}, 1000), 0);
+    EXPECT_EQ(GameEngine::vainqueur({{ 1000, 1000 }}, 1000), 1);
+}
@@ -7,6 +7,8 @@
 #include <QJsonArray>
 #include <QTimer>
 #include <QEventLoop>
+#include <QElapsedTimer>
+#include <QDateTime>
 #include <QTest>
 #include <iostream>
 #include "../server/GameServer.h"
@@ -52,6 +54,7 @@ public:
                 emit registered(m_connectionId);
             } else if (type == "gameFound") {
                 m_playerPosition = obj["playerPosition"].toInt();
+                m_roomId = obj["roomId"].toInt(-1);
                 m_myCards = obj["myCards"].toArray();
                 emit gameFound(m_playerPosition, m_myCards);
             } else if (type == "gameState") {
@@ -79,22 +82,52 @@ public:
         }
     }
 
-    void sendRegister(bool wasInGame = false) {
+    void sendRegister(bool wasInGame = false, int version = GameServer::MIN_CLIENT_VERSION) {
         QJsonObject msg;
         msg["type"] = "register";
         msg["playerName"] = m_playerName;
         msg["avatar"] = "avataaars1.svg";
         msg["wasInGame"] = wasInGame;
+        msg["version"] = version;
+        sendMessage(msg);
+    }
+
+    // Compte avec le nom du client comme pseudo
+    void sendRegisterAccount(const QString& email, const QString& password) {
+        QJsonObject msg;
+        msg["type"] = "registerAccount";
+        msg["pseudo"] = m_playerName;
+        msg["email"] = email;
+        msg["password"] = password;
+        msg["avatar"] = "avataaars1.svg";
         msg["version"] = GameServer::MIN_CLIENT_VERSION;
         sendMessage(msg);
     }
 
+    void sendLoginAccount(const QString& email, const QString& password, int version = GameServer::MIN_CLIENT_VERSION) {
+        QJsonObject msg;
+        msg["type"] = "loginAccount";
+        msg["email"] = email;
+        msg["password"] = password;
+        msg["version"] = version;
+        sendMessage(msg);
+    }
+
     void sendJoinMatchmaking() {
         QJsonObject msg;
         msg["type"] = "joinMatchmaking";
         sendMessage(msg);
     }
 
+    // clockSpeed >= 0 : horloge de la room d'entraînement (0 = sans délai d'animation)
+    void sendJoinTraining(double clockSpeed = -1) {
+        QJsonObject msg;
+        msg["type"] = "joinTraining";
+        msg["gameMode"] = "coinche";
+        if (clockSpeed >= 0) msg["clockSpeed"] = clockSpeed;
+        sendMessage(msg);
+    }
+
     void sendMakeBid(int bidValue, int suit) {
         QJsonObject msg;
         msg["type"] = "makeBid";
@@ -123,10 +156,25 @@ public:
         sendMessage(msg);
     }
 
+    void sendResync(qint64 lastSeq) {
+        QJsonObject msg;
+        msg["type"] = "resync";
+        msg["lastSeq"] = lastSeq;
+        sendMessage(msg);
+    }
+
+    void sendGetLeaderboard(const QString& gameMode) {
+        QJsonObject msg;
+        msg["type"] = "getLeaderboard";
+        msg["gameMode"] = gameMode;
+        sendMessage(msg);
+    }
+
     bool isConnected() const { return m_connected; }
     QString playerName() const { return m_playerName; }
     QString connectionId() const { return m_connectionId; }
     int playerPosition() const { return m_playerPosition; }
+    int roomId() const { return m_roomId; }
     QJsonArray myCards() const { return m_myCards; }
     QJsonObject lastMessage() const { return m_lastMessage; }
 
@@ -162,6 +210,7 @@ private:
     QString m_connectionId;
     bool m_connected;
     int m_playerPosition;
+    int m_roomId = -1;
     QJsonArray m_myCards;
     QJsonObject m_lastMessage;
     QList<QJsonObject> m_allMessages;  // Track all messages for debugging
@@ -214,9 +263,9 @@ protected:
         QCoreApplication::processEvents();
     }
 
-    // Helper pour créer et connecter un client
-    MockGameClient* createClient(const QString& name) {
-        const QString url = QString("ws://localhost:%1").arg(TEST_PORT);
+    // Helper pour créer et connecter un client (port 0 : serveur principal)
+    MockGameClient* createClient(const QString& name, quint16 port = 0) {
+        const QString url = QString("ws://localhost:%1").arg(port ? port : TEST_PORT);
         MockGameClient* client = new MockGameClient(url, name, nullptr);
         clients.append(client);
 
@@ -479,6 +528,273 @@ TEST_F(GameServerIntegrationTest, BiddingPhase_OnePlayerBids) {
     EXPECT_GT(totalBids, 0) << "At least some players should have received bidMade messages";
 }
 
+// ========================================
+// Tests de synchronisation (messages numérotés)
+// ========================================
+
+TEST_F(GameServerIntegrationTest, Sync_MessagesNumerotesEtResync) {
+    QList<MockGameClient*> players;
+    for (int i = 0; i < 4; i++) {
+        MockGameClient* client = createClient(QString("Player%1").arg(i + 1));
+        client->sendRegister();
+        waitForSignal(client, SIGNAL(registered(QString)), 2000);
+        client->sendJoinMatchmaking();
+        players.append(client);
+    }
+
+    waitForAllSignals(
+        QList<QObject*>({players[0], players[1], players[2], players[3]}),
+        SIGNAL(gameFound(int, const QJsonArray&)),
+        5000
+    );
+    QCoreApplication::processEvents();
+
+    players[0]->sendMakeBid(14, 0);  // PASSE
+    QTest::qWait(200);
+    players[1]->sendMakeBid(1, 6);   // QUATREVINGT PIQUE
+    QTest::qWait(200);
+    QCoreApplication::processEvents();
+
+    // Les messages d'état reçus par le joueur 2 sont numérotés sans trou
+    auto numeros = [](const QList<QJsonObject>& messages) {
+        QList<qint64> seqs;
+        for (const QJsonObject& msg : messages) {
+            if (msg.contains("seq") && msg["type"].toString() != "gameFound") {
+                seqs.append(msg["seq"].toInteger());
+            }
+        }
+        return seqs;
+    };
+    QList<qint64> recus = numeros(players[2]->allMessages());
+    ASSERT_GE(recus.size(), 2) << "Les annonces doivent être diffusées avec un numéro";
+    for (int i = 1; i < recus.size(); i++) {
+        EXPECT_EQ(recus[i], recus[i - 1] + 1);
+    }
+
+    // Resync depuis le premier message : le serveur renvoie exactement la suite, dans l'ordre
+    int dejaRecus = players[2]->allMessages().size();
+    players[2]->sendResync(recus.first());
+    QTest::qWait(300);
+    QCoreApplication::processEvents();
+
+    QList<qint64> rejoues = numeros(players[2]->allMessages().mid(dejaRecus));
+    ASSERT_GE(rejoues.size(), recus.size() - 1);
+    for (int i = 0; i < recus.size() - 1; i++) {
+        EXPECT_EQ(rejoues[i], recus[i + 1]);
+    }
+}
+
+TEST_F(GameServerIntegrationTest, Training_HorlogeSansDelai) {
+    // Vitesse 0 : les bots annoncent au tick suivant au lieu de 3 s chacun
+    MockGameClient* humain = createClient("Player1");
+    humain->sendRegister();
+    waitForSignal(humain, SIGNAL(registered(QString)), 2000);
+    humain->sendJoinTraining(0);
+    ASSERT_TRUE(waitForSignal(humain, SIGNAL(gameFound(int, const QJsonArray&)), 3000));
+    EXPECT_EQ(humain->playerPosition(), 0);
+
+    QSignalSpy annonces(humain, &MockGameClient::bidMade);
+    humain->sendMakeBid(14, 0);  // PASSE
+
+    // Les 3 bots annoncent bien avant les 9 s du rythme normal
+    QElapsedTimer chrono;
+    chrono.start();
+    while (annonces.count() < 4 && chrono.elapsed() < 1500) {
+        QTest::qWait(20);
+    }
+    EXPECT_GE(annonces.count(), 4) << "Annonce du joueur + 3 bots";
+    for (int i = 1; i < annonces.count() && i < 4; i++) {
+        EXPECT_EQ(annonces[i][0].toInt(), i);
+    }
+}
+
+TEST_F(GameServerIntegrationTest, Leaderboard_JoueurNonClasse) {
+    MockGameClient* client = createClient("Player1");
+    client->sendRegister();
+    ASSERT_TRUE(waitForSignal(client, SIGNAL(registered(QString)), 2000));
+
+    client->sendGetLeaderboard("belote");
+    QElapsedTimer chrono;
+    chrono.start();
+    while (client->lastMessage()["type"].toString() != "leaderboard" && chrono.elapsed() < 2000) {
+        QTest::qWait(20);
+    }
+    QJsonObject classement = client->lastMessage();
+    ASSERT_EQ(classement["type"].toString(), "leaderboard");
+    EXPECT_EQ(classement["gameMode"].toString(), "belote");
+    EXPECT_TRUE(classement["entries"].isArray());
+    EXPECT_EQ(classement["myRank"].toInt(-1), 0);  // Aucune partie cotée
+}
+
+TEST_F(GameServerIntegrationTest, Broker_RedirigeVersLeServeurHote) {
+    // Deux serveurs coordonnés par un broker local, comme deux processus sur la même machine
+    const QString brokerPath = QDir::temp().filePath("test_coinche_broker");
+    MatchmakingBroker broker;
+    ASSERT_TRUE(broker.listen(brokerPath));
+
+    QString secondDbPath = QDir::temp().filePath("test_gameserver_integration_b.db");
+    QFile::remove(secondDbPath);
+    DatabaseManager secondDb;
+    ASSERT_TRUE(secondDb.initialize(secondDbPath));
+    const quint16 secondPort = TEST_PORT + 1;
+    GameServer second(secondPort, &secondDb);
+
+    gameServer->enableBroker(brokerPath, "a", QString("ws://localhost:%1").arg(TEST_PORT));
+    second.enableBroker(brokerPath, "b", QString("ws://localhost:%1").arg(secondPort));
+    QElapsedTimer chrono;
+    chrono.start();
+    while (broker.serverCount() < 2 && chrono.elapsed() < 3000) {
+        QTest::qWait(20);
+    }
+    ASSERT_EQ(broker.serverCount(), 2);
+    QTest::qWait(200);  // Diffusion de l'annuaire
+
+    auto attendreType = [](MockGameClient *c, const QString &type) {
+        QElapsedTimer attente;
+        attente.start();
+        while (attente.elapsed() < 2000) {
+            for (const QJsonObject &message : c->allMessages()) {
+                if (message["type"].toString() == type) return message;
+            }
+            QTest::qWait(20);
+        }
+        return QJsonObject();
+    };
+
+    // À égalité de charge, le matchmaking coinche est hébergé par "a"
+    MockGameClient* client = createClient("Player1", secondPort);
+    client->sendRegister(false, Broker::REDIRECT_MIN_VERSION);
+    ASSERT_TRUE(waitForSignal(client, SIGNAL(registered(QString)), 2000));
+    client->sendJoinMatchmaking();
+    QJsonObject redirect = attendreType(client, "redirect");
+    EXPECT_EQ(redirect["url"].toString(), QString("ws://localhost:%1").arg(TEST_PORT));
+    EXPECT_EQ(redirect["resume"].toString(), "joinMatchmaking");
+
+    // Un ancien client ne sait pas suivre : il reste dans la file locale
+    MockGameClient* ancien = createClient("Player2", secondPort);
+    ancien->sendRegister();
+    ASSERT_TRUE(waitForSignal(ancien, SIGNAL(registered(QString)), 2000));
+    ancien->sendJoinMatchmaking();
+    EXPECT_FALSE(attendreType(ancien, "matchmakingStatus").isEmpty());
+    EXPECT_TRUE(attendreType(ancien, "redirect").isEmpty());
+
+    // Fermer les clients avant la destruction du second serveur
+    for (MockGameClient* c : clients) delete c;
+    clients.clear();
+    QCoreApplication::processEvents();
+}
+
+TEST_F(GameServerIntegrationTest, Broker_LoginRedirigeVersLaPartie) {
+    const QString brokerPath = QDir::temp().filePath("test_coinche_broker");
+    MatchmakingBroker broker;
+    ASSERT_TRUE(broker.listen(brokerPath));
+
+    QString secondDbPath = QDir::temp().filePath("test_gameserver_integration_b.db");
+    QFile::remove(secondDbPath);
+    DatabaseManager secondDb;
+    ASSERT_TRUE(secondDb.initialize(secondDbPath));
+    const quint16 secondPort = TEST_PORT + 1;
+    GameServer second(secondPort, &secondDb);
+
+    gameServer->enableBroker(brokerPath, "a", QString("ws://localhost:%1").arg(TEST_PORT));
+    second.enableBroker(brokerPath, "b", QString("ws://localhost:%1").arg(secondPort));
+    QElapsedTimer chrono;
+    chrono.start();
+    while (broker.serverCount() < 2 && chrono.elapsed() < 3000) {
+        QTest::qWait(20);
+    }
+    ASSERT_EQ(broker.serverCount(), 2);
+
+    auto attendreType = [](MockGameClient *c, const QString &type) {
+        QElapsedTimer attente;
+        attente.start();
+        while (attente.elapsed() < 2000) {
+            for (const QJsonObject &message : c->allMessages()) {
+                if (message["type"].toString() == type) return message;
+            }
+            QTest::qWait(20);
+        }
+        return QJsonObject();
+    };
+
+    // Compte créé sur "a" (les deux serveurs partagent la base des comptes), partie lancée sur "a"
+    const QString suffixe = QString::number(QDateTime::currentMSecsSinceEpoch());
+    const QString email = QString("login%1@test.com").arg(suffixe);
+    const QString password = "motdepasse123";
+    MockGameClient* hote = createClient(QString("Login%1").arg(suffixe));
+    hote->sendRegisterAccount(email, password);
+    ASSERT_FALSE(attendreType(hote, "registerAccountSuccess").isEmpty());
+    hote->sendJoinTraining();
+    ASSERT_FALSE(attendreType(hote, "gameFound").isEmpty());
+    QTest::qWait(300);  // Publication de l'état de "a" et diffusion de l'annuaire
+
+    // Connexion au compte depuis "b" (autre appareil, autre serveur) : le client part sur "a"
+    MockGameClient* client = createClient("Login", secondPort);
+    client->sendLoginAccount(email, password, Broker::REDIRECT_MIN_VERSION);
+    EXPECT_FALSE(attendreType(client, "loginAccountSuccess").isEmpty());
+    QJsonObject redirect = attendreType(client, "redirect");
+    EXPECT_EQ(redirect["url"].toString(), QString("ws://localhost:%1").arg(TEST_PORT));
+
+    for (MockGameClient* c : clients) delete c;
+    clients.clear();
+    QCoreApplication::processEvents();
+}
+
+TEST_F(GameServerIntegrationTest, Broker_InvitesDistinctsEntreServeurs) {
+    const QString brokerPath = QDir::temp().filePath("test_coinche_broker");
+    MatchmakingBroker broker;
+    ASSERT_TRUE(broker.listen(brokerPath));
+
+    QString secondDbPath = QDir::temp().filePath("test_gameserver_integration_b.db");
+    QFile::remove(secondDbPath);
+    DatabaseManager secondDb;
+    ASSERT_TRUE(secondDb.initialize(secondDbPath));
+    const quint16 secondPort = TEST_PORT + 1;
+    GameServer second(secondPort, &secondDb);
+
+    gameServer->enableBroker(brokerPath, "a", QString("ws://localhost:%1").arg(TEST_PORT));
+    second.enableBroker(brokerPath, "b", QString("ws://localhost:%1").arg(secondPort));
+    QElapsedTimer chrono;
+    chrono.start();
+    while (broker.serverCount() < 2 && chrono.elapsed() < 3000) {
+        QTest::qWait(20);
+    }
+    ASSERT_EQ(broker.serverCount(), 2);
+
+    auto attendreType = [](MockGameClient *c, const QString &type, int timeoutMs = 2000) {
+        QElapsedTimer attente;
+        attente.start();
+        while (attente.elapsed() < timeoutMs) {
+            for (const QJsonObject &message : c->allMessages()) {
+                if (message["type"].toString() == type) return message;
+            }
+            QTest::qWait(20);
+        }
+        return QJsonObject();
+    };
+
+    // Premier invité de "a", en partie sur "a" (donc dans l'annuaire du broker)
+    MockGameClient* inviteA = createClient("");
+    inviteA->sendRegister(false, Broker::REDIRECT_MIN_VERSION);
+    QJsonObject enregistreA = attendreType(inviteA, "registered");
+    ASSERT_FALSE(enregistreA.isEmpty());
+    inviteA->sendJoinTraining();
+    ASSERT_FALSE(attendreType(inviteA, "gameFound").isEmpty());
+    QTest::qWait(300);  // Publication de l'état de "a" et diffusion de l'annuaire
+
+    // Premier invité de "b" : autre nom, et pas de redirection vers la partie du premier
+    MockGameClient* inviteB = createClient("", secondPort);
+    inviteB->sendRegister(false, Broker::REDIRECT_MIN_VERSION);
+    QJsonObject enregistreB = attendreType(inviteB, "registered");
+    ASSERT_FALSE(enregistreB.isEmpty());
+    EXPECT_NE(enregistreA["playerName"].toString(), enregistreB["playerName"].toString());
+    EXPECT_TRUE(attendreType(inviteB, "redirect", 500).isEmpty());
+
+    for (MockGameClient* c : clients) delete c;
+    clients.clear();
+    QCoreApplication::processEvents();
+}
+
 // ========================================
 // Tests de phase de jeu (simplifiés)
 // ========================================
@@ -521,6 +837,9 @@ TEST_F(GameServerIntegrationTest, PlayingPhase_PlayersCanPlayCards) {
     for (QSignalSpy* spy : gameFoundSpies) delete spy;
     ASSERT_TRUE(allReceived) << "All players should receive gameFound signal";
 
+    // Horloge de cette room sans délai d'animation : le jeu démarre dès la fin des enchères
+    ASSERT_TRUE(gameServer->setRoomClockSpeed(players[0]->roomId(), 0));
+
     QCoreApplication::processEvents();
     QTest::qWait(500);
 
@@ -545,7 +864,7 @@ TEST_F(GameServerIntegrationTest, PlayingPhase_PlayersCanPlayCards) {
     QCoreApplication::processEvents();
 
     players[0]->sendMakeBid(14, 0);  // Player 0 passe (3ème passe après enchère → fin enchères, 14 = PASSE)
-    QTest::qWait(2000);  // Attendre que la phase de jeu démarre
+    QTest::qWait(300);  // Attendre que la phase de jeu démarre
     QCoreApplication::processEvents();
 
     // Créer des spies pour cardPlayed
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "../server/Glicko2.h"
+
+TEST(Glicko2Test, ExempleDeGlickman) {
+    // Exemple de référence du document de Glickman
+    Glicko2::Rating joueur;
+    joueur.rating = 1500;
+    joueur.rd = 200;
+    joueur.volatility = 0.06;
+
+    Glicko2::Rating apres = Glicko2::update(joueur, {
+        {1500, 1400, 30, 1.0},
+        {1500, 1550, 100, 0.0},
+        {1500, 1700, 300, 0.0},
+    });
+    EXPECT_NEAR(apres.rating, 1464.06, 0.05);
+    EXPECT_NEAR(apres.rd, 151.52, 0.05);
+    EXPECT_NEAR(apres.volatility, 0.05999, 0.00001);
+    EXPECT_EQ(apres.games, 3);
+}
+
+TEST(Glicko2Test, PartieEnEquipes) {
+    std::array<Glicko2::Rating, 4> places;
+    std::array<Glicko2::Rating, 4> apres = Glicko2::rateTeamGame(places, true);
+
+    // Équipe 1 (places 0 et 2) gagne : symétrique entre partenaires et adversaires
+    EXPECT_GT(apres[0].rating, 1500);
+    EXPECT_DOUBLE_EQ(apres[0].rating, apres[2].rating);
+    EXPECT_LT(apres[1].rating, 1500);
+    EXPECT_NEAR(apres[0].rating - 1500, 1500 - apres[1].rating, 1e-9);
+    EXPECT_LT(apres[0].rd, Glicko2::DEFAULT_RD);
+    EXPECT_EQ(apres[3].games, 1);
+}
+
+TEST(Glicko2Test, PartenaireFortEtNouveauJoueur) {
+    std::array<Glicko2::Rating, 4> places;
+    places[0] = {1900, 50, 0.06, 200};   // Confirmé
+    places[2] = {1500, 350, 0.06, 0};    // Nouveau
+    places[1] = {1700, 50, 0.06, 200};
+    places[3] = {1700, 50, 0.06, 200};
+
+    std::array<Glicko2::Rating, 4> victoire = Glicko2::rateTeamGame(places, true);
+    // Le nouveau joueur (grande incertitude) bouge bien plus que son partenaire confirmé
+    EXPECT_GT(victoire[2].rating - 1500, 5 * (victoire[0].rating - 1900));
+
+    // Équipes de même moyenne : gagner contre plus fort en moyenne rapporte plus
+    places[1] = {1800, 50, 0.06, 200};
+    places[3] = {1800, 50, 0.06, 200};
+    std::array<Glicko2::Rating, 4> exploit = Glicko2::rateTeamGame(places, true);
+    EXPECT_GT(exploit[0].rating, victoire[0].rating);
+}
+
+TEST(Glicko2Test, JoueurPartiPerd) {
+    std::array<Glicko2::Rating, 4> places;
+    // Équipe 1 gagne, mais le joueur de la place 2 est parti avant la fin
+    std::array<Glicko2::Rating, 4> apres = Glicko2::rateTeamGame(places, {1.0, 0.0, 0.0, 0.0});
+    std::array<Glicko2::Rating, 4> normal = Glicko2::rateTeamGame(places, true);
+
+    EXPECT_LT(apres[2].rating, 1500);
+    EXPECT_DOUBLE_EQ(apres[2].rating, normal[1].rating);
+    EXPECT_DOUBLE_EQ(apres[0].rating, normal[0].rating);
+    EXPECT_EQ(apres[2].games, 1);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "../server/IndexedQueue.h"
+#include <string>
+#include <vector>
+
+static std::vector<std::string> contenu(const IndexedQueue<std::string> &file) {
+    return std::vector<std::string>(file.begin(), file.end());
+}
+
+TEST(IndexedQueueTest, OrdreArriveeSansDoublon) {
+    IndexedQueue<std::string> file;
+    EXPECT_TRUE(file.isEmpty());
+    EXPECT_TRUE(file.enqueue("a"));
+    EXPECT_TRUE(file.enqueue("b"));
+    EXPECT_FALSE(file.enqueue("a"));  // Déjà en attente : garde sa place
+    EXPECT_TRUE(file.enqueue("c"));
+
+    EXPECT_EQ(file.size(), 3);
+    EXPECT_EQ(contenu(file), std::vector<std::string>({"a", "b", "c"}));
+    EXPECT_EQ(file.dequeue(), "a");
+    EXPECT_FALSE(file.contains("a"));
+    EXPECT_EQ(file.size(), 2);
+}
+
+TEST(IndexedQueueTest, RetraitAuMilieu) {
+    IndexedQueue<std::string> file;
+    for (const char *id : {"j1", "j2", "j3", "j4"}) file.enqueue(id);
+
+    // Déconnexion d'un joueur au milieu de la file
+    EXPECT_TRUE(file.remove("j2"));
+    EXPECT_FALSE(file.remove("j2"));
+    EXPECT_FALSE(file.contains("j2"));
+    EXPECT_EQ(contenu(file), std::vector<std::string>({"j1", "j3", "j4"}));
+
+    // Il peut revenir, en fin de file
+    EXPECT_TRUE(file.enqueue("j2"));
+    EXPECT_EQ(file.dequeue(), "j1");
+    EXPECT_EQ(file.dequeue(), "j3");
+    EXPECT_EQ(file.dequeue(), "j4");
+    EXPECT_EQ(file.dequeue(), "j2");
+    EXPECT_TRUE(file.isEmpty());
+}
+
+TEST(IndexedQueueTest, GrandeFile) {
+    IndexedQueue<int> file;
+    for (int i = 0; i < 10000; i++) file.enqueue(i);
+    for (int i = 0; i < 10000; i += 2) EXPECT_TRUE(file.remove(i));
+
+    EXPECT_EQ(file.size(), 5000);
+    int attendu = 1;
+    for (int id : file) {
+        EXPECT_EQ(id, attendu);
+        attendu += 2;
+    }
+    file.clear();
+    EXPECT_TRUE(file.isEmpty());
+    EXPECT_FALSE(file.contains(1));
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "../server/LeaderboardIndex.h"
+#include <string>
+
+using Classement = LeaderboardIndex<std::string>;
+
+TEST(LeaderboardIndexTest, TopEtRang) {
+    Classement classement;
+    classement.set("alice", 1620.4);
+    classement.set("bob", 1710);
+    classement.set("carol", 1480);
+    classement.set("dave", 1620.2);  // Ex aequo avec alice une fois arrondi
+
+    EXPECT_EQ(classement.size(), 4);
+    EXPECT_EQ(classement.rank("bob"), 1);
+    EXPECT_EQ(classement.rank("alice"), 2);
+    EXPECT_EQ(classement.rank("dave"), 2);
+    EXPECT_EQ(classement.rank("carol"), 4);
+    EXPECT_EQ(classement.rank("inconnu"), 0);
+
+    auto top = classement.top(3);
+    ASSERT_EQ(top.size(), 3u);
+    EXPECT_EQ(top[0].key, "bob");
+    EXPECT_EQ(top[0].score, 1710);
+    EXPECT_EQ(top[1].key, "alice");
+    EXPECT_EQ(top[2].key, "dave");
+    EXPECT_EQ(top[2].rank, 2);
+}
+
+TEST(LeaderboardIndexTest, MiseAJourEtRetrait) {
+    Classement classement;
+    classement.set("alice", 1500);
+    classement.set("bob", 1600);
+    classement.set("alice", 1650);  // Remonte
+    EXPECT_EQ(classement.size(), 2);
+    EXPECT_EQ(classement.rank("alice"), 1);
+    EXPECT_EQ(classement.rank("bob"), 2);
+
+    EXPECT_TRUE(classement.remove("alice"));
+    EXPECT_FALSE(classement.remove("alice"));
+    EXPECT_EQ(classement.rank("bob"), 1);
+    EXPECT_EQ(classement.score("alice"), -1);
+
+    // Cotes hors bornes : ramenées dans [0, MAX_SCORE]
+    classement.set("extreme", 9999);
+    EXPECT_EQ(classement.score("extreme"), Classement::MAX_SCORE);
+    EXPECT_EQ(classement.top(1)[0].key, "extreme");
+}
+
+TEST(LeaderboardIndexTest, GrandClassement) {
+    Classement classement;
+    for (int i = 0; i < 100000; i++) {
+        classement.set("j" + std::to_string(i), 1000 + i % 2000);
+    }
+    // 50 joueurs par score : rang = 1 + 50 × (scores au-dessus)
+    EXPECT_EQ(classement.rank("j1999"), 1);
+    EXPECT_EQ(classement.rank("j0"), 1 + 50 * 1999);
+    auto top = classement.top(60);
+    ASSERT_EQ(top.size(), 60u);
+    EXPECT_EQ(top[0].score, 2999);
+    EXPECT_EQ(top[50].score, 2998);
+    EXPECT_EQ(top[50].rank, 51);
+}
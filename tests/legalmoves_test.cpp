@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "../LegalMoves.h"
+
+// Construit un masque à partir d'une liste de cartes
+static CardSet mainDe(std::initializer_list<std::pair<Carte::Couleur, Carte::Chiffre>> cartes) {
+    CardSet set;
+    for (const auto& c : cartes) {
+        set.add(makeCardId(c.first, c.second));
+    }
+    return set;
+}
+
+// ========================================
+// Mode couleur (atout = PIQUE)
+// ========================================
+
+TEST(LegalMovesTest, EntameToutEstJouable) {
+    CardSet main = mainDe({{Carte::COEUR, Carte::AS}, {Carte::PIQUE, Carte::SEPT}});
+    EXPECT_EQ(LegalMoves::legalMoves(main, Carte::COULEURINVALIDE, CARD_ID_INVALIDE, false,
+                                     Carte::PIQUE, CardTables::MODE_COULEUR), main);
+}
+
+TEST(LegalMovesTest, DoitFournirALaCouleurDemandee) {
+    CardSet main = mainDe({{Carte::COEUR, Carte::SEPT}, {Carte::COEUR, Carte::AS}, {Carte::PIQUE, Carte::VALET}});
+    CardSet jouables = LegalMoves::legalMoves(main, Carte::COEUR, makeCardId(Carte::COEUR, Carte::ROI), false,
+                                              Carte::PIQUE, CardTables::MODE_COULEUR);
+    // Pas d'obligation de monter hors atout
+    EXPECT_EQ(jouables, mainDe({{Carte::COEUR, Carte::SEPT}, {Carte::COEUR, Carte::AS}}));
+}
+
+TEST(LegalMovesTest, DoitMonterAAtout) {
+    CardSet main = mainDe({{Carte::PIQUE, Carte::SEPT}, {Carte::PIQUE, Carte::NEUF}, {Carte::COEUR, Carte::AS}});
+    CardSet jouables = LegalMoves::legalMoves(main, Carte::PIQUE, makeCardId(Carte::PIQUE, Carte::AS), false,
+                                              Carte::PIQUE, CardTables::MODE_COULEUR);
+    EXPECT_EQ(jouables, mainDe({{Carte::PIQUE, Carte::NEUF}}));
+}
+
+TEST(LegalMovesTest, DoitCouperEtSurcouper) {
+    CardSet main = mainDe({{Carte::PIQUE, Carte::SEPT}, {Carte::PIQUE, Carte::VALET}, {Carte::TREFLE, Carte::AS}});
+
+    // Adversaire maître à coeur : tous les atouts sont jouables
+    EXPECT_EQ(LegalMoves::legalMoves(main, Carte::COEUR, makeCardId(Carte::COEUR, Carte::AS), false,
+                                     Carte::PIQUE, CardTables::MODE_COULEUR),
+              mainDe({{Carte::PIQUE, Carte::SEPT}, {Carte::PIQUE, Carte::VALET}}));
+
+    // Adversaire a coupé du 9 : seul le Valet surcoupe
+    EXPECT_EQ(LegalMoves::legalMoves(main, Carte::COEUR, makeCardId(Carte::PIQUE, Carte::NEUF), false,
+                                     Carte::PIQUE, CardTables::MODE_COULEUR),
+              mainDe({{Carte::PIQUE, Carte::VALET}}));
+}
+
+TEST(LegalMovesTest, DefausseLibreSiPartenaireMaitre) {
+    CardSet main = mainDe({{Carte::PIQUE, Carte::SEPT}, {Carte::TREFLE, Carte::AS}});
+    EXPECT_EQ(LegalMoves::legalMoves(main, Carte::COEUR, makeCardId(Carte::COEUR, Carte::AS), true,
+                                     Carte::PIQUE, CardTables::MODE_COULEUR), main);
+}
+
+// ========================================
+// Tout Atout / Sans Atout
+// ========================================
+
+TEST(LegalMovesTest, ToutAtoutDoitMonterDansLaCouleur) {
+    CardSet main = mainDe({{Carte::COEUR, Carte::SEPT}, {Carte::COEUR, Carte::VALET}, {Carte::TREFLE, Carte::AS}});
+    EXPECT_EQ(LegalMoves::legalMoves(main, Carte::COEUR, makeCardId(Carte::COEUR, Carte::NEUF), false,
+                                     Carte::COULEURINVALIDE, CardTables::MODE_TOUT_ATOUT),
+              mainDe({{Carte::COEUR, Carte::VALET}}));
+
+    // Sans la couleur demandée, on se défausse librement
+    CardSet sansCoeur = mainDe({{Carte::TREFLE, Carte::AS}, {Carte::PIQUE, Carte::SEPT}});
+    EXPECT_EQ(LegalMoves::legalMoves(sansCoeur, Carte::COEUR, makeCardId(Carte::COEUR, Carte::NEUF), false,
+                                     Carte::COULEURINVALIDE, CardTables::MODE_TOUT_ATOUT), sansCoeur);
+}
+
+TEST(LegalMovesTest, SansAtoutPasDObligationDeMonter) {
+    CardSet main = mainDe({{Carte::COEUR, Carte::SEPT}, {Carte::COEUR, Carte::AS}, {Carte::TREFLE, Carte::AS}});
+    EXPECT_EQ(LegalMoves::legalMoves(main, Carte::COEUR, makeCardId(Carte::COEUR, Carte::DIX), false,
+                                     Carte::COULEURINVALIDE, CardTables::MODE_SANS_ATOUT),
+              mainDe({{Carte::COEUR, Carte::SEPT}, {Carte::COEUR, Carte::AS}}));
+}
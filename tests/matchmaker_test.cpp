@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "../server/Matchmaker.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using File = Matchmaker<std::string>;
+
+static std::vector<std::string> trie(std::vector<std::string> table) {
+    std::sort(table.begin(), table.end());
+    return table;
+}
+
+TEST(MatchmakerTest, RegroupeLesNiveauxProches) {
+    File file;
+    // Deux groupes de niveau entrés en alternance : le FIFO les aurait mélangés
+    file.enqueue("fort1", 1900, 0);
+    file.enqueue("faible1", 1100, 0);
+    file.enqueue("fort2", 1880, 0);
+    file.enqueue("faible2", 1120, 0);
+    file.enqueue("fort3", 1910, 0);
+    file.enqueue("faible3", 1090, 0);
+    EXPECT_TRUE(file.takeTable(0).empty());
+
+    file.enqueue("fort4", 1870, 0);
+    std::vector<std::string> table = file.takeTable(0);
+    EXPECT_EQ(trie(table), std::vector<std::string>({"fort1", "fort2", "fort3", "fort4"}));
+    EXPECT_EQ(file.size(), 3);
+    EXPECT_FALSE(file.contains("fort1"));
+}
+
+TEST(MatchmakerTest, EquipesEquilibrees) {
+    File file;
+    file.enqueue("a", 1400, 0);
+    file.enqueue("b", 1450, 0);
+    file.enqueue("c", 1480, 0);
+    file.enqueue("d", 1490, 0);
+    std::vector<std::string> table = file.takeTable(0);
+    ASSERT_EQ(table.size(), 4u);
+    // Le plus faible joue avec le plus fort (places 0 et 2 contre 1 et 3)
+    bool aAvecD = (table[0] == "a" && table[2] == "d") || (table[0] == "d" && table[2] == "a")
+               || (table[1] == "a" && table[3] == "d") || (table[1] == "d" && table[3] == "a");
+    EXPECT_TRUE(aAvecD);
+}
+
+TEST(MatchmakerTest, FenetreElargieAvecLAttente) {
+    File file;
+    file.enqueue("j1", 1200, 0);
+    file.enqueue("j2", 1500, 0);
+    file.enqueue("j3", 1700, 0);
+    file.enqueue("j4", 1900, 0);
+    EXPECT_TRUE(file.takeTable(1000).empty());      // Écart 700 > fenêtre de départ
+    EXPECT_TRUE(file.takeTable(20000).empty());     // 100 + 20 × 20 s = 500
+    EXPECT_EQ(file.takeTable(File::UNBOUNDED_AFTER_MS).size(), 4u);
+    EXPECT_TRUE(file.isEmpty());
+}
+
+TEST(MatchmakerTest, PartenairesDeLobbyEnsemble) {
+    File file;
+    file.enqueue("p1", 1500, 0);
+    file.enqueue("p2", 1500, 0);
+    EXPECT_TRUE(file.pair("p1", "p2"));
+    file.enqueue("s1", 1510, 0);
+    file.enqueue("s2", 1490, 0);
+    file.enqueue("s3", 1500, 0);
+
+    std::vector<std::string> table = file.takeTable(0);
+    ASSERT_EQ(table.size(), 4u);
+    int p1 = static_cast<int>(std::find(table.begin(), table.end(), "p1") - table.begin());
+    int p2 = static_cast<int>(std::find(table.begin(), table.end(), "p2") - table.begin());
+    ASSERT_LT(p1, 4);
+    ASSERT_LT(p2, 4);
+    EXPECT_EQ(p1 % 2, p2 % 2) << "Partenaires dans la même équipe";
+    EXPECT_EQ(file.size(), 1);
+}
+
+TEST(MatchmakerTest, RetraitEtOrdreArrivee) {
+    File file;
+    file.enqueue("a", 1500, 0);
+    file.enqueue("b", 1300, 0);
+    file.enqueue("c", 1700, 0);
+    EXPECT_FALSE(file.enqueue("a", 1000, 0));
+    EXPECT_DOUBLE_EQ(file.rating("a"), 1500);
+
+    file.pair("a", "b");
+    EXPECT_TRUE(file.remove("a"));
+    EXPECT_FALSE(file.remove("a"));
+    EXPECT_EQ(std::vector<std::string>(file.begin(), file.end()), std::vector<std::string>({"b", "c"}));
+
+    file.setRating("c", 1350);
+    EXPECT_DOUBLE_EQ(file.rating("c"), 1350);
+    EXPECT_EQ(file.dequeue(), "b");
+    EXPECT_EQ(file.dequeue(), "c");
+    EXPECT_TRUE(file.isEmpty());
+}
+
+TEST(MatchmakerTest, CoteDepuisLeBilan) {
+    EXPECT_DOUBLE_EQ(File::ratingFromRecord(0, 0), File::DEFAULT_RATING);
+    EXPECT_GT(File::ratingFromRecord(100, 70), File::ratingFromRecord(10, 7));
+    EXPECT_LT(File::ratingFromRecord(100, 30), File::DEFAULT_RATING);
+}
+
+TEST(MatchmakerTest, GrandeFile) {
+    // Arrivées à des niveaux variés : chaque table formée reste serrée
+    File file;
+    int formees = 0;
+    for (int i = 0; i < 2000; i++) {
+        file.enqueue("j" + std::to_string(i), 1000 + (i * 7919) % 1000, 0);
+        for (std::vector<std::string> table = file.takeTable(0); !table.empty(); table = file.takeTable(0)) {
+            double min = 1e9, max = -1e9;
+            for (const std::string &id : table) {
+                int n = std::stoi(id.substr(1));
+                double cote = 1000 + (n * 7919) % 1000;
+                min = std::min(min, cote);
+                max = std::max(max, cote);
+            }
+            EXPECT_LE(max - min, File::BASE_WINDOW);
+            formees++;
+        }
+    }
+    EXPECT_GT(formees, 400);
+    EXPECT_EQ(file.size() + formees * 4, 2000);
+}
+
+TEST(MatchmakerTest, GroupePourBotsDansLaFenetre) {
+    File file;
+    file.enqueue("ancien", 1500, 0);
+    file.enqueue("loin", 1900, 1000);
+    file.enqueue("proche", 1550, 2000);
+    // Après 5 s, fenêtre de 200 : le joueur à 1900 attend une autre table
+    EXPECT_EQ(trie(file.takeGroup(5000)), std::vector<std::string>({"ancien", "proche"}));
+    EXPECT_EQ(file.size(), 1);
+    EXPECT_TRUE(file.contains("loin"));
+
+    // Au-delà de UNBOUNDED_AFTER_MS, tout le monde est pris (au plus 3)
+    file.enqueue("a", 1000, 0);
+    file.enqueue("b", 2000, 0);
+    file.enqueue("c", 1500, 0);
+    EXPECT_EQ(file.takeGroup(File::UNBOUNDED_AFTER_MS + 1000).size(), 3u);
+    EXPECT_EQ(file.size(), 1);
+}
+
+TEST(MatchmakerTest, GroupePourBotsGardeLesPaires) {
+    File file;
+    file.enqueue("seul", 1500, 0);
+    file.enqueue("p1", 1500, 0);
+    file.enqueue("p2", 1500, 0);
+    file.enqueue("s2", 1500, 0);
+    file.pair("p1", "p2");
+    // La paire passe en entier ou pas du tout
+    std::vector<std::string> groupe = file.takeGroup(0);
+    EXPECT_EQ(trie(groupe), std::vector<std::string>({"p1", "p2", "seul"}));
+    EXPECT_EQ(file.size(), 1);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "../server/MessageDispatcher.h"
+
+TEST(MessageDispatcherTest, RouteVersLeBonHandler) {
+    MessageDispatcher dispatcher;
+    QString recu;
+    dispatcher.registerHandler("playCard", [&recu](QWebSocket*, const QJsonObject &data) {
+        recu = "playCard:" + QString::number(data["cardIndex"].toInt());
+    });
+    dispatcher.registerHandler("makeBid", [&recu](QWebSocket*, const QJsonObject &) { recu = "makeBid"; });
+
+    MessageDispatcher::Route *route = dispatcher.find("playCard");
+    ASSERT_NE(route, nullptr);
+    QJsonObject data;
+    data["cardIndex"] = 3;
+    dispatcher.invoke(*route, nullptr, data);
+    EXPECT_EQ(recu, QString("playCard:3"));
+
+    EXPECT_EQ(dispatcher.find("inconnu"), nullptr);
+    EXPECT_EQ(dispatcher.types().size(), 2);
+}
+
+TEST(MessageDispatcherTest, VerificationVersionParRoute) {
+    MessageDispatcher dispatcher;
+    dispatcher.registerHandler("loginAccount", [](QWebSocket*, const QJsonObject &) {}, true);
+    dispatcher.registerHandler("playCard", [](QWebSocket*, const QJsonObject &) {});
+
+    EXPECT_TRUE(dispatcher.find("loginAccount")->checkVersion);
+    EXPECT_FALSE(dispatcher.find("playCard")->checkVersion);
+}
+
+TEST(MessageDispatcherTest, ComptageEtRemiseAZero) {
+    MessageDispatcher dispatcher;
+    dispatcher.registerHandler("sendEmoji", [](QWebSocket*, const QJsonObject &) {});
+
+    MessageDispatcher::Route *route = dispatcher.find("sendEmoji");
+    for (int i = 0; i < 5; i++) {
+        dispatcher.invoke(*route, nullptr, QJsonObject());
+    }
+    const MessageDispatcher::Stats *stats = dispatcher.stats("sendEmoji");
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->count, 5u);
+    quint64 total = 0;
+    for (quint64 n : stats->histogram) total += n;
+    EXPECT_EQ(total, 5u);
+
+    dispatcher.resetStats();
+    EXPECT_EQ(dispatcher.stats("sendEmoji")->count, 0u);
+    EXPECT_NE(dispatcher.find("sendEmoji"), nullptr);
+}
+
+TEST(MessageDispatcherTest, HistogrammeParPuissanceDeDeux) {
+    MessageDispatcher::Stats stats;
+    stats.record(500);          // < 1 µs
+    stats.record(1500);         // 1 µs
+    stats.record(3000);         // 3 µs
+    stats.record(100000);       // 100 µs
+
+    EXPECT_EQ(stats.histogram[0], 1u);
+    EXPECT_EQ(stats.histogram[1], 1u);
+    EXPECT_EQ(stats.histogram[2], 1u);
+    EXPECT_EQ(stats.histogram[7], 1u);
+    EXPECT_EQ(stats.maxNs, 100000u);
+    EXPECT_EQ(stats.percentileUs(0.50), 4u);
+    EXPECT_EQ(stats.percentileUs(0.99), 128u);
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <QCryptographicHash>
+#include "../server/PasswordHasher.h"
+
+// Vecteurs de test PBKDF2-HMAC-SHA256 (RFC 7914 §11 et vecteurs usuels)
+TEST(PasswordHasherTest, Pbkdf2VecteursDeReference) {
+    EXPECT_EQ(PasswordHasher::pbkdf2Sha256("password", "salt", 1).toHex(),
+              QByteArray("120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b"));
+    EXPECT_EQ(PasswordHasher::pbkdf2Sha256("password", "salt", 4096).toHex(),
+              QByteArray("c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a"));
+
+    // Clé plus longue qu'un bloc SHA-256
+    EXPECT_EQ(PasswordHasher::pbkdf2Sha256("passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, 40).toHex(),
+              QByteArray("348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9"));
+}
+
+TEST(PasswordHasherTest, HashPuisVerification) {
+    QString salt = PasswordHasher::generateSalt();
+    QString hash = PasswordHasher::hash("Password1!", salt, 2000);
+    EXPECT_TRUE(hash.startsWith("pbkdf2-sha256$2000$"));
+
+    PasswordHasher::Verification ok = PasswordHasher::verify("Password1!", salt, hash);
+    EXPECT_TRUE(ok.ok);
+    EXPECT_TRUE(ok.needsRehash) << "Coût inférieur au coût courant";
+
+    EXPECT_FALSE(PasswordHasher::verify("Password2!", salt, hash).ok);
+    EXPECT_FALSE(PasswordHasher::verify("Password1!", PasswordHasher::generateSalt(), hash).ok);
+    EXPECT_FALSE(PasswordHasher::verify("Password1!", salt, QString()).ok);
+    EXPECT_FALSE(PasswordHasher::verify("Password1!", salt, "pbkdf2-sha256$abc$00").ok);
+
+    QString courant = PasswordHasher::hash("Password1!", salt);
+    EXPECT_FALSE(PasswordHasher::verify("Password1!", salt, courant).needsRehash);
+}
+
+TEST(PasswordHasherTest, AncienFormatAccepteEtARecalculer) {
+    QString salt = PasswordHasher::generateSalt();
+    QString ancien = QString(QCryptographicHash::hash(QString("Password1!" + salt).toUtf8(),
+                                                      QCryptographicHash::Sha256).toHex());
+
+    PasswordHasher::Verification verification = PasswordHasher::verify("Password1!", salt, ancien);
+    EXPECT_TRUE(verification.ok);
+    EXPECT_TRUE(verification.needsRehash);
+    EXPECT_FALSE(PasswordHasher::verify("mauvais", salt, ancien).ok);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "../PimcBot.h"
+#include "../LegalMoves.h"
+#include <algorithm>
+#include <chrono>
+
+TEST(PimcBotTest, CartesExcluesApresDefausse) {
+    // Entame à coeur, le joueur défausse un trèfle alors que l'adversaire est maître : ni coeur ni atout
+    CardSet exclues = LegalMoves::cartesExclues(makeCardId(Carte::TREFLE, Carte::SEPT), Carte::COEUR,
+                                                makeCardId(Carte::COEUR, Carte::AS), false,
+                                                Carte::PIQUE, CardTables::MODE_COULEUR);
+    EXPECT_EQ(exclues, CardSet::suit(Carte::COEUR) | CardSet::suit(Carte::PIQUE));
+
+    // Partenaire maître : la défausse ne révèle que l'absence de coeur
+    exclues = LegalMoves::cartesExclues(makeCardId(Carte::TREFLE, Carte::SEPT), Carte::COEUR,
+                                        makeCardId(Carte::COEUR, Carte::AS), true,
+                                        Carte::PIQUE, CardTables::MODE_COULEUR);
+    EXPECT_EQ(exclues, CardSet::suit(Carte::COEUR));
+}
+
+TEST(PimcBotTest, DistributionRespecteLesContraintes) {
+    PimcBot::Contexte contexte;
+    contexte.joueur = 0;
+    contexte.couleurAtout = Carte::PIQUE;
+    // Fin de manche à 3 cartes chacun, les 20 autres cartes sont tombées
+    for (int rang = Carte::SEPT; rang <= Carte::NEUF; rang++) {
+        contexte.main.add(makeCardId(Carte::COEUR, static_cast<Carte::Chiffre>(rang)));
+    }
+    CardSet cachees = CardSet::suit(Carte::TREFLE);
+    cachees.add(makeCardId(Carte::PIQUE, Carte::AS));
+    contexte.jouees = ~(contexte.main | cachees);
+    contexte.nbCartes = {{ 3, 3, 3, 3 }};
+    // Le joueur 1 n'a plus d'atout
+    contexte.exclues[1] = CardSet::suit(Carte::PIQUE);
+
+    std::mt19937 rng(42);
+    for (int essai = 0; essai < 50; essai++) {
+        std::array<CardSet, 4> mains;
+        ASSERT_TRUE(PimcBot::sampleDeal(contexte, rng, mains));
+        EXPECT_EQ(mains[0], contexte.main);
+        EXPECT_EQ(mains[1].size(), 3);
+        EXPECT_EQ(mains[2].size(), 3);
+        EXPECT_EQ(mains[3].size(), 3);
+        EXPECT_TRUE((mains[1] & contexte.exclues[1]).empty());
+        EXPECT_EQ(mains[1] | mains[2] | mains[3], cachees);
+    }
+}
+
+TEST(PimcBotTest, DistributionImpossible) {
+    PimcBot::Contexte contexte;
+    contexte.joueur = 0;
+    contexte.couleurAtout = Carte::PIQUE;
+    contexte.main.add(makeCardId(Carte::COEUR, Carte::SEPT));
+    CardSet cachees = CardSet::single(makeCardId(Carte::PIQUE, Carte::AS));
+    contexte.jouees = ~(contexte.main | cachees);
+    contexte.nbCartes = {{ 1, 1, 0, 0 }};
+    contexte.exclues[1] = cachees;
+
+    std::mt19937 rng(1);
+    std::array<CardSet, 4> mains;
+    EXPECT_FALSE(PimcBot::sampleDeal(contexte, rng, mains));
+
+    PimcBot::Options options;
+    EXPECT_EQ(PimcBot::chooseCard(contexte, options).carte, CARD_ID_INVALIDE);
+}
+
+TEST(PimcBotTest, PrendLePliMaitre) {
+    // Dernier pli : le bot (joueur 3) doit prendre avec l'As plutôt que jouer le 7
+    PimcBot::Contexte contexte;
+    contexte.joueur = 3;
+    contexte.couleurAtout = Carte::PIQUE;
+    contexte.main.add(makeCardId(Carte::COEUR, Carte::AS));
+    contexte.main.add(makeCardId(Carte::COEUR, Carte::SEPT));
+    contexte.pli = {{ makeCardId(Carte::COEUR, Carte::DIX), makeCardId(Carte::COEUR, Carte::HUIT),
+                      CARD_ID_INVALIDE, CARD_ID_INVALIDE }};
+    contexte.pliSize = 2;
+    contexte.leader = 1;
+    CardSet cachees = CardSet::single(makeCardId(Carte::COEUR, Carte::ROI))
+                    | CardSet::single(makeCardId(Carte::TREFLE, Carte::SEPT))
+                    | CardSet::single(makeCardId(Carte::TREFLE, Carte::HUIT))
+                    | CardSet::single(makeCardId(Carte::TREFLE, Carte::NEUF));
+    contexte.jouees = ~(contexte.main | cachees) & ~CardSet::single(contexte.pli[0]) & ~CardSet::single(contexte.pli[1]);
+    contexte.nbCartes = {{ 2, 1, 1, 2 }};
+
+    PimcBot::Options options;
+    options.seed = 5;
+    PimcBot::Resultat resultat = PimcBot::chooseCard(contexte, options);
+    EXPECT_GT(resultat.samples, 0);
+    EXPECT_EQ(resultat.carte, makeCardId(Carte::COEUR, Carte::AS));
+}
+
+TEST(PimcBotTest, CoupDansLeBudget) {
+    // Mains complètes (le cas le plus long) : l'échéance vaut aussi au milieu d'un échantillon
+    PimcBot::Options options;
+    options.maxSamples = 1000;
+    constexpr int MARGE_MS = 50;
+    std::mt19937 rng(3);
+    for (int donne = 0; donne < 4; donne++) {
+        std::array<CardId, NB_CARTES> cartes;
+        for (int id = 0; id < NB_CARTES; id++) cartes[id] = static_cast<CardId>(id);
+        std::shuffle(cartes.begin(), cartes.end(), rng);
+
+        PimcBot::Contexte contexte;
+        contexte.joueur = donne % 4;
+        contexte.leader = contexte.joueur;
+        contexte.couleurAtout = Carte::PIQUE;
+        for (int i = 0; i < 8; i++) contexte.main.add(cartes[i]);
+        contexte.nbCartes = {{ 8, 8, 8, 8 }};
+        options.seed = donne;
+
+        auto debut = std::chrono::steady_clock::now();
+        PimcBot::Resultat resultat = PimcBot::chooseCard(contexte, options);
+        auto duree = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - debut);
+        EXPECT_LT(duree.count(), options.budgetMs + MARGE_MS) << "donne " << donne;
+        if (resultat.carte != CARD_ID_INVALIDE) {
+            EXPECT_TRUE(contexte.main.contains(resultat.carte));
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "../server/TimingWheel.h"
+#include <random>
+
+TEST(TimingWheelTest, ExecuteALEcheanceJamaisAvant) {
+    TimingWheel roue(10);
+    std::vector<int> ordre;
+    roue.schedule(0, 1500, [&ordre]() { ordre.push_back(1500); });
+    roue.schedule(0, 500, [&ordre]() { ordre.push_back(500); });
+    roue.schedule(0, 20250, [&ordre]() { ordre.push_back(20250); });
+
+    roue.advance(490);
+    EXPECT_TRUE(ordre.empty());
+    roue.advance(500);
+    EXPECT_EQ(ordre, std::vector<int>({500}));
+    roue.advance(20240);
+    EXPECT_EQ(ordre, std::vector<int>({500, 1500}));
+    roue.advance(20250);
+    EXPECT_EQ(ordre, std::vector<int>({500, 1500, 20250}));
+    EXPECT_TRUE(roue.empty());
+}
+
+TEST(TimingWheelTest, AnnulationEtReplanification) {
+    TimingWheel roue(10);
+    int declenches = 0;
+    TimingWheel::TimerId timeout = roue.schedule(0, 15000, [&declenches]() { declenches++; });
+    EXPECT_TRUE(roue.isPending(timeout));
+
+    // Le joueur joue à temps : le timeout est annulé et réarmé pour le suivant
+    roue.advance(3000);
+    EXPECT_TRUE(roue.cancel(timeout));
+    EXPECT_FALSE(roue.cancel(timeout));
+    timeout = roue.schedule(3000, 15000, [&declenches]() { declenches += 10; });
+
+    roue.advance(17990);
+    EXPECT_EQ(declenches, 0);
+    roue.advance(18000);
+    EXPECT_EQ(declenches, 10);
+    EXPECT_FALSE(roue.isPending(timeout));
+}
+
+TEST(TimingWheelTest, TakeExecuteSansAttendre) {
+    TimingWheel roue(10);
+    int declenches = 0;
+    TimingWheel::TimerId animation = roue.schedule(0, 7500, [&declenches]() { declenches++; });
+
+    TimingWheel::Callback callback = roue.take(animation);
+    ASSERT_TRUE(callback);
+    callback();
+    EXPECT_EQ(declenches, 1);
+    EXPECT_FALSE(roue.take(animation));
+
+    roue.advance(10000);
+    EXPECT_EQ(declenches, 1);
+}
+
+TEST(TimingWheelTest, RepriseApresInactivite) {
+    TimingWheel roue(10);
+    roue.advance(1000);
+
+    // Plus d'avance pendant 3 jours (timer arrêté), puis un nouvel événement
+    const std::int64_t troisJours = 3LL * 24 * 3600 * 1000;
+    int declenches = 0;
+    roue.schedule(troisJours, 500, [&declenches]() { declenches++; });
+    EXPECT_EQ(roue.advance(troisJours + 490), 0);
+    EXPECT_EQ(roue.advance(troisJours + 500), 1);
+    EXPECT_EQ(declenches, 1);
+}
+
+TEST(TimingWheelTest, CallbackPlanifieLaSuite) {
+    TimingWheel roue(10);
+    int secondes = 0;
+    std::function<void()> tic;
+    tic = [&]() {
+        secondes++;
+        if (secondes < 10) roue.schedule(secondes * 1000, 1000, tic);
+    };
+    roue.schedule(0, 1000, tic);
+
+    roue.advance(60000);
+    EXPECT_EQ(secondes, 10);
+    EXPECT_TRUE(roue.empty());
+}
+
+TEST(TimingWheelTest, DelaisAleatoiresTousNiveaux) {
+    TimingWheel roue(10);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<std::int64_t> delai(0, 3 * 3600 * 1000);  // Jusqu'au niveau 3
+
+    std::vector<std::int64_t> echeances(500), executions(500, -1);
+    std::int64_t maintenant = 0;
+    for (int i = 0; i < 500; i++) {
+        echeances[i] = delai(rng);
+        roue.schedule(0, echeances[i], [&executions, &maintenant, i]() { executions[i] = maintenant; });
+    }
+
+    // Avance par pas irréguliers, comme un timer système en retard
+    while (!roue.empty()) {
+        maintenant += 7 + maintenant % 5000;
+        roue.advance(maintenant);
+    }
+    for (int i = 0; i < 500; i++) {
+        ASSERT_GE(executions[i], echeances[i]) << i;
+    }
+}
+
+TEST(TimingWheelTest, PrecisionAuTickPres) {
+    TimingWheel roue(10);
+    std::vector<std::int64_t> executions;
+    std::int64_t maintenant = 0;
+    for (std::int64_t d : {5, 640, 650, 40960, 41000, 2621440}) {
+        roue.schedule(0, d, [&executions, &maintenant]() { executions.push_back(maintenant); });
+    }
+    while (!roue.empty()) {
+        maintenant += 10;
+        roue.advance(maintenant);
+    }
+    EXPECT_EQ(executions, std::vector<std::int64_t>({10, 640, 650, 40960, 41000, 2621440}));
+}
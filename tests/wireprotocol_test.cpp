@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <QFile>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QSet>
+#include "../server/WireProtocol.h"
+
+static QJsonObject carte(int value, int suit) {
+    QJsonObject c;
+    c["value"] = value;
+    c["suit"] = suit;
+    return c;
+}
+
+TEST(WireProtocolTest, AllerRetourMessageDeJeu) {
+    QJsonObject msg;
+    msg["type"] = "cardPlayed";
+    msg["playerIndex"] = 2;
+    msg["cardIndex"] = 5;
+    msg["cardValue"] = 14;
+    msg["cardSuit"] = 6;
+
+    QJsonObject decode;
+    ASSERT_TRUE(WireProtocol::decode(WireProtocol::encode(msg), decode));
+    EXPECT_EQ(decode, msg);
+}
+
+TEST(WireProtocolTest, AllerRetourCartesEtClesInconnues) {
+    QJsonArray main;
+    main.append(carte(7, 3));
+    main.append(carte(14, 6));
+    main.append(carte(11, 4));
+
+    QJsonObject msg;
+    msg["type"] = "nouveauTypeDeMessage";   // Hors dictionnaire : encodé en chaîne
+    msg["champInconnu"] = "texte";
+    msg["myCards"] = main;
+    msg["ratio"] = 0.75;
+    msg["isToutAtout"] = false;
+    msg["playableCards"] = QJsonArray({0, 2});
+
+    QJsonObject decode;
+    ASSERT_TRUE(WireProtocol::decode(WireProtocol::encode(msg), decode));
+    EXPECT_EQ(decode, msg);
+}
+
+TEST(WireProtocolTest, ObjetNonCarteConserve) {
+    // Même clés qu'une carte mais hors bornes : reste un objet
+    QJsonObject msg;
+    msg["type"] = "bidMade";
+    msg["retournee"] = carte(0, 0);
+
+    QJsonObject decode;
+    ASSERT_TRUE(WireProtocol::decode(WireProtocol::encode(msg), decode));
+    EXPECT_EQ(decode, msg);
+}
+
+TEST(WireProtocolTest, PlusCompactQueJson) {
+    QJsonArray main;
+    for (int i = 0; i < 8; i++) main.append(carte(7 + i, 3 + i % 4));
+
+    QJsonObject msg;
+    msg["type"] = "gameState";
+    msg["biddingPhase"] = false;
+    msg["currentPlayer"] = 1;
+    msg["atout"] = 4;
+    msg["isToutAtout"] = false;
+    msg["isSansAtout"] = false;
+    msg["playableCards"] = QJsonArray({0, 1, 2, 3});
+    msg["myCards"] = main;
+
+    QByteArray json = QJsonDocument(msg).toJson(QJsonDocument::Compact);
+    QByteArray cbor = WireProtocol::encode(msg);
+    EXPECT_LT(cbor.size() * 3, json.size());
+}
+
+TEST(WireProtocolTest, TrameInvalideRejetee) {
+    QJsonObject decode;
+    EXPECT_FALSE(WireProtocol::decode(QByteArray("\xff\x00\x12", 3), decode));
+    EXPECT_FALSE(WireProtocol::decode(QCborValue(42).toCbor(), decode));
+}
+
+TEST(WireProtocolTest, LotDeMessages) {
+    for (int taille : {1, 3, 30, 300}) {
+        QList<QByteArray> trames;
+        for (int i = 0; i < taille; i++) {
+            QJsonObject msg;
+            msg["type"] = "cardPlayed";
+            msg["playerIndex"] = i % 4;
+            msg["cardIndex"] = i;
+            trames.append(WireProtocol::encode(msg));
+        }
+
+        QList<QJsonObject> messages;
+        ASSERT_TRUE(WireProtocol::decodeBatch(WireProtocol::encodeBatch(trames), messages)) << "taille " << taille;
+        ASSERT_EQ(messages.size(), taille);
+        for (int i = 0; i < taille; i++) {
+            EXPECT_EQ(messages[i]["cardIndex"].toInt(), i);
+            EXPECT_EQ(messages[i]["type"].toString(), QString("cardPlayed"));
+        }
+    }
+
+    // Un message seul reste décodable par decodeBatch
+    QJsonObject seul;
+    seul["type"] = "gameOver";
+    QList<QJsonObject> messages;
+    ASSERT_TRUE(WireProtocol::decodeBatch(WireProtocol::encode(seul), messages));
+    ASSERT_EQ(messages.size(), 1);
+    EXPECT_EQ(messages[0]["type"].toString(), QString("gameOver"));
+
+    messages.clear();
+    EXPECT_FALSE(WireProtocol::decodeBatch(QCborValue(QCborArray{1, 2}).toCbor(), messages));
+}
+
+TEST(WireProtocolTest, TypesEnvoyesParLeServeurConnus) {
+    QSet<QString> connus;
+    for (const QString &type : WireProtocol::types()) {
+        EXPECT_FALSE(connus.contains(type)) << "doublon : " << type.toStdString();
+        connus.insert(type);
+    }
+
+    // Toutes les affectations msg["type"] = "..." du serveur
+    static const QRegularExpression affectation(R"re(\["type"\]\s*=\s*"(\w+)")re");
+    int nbTypes = 0;
+    for (const char *fichier : {"GameServer.cpp", "GameServer.h"}) {
+        QFile source(QString(COINCHE_SERVER_DIR) + "/" + fichier);
+        ASSERT_TRUE(source.open(QIODevice::ReadOnly)) << fichier;
+        const QString texte = QString::fromUtf8(source.readAll());
+        auto it = affectation.globalMatch(texte);
+        while (it.hasNext()) {
+            const QString type = it.next().captured(1);
+            EXPECT_TRUE(connus.contains(type)) << fichier << " envoie \"" << type.toStdString()
+                                               << "\" absent de WireProtocol::types()";
+            nbTypes++;
+        }
+    }
+    EXPECT_GT(nbTypes, 50);
+}